@@ -37,71 +37,39 @@ namespace Falcor
 {
 GpuMemoryHeap::~GpuMemoryHeap()
 {
-    mDeferredReleases = decltype(mDeferredReleases)();
+    mPages.clear();
 }
 
-GpuMemoryHeap::GpuMemoryHeap(ref<Device> pDevice, MemoryType memoryType, size_t pageSize, ref<Fence> pFence)
-    : mpDevice(pDevice), mMemoryType(memoryType), mpFence(pFence), mPageSize(pageSize)
-{
-    allocateNewPage();
-}
+GpuMemoryHeap::GpuMemoryHeap(ref<Device> pDevice, MemoryType memoryType, size_t pageSize, ref<Fence> pFence, size_t maxPooledSize)
+    : mpDevice(pDevice), mMemoryType(memoryType), mpFence(pFence), mPageSize(pageSize), mPlacement(pageSize, maxPooledSize)
+{}
 
-ref<GpuMemoryHeap> GpuMemoryHeap::create(ref<Device> pDevice, MemoryType memoryType, size_t pageSize, ref<Fence> pFence)
+ref<GpuMemoryHeap> GpuMemoryHeap::create(
+    ref<Device> pDevice,
+    MemoryType memoryType,
+    size_t pageSize,
+    ref<Fence> pFence,
+    size_t maxPooledSize
+)
 {
-    return ref<GpuMemoryHeap>(new GpuMemoryHeap(pDevice, memoryType, pageSize, pFence));
+    return ref<GpuMemoryHeap>(new GpuMemoryHeap(pDevice, memoryType, pageSize, pFence, maxPooledSize));
 }
 
-void GpuMemoryHeap::allocateNewPage()
+GpuMemoryHeap::Allocation GpuMemoryHeap::allocate(size_t size, size_t alignment)
 {
-    if (mpActivePage)
-    {
-        mUsedPages[mCurrentPageId] = std::move(mpActivePage);
-    }
-
-    if (mAvailablePages.size())
-    {
-        mpActivePage = std::move(mAvailablePages.front());
-        mAvailablePages.pop();
-        mpActivePage->allocationsCount = 0;
-        mpActivePage->currentOffset = 0;
-    }
-    else
-    {
-        mpActivePage = std::make_unique<PageData>();
-        initBasePageData((*mpActivePage), mPageSize);
-    }
+    std::lock_guard<std::mutex> lock(mMutex);
 
-    mpActivePage->currentOffset = 0;
-    mCurrentPageId++;
-}
+    GpuMemoryPlacement::Placement placement = mPlacement.allocate(size, alignment);
+    BaseData& page = mPages[placement.pageID];
+    if (placement.newPage)
+        initBasePageData(page, placement.pageSize);
 
-GpuMemoryHeap::Allocation GpuMemoryHeap::allocate(size_t size, size_t alignment)
-{
     Allocation data;
-    if (size > mPageSize)
-    {
-        data.pageID = GpuMemoryHeap::Allocation::kMegaPageId;
-        initBasePageData(data, size);
-    }
-    else
-    {
-        // Calculate the start
-        size_t currentOffset = align_to(alignment, mpActivePage->currentOffset);
-        if (currentOffset + size > mPageSize)
-        {
-            currentOffset = 0;
-            allocateNewPage();
-        }
-
-        data.pageID = mCurrentPageId;
-        data.size = size;
-        data.offset = currentOffset;
-        data.pData = mpActivePage->pData + currentOffset;
-        data.gfxBufferResource = mpActivePage->gfxBufferResource;
-        mpActivePage->currentOffset = currentOffset + size;
-        mpActivePage->allocationsCount++;
-    }
-
+    data.pageID = placement.pageID;
+    data.size = size;
+    data.offset = placement.offset;
+    data.pData = page.pData + placement.offset;
+    data.gfxBufferResource = page.gfxBufferResource;
     data.fenceValue = mpFence->getSignaledValue();
     return data;
 }
@@ -115,39 +83,76 @@ GpuMemoryHeap::Allocation GpuMemoryHeap::allocate(size_t size, ResourceBindFlags
 void GpuMemoryHeap::release(Allocation& data)
 {
     FALCOR_ASSERT(data.gfxBufferResource);
-    mDeferredReleases.push(data);
+    std::lock_guard<std::mutex> lock(mMutex);
+    mPlacement.release(data.pageID, data.fenceValue);
 }
 
 void GpuMemoryHeap::executeDeferredReleases()
 {
-    uint64_t currentValue = mpFence->getCurrentValue();
-    while (mDeferredReleases.size() && mDeferredReleases.top().fenceValue < currentValue)
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // Destroy the pages that don't fit in the pool anymore.
+    for (uint64_t pageID : mPlacement.executeDeferredReleases(mpFence->getCurrentValue()))
+        mPages.erase(pageID);
+}
+
+GpuMemoryHeap::SubAllocator::SubAllocator(ref<GpuMemoryHeap> pHeap, size_t chunkSize)
+    : mpHeap(pHeap), mChunkSize(chunkSize > 0 ? chunkSize : pHeap->getPageSize())
+{
+    FALCOR_CHECK(mChunkSize <= mpHeap->getPageSize(), "Chunk size must not be larger than the page size of the heap.");
+}
+
+GpuMemoryHeap::SubAllocator::~SubAllocator()
+{
+    reset();
+}
+
+GpuMemoryHeap::Allocation GpuMemoryHeap::SubAllocator::allocate(size_t size, size_t alignment)
+{
+    if (size > mChunkSize)
+    {
+        // Release the allocation right away. It is recycled once the GPU has passed the next fence signal.
+        Allocation data = mpHeap->allocate(size, alignment);
+        mpHeap->release(data);
+        return data;
+    }
+
+    // Align the offset in the page, which is what the alignment applies to.
+    size_t offset = mChunk.gfxBufferResource ? align_to(alignment, size_t(mChunk.offset) + mChunkOffset) - mChunk.offset : mChunkSize;
+    if (offset + size > mChunkSize)
     {
-        const Allocation& data = mDeferredReleases.top();
-        if (data.pageID == mCurrentPageId)
-        {
-            mpActivePage->allocationsCount--;
-            if (mpActivePage->allocationsCount == 0)
-            {
-                mpActivePage->currentOffset = 0;
-            }
-        }
-        else
-        {
-            if (data.pageID != Allocation::kMegaPageId)
-            {
-                auto& pData = mUsedPages[data.pageID];
-                pData->allocationsCount--;
-                if (pData->allocationsCount == 0)
-                {
-                    mAvailablePages.push(std::move(pData));
-                    mUsedPages.erase(data.pageID);
-                }
-            }
-            // else it's a mega-page. Popping it will release the resource
-        }
-        mDeferredReleases.pop();
+        reset();
+        mChunk = mpHeap->allocate(mChunkSize, alignment);
+        offset = 0;
     }
+
+    Allocation data;
+    data.gfxBufferResource = mChunk.gfxBufferResource;
+    data.size = size;
+    data.offset = mChunk.offset + offset;
+    data.pData = mChunk.pData + offset;
+    data.pageID = mChunk.pageID;
+    data.fenceValue = mChunk.fenceValue;
+    mChunkOffset = offset + size;
+    return data;
+}
+
+GpuMemoryHeap::Allocation GpuMemoryHeap::SubAllocator::allocate(size_t size, ResourceBindFlags bindFlags)
+{
+    size_t alignment = mpHeap->mpDevice->getBufferDataAlignment(bindFlags);
+    return allocate(align_to(alignment, size), alignment);
+}
+
+void GpuMemoryHeap::SubAllocator::reset()
+{
+    if (!mChunk.gfxBufferResource)
+        return;
+
+    // The chunk may have been used for allocations since it was allocated.
+    mChunk.fenceValue = mpHeap->mpFence->getSignaledValue();
+    mpHeap->release(mChunk);
+    mChunk = {};
+    mChunkOffset = 0;
 }
 
 Slang::ComPtr<gfx::IBufferResource> createBufferResource(
@@ -31,13 +31,21 @@
 #include "Resource.h"
 #include "Buffer.h"
 #include "Fence.h"
+#include "GpuMemoryPlacement.h"
 #include "Core/Macros.h"
 #include "Core/Object.h"
-#include <queue>
+#include <mutex>
 #include <unordered_map>
 
 namespace Falcor
 {
+/**
+ * Heap of transient GPU memory, used for staging data for uploads and readbacks.
+ *
+ * Allocations are placed in pages of mapped buffers by GpuMemoryPlacement. Pages, including the dedicated
+ * pages of allocations larger than the page size, are recycled once the GPU is done with their allocations.
+ * The heap can be used from multiple threads. Threads that allocate frequently should use a SubAllocator.
+ */
 class FALCOR_API GpuMemoryHeap : public Object
 {
     FALCOR_OBJECT(GpuMemoryHeap)
@@ -56,11 +64,52 @@ public:
     {
         uint64_t pageID = 0;
         uint64_t fenceValue = 0;
+    };
+
+    /**
+     * Linear sub-allocator for use by a single thread.
+     *
+     * Allocations are placed linearly in chunks allocated from the heap, so that threads don't contend for
+     * the heap on every allocation. When a chunk is exhausted, it is released to the heap and a new chunk is
+     * allocated. Allocations larger than the chunk size are made from the heap directly.
+     *
+     * Allocations are not released individually and must not be passed to GpuMemoryHeap::release().
+     * They stay valid until their chunk has been retired and the GPU has passed the next fence signal.
+     */
+    class FALCOR_API SubAllocator
+    {
+    public:
+        /**
+         * Create a sub-allocator.
+         * @param[in] pHeap Heap to allocate chunks from.
+         * @param[in] chunkSize Chunk size in bytes. A value of zero uses the page size of the heap.
+         */
+        SubAllocator(ref<GpuMemoryHeap> pHeap, size_t chunkSize = 0);
+        ~SubAllocator();
+
+        SubAllocator(const SubAllocator&) = delete;
+        SubAllocator& operator=(const SubAllocator&) = delete;
+
+        Allocation allocate(size_t size, size_t alignment = 1);
+        Allocation allocate(size_t size, ResourceBindFlags bindFlags);
 
-        static constexpr uint64_t kMegaPageId = -1;
-        bool operator<(const Allocation& other) const { return fenceValue > other.fenceValue; }
+        /**
+         * Release the current chunk to the heap.
+         */
+        void reset();
+
+        size_t getChunkSize() const { return mChunkSize; }
+
+    private:
+        ref<GpuMemoryHeap> mpHeap;
+        size_t mChunkSize = 0;
+        Allocation mChunk;
+        size_t mChunkOffset = 0;
     };
 
+    /// Default maximum size of the free pages kept for reuse.
+    static constexpr size_t kDefaultMaxPooledSize = 128 * 1024 * 1024;
+
     ~GpuMemoryHeap();
 
     /**
@@ -68,9 +117,16 @@ public:
      * @param[in] memoryType The memory type of heap.
      * @param[in] pageSize Page size in bytes.
      * @param[in] pFence Fence to use for synchronization.
+     * @param[in] maxPooledSize Maximum size in bytes of the free pages kept for reuse.
      * @return A new object, or throws an exception if creation failed.
      */
-    static ref<GpuMemoryHeap> create(ref<Device> pDevice, MemoryType memoryType, size_t pageSize, ref<Fence> pFence);
+    static ref<GpuMemoryHeap> create(
+        ref<Device> pDevice,
+        MemoryType memoryType,
+        size_t pageSize,
+        ref<Fence> pFence,
+        size_t maxPooledSize = kDefaultMaxPooledSize
+    );
 
     Allocation allocate(size_t size, size_t alignment = 1);
     Allocation allocate(size_t size, ResourceBindFlags bindFlags);
@@ -81,28 +137,17 @@ public:
     void breakStrongReferenceToDevice();
 
 private:
-    GpuMemoryHeap(ref<Device> pDevice, MemoryType memoryType, size_t pageSize, ref<Fence> pFence);
-
-    struct PageData : public BaseData
-    {
-        uint32_t allocationsCount = 0;
-        size_t currentOffset = 0;
-
-        using UniquePtr = std::unique_ptr<PageData>;
-    };
+    GpuMemoryHeap(ref<Device> pDevice, MemoryType memoryType, size_t pageSize, ref<Fence> pFence, size_t maxPooledSize);
 
     BreakableReference<Device> mpDevice;
     MemoryType mMemoryType;
     ref<Fence> mpFence;
     size_t mPageSize = 0;
-    size_t mCurrentPageId = 0;
-    PageData::UniquePtr mpActivePage;
 
-    std::priority_queue<Allocation> mDeferredReleases;
-    std::unordered_map<size_t, PageData::UniquePtr> mUsedPages;
-    std::queue<PageData::UniquePtr> mAvailablePages;
+    std::mutex mMutex; ///< Protects the placement and the pages.
+    GpuMemoryPlacement mPlacement;
+    std::unordered_map<uint64_t, BaseData> mPages;
 
-    void allocateNewPage();
     void initBasePageData(BaseData& data, size_t size);
 };
 } // namespace Falcor
@@ -0,0 +1,203 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GpuMemoryPlacement.h"
+#include "Core/Error.h"
+#include "Utils/Math/Common.h"
+
+namespace Falcor
+{
+GpuMemoryPlacement::GpuMemoryPlacement(size_t pageSize, size_t maxPooledSize) : mPageSize(pageSize), mMaxPooledSize(maxPooledSize)
+{
+    FALCOR_CHECK(pageSize > 0, "Page size must be larger than zero.");
+}
+
+GpuMemoryPlacement::Placement GpuMemoryPlacement::allocate(size_t size, size_t alignment)
+{
+    Placement placement;
+    if (size > mPageSize)
+    {
+        // Large allocations get a page of their own.
+        placement = acquirePage(getPageSize(size));
+    }
+    else
+    {
+        size_t offset = mActivePageID != kInvalidPageID ? align_to(alignment, mActiveOffset) : mPageSize;
+        if (offset + size > mPageSize)
+        {
+            // Retire the active page. It is recycled when its last allocation is released.
+            if (mActivePageID != kInvalidPageID && mPages[mActivePageID].allocationCount == 0)
+                recyclePage(mActivePageID);
+
+            Placement active = acquirePage(mPageSize);
+            mActivePageID = active.pageID;
+            offset = 0;
+            placement = active;
+        }
+        else
+        {
+            placement.pageID = mActivePageID;
+            placement.pageSize = mPageSize;
+        }
+
+        placement.offset = offset;
+        mActiveOffset = offset + size;
+    }
+
+    mPages[placement.pageID].allocationCount++;
+    return placement;
+}
+
+void GpuMemoryPlacement::release(uint64_t pageID, uint64_t fenceValue)
+{
+    FALCOR_ASSERT(mPages.count(pageID) && mPages[pageID].allocationCount > 0);
+    mDeferredReleases.push({pageID, fenceValue});
+}
+
+std::vector<uint64_t> GpuMemoryPlacement::executeDeferredReleases(uint64_t completedValue)
+{
+    while (!mDeferredReleases.empty() && mDeferredReleases.top().fenceValue < completedValue)
+    {
+        uint64_t pageID = mDeferredReleases.top().pageID;
+        mDeferredReleases.pop();
+
+        Page& page = mPages[pageID];
+        FALCOR_ASSERT(page.allocationCount > 0);
+        if (--page.allocationCount > 0)
+            continue;
+
+        // The active page is reused from the start, all other pages are returned to the pool.
+        if (pageID == mActivePageID)
+            mActiveOffset = 0;
+        else
+            recyclePage(pageID);
+    }
+
+    std::vector<uint64_t> evictedPages;
+    std::swap(evictedPages, mEvictedPages);
+    return evictedPages;
+}
+
+size_t GpuMemoryPlacement::getPageSize(size_t size) const
+{
+    if (size <= mPageSize)
+        return mPageSize;
+
+    // Pages larger than the pool budget are never reused, so they are not rounded up.
+    if (size > mMaxPooledSize)
+        return size;
+
+    uint32_t sizeClass = 0;
+    while (getSizeClassPageSize(sizeClass) < size)
+        sizeClass++;
+    size_t pageSize = getSizeClassPageSize(sizeClass);
+    return pageSize <= mMaxPooledSize ? pageSize : size;
+}
+
+size_t GpuMemoryPlacement::getSizeClassPageSize(uint32_t sizeClass) const
+{
+    // Size classes step by a quarter of a power of two: 1, 1.25, 1.5, 1.75, 2, 2.5, ... times the page size.
+    size_t baseSize = mPageSize << (sizeClass / 4);
+    return baseSize + (sizeClass % 4) * (baseSize / 4);
+}
+
+uint32_t GpuMemoryPlacement::getSizeClass(size_t pageSize) const
+{
+    uint32_t sizeClass = 0;
+    while (getSizeClassPageSize(sizeClass) < pageSize)
+        sizeClass++;
+    FALCOR_ASSERT(getSizeClassPageSize(sizeClass) == pageSize);
+    return sizeClass;
+}
+
+bool GpuMemoryPlacement::isPoolable(size_t pageSize) const
+{
+    return pageSize <= mMaxPooledSize;
+}
+
+GpuMemoryPlacement::Placement GpuMemoryPlacement::acquirePage(size_t pageSize)
+{
+    Placement placement;
+    placement.pageSize = pageSize;
+
+    // Reuse the most recently released page of the size class.
+    if (isPoolable(pageSize))
+    {
+        uint32_t sizeClass = getSizeClass(pageSize);
+        if (sizeClass < mFreePages.size() && !mFreePages[sizeClass].empty())
+        {
+            placement.pageID = mFreePages[sizeClass].back();
+            mFreePages[sizeClass].pop_back();
+            mPooledSize -= pageSize;
+            return placement;
+        }
+    }
+
+    placement.pageID = mNextPageID++;
+    placement.newPage = true;
+    mPages[placement.pageID].size = pageSize;
+    return placement;
+}
+
+void GpuMemoryPlacement::recyclePage(uint64_t pageID)
+{
+    Page& page = mPages[pageID];
+
+    // Pages that don't fit the pool are destroyed right away instead of evicting all other pages.
+    if (!isPoolable(page.size))
+    {
+        mPages.erase(pageID);
+        mEvictedPages.push_back(pageID);
+        return;
+    }
+
+    uint32_t sizeClass = getSizeClass(page.size);
+    if (sizeClass >= mFreePages.size())
+        mFreePages.resize(sizeClass + 1);
+    mFreePages[sizeClass].push_back(pageID);
+    page.releaseIndex = mReleaseCount++;
+    mPooledSize += page.size;
+
+    // Evict the least recently released pages until the pool is within budget.
+    while (mPooledSize > mMaxPooledSize)
+    {
+        std::deque<uint64_t>* pOldest = nullptr;
+        for (auto& freePages : mFreePages)
+        {
+            if (!freePages.empty() && (!pOldest || mPages[freePages.front()].releaseIndex < mPages[pOldest->front()].releaseIndex))
+                pOldest = &freePages;
+        }
+        FALCOR_ASSERT(pOldest);
+
+        uint64_t evictedID = pOldest->front();
+        pOldest->pop_front();
+        mPooledSize -= mPages[evictedID].size;
+        mPages.erase(evictedID);
+        mEvictedPages.push_back(evictedID);
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,154 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Placement policy of GpuMemoryHeap.
+ *
+ * Keeps track of the pages of a heap, the placement of allocations in them and when pages can be reused.
+ * No GPU resources are created, which allows the policy to be tested on the CPU.
+ *
+ * Allocations up to the page size are placed linearly in the active page. When an allocation doesn't fit,
+ * the active page is retired and a free page becomes active. Retired pages are recycled once all their
+ * allocations have been released.
+ *
+ * Larger allocations get a page of their own. Large page sizes are rounded up to size classes in quarter
+ * power-of-two steps of the page size (1.25, 1.5, 1.75, 2, 2.5, ...), which limits the waste to 25%, so that
+ * released large pages can be pooled by size class and reused. Pages larger than the pool budget are never
+ * pooled, so they are allocated with the exact size and destroyed when released.
+ *
+ * Releases are deferred until the GPU has passed the fence value they were made at. Free pages are pooled
+ * up to a memory budget, beyond which the least recently released pages are evicted.
+ *
+ * The class is not thread-safe.
+ */
+class FALCOR_API GpuMemoryPlacement
+{
+public:
+    static constexpr uint64_t kInvalidPageID = std::numeric_limits<uint64_t>::max();
+
+    struct Placement
+    {
+        uint64_t pageID = kInvalidPageID;
+        size_t pageSize = 0;  ///< Size of the page in bytes.
+        size_t offset = 0;    ///< Offset of the allocation in the page in bytes.
+        bool newPage = false; ///< True if the page is new and needs to be created by the caller.
+    };
+
+    /**
+     * Create a placement policy.
+     * @param[in] pageSize Page size in bytes.
+     * @param[in] maxPooledSize Maximum size in bytes of the free pages kept for reuse.
+     */
+    GpuMemoryPlacement(size_t pageSize, size_t maxPooledSize);
+
+    /**
+     * Place an allocation.
+     * @param[in] size Size in bytes.
+     * @param[in] alignment Alignment in bytes of the offset in the page.
+     * @return The placement.
+     */
+    Placement allocate(size_t size, size_t alignment);
+
+    /**
+     * Release an allocation. The release takes effect once the GPU has passed the fence value.
+     * @param[in] pageID Page of the allocation.
+     * @param[in] fenceValue Signaled fence value at the time the allocation was last used.
+     */
+    void release(uint64_t pageID, uint64_t fenceValue);
+
+    /**
+     * Execute the releases whose fence value has been passed by the GPU.
+     * @param[in] completedValue Current value of the fence.
+     * @return IDs of the pages evicted from the pool. The caller needs to destroy them.
+     */
+    std::vector<uint64_t> executeDeferredReleases(uint64_t completedValue);
+
+    /**
+     * Get the size of the page holding an allocation of the given size.
+     * @param[in] size Allocation size in bytes.
+     * @return Page size in bytes.
+     */
+    size_t getPageSize(size_t size) const;
+
+    size_t getPageSize() const { return mPageSize; }
+    size_t getMaxPooledSize() const { return mMaxPooledSize; }
+
+    /// Get the number of existing pages, including the pooled ones.
+    size_t getPageCount() const { return mPages.size(); }
+
+    /// Get the total size in bytes of the pooled pages.
+    size_t getPooledSize() const { return mPooledSize; }
+
+private:
+    struct Page
+    {
+        size_t size = 0;
+        uint32_t allocationCount = 0;
+        uint64_t releaseIndex = 0; ///< Order in which the page was added to the pool.
+    };
+
+    struct DeferredRelease
+    {
+        uint64_t pageID;
+        uint64_t fenceValue;
+        bool operator<(const DeferredRelease& other) const { return fenceValue > other.fenceValue; }
+    };
+
+    size_t getSizeClassPageSize(uint32_t sizeClass) const;
+    uint32_t getSizeClass(size_t pageSize) const;
+    bool isPoolable(size_t pageSize) const;
+    Placement acquirePage(size_t pageSize);
+    void recyclePage(uint64_t pageID);
+
+    size_t mPageSize;
+    size_t mMaxPooledSize;
+
+    uint64_t mNextPageID = 0;
+    uint64_t mActivePageID = kInvalidPageID;
+    size_t mActiveOffset = 0;
+    std::unordered_map<uint64_t, Page> mPages;
+
+    std::priority_queue<DeferredRelease> mDeferredReleases;
+
+    std::vector<std::deque<uint64_t>> mFreePages; ///< Free pages per size class, in order of release.
+    size_t mPooledSize = 0;
+    uint64_t mReleaseCount = 0;
+    std::vector<uint64_t> mEvictedPages;
+};
+} // namespace Falcor
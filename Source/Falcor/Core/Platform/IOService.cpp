@@ -0,0 +1,365 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "IOService.h"
+#include "Core/Error.h"
+
+#include <fstream>
+
+namespace Falcor
+{
+
+namespace
+{
+std::string getReadAheadKey(const std::filesystem::path& path)
+{
+    return std::filesystem::absolute(path).lexically_normal().string();
+}
+} // namespace
+
+IOService::ReadAhead::ReadAhead(ReadAhead&& other) noexcept : mpService(other.mpService), mId(other.mId)
+{
+    other.mpService = nullptr;
+}
+
+IOService::ReadAhead& IOService::ReadAhead::operator=(ReadAhead&& other) noexcept
+{
+    if (this != &other)
+    {
+        release();
+        mpService = other.mpService;
+        mId = other.mId;
+        other.mpService = nullptr;
+    }
+    return *this;
+}
+
+IOService::ReadAhead::~ReadAhead()
+{
+    release();
+}
+
+void IOService::ReadAhead::release()
+{
+    if (mpService)
+        mpService->releaseReadAhead(mId);
+    mpService = nullptr;
+}
+
+IOService& IOService::get()
+{
+    static IOService service;
+    return service;
+}
+
+IOService::IOService(uint32_t threadCount)
+{
+    FALCOR_CHECK(threadCount > 0, "Thread count must be larger than zero.");
+    for (uint32_t i = 0; i < threadCount; i++)
+        mThreads.emplace_back([this]() { worker(); });
+}
+
+IOService::~IOService()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTerminate = true;
+    }
+    mCondition.notify_all();
+    for (auto& thread : mThreads)
+        thread.join();
+}
+
+std::string IOService::read(const std::filesystem::path& path)
+{
+    std::future<ReadAheadData> future;
+    if (takeReadAhead(path, future))
+        return consumeReadAhead(path, std::move(future));
+    return readWhole(path);
+}
+
+std::string IOService::read(const std::filesystem::path& path, uint64_t offset, size_t size)
+{
+    return readRange(path, offset, size);
+}
+
+std::future<std::string> IOService::readAsync(const std::filesystem::path& path)
+{
+    std::future<ReadAheadData> future;
+    if (takeReadAhead(path, future))
+    {
+        // The read-ahead task was queued before this one, so waiting on it cannot block the queue.
+        auto pFuture = std::make_shared<std::future<ReadAheadData>>(std::move(future));
+        return enqueue<std::string>([this, path, pFuture]() { return consumeReadAhead(path, std::move(*pFuture)); });
+    }
+    return enqueue<std::string>([this, path]() { return readWhole(path); });
+}
+
+std::future<std::string> IOService::readAsync(const std::filesystem::path& path, uint64_t offset, size_t size)
+{
+    return enqueue<std::string>([this, path, offset, size]() { return readRange(path, offset, size); });
+}
+
+IOService::ReadAhead IOService::readAhead(const std::vector<std::filesystem::path>& paths)
+{
+    // Query the file sizes before taking the lock.
+    std::vector<std::pair<std::filesystem::path, uint64_t>> files;
+    files.reserve(paths.size());
+    for (const auto& path : paths)
+    {
+        std::error_code ec;
+        uint64_t size = std::filesystem::file_size(path, ec);
+        if (!ec)
+            files.emplace_back(path, size);
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    uint64_t ownerId = mNextReadAheadId++;
+    for (auto& [path, size] : files)
+    {
+        std::string key = getReadAheadKey(path);
+        if (mReadAheadByKey.count(key))
+            continue;
+        ReadAheadEntry entry;
+        entry.key = key;
+        entry.path = std::move(path);
+        entry.ownerId = ownerId;
+        entry.size = size;
+        mReadAheadByKey.emplace(std::move(key), mReadAhead.insert(mReadAhead.end(), std::move(entry)));
+    }
+    startReadAhead();
+    return ReadAhead(this, ownerId);
+}
+
+std::shared_ptr<const MemoryMappedFile> IOService::map(const std::filesystem::path& path, MemoryMappedFile::AccessHint accessHint)
+{
+    // Wait for a pending read-ahead of the file, which leaves the file in the OS cache, and drop the data.
+    std::future<ReadAheadData> future;
+    if (takeReadAhead(path, future))
+        future.wait();
+
+    auto pFile = std::make_shared<MemoryMappedFile>(path, MemoryMappedFile::kWholeFile, accessHint);
+    if (!pFile->isOpen() || pFile->getMappedSize() != pFile->getSize())
+        return nullptr;
+    return pFile;
+}
+
+IOService::Stats IOService::getStats() const
+{
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    Stats stats = mStats;
+    if (mActiveReads > 0)
+        stats.busyTime += std::chrono::duration<double>(Clock::now() - mBusyStart).count();
+    return stats;
+}
+
+void IOService::resetStats()
+{
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    mStats = {};
+    mBusyStart = Clock::now();
+}
+
+template<typename T>
+std::future<T> IOService::enqueue(std::function<T()> func)
+{
+    auto pTask = std::make_shared<std::packaged_task<T()>>(std::move(func));
+    auto future = pTask->get_future();
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQueue.push_back([pTask]() { (*pTask)(); });
+    }
+    mCondition.notify_one();
+    return future;
+}
+
+std::string IOService::readRange(const std::filesystem::path& path, uint64_t offset, size_t size)
+{
+    std::string data;
+    beginRead();
+    try
+    {
+        std::ifstream ifs(path, std::ios::binary);
+        if (!ifs)
+            FALCOR_THROW("Failed to read from file '{}'.", path);
+
+        data.resize(size);
+        ifs.seekg(offset);
+        ifs.read(data.data(), size);
+        if ((size_t)ifs.gcount() != size)
+            FALCOR_THROW("Failed to read {} bytes at offset {} from file '{}'.", size, offset, path);
+    }
+    catch (...)
+    {
+        endRead(0, false);
+        throw;
+    }
+    endRead(size, true);
+    return data;
+}
+
+std::string IOService::readWhole(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(path, ec);
+    if (ec)
+        FALCOR_THROW("Failed to read from file '{}'.", path);
+    return readRange(path, 0, size);
+}
+
+bool IOService::takeReadAhead(const std::filesystem::path& path, std::future<ReadAheadData>& future)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (mReadAhead.empty())
+        return false;
+
+    auto it = mReadAheadByKey.find(getReadAheadKey(path));
+    if (it == mReadAheadByKey.end())
+        return false;
+
+    // Hints that have not been started yet are dropped, the caller reads the file itself.
+    auto entryIt = it->second;
+    bool started = entryIt->started;
+    if (started)
+        future = std::move(entryIt->data);
+    mReadAheadByKey.erase(it);
+    mReadAhead.erase(entryIt);
+    startReadAhead();
+    return started;
+}
+
+std::string IOService::consumeReadAhead(const std::filesystem::path& path, std::future<ReadAheadData> future)
+{
+    ReadAheadData readAhead;
+    try
+    {
+        readAhead = future.get();
+    }
+    catch (...)
+    {
+        // Read the file again to report the current error, if any.
+        return readWhole(path);
+    }
+
+    // Use the data only if the file has not been modified since it was read.
+    std::error_code sizeEc, timeEc;
+    uint64_t size = std::filesystem::file_size(path, sizeEc);
+    auto writeTime = std::filesystem::last_write_time(path, timeEc);
+    if (sizeEc || timeEc || size != readAhead.data.size() || writeTime != readAhead.writeTime)
+        return readWhole(path);
+    return std::move(readAhead.data);
+}
+
+void IOService::releaseReadAhead(uint64_t ownerId)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto it = mReadAhead.begin(); it != mReadAhead.end();)
+    {
+        if (it->ownerId == ownerId)
+        {
+            // Dropping the future of a started hint releases the data once the read has finished.
+            mReadAheadByKey.erase(it->key);
+            it = mReadAhead.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    startReadAhead();
+}
+
+void IOService::startReadAhead()
+{
+    // Started hints are at the front of the list. Start the following hints in order while within the budget.
+    size_t count = 0;
+    uint64_t byteCount = 0;
+    for (auto& entry : mReadAhead)
+    {
+        if (count >= kMaxReadAheadCount)
+            break;
+        if (!entry.started)
+        {
+            if (count > 0 && byteCount + entry.size > kMaxReadAheadBytes)
+                break;
+            auto pTask = std::make_shared<std::packaged_task<ReadAheadData()>>(
+                [this, path = entry.path]()
+                {
+                    ReadAheadData readAhead;
+                    std::error_code ec;
+                    readAhead.writeTime = std::filesystem::last_write_time(path, ec);
+                    if (ec)
+                        FALCOR_THROW("Failed to read from file '{}'.", path);
+                    readAhead.data = readWhole(path);
+                    return readAhead;
+                }
+            );
+            entry.data = pTask->get_future();
+            entry.started = true;
+            mQueue.push_back([pTask]() { (*pTask)(); });
+            mCondition.notify_one();
+        }
+        count++;
+        byteCount += entry.size;
+    }
+}
+
+void IOService::beginRead()
+{
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    if (mActiveReads++ == 0)
+        mBusyStart = Clock::now();
+}
+
+void IOService::endRead(uint64_t byteCount, bool completed)
+{
+    std::lock_guard<std::mutex> lock(mStatsMutex);
+    mStats.bytesRead += byteCount;
+    if (completed)
+        mStats.readCount++;
+    if (--mActiveReads == 0)
+        mStats.busyTime += std::chrono::duration<double>(Clock::now() - mBusyStart).count();
+}
+
+void IOService::worker()
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mCondition.wait(lock, [this]() { return mTerminate || !mQueue.empty(); });
+            if (mQueue.empty())
+                return;
+            task = std::move(mQueue.front());
+            mQueue.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace Falcor
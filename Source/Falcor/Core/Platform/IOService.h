@@ -0,0 +1,240 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+
+#include "Core/Macros.h"
+#include "MemoryMappedFile.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Shared service for reading files, used by the importers and loaders.
+ *
+ * The service provides:
+ * - Blocking and asynchronous reads of whole files or file ranges. Asynchronous reads are executed
+ *   on a pool of I/O threads, so that independent reads overlap and hide the latency of networked storage.
+ * - Read-ahead hints, which start reading files that will be needed soon. The next read of the same
+ *   file picks up the data instead of reading the file again. Hints are owned by the caller and
+ *   unconsumed data is released when the caller drops them.
+ * - Memory-mapped views of files, for random access to large local files.
+ * - Aggregate statistics on the amount of data read and the throughput.
+ *
+ * All functions are thread-safe. Reads throw an exception if the file cannot be read.
+ */
+class FALCOR_API IOService
+{
+public:
+    static constexpr uint32_t kDefaultThreadCount = 8;
+
+    /// Maximum number of files that are read ahead of the reads consuming them.
+    static constexpr size_t kMaxReadAheadCount = 64;
+    /// Maximum number of bytes that are read ahead of the reads consuming them. A single larger file is still read ahead.
+    static constexpr uint64_t kMaxReadAheadBytes = 1ull << 30;
+
+    struct Stats
+    {
+        uint64_t bytesRead = 0; ///< Total number of bytes read.
+        uint64_t readCount = 0; ///< Number of completed reads.
+        double busyTime = 0.0;  ///< Wall-clock time in seconds during which at least one read was in progress.
+
+        /// Get the aggregate throughput of all reads in bytes per second.
+        double getBytesPerSecond() const { return busyTime > 0.0 ? bytesRead / busyTime : 0.0; }
+    };
+
+    /**
+     * Read-ahead hints issued by readAhead(). The hints are active for the lifetime of the object.
+     * Destroying the object (or calling release()) cancels hints that have not been started and
+     * releases data that has not been consumed.
+     */
+    class FALCOR_API ReadAhead
+    {
+    public:
+        ReadAhead() = default;
+        ReadAhead(ReadAhead&& other) noexcept;
+        ReadAhead& operator=(ReadAhead&& other) noexcept;
+        ~ReadAhead();
+
+        /// Cancel the hints and release the data that has not been consumed.
+        void release();
+
+    private:
+        ReadAhead(IOService* pService, uint64_t id) : mpService(pService), mId(id) {}
+        ReadAhead(const ReadAhead&) = delete;
+        ReadAhead& operator=(const ReadAhead&) = delete;
+
+        IOService* mpService = nullptr;
+        uint64_t mId = 0;
+
+        friend class IOService;
+    };
+
+    /**
+     * Get the shared service.
+     */
+    static IOService& get();
+
+    /**
+     * Create an I/O service.
+     * @param[in] threadCount Number of I/O threads.
+     */
+    IOService(uint32_t threadCount = kDefaultThreadCount);
+
+    /// Destructor. Waits for pending reads to finish.
+    ~IOService();
+
+    /**
+     * Read a whole file.
+     * @param[in] path File path.
+     * @return The contents of the file.
+     */
+    std::string read(const std::filesystem::path& path);
+
+    /**
+     * Read a range of a file.
+     * @param[in] path File path.
+     * @param[in] offset Offset in bytes from the start of the file.
+     * @param[in] size Number of bytes to read. The range must be within the file.
+     * @return The contents of the range.
+     */
+    std::string read(const std::filesystem::path& path, uint64_t offset, size_t size);
+
+    /**
+     * Read a whole file asynchronously.
+     * @param[in] path File path.
+     * @return Future holding the contents of the file, or the exception if the file cannot be read.
+     */
+    std::future<std::string> readAsync(const std::filesystem::path& path);
+
+    /**
+     * Read a range of a file asynchronously.
+     * @param[in] path File path.
+     * @param[in] offset Offset in bytes from the start of the file.
+     * @param[in] size Number of bytes to read. The range must be within the file.
+     * @return Future holding the contents of the range, or the exception if the range cannot be read.
+     */
+    std::future<std::string> readAsync(const std::filesystem::path& path, uint64_t offset, size_t size);
+
+    /**
+     * Hint that files will be read soon, in the given order. The files are read in the background and the data is
+     * handed to the next read or mapping of the whole file. At most kMaxReadAheadCount files and kMaxReadAheadBytes
+     * are read ahead of the consuming reads; the remaining files are started as earlier ones are consumed.
+     * Data is not used if the file has been modified since it was read. Hints for missing files and for files
+     * already hinted are ignored.
+     * @param[in] paths File paths.
+     * @return The hints. The hints are cancelled when the returned object is destroyed.
+     */
+    [[nodiscard]] ReadAhead readAhead(const std::vector<std::filesystem::path>& paths);
+
+    /**
+     * Map a whole file into memory.
+     * @param[in] path File path.
+     * @param[in] accessHint Hint on how memory is accessed.
+     * @return The memory-mapped file, or nullptr if the file cannot be mapped (this includes empty files).
+     */
+    std::shared_ptr<const MemoryMappedFile> map(
+        const std::filesystem::path& path,
+        MemoryMappedFile::AccessHint accessHint = MemoryMappedFile::AccessHint::Normal
+    );
+
+    /**
+     * Get the I/O statistics.
+     */
+    Stats getStats() const;
+
+    /**
+     * Reset the I/O statistics.
+     */
+    void resetStats();
+
+private:
+    IOService(const IOService&) = delete;
+    IOService& operator=(const IOService&) = delete;
+
+    using Clock = std::chrono::steady_clock;
+
+    struct ReadAheadData
+    {
+        std::string data;
+        std::filesystem::file_time_type writeTime; ///< Last write time of the file before it was read.
+    };
+
+    struct ReadAheadEntry
+    {
+        std::string key;                    ///< Normalized path.
+        std::filesystem::path path;
+        uint64_t ownerId = 0;               ///< ID of the owning ReadAhead object.
+        uint64_t size = 0;                  ///< File size at the time of the hint.
+        bool started = false;
+        std::future<ReadAheadData> data;
+    };
+
+    template<typename T>
+    std::future<T> enqueue(std::function<T()> func);
+    std::string readRange(const std::filesystem::path& path, uint64_t offset, size_t size);
+    std::string readWhole(const std::filesystem::path& path);
+    bool takeReadAhead(const std::filesystem::path& path, std::future<ReadAheadData>& future);
+    std::string consumeReadAhead(const std::filesystem::path& path, std::future<ReadAheadData> future);
+    void releaseReadAhead(uint64_t ownerId);
+    void startReadAhead();
+    void beginRead();
+    void endRead(uint64_t byteCount, bool completed);
+    void worker();
+
+    std::vector<std::thread> mThreads;
+    std::deque<std::function<void()>> mQueue;
+    bool mTerminate = false;
+    mutable std::mutex mMutex;
+    std::condition_variable mCondition;
+
+    std::list<ReadAheadEntry> mReadAhead; ///< Read-ahead hints in the order they are expected to be consumed. Started hints come first.
+    std::unordered_map<std::string, std::list<ReadAheadEntry>::iterator> mReadAheadByKey;
+    uint64_t mNextReadAheadId = 1;
+
+    mutable std::mutex mStatsMutex;
+    Stats mStats;
+    uint32_t mActiveReads = 0;
+    Clock::time_point mBusyStart;
+};
+
+} // namespace Falcor
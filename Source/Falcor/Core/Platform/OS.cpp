@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "OS.h"
+#include "IOService.h"
 #include "Core/Error.h"
 #include "Utils/StringUtils.h"
 #include "Utils/StringFormatters.h"
@@ -272,10 +273,7 @@ std::filesystem::path getTempFilePath()
 
 std::string readFile(const std::filesystem::path& path)
 {
-    std::ifstream ifs(path, std::ios::binary);
-    if (!ifs)
-        FALCOR_THROW("Failed to read from file '{}'.", path);
-    return std::string((std::istreambuf_iterator<char>(ifs)), (std::istreambuf_iterator<char>()));
+    return IOService::get().read(path);
 }
 
 std::string decompressFile(const std::filesystem::path& path)
@@ -472,7 +472,7 @@ FALCOR_API uint32_t bitScanForward(uint32_t a);
 FALCOR_API uint32_t popcount(uint32_t a);
 
 /**
- * Read the contents of a file into a string.
+ * Read the contents of a file into a string using the shared IOService.
  * Throws an exception if the file cannot be read.
  * @param[in] path File path.
  * @return The contents of the file.
@@ -46,6 +46,11 @@ SceneBuilder& accessActivePythonSceneBuilder()
     return *spActivePythonSceneBuilder;
 }
 
+SceneBuilder* getActivePythonSceneBuilder()
+{
+    return spActivePythonSceneBuilder;
+}
+
 AssetResolver& getActiveAssetResolver()
 {
     return spActivePythonSceneBuilder ? spActivePythonSceneBuilder->getAssetResolver() : AssetResolver::getDefaultResolver();
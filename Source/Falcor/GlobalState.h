@@ -47,6 +47,7 @@ namespace Falcor
 
 FALCOR_API void setActivePythonSceneBuilder(SceneBuilder* pSceneBuilder);
 FALCOR_API SceneBuilder& accessActivePythonSceneBuilder();
+FALCOR_API SceneBuilder* getActivePythonSceneBuilder();
 FALCOR_API AssetResolver& getActiveAssetResolver();
 
 FALCOR_API void setActivePythonRenderGraphDevice(ref<Device> pDevice);
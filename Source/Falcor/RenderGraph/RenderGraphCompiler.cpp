@@ -69,15 +69,90 @@ std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
     auto pExe = std::make_unique<RenderGraphExe>();
     pExe->mExecutionList.reserve(c.mExecutionList.size());
 
-    for (auto e : c.mExecutionList)
+    for (const auto& e : c.mExecutionList)
     {
-        pExe->insertPass(e.name, e.pPass);
+        pExe->insertPass(e.name, e.pPass, pResourcesCache->createFieldTable(e.name, e.reflector));
     }
+    pExe->mExecutionPlan = RenderGraphScheduler::build(c.buildSchedulerInput(*pExe));
     c.restoreCompilationChanges();
     pExe->mpResourceCache = std::move(pResourcesCache);
     return pExe;
 }
 
+RenderGraphScheduler::Input RenderGraphCompiler::buildSchedulerInput(const RenderGraphExe& exe) const
+{
+    FALCOR_ASSERT(exe.mExecutionList.size() == mExecutionList.size());
+
+    RenderGraphScheduler::Input input;
+    input.passes.resize(mExecutionList.size());
+
+    std::unordered_map<uint32_t, uint32_t> nodeToPass;
+    for (size_t i = 0; i < mExecutionList.size(); i++)
+        nodeToPass[mExecutionList[i].index] = (uint32_t)i;
+
+    // External resources get identifiers in a separate range from the resources owned by the cache.
+    const uint32_t kExternalResourceBit = 1u << 31;
+
+    for (size_t i = 0; i < mExecutionList.size(); i++)
+    {
+        const auto& passData = mExecutionList[i];
+        const auto& fields = exe.mExecutionList[i].fields;
+        auto& pass = input.passes[i];
+        pass.name = passData.name;
+
+        // Dependencies from incoming edges, including execution edges.
+        const DirectedGraph::Node* pNode = mGraph.mpGraph->getNode(passData.index);
+        for (uint32_t e = 0; e < pNode->getIncomingEdgeCount(); e++)
+        {
+            auto it = nodeToPass.find(mGraph.mpGraph->getEdge(pNode->getIncomingEdge(e))->getSourceNode());
+            if (it != nodeToPass.end())
+                input.dependencies.emplace_back(it->second, (uint32_t)i);
+        }
+
+        // Resource accesses. Internal fields are private to the pass and don't affect scheduling.
+        // A pass is an async compute candidate if it writes all of its outputs through UAVs.
+        bool computeOnly = true;
+        bool hasOutputs = false;
+        for (uint32_t f = 0; f < fields.getFieldCount(); f++)
+        {
+            const auto& field = *passData.reflector.getField(f);
+            const auto& handle = fields.getHandle(f);
+            auto visibility = field.getVisibility();
+            if (!is_set(visibility, RenderPassReflection::Field::Visibility::Input | RenderPassReflection::Field::Visibility::Output))
+                continue;
+            if (handle.resourceIndex == ResourceCache::kInvalidIndex && !exe.mpResourceCache->getResource(handle))
+                continue;
+
+            RenderGraphScheduler::ResourceAccess access;
+            access.resource =
+                handle.resourceIndex != ResourceCache::kInvalidIndex ? handle.resourceIndex : (handle.externalIndex | kExternalResourceBit);
+            access.write = is_set(visibility, RenderPassReflection::Field::Visibility::Output);
+            if (!access.write)
+            {
+                access.state = Resource::State::ShaderResource;
+            }
+            else
+            {
+                auto bindFlags = field.getBindFlags();
+                if (is_set(bindFlags, ResourceBindFlags::DepthStencil))
+                    access.state = Resource::State::DepthStencil;
+                else if (is_set(bindFlags, ResourceBindFlags::RenderTarget))
+                    access.state = Resource::State::RenderTarget;
+                else if (is_set(bindFlags, ResourceBindFlags::UnorderedAccess))
+                    access.state = Resource::State::UnorderedAccess;
+                else
+                    access.state = Resource::State::Common;
+                computeOnly = computeOnly && access.state == Resource::State::UnorderedAccess;
+                hasOutputs = true;
+            }
+            pass.accesses.push_back(access);
+        }
+        pass.asyncComputeCapable = computeOnly && hasOutputs;
+    }
+
+    return input;
+}
+
 void RenderGraphCompiler::validateGraph() const
 {
     std::string err;
@@ -30,6 +30,7 @@
 #include "RenderPassReflection.h"
 #include "ResourceCache.h"
 #include "RenderGraphExe.h"
+#include "RenderGraphScheduler.h"
 #include "Core/Macros.h"
 #include <string>
 #include <utility>
@@ -79,5 +80,6 @@ private:
     void validateGraph() const;
     void restoreCompilationChanges();
     RenderPass::CompileData prepPassCompilationData(const PassData& passData);
+    RenderGraphScheduler::Input buildSchedulerInput(const RenderGraphExe& exe) const;
 };
 } // namespace Falcor
@@ -38,7 +38,7 @@ void RenderGraphExe::execute(const Context& ctx)
     {
         FALCOR_PROFILE(ctx.pRenderContext, pass.name);
 
-        RenderData renderData(pass.name, *mpResourceCache, ctx.passesDictionary, ctx.defaultTexDims, ctx.defaultTexFormat);
+        RenderData renderData(pass.name, *mpResourceCache, pass.fields, ctx.passesDictionary, ctx.defaultTexDims, ctx.defaultTexFormat);
         pass.pPass->execute(ctx.pRenderContext, renderData);
     }
 }
@@ -93,9 +93,9 @@ void RenderGraphExe::onHotReload(HotReloadFlags reloaded)
     }
 }
 
-void RenderGraphExe::insertPass(const std::string& name, const ref<RenderPass>& pPass)
+void RenderGraphExe::insertPass(const std::string& name, const ref<RenderPass>& pPass, ResourceCache::FieldTable fields)
 {
-    mExecutionList.push_back(Pass(name, pPass));
+    mExecutionList.push_back(Pass(name, pPass, std::move(fields)));
 }
 
 ref<Resource> RenderGraphExe::getResource(const std::string& name) const
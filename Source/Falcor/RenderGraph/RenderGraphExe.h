@@ -28,6 +28,7 @@
 #pragma once
 #include "RenderPass.h"
 #include "ResourceCache.h"
+#include "RenderGraphScheduler.h"
 #include "Core/Macros.h"
 #include "Core/HotReloadFlags.h"
 #include "Core/API/Formats.h"
@@ -36,6 +37,7 @@
 #include "Utils/Dictionary.h"
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace Falcor
@@ -94,22 +96,32 @@ public:
      */
     void setInput(const std::string& name, const ref<Resource>& pResource);
 
+    /**
+     * Get the execution plan computed when the graph was compiled.
+     * Pass indices in the plan refer to the serial execution order of the graph.
+     */
+    const RenderGraphScheduler::ExecutionPlan& getExecutionPlan() const { return mExecutionPlan; }
+
 private:
     friend class RenderGraphCompiler;
 
-    void insertPass(const std::string& name, const ref<RenderPass>& pPass);
+    void insertPass(const std::string& name, const ref<RenderPass>& pPass, ResourceCache::FieldTable fields);
 
     struct Pass
     {
         std::string name;
         ref<RenderPass> pPass;
+        ResourceCache::FieldTable fields; ///< Resource handles for the pass' fields, resolved at compile time.
 
     private:
         friend class RenderGraphExe; // Force RenderGraphCompiler to use insertPass() by hiding this Ctor from it
-        Pass(const std::string& name_, const ref<RenderPass>& pPass_) : name(name_), pPass(pPass_) {}
+        Pass(const std::string& name_, const ref<RenderPass>& pPass_, ResourceCache::FieldTable fields_)
+            : name(name_), pPass(pPass_), fields(std::move(fields_))
+        {}
     };
 
     std::vector<Pass> mExecutionList;
     std::unique_ptr<ResourceCache> mpResourceCache;
+    RenderGraphScheduler::ExecutionPlan mExecutionPlan;
 };
 } // namespace Falcor
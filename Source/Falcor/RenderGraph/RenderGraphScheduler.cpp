@@ -0,0 +1,248 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "RenderGraphScheduler.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace Falcor
+{
+namespace
+{
+void addUnique(std::vector<uint32_t>& v, uint32_t value)
+{
+    if (std::find(v.begin(), v.end(), value) == v.end())
+        v.push_back(value);
+}
+
+/**
+ * Collect the predecessors of every pass from the explicit dependencies and the resource hazards.
+ * Resource hazards are derived in input order: reads depend on the last writer, writes depend on the last writer and all readers since.
+ */
+std::vector<std::vector<uint32_t>> collectPredecessors(const RenderGraphScheduler::Input& input)
+{
+    const uint32_t passCount = (uint32_t)input.passes.size();
+    std::vector<std::vector<uint32_t>> preds(passCount);
+
+    for (const auto& [src, dst] : input.dependencies)
+    {
+        FALCOR_CHECK(src < passCount && dst < passCount, "Dependency ({}, {}) is out of range.", src, dst);
+        FALCOR_CHECK(src < dst, "Dependency ({}, {}) does not follow the pass order.", src, dst);
+        addUnique(preds[dst], src);
+    }
+
+    struct HazardState
+    {
+        uint32_t lastWriter = RenderGraphScheduler::kInvalidIndex;
+        std::vector<uint32_t> readers;
+    };
+    std::unordered_map<uint32_t, HazardState> hazards;
+
+    for (uint32_t i = 0; i < passCount; i++)
+    {
+        for (const auto& access : input.passes[i].accesses)
+        {
+            FALCOR_CHECK(
+                access.resource != RenderGraphScheduler::kInvalidIndex, "Pass '{}' has an invalid resource access.", input.passes[i].name
+            );
+            auto& hazard = hazards[access.resource];
+            if (hazard.lastWriter != RenderGraphScheduler::kInvalidIndex && hazard.lastWriter != i)
+                addUnique(preds[i], hazard.lastWriter);
+
+            if (access.write)
+            {
+                for (uint32_t reader : hazard.readers)
+                    if (reader != i)
+                        addUnique(preds[i], reader);
+                hazard.lastWriter = i;
+                hazard.readers.clear();
+            }
+            else
+            {
+                addUnique(hazard.readers, i);
+            }
+        }
+    }
+
+    return preds;
+}
+} // namespace
+
+const RenderGraphScheduler::ScheduledPass* RenderGraphScheduler::ExecutionPlan::findPass(uint32_t pass) const
+{
+    for (const auto& p : passes)
+        if (p.pass == pass)
+            return &p;
+    return nullptr;
+}
+
+RenderGraphScheduler::ExecutionPlan RenderGraphScheduler::build(const Input& input)
+{
+    const uint32_t passCount = (uint32_t)input.passes.size();
+    ExecutionPlan plan;
+    if (passCount == 0)
+        return plan;
+
+    std::vector<std::vector<uint32_t>> preds = collectPredecessors(input);
+    std::vector<std::vector<uint32_t>> succs(passCount);
+    for (uint32_t i = 0; i < passCount; i++)
+        for (uint32_t p : preds[i])
+            succs[p].push_back(i);
+
+    // Dependency levels and earliest finish times. Predecessors always precede a pass in the input, so a single forward sweep suffices.
+    std::vector<uint32_t> level(passCount, 0);
+    std::vector<float> earliestFinish(passCount, 0.f);
+    std::vector<uint32_t> criticalPred(passCount, kInvalidIndex);
+    for (uint32_t i = 0; i < passCount; i++)
+    {
+        float start = 0.f;
+        for (uint32_t p : preds[i])
+        {
+            level[i] = std::max(level[i], level[p] + 1);
+            if (criticalPred[i] == kInvalidIndex || earliestFinish[p] > start)
+            {
+                start = earliestFinish[p];
+                criticalPred[i] = p;
+            }
+        }
+        earliestFinish[i] = start + input.passes[i].cost;
+    }
+
+    // Critical path.
+    uint32_t last = (uint32_t)std::distance(earliestFinish.begin(), std::max_element(earliestFinish.begin(), earliestFinish.end()));
+    plan.criticalPathCost = earliestFinish[last];
+    for (uint32_t i = last; i != kInvalidIndex; i = criticalPred[i])
+        plan.criticalPath.push_back(i);
+    std::reverse(plan.criticalPath.begin(), plan.criticalPath.end());
+
+    std::vector<bool> onCriticalPath(passCount, false);
+    for (uint32_t i : plan.criticalPath)
+        onCriticalPath[i] = true;
+
+    // Latest finish times, computed in a backward sweep.
+    std::vector<float> latestFinish(passCount, plan.criticalPathCost);
+    for (uint32_t i = passCount; i-- > 0;)
+    {
+        for (uint32_t s : succs[i])
+            latestFinish[i] = std::min(latestFinish[i], latestFinish[s] - input.passes[s].cost);
+    }
+
+    // Group passes into levels and order the schedule by level, keeping the input order within a level.
+    uint32_t levelCount = *std::max_element(level.begin(), level.end()) + 1;
+    plan.levels.resize(levelCount);
+    for (uint32_t i = 0; i < passCount; i++)
+        plan.levels[level[i]].push_back(i);
+
+    std::vector<uint32_t> order;
+    order.reserve(passCount);
+    for (const auto& passes : plan.levels)
+        order.insert(order.end(), passes.begin(), passes.end());
+
+    // Assign queues. Compute-only passes that have slack can overlap with the critical path on the compute queue.
+    std::vector<Queue> queue(passCount, Queue::Graphics);
+    for (uint32_t i = 0; i < passCount; i++)
+    {
+        float slack = latestFinish[i] - earliestFinish[i];
+        if (input.passes[i].asyncComputeCapable && !onCriticalPath[i] && slack > 0.f)
+            queue[i] = Queue::Compute;
+    }
+
+    // Place barriers by simulating the resource states in schedule order. Each queue executes its passes in schedule order.
+    struct ResourceTracker
+    {
+        Resource::State state = Resource::State::Undefined;
+        uint32_t lastPass = kInvalidIndex;
+        bool lastWrite = false;
+        uint32_t transitionPass = kInvalidIndex; ///< Pass that the last transition is ordered with.
+        std::vector<uint32_t> users;             ///< Passes that accessed the resource since the last transition.
+    };
+    std::unordered_map<uint32_t, ResourceTracker> resources;
+    std::vector<uint32_t> scheduleIndex(passCount, kInvalidIndex);
+
+    plan.passes.reserve(passCount);
+    for (uint32_t i : order)
+    {
+        scheduleIndex[i] = (uint32_t)plan.passes.size();
+        ScheduledPass scheduled;
+        scheduled.pass = i;
+        scheduled.level = level[i];
+        scheduled.queue = queue[i];
+        scheduled.onCriticalPath = onCriticalPath[i];
+        scheduled.slack = latestFinish[i] - earliestFinish[i];
+
+        for (uint32_t p : preds[i])
+            if (queue[p] != queue[i])
+                addUnique(scheduled.queueWaits, p);
+
+        for (const auto& access : input.passes[i].accesses)
+        {
+            auto& tracker = resources[access.resource];
+            bool previousPass = tracker.lastPass != kInvalidIndex && tracker.lastPass != i;
+            bool transition = tracker.state != access.state;
+            bool uavBarrier =
+                !transition && access.state == Resource::State::UnorderedAccess && previousPass && (access.write || tracker.lastWrite);
+
+            if (transition || uavBarrier)
+            {
+                Barrier barrier = {access.resource, tracker.state, access.state, tracker.lastPass};
+                if (transition && previousPass && tracker.lastWrite && queue[tracker.lastPass] != queue[i])
+                {
+                    // Release the resource on the producer's queue, so consumers on both queues can use it without waiting on each other.
+                    plan.passes[scheduleIndex[tracker.lastPass]].releaseBarriers.push_back(barrier);
+                    addUnique(scheduled.queueWaits, tracker.lastPass);
+                    tracker.transitionPass = tracker.lastPass;
+                }
+                else
+                {
+                    scheduled.barriers.push_back(barrier);
+                    for (uint32_t user : tracker.users)
+                        if (user != i && queue[user] != queue[i])
+                            addUnique(scheduled.queueWaits, user);
+                    tracker.transitionPass = i;
+                }
+                tracker.users.clear();
+            }
+            else if (tracker.transitionPass != kInvalidIndex && tracker.transitionPass != i && queue[tracker.transitionPass] != queue[i])
+            {
+                // The resource is already in the right state, but the transition happened on the other queue.
+                addUnique(scheduled.queueWaits, tracker.transitionPass);
+            }
+
+            addUnique(tracker.users, i);
+            tracker.state = access.state;
+            tracker.lastPass = i;
+            tracker.lastWrite = access.write;
+        }
+
+        plan.passes.push_back(std::move(scheduled));
+    }
+
+    return plan;
+}
+} // namespace Falcor
@@ -0,0 +1,135 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Resource.h"
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Builds an execution plan for a set of render passes.
+ *
+ * The scheduler groups passes into dependency levels (passes within a level do not depend on each other),
+ * computes the critical path through the graph, identifies passes that are candidates for the async compute queue,
+ * and places resource transitions and cross-queue synchronization points.
+ *
+ * The scheduler only operates on plain data and does not require a device, which makes it testable on the CPU.
+ */
+class FALCOR_API RenderGraphScheduler
+{
+public:
+    static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    enum class Queue : uint32_t
+    {
+        Graphics,
+        Compute,
+    };
+
+    /**
+     * Describes how a pass accesses a resource.
+     */
+    struct ResourceAccess
+    {
+        uint32_t resource = kInvalidIndex;                   ///< Resource identifier. Aliased fields must use the same identifier.
+        Resource::State state = Resource::State::Undefined; ///< State the resource needs to be in while the pass executes.
+        bool write = false;                                  ///< True if the pass writes to the resource.
+    };
+
+    struct PassDesc
+    {
+        std::string name;
+        float cost = 1.f;                     ///< Estimated execution cost. Used to compute the critical path.
+        bool asyncComputeCapable = false;     ///< True if the pass only uses compute work and could run on the compute queue.
+        std::vector<ResourceAccess> accesses; ///< Resources accessed by the pass.
+    };
+
+    /**
+     * Input to the scheduler. Passes are listed in a valid serial execution order (e.g. a topological sort of the graph).
+     * Dependencies are pairs of (producer, consumer) pass indices. Additional dependencies are derived from the resource accesses.
+     */
+    struct Input
+    {
+        std::vector<PassDesc> passes;
+        std::vector<std::pair<uint32_t, uint32_t>> dependencies;
+    };
+
+    /**
+     * A resource transition placed before a pass.
+     * A transition where `before` and `after` are both UnorderedAccess is a UAV barrier between two writes.
+     */
+    struct Barrier
+    {
+        uint32_t resource = kInvalidIndex;
+        Resource::State before = Resource::State::Undefined;
+        Resource::State after = Resource::State::Undefined;
+        uint32_t producerPass = kInvalidIndex; ///< Pass that last accessed the resource, or kInvalidIndex if this is the first access.
+    };
+
+    struct ScheduledPass
+    {
+        uint32_t pass = kInvalidIndex;        ///< Index of the pass in the input.
+        uint32_t level = 0;                   ///< Dependency level. Passes on the same level can execute concurrently.
+        Queue queue = Queue::Graphics;        ///< Queue the pass is assigned to.
+        bool onCriticalPath = false;          ///< True if the pass is on the critical path.
+        float slack = 0.f;                    ///< How much the pass can be delayed without delaying the frame.
+        std::vector<Barrier> barriers;        ///< Transitions to execute before the pass, on the pass' queue.
+        std::vector<Barrier> releaseBarriers; ///< Transitions to execute after the pass, for resources it produced for the other queue.
+        std::vector<uint32_t> queueWaits;     ///< Passes on the other queue that must complete before this pass starts.
+    };
+
+    struct ExecutionPlan
+    {
+        std::vector<ScheduledPass> passes;        ///< Scheduled passes, ordered by level and then by the input order.
+        std::vector<std::vector<uint32_t>> levels; ///< Input pass indices for each dependency level.
+        std::vector<uint32_t> criticalPath;        ///< Input pass indices along the critical path, in execution order.
+        float criticalPathCost = 0.f;              ///< Total cost of the critical path.
+
+        uint32_t getLevelCount() const { return (uint32_t)levels.size(); }
+
+        /**
+         * Find the scheduled pass for an input pass index.
+         * @return Pointer to the scheduled pass, or nullptr if the index is out of range.
+         */
+        const ScheduledPass* findPass(uint32_t pass) const;
+    };
+
+    /**
+     * Build an execution plan.
+     * Throws if a dependency is out of range or does not follow the order of the passes in the input.
+     * @param[in] input Passes and dependencies to schedule.
+     * @return The execution plan.
+     */
+    static ExecutionPlan build(const Input& input);
+};
+} // namespace Falcor
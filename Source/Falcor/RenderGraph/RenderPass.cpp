@@ -32,18 +32,41 @@ namespace Falcor
 RenderData::RenderData(
     const std::string& passName,
     ResourceCache& resources,
+    const ResourceCache::FieldTable& fields,
     Dictionary& dictionary,
     const uint2& defaultTexDims,
     ResourceFormat defaultTexFormat
 )
-    : mName(passName), mResources(resources), mDictionary(dictionary), mDefaultTexDims(defaultTexDims), mDefaultTexFormat(defaultTexFormat)
+    : mName(passName)
+    , mResources(resources)
+    , mFields(fields)
+    , mDictionary(dictionary)
+    , mDefaultTexDims(defaultTexDims)
+    , mDefaultTexFormat(defaultTexFormat)
 {}
 
 const ref<Resource>& RenderData::getResource(const std::string_view name) const
 {
+    uint32_t fieldIndex = mFields.findField(name);
+    if (fieldIndex != kInvalidField)
+        return mResources.getResource(mFields.getHandle(fieldIndex));
+
+    // Fall back to the full name for resources that are not part of the pass' reflection
     return mResources.getResource(fmt::format("{}.{}", mName, name));
 }
 
+const ref<Resource>& RenderData::getResource(uint32_t fieldIndex) const
+{
+    FALCOR_CHECK(fieldIndex < mFields.getFieldCount(), "Field index {} is out of range for pass '{}'.", fieldIndex, mName);
+    return mResources.getResource(mFields.getHandle(fieldIndex));
+}
+
+ref<Texture> RenderData::getTexture(uint32_t fieldIndex) const
+{
+    auto pResource = getResource(fieldIndex);
+    return pResource ? pResource->asTexture() : nullptr;
+}
+
 ref<Texture> RenderData::getTexture(const std::string_view name) const
 {
     auto pResource = getResource(name);
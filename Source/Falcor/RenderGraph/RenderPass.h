@@ -51,6 +51,8 @@ namespace Falcor
 class FALCOR_API RenderData
 {
 public:
+    static constexpr uint32_t kInvalidField = ResourceCache::kInvalidIndex;
+
     /**
      * Get a resource
      * @param[in] name The name of the pass' resource (i.e. "outputColor"). No need to specify the pass' name
@@ -72,6 +74,29 @@ public:
      */
     ref<Texture> getTexture(const std::string_view name) const;
 
+    /**
+     * Get the index of one of the pass' fields.
+     * The index equals the position of the field in the pass' reflection and stays valid until the graph is recompiled.
+     * Resolving the index once and using it for lookups avoids the string processing of the name-based accessors.
+     * @param[in] name The name of the pass' resource (i.e. "outputColor").
+     * @return The index of the field, or kInvalidField if the pass has no such field.
+     */
+    uint32_t getFieldIndex(const std::string_view name) const { return mFields.findField(name); }
+
+    /**
+     * Get a resource by field index.
+     * @param[in] fieldIndex Index of the field as returned by getFieldIndex().
+     * @return If the field exists, a pointer to the resource. Otherwise, nullptr
+     */
+    const ref<Resource>& getResource(uint32_t fieldIndex) const;
+
+    /**
+     * Get a texture by field index.
+     * @param[in] fieldIndex Index of the field as returned by getFieldIndex().
+     * @return If the texture exists, a pointer to the texture. Otherwise, nullptr
+     */
+    ref<Texture> getTexture(uint32_t fieldIndex) const;
+
     /**
      * Get the global dictionary. You can use it to pass data between different passes
      */
@@ -91,6 +116,7 @@ protected:
     RenderData(
         const std::string& passName,
         ResourceCache& resources,
+        const ResourceCache::FieldTable& fields,
         Dictionary& dictionary,
         const uint2& defaultTexDims,
         ResourceFormat defaultTexFormat
@@ -98,6 +124,7 @@ protected:
 
     const std::string& mName;
     ResourceCache& mResources;
+    const ResourceCache::FieldTable& mFields;
     Dictionary& mDictionary;
     uint2 mDefaultTexDims;
     ResourceFormat mDefaultTexFormat;
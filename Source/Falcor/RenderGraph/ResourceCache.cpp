@@ -30,6 +30,7 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Buffer.h"
 #include "Utils/Logger.h"
+#include <algorithm>
 
 namespace Falcor
 {
@@ -39,21 +40,77 @@ void ResourceCache::reset()
     mResourceData.clear();
 }
 
+namespace
+{
+const ref<Resource> kNullResource;
+}
+
+void ResourceCache::FieldTable::addField(const std::string& name, const ResourceHandle& handle)
+{
+    uint32_t index = (uint32_t)mHandles.size();
+    mHandles.push_back(handle);
+    auto it = std::lower_bound(
+        mSortedNames.begin(), mSortedNames.end(), name, [](const auto& entry, const std::string& n) { return entry.first < n; }
+    );
+    FALCOR_ASSERT(it == mSortedNames.end() || it->first != name);
+    mSortedNames.insert(it, {name, index});
+}
+
+uint32_t ResourceCache::FieldTable::findField(std::string_view name) const
+{
+    auto it = std::lower_bound(
+        mSortedNames.begin(), mSortedNames.end(), name, [](const auto& entry, std::string_view n) { return entry.first < n; }
+    );
+    if (it == mSortedNames.end() || it->first != name)
+        return kInvalidIndex;
+    return it->second;
+}
+
 const ref<Resource>& ResourceCache::getResource(const std::string& name) const
 {
-    static const ref<Resource> pNull;
-    auto extIt = mExternalResources.find(name);
+    // External resources take precedence over render graph resources
+    auto extIt = mExternalNameToIndex.find(name);
+    if (extIt != mExternalNameToIndex.end() && mExternalResources[extIt->second])
+        return mExternalResources[extIt->second];
 
-    // Search external resources if not found in render graph resources
-    if (extIt == mExternalResources.end())
+    const auto& it = mNameToIndex.find(name);
+    if (it == mNameToIndex.end())
+        return kNullResource;
+    return mResourceData[it->second].pResource;
+}
+
+const ref<Resource>& ResourceCache::getResource(const ResourceHandle& handle) const
+{
+    if (handle.externalIndex != kInvalidIndex && mExternalResources[handle.externalIndex])
+        return mExternalResources[handle.externalIndex];
+    if (handle.resourceIndex != kInvalidIndex)
+        return mResourceData[handle.resourceIndex].pResource;
+    return kNullResource;
+}
+
+ResourceCache::ResourceHandle ResourceCache::createResourceHandle(const std::string& name)
+{
+    ResourceHandle handle;
+    auto [extIt, inserted] = mExternalNameToIndex.try_emplace(name, (uint32_t)mExternalResources.size());
+    if (inserted)
+        mExternalResources.push_back(nullptr);
+    handle.externalIndex = extIt->second;
+
+    auto it = mNameToIndex.find(name);
+    if (it != mNameToIndex.end())
+        handle.resourceIndex = it->second;
+    return handle;
+}
+
+ResourceCache::FieldTable ResourceCache::createFieldTable(const std::string& passName, const RenderPassReflection& reflection)
+{
+    FieldTable table;
+    for (size_t i = 0; i < reflection.getFieldCount(); i++)
     {
-        const auto& it = mNameToIndex.find(name);
-        if (it == mNameToIndex.end())
-            return pNull;
-        return mResourceData[it->second].pResource;
+        const std::string& fieldName = reflection.getField(i)->getName();
+        table.addField(fieldName, createResourceHandle(passName + '.' + fieldName));
     }
-
-    return extIt->second;
+    return table;
 }
 
 const RenderPassReflection::Field& ResourceCache::getResourceReflection(const std::string& name) const
@@ -65,17 +122,24 @@ const RenderPassReflection::Field& ResourceCache::getResourceReflection(const st
 void ResourceCache::registerExternalResource(const std::string& name, const ref<Resource>& pResource)
 {
     if (pResource)
-        mExternalResources[name] = pResource;
+    {
+        auto [it, inserted] = mExternalNameToIndex.try_emplace(name, (uint32_t)mExternalResources.size());
+        if (inserted)
+            mExternalResources.push_back(pResource);
+        else
+            mExternalResources[it->second] = pResource;
+    }
     else
     {
-        auto it = mExternalResources.find(name);
-        if (it == mExternalResources.end())
+        auto it = mExternalNameToIndex.find(name);
+        if (it == mExternalNameToIndex.end() || !mExternalResources[it->second])
         {
             logWarning("ResourceCache::registerExternalResource: '{}' does not exist.", name);
             return;
         }
 
-        mExternalResources.erase(it);
+        // Keep the slot so that handles referencing it remain valid
+        mExternalResources[it->second] = nullptr;
     }
 }
 
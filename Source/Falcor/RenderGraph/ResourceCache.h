@@ -30,7 +30,9 @@
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
+#include <limits>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -51,6 +53,45 @@ public:
         ResourceFormat format = ResourceFormat::Unknown; ///< Format to use for texture creation
     };
 
+    static constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * Handle to a resource resolved once at graph compilation time.
+     * Looking up a resource through a handle does not involve any string operations.
+     * A handle stays valid for the lifetime of the cache. External resources bound after the handle was created are picked up.
+     */
+    struct ResourceHandle
+    {
+        uint32_t externalIndex = kInvalidIndex; ///< Index into the external resource slots.
+        uint32_t resourceIndex = kInvalidIndex; ///< Index into the resources owned by the cache.
+    };
+
+    /**
+     * Table of resource handles for the fields of a single render pass.
+     * Entries are stored in the same order as the fields in the pass' reflection.
+     */
+    class FieldTable
+    {
+    public:
+        /**
+         * Add a field to the table. Fields must be added before lookups are performed.
+         */
+        void addField(const std::string& name, const ResourceHandle& handle);
+
+        /**
+         * Find the index of a field by name.
+         * @return The index of the field, or kInvalidIndex if the pass has no such field.
+         */
+        uint32_t findField(std::string_view name) const;
+
+        uint32_t getFieldCount() const { return (uint32_t)mHandles.size(); }
+        const ResourceHandle& getHandle(uint32_t index) const { return mHandles[index]; }
+
+    private:
+        std::vector<ResourceHandle> mHandles;
+        std::vector<std::pair<std::string, uint32_t>> mSortedNames; ///< Field names sorted for binary search, paired with the field index.
+    };
+
     /**
      * Add/Remove reference to a graph input resource not owned by the cache
      * @param[in] name The resource's name
@@ -78,6 +119,24 @@ public:
      */
     const ref<Resource>& getResource(const std::string& name) const;
 
+    /**
+     * Get a resource by handle. Includes external resources known by the cache.
+     */
+    const ref<Resource>& getResource(const ResourceHandle& handle) const;
+
+    /**
+     * Create a handle for a resource name in the format of PassName.FieldName.
+     * This reserves an external resource slot for the name, so that external resources bound later are visible through the handle.
+     */
+    ResourceHandle createResourceHandle(const std::string& name);
+
+    /**
+     * Build the field table for a render pass.
+     * @param[in] passName The name of the pass.
+     * @param[in] reflection The reflection data of the pass.
+     */
+    FieldTable createFieldTable(const std::string& passName, const RenderPassReflection& reflection);
+
     /**
      * Get the field-reflection of a resource
      */
@@ -108,8 +167,10 @@ private:
     std::unordered_map<std::string, uint32_t> mNameToIndex;
     std::vector<ResourceData> mResourceData;
 
-    // References to output resources not to be allocated by the render graph
-    ResourcesMap mExternalResources;
+    // References to output resources not to be allocated by the render graph.
+    // Slots are never removed, unregistering a resource clears its slot so that existing handles remain valid.
+    std::unordered_map<std::string, uint32_t> mExternalNameToIndex;
+    std::vector<ref<Resource>> mExternalResources;
 };
 
 } // namespace Falcor
@@ -29,7 +29,13 @@
 #include "Animation.h"
 #include "Core/API/RenderContext.h"
 #include "Scene/Scene.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
+#include "Utils/StringUtils.h"
 #include "Utils/Timing/Profiler.h"
+#include <cstddef>
+#include <execution>
 
 namespace Falcor
 {
@@ -96,15 +102,18 @@ namespace Falcor
         }
     }
 
-    AnimatedVertexCache::AnimatedVertexCache(ref<Device> pDevice, Scene* pScene, const ref<Buffer>& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes)
+    AnimatedVertexCache::AnimatedVertexCache(ref<Device> pDevice, Scene* pScene, const ref<Buffer>& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, const StreamingOptions& streamingOptions)
         : mpDevice(pDevice)
         , mpScene(pScene)
         , mpPrevVertexData(pPrevVertexData)
+        , mStreamingOptions(streamingOptions)
         , mCachedCurves(cachedCurves)
         , mCachedMeshes(cachedMeshes)
     {
         if (mCachedCurves.empty() && mCachedMeshes.empty()) return;
 
+        mStreamingOptions.windowSize = std::max(mStreamingOptions.windowSize, 2u);
+
         if (!mCachedCurves.empty())
         {
             for (auto& cache : mCachedCurves)
@@ -138,6 +147,32 @@ namespace Falcor
 
             createMeshVertexUpdatePass();
         }
+
+        if (isStreaming())
+        {
+            // The keyframes are on disk now, release the host copies.
+            for (auto& cache : mCachedCurves) cache.vertexData = {};
+            for (auto& cache : mCachedMeshes) cache.vertexData = {};
+
+            uint64_t fileSize = 0;
+            for (const auto& pStream : { mpCurveVertexStream.get(), mpCurvePolyTubeVertexStream.get() }) fileSize += pStream ? pStream->pFile->getFileSize() : 0;
+            for (const auto& pStream : mMeshVertexStreams) fileSize += pStream->pFile->getFileSize();
+            logInfo("Streaming vertex cache keyframes from disk ({}), keeping {} keyframes per cache resident.", formatByteSize(fileSize), mStreamingOptions.windowSize);
+        }
+    }
+
+    AnimatedVertexCache::~AnimatedVertexCache()
+    {
+        // Loads in flight reference the streams.
+        for (auto& batch : mLoadBatches) batch.done.wait();
+    }
+
+    AnimatedVertexCache::FrameStream::~FrameStream()
+    {
+        // The file needs to be unmapped before it can be removed.
+        pFile.reset();
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
     }
 
     bool AnimatedVertexCache::animate(RenderContext* pRenderContext, double time)
@@ -149,15 +184,19 @@ namespace Falcor
             double curveTime = mLoopAnimations ? std::fmod(time, mGlobalCurveAnimationLength) : time;
             InterpolationInfo interpolationInfo = calculateInterpolation(curveTime, mCurveKeyframeTimes, mPreInfinityBehavior, Animation::Behavior::Constant);
 
+            InterpolationInfo lssInfo = mpCurveVertexStream ? streamFrames(*mpCurveVertexStream, interpolationInfo) : interpolationInfo;
+            InterpolationInfo polyTubeInfo = mpCurvePolyTubeVertexStream ? streamFrames(*mpCurvePolyTubeVertexStream, interpolationInfo) : interpolationInfo;
+            flushFrameLoads(pRenderContext);
+
             if (mCurveLSSCount > 0)
             {
-                executeCurveLSSVertexUpdatePass(pRenderContext, interpolationInfo);
+                executeCurveLSSVertexUpdatePass(pRenderContext, lssInfo);
                 executeCurveLSSAABBUpdatePass(pRenderContext);
             }
 
             if (mCurvePolyTubeCount > 0)
             {
-                executeCurvePolyTubeVertexUpdatePass(pRenderContext, interpolationInfo);
+                executeCurvePolyTubeVertexUpdatePass(pRenderContext, polyTubeInfo);
             }
 
 
@@ -196,6 +235,94 @@ namespace Falcor
         return m;
     }
 
+    std::unique_ptr<AnimatedVertexCache::FrameStream> AnimatedVertexCache::createFrameStream(const std::string& name, const VertexCacheFile::Desc& desc, uint32_t frameCount, const VertexCacheFile::FrameFunc& getFrame)
+    {
+        auto pStream = std::make_unique<FrameStream>();
+        pStream->path = getTempFilePath();
+        VertexCacheFile::write(pStream->path, desc, frameCount, getFrame);
+        pStream->pFile = std::make_unique<VertexCacheFile>(pStream->path);
+        pStream->pWindow = std::make_unique<VertexCacheWindow>(std::min(mStreamingOptions.windowSize, frameCount));
+
+        ResourceBindFlags bindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
+        pStream->buffers.resize(pStream->pWindow->getSlotCount());
+        for (uint32_t i = 0; i < pStream->buffers.size(); i++)
+        {
+            pStream->buffers[i] = mpDevice->createStructuredBuffer(desc.vertexStride, desc.vertexCount, bindFlags, MemoryType::DeviceLocal, nullptr, false);
+            pStream->buffers[i]->setName(name + "[" + std::to_string(i) + "]");
+        }
+        return pStream;
+    }
+
+    InterpolationInfo AnimatedVertexCache::streamFrames(FrameStream& stream, const InterpolationInfo& info)
+    {
+        // Keep the two interpolated keyframes resident, followed by as many of the next keyframes as fit into the window.
+        const uint32_t frameCount = stream.pFile->getFrameCount();
+        std::vector<uint32_t> frames = { info.keyframeIndices.x, info.keyframeIndices.y };
+        for (uint32_t i = 1; frames.size() < stream.pWindow->getSlotCount() && i < frameCount; i++)
+        {
+            frames.push_back((info.keyframeIndices.y + i) % frameCount);
+        }
+
+        for (const auto& load : stream.pWindow->update(frames)) mQueuedLoads.push_back({ &stream, load, {} });
+        for (uint32_t i = 0; i < 2; i++) mRequiredFrames.push_back({ &stream, frames[i] });
+
+        InterpolationInfo slotInfo = info;
+        slotInfo.keyframeIndices = uint2(stream.pWindow->findSlot(frames[0]), stream.pWindow->findSlot(frames[1]));
+        return slotInfo;
+    }
+
+    void AnimatedVertexCache::flushFrameLoads(RenderContext* pRenderContext)
+    {
+        if (!mQueuedLoads.empty())
+        {
+            LoadBatch batch;
+            batch.loads = std::move(mQueuedLoads);
+            mQueuedLoads.clear();
+            batch.done = std::async(std::launch::async, [loads = batch.loads.data(), count = batch.loads.size()]()
+            {
+                NumericRange<size_t> range(0, count);
+                std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i)
+                {
+                    FrameLoad& frameLoad = loads[i];
+                    frameLoad.data.resize(frameLoad.pStream->pFile->getFrameSize());
+                    frameLoad.pStream->pFile->readFrame(frameLoad.load.frame, frameLoad.data.data());
+                });
+            });
+            mLoadBatches.push_back(std::move(batch));
+        }
+
+        // Upload the loads that have completed in the meantime.
+        for (auto& batch : mLoadBatches)
+        {
+            if (batch.done.wait_for(std::chrono::seconds(0)) == std::future_status::ready) completeLoadBatch(pRenderContext, batch);
+        }
+
+        // Wait for the keyframes needed for this update. Batches complete in order of submission.
+        auto isMissing = [](const std::pair<FrameStream*, uint32_t>& required) { return !required.first->pWindow->isLoaded(required.second); };
+        for (auto& batch : mLoadBatches)
+        {
+            if (std::none_of(mRequiredFrames.begin(), mRequiredFrames.end(), isMissing)) break;
+            if (batch.done.valid()) completeLoadBatch(pRenderContext, batch);
+        }
+        FALCOR_ASSERT(std::none_of(mRequiredFrames.begin(), mRequiredFrames.end(), isMissing));
+        mRequiredFrames.clear();
+
+        mLoadBatches.erase(std::remove_if(mLoadBatches.begin(), mLoadBatches.end(), [](const LoadBatch& batch) { return !batch.done.valid(); }), mLoadBatches.end());
+    }
+
+    void AnimatedVertexCache::completeLoadBatch(RenderContext* pRenderContext, LoadBatch& batch)
+    {
+        // Invalidates the future to mark the batch as completed.
+        batch.done.get();
+        for (auto& frameLoad : batch.loads)
+        {
+            // Loads into slots that have been reassigned in the meantime are discarded.
+            if (!frameLoad.pStream->pWindow->markLoaded(frameLoad.load)) continue;
+            pRenderContext->updateBuffer(frameLoad.pStream->buffers[frameLoad.load.slot].get(), frameLoad.data.data(), 0, frameLoad.data.size());
+        }
+        batch.loads.clear();
+    }
+
     // We create a merged list of all timestamps and generate new frames for curves where those timestamps are missing.
     // This can lead to fairly heavy overhead if we have cached curves with vastly different total length.
     // Currently, our assets have cached curves with the same list of timestamps.
@@ -213,6 +340,39 @@ namespace Falcor
         mGlobalCurveAnimationLength = mCurveKeyframeTimes.empty() ? 0 : mCurveKeyframeTimes.back();
     }
 
+    std::vector<DynamicCurveVertexData> AnimatedVertexCache::getCurveKeyframeData(CurveTessellationMode tessellationMode, uint32_t vertexCount, uint32_t keyframe) const
+    {
+        // Concatenate the vertex data of all curves with the given tessellation mode at a global keyframe.
+        std::vector<DynamicCurveVertexData> vertexData;
+        vertexData.reserve(vertexCount);
+        const double time = mCurveKeyframeTimes[keyframe];
+
+        for (const auto& cache : mCachedCurves)
+        {
+            if (cache.tessellationMode != tessellationMode) continue;
+
+            const auto& timeSamples = cache.timeSamples;
+            size_t k = std::min(size_t(std::lower_bound(timeSamples.begin(), timeSamples.end(), time) - timeSamples.begin()), timeSamples.size() - 1);
+
+            if (timeSamples[k] == time || k == 0)
+            {
+                vertexData.insert(vertexData.end(), cache.vertexData[k].begin(), cache.vertexData[k].end());
+            }
+            else
+            {
+                // Linearly interpolate at the missing keyframe.
+                float t = float((time - timeSamples[k - 1]) / (timeSamples[k] - timeSamples[k - 1]));
+                for (size_t p = 0; p < cache.vertexData[k].size(); p++)
+                {
+                    vertexData.push_back({ lerp(cache.vertexData[k - 1][p].position, cache.vertexData[k][p].position, t) });
+                }
+            }
+        }
+
+        FALCOR_ASSERT(vertexData.size() == vertexCount);
+        return vertexData;
+    }
+
     void AnimatedVertexCache::bindCurveLSSBuffers()
     {
         // Compute curve vertex and index (segment) count.
@@ -228,50 +388,40 @@ namespace Falcor
 
         // Create buffers for vertex positions in curve vertex caches.
         ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
-        mpCurveVertexBuffers.resize(mCurveKeyframeTimes.size());
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++)
+        if (isStreaming())
+        {
+            VertexCacheFile::Desc desc;
+            desc.vertexCount = mCurveVertexCount;
+            desc.vertexStride = sizeof(DynamicCurveVertexData);
+            desc.positionTolerance = mStreamingOptions.positionTolerance;
+            std::vector<DynamicCurveVertexData> frameData;
+            auto getFrame = [&](uint32_t frame) { frameData = getCurveKeyframeData(CurveTessellationMode::LinearSweptSphere, mCurveVertexCount, frame); return frameData.data(); };
+            mpCurveVertexStream = createFrameStream("AnimatedVertexCache::mpCurveVertexBuffers", desc, (uint32_t)mCurveKeyframeTimes.size(), getFrame);
+            mpCurveVertexBuffers = mpCurveVertexStream->buffers;
+        }
+        else
         {
-            mpCurveVertexBuffers[i] = mpDevice->createStructuredBuffer(sizeof(DynamicCurveVertexData), mCurveVertexCount, vbBindFlags, MemoryType::DeviceLocal, nullptr, false);
-            mpCurveVertexBuffers[i]->setName("AnimatedVertexCache::mpCurveVertexBuffers[" + std::to_string(i) + "]");
+            // Initialize vertex buffers with cached positions.
+            mpCurveVertexBuffers.resize(mCurveKeyframeTimes.size());
+            for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++)
+            {
+                auto vertexData = getCurveKeyframeData(CurveTessellationMode::LinearSweptSphere, mCurveVertexCount, i);
+                mpCurveVertexBuffers[i] = mpDevice->createStructuredBuffer(sizeof(DynamicCurveVertexData), mCurveVertexCount, vbBindFlags, MemoryType::DeviceLocal, vertexData.data(), false);
+                mpCurveVertexBuffers[i]->setName("AnimatedVertexCache::mpCurveVertexBuffers[" + std::to_string(i) + "]");
+            }
         }
 
         // Create buffers for previous vertex positions.
         mpPrevCurveVertexBuffer = mpDevice->createStructuredBuffer(sizeof(DynamicCurveVertexData), mCurveVertexCount, vbBindFlags, MemoryType::DeviceLocal, nullptr, false);
         mpPrevCurveVertexBuffer->setName("AnimatedVertexCache::mpPrevCurveVertexBuffer");
 
-        // Initialize vertex buffers with cached positions.
+        // Initialize it with positions at the first keyframe.
         uint32_t offset = 0;
         for (size_t i = 0; i < mCachedCurves.size(); i++)
         {
             if (mCachedCurves[i].tessellationMode != CurveTessellationMode::LinearSweptSphere) continue;
 
-            size_t vertexCount = mCachedCurves[i].vertexData[0].size();
-            uint32_t bufSize = uint32_t(vertexCount * sizeof(DynamicCurveVertexData));
-            uint32_t k = 0;
-            const auto& timeSamples = mCachedCurves[i].timeSamples;
-
-            for (uint32_t j = 0; j < mCurveKeyframeTimes.size(); j++)
-            {
-                while (k + 1 < timeSamples.size() && timeSamples[k] < mCurveKeyframeTimes[j]) k++;
-
-                if (timeSamples[k] == mCurveKeyframeTimes[j])
-                {
-                    mpCurveVertexBuffers[j]->setBlob(mCachedCurves[i].vertexData[k].data(), offset, bufSize);
-                }
-                else
-                {
-                    // Linearly interpolate at the missing keyframe.
-                    float t = float((mCurveKeyframeTimes[j] - timeSamples[k - 1]) / (timeSamples[k] - timeSamples[k - 1]));
-                    std::vector<DynamicCurveVertexData> interpVertices(vertexCount);
-                    for (size_t p = 0; p < vertexCount; p++)
-                    {
-                        interpVertices[p].position = lerp(mCachedCurves[i].vertexData[k - 1][p].position, mCachedCurves[i].vertexData[k][p].position, t);
-                    }
-                    mpCurveVertexBuffers[j]->setBlob(interpVertices.data(), offset, bufSize);
-                }
-            }
-
-            // Initialize it with positions at the first keyframe.
+            uint32_t bufSize = uint32_t(mCachedCurves[i].vertexData[0].size() * sizeof(DynamicCurveVertexData));
             mpPrevCurveVertexBuffer->setBlob(mCachedCurves[i].vertexData[0].data(), offset, bufSize);
 
             offset += bufSize;
@@ -341,55 +491,35 @@ namespace Falcor
 
         // Create buffers for vertex positions in curve vertex caches.
         ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
-        mpCurvePolyTubeVertexBuffers.resize(mCurveKeyframeTimes.size());
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++)
+        if (isStreaming())
         {
-            mpCurvePolyTubeVertexBuffers[i] = mpDevice->createStructuredBuffer(sizeof(DynamicCurveVertexData), mCurvePolyTubeVertexCount, vbBindFlags, MemoryType::DeviceLocal, nullptr, false);
-            mpCurvePolyTubeVertexBuffers[i]->setName("AnimatedVertexCache::mpCurvePolyTubeVertexBuffers[" + std::to_string(i) + "]");
+            VertexCacheFile::Desc desc;
+            desc.vertexCount = mCurvePolyTubeVertexCount;
+            desc.vertexStride = sizeof(DynamicCurveVertexData);
+            desc.positionTolerance = mStreamingOptions.positionTolerance;
+            std::vector<DynamicCurveVertexData> frameData;
+            auto getFrame = [&](uint32_t frame) { frameData = getCurveKeyframeData(CurveTessellationMode::PolyTube, mCurvePolyTubeVertexCount, frame); return frameData.data(); };
+            mpCurvePolyTubeVertexStream = createFrameStream("AnimatedVertexCache::mpCurvePolyTubeVertexBuffers", desc, (uint32_t)mCurveKeyframeTimes.size(), getFrame);
+            mpCurvePolyTubeVertexBuffers = mpCurvePolyTubeVertexStream->buffers;
         }
-
-        // Initialize vertex buffers with cached positions.
-        uint32_t offset = 0;
-        for (size_t i = 0; i < mCachedCurves.size(); i++)
+        else
         {
-            if (mCachedCurves[i].tessellationMode != CurveTessellationMode::PolyTube) continue;
-
-            size_t vertexCount = mCachedCurves[i].vertexData[0].size();
-            uint32_t bufSize = uint32_t(vertexCount * sizeof(DynamicCurveVertexData));
-            uint32_t k = 0;
-            const auto& timeSamples = mCachedCurves[i].timeSamples;
-
-            for (uint32_t j = 0; j < mCurveKeyframeTimes.size(); j++)
+            // Initialize vertex buffers with cached positions.
+            mpCurvePolyTubeVertexBuffers.resize(mCurveKeyframeTimes.size());
+            for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++)
             {
-                while (k + 1 < timeSamples.size() && timeSamples[k] < mCurveKeyframeTimes[j]) k++;
-
-                if (timeSamples[k] == mCurveKeyframeTimes[j])
-                {
-                    mpCurvePolyTubeVertexBuffers[j]->setBlob(mCachedCurves[i].vertexData[k].data(), offset, bufSize);
-                }
-                else
-                {
-                    // Linearly interpolate at the missing keyframe.
-                    float t = float((mCurveKeyframeTimes[j] - timeSamples[k - 1]) / (timeSamples[k] - timeSamples[k - 1]));
-                    std::vector<DynamicCurveVertexData> interpVertices(vertexCount);
-                    for (size_t p = 0; p < vertexCount; p++)
-                    {
-                        interpVertices[p].position = lerp(mCachedCurves[i].vertexData[k - 1][p].position, mCachedCurves[i].vertexData[k][p].position, t);
-                    }
-                    mpCurvePolyTubeVertexBuffers[j]->setBlob(interpVertices.data(), offset, bufSize);
-                }
+                auto vertexData = getCurveKeyframeData(CurveTessellationMode::PolyTube, mCurvePolyTubeVertexCount, i);
+                mpCurvePolyTubeVertexBuffers[i] = mpDevice->createStructuredBuffer(sizeof(DynamicCurveVertexData), mCurvePolyTubeVertexCount, vbBindFlags, MemoryType::DeviceLocal, vertexData.data(), false);
+                mpCurvePolyTubeVertexBuffers[i]->setName("AnimatedVertexCache::mpCurvePolyTubeVertexBuffers[" + std::to_string(i) + "]");
             }
-
-            offset += bufSize;
         }
 
         // Create curve strand index buffer.
-        vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess;
         mpCurvePolyTubeStrandIndexBuffer = mpDevice->createBuffer(sizeof(uint32_t) * mCurvePolyTubeVertexCount, vbBindFlags);
         mpCurvePolyTubeStrandIndexBuffer->setName("AnimatedVertexCache::mpCurvePolyTubeStrandIndexBuffer");
 
         // Initialize strand index buffer.
-        offset = 0;
+        uint32_t offset = 0;
         const uint32_t strandLastVertexIndex = 0xffffffff;
         std::vector<uint32_t> strandIndexData(mCurvePolyTubeVertexCount);
         for (uint32_t i = 0; i < (uint32_t)mCachedCurves.size(); i++)
@@ -437,32 +567,45 @@ namespace Falcor
 
     void AnimatedVertexCache::initMeshBuffers()
     {
-        mpMeshVertexBuffers.resize(mMeshKeyframeCount);
+        mpMeshVertexBuffers.reserve(mMeshKeyframeCount);
         std::vector<PerMeshMetadata> meshMetadata;
         meshMetadata.reserve(mCachedMeshes.size());
 
-        uint32_t keyframeOffset = 0;
         for (auto& cache : mCachedMeshes)
         {
             FALCOR_ASSERT(cache.vertexData.front().size() == mpScene->getMesh(cache.meshID).vertexCount);
 
             PerMeshMetadata meta;
-            meta.keyframeBufferOffset = keyframeOffset;
+            meta.keyframeBufferOffset = (uint32_t)mpMeshVertexBuffers.size();
             meta.vertexCount = (uint32_t)cache.vertexData.front().size();
             meta.sceneVbOffset = mpScene->getMesh(cache.meshID).vbOffset;
             meta.prevVbOffset = mpScene->getMesh(cache.meshID).prevVbOffset;
             meshMetadata.push_back(meta);
 
+            if (isStreaming())
+            {
+                // Create vertex buffers for the window of resident keyframes on this mesh.
+                VertexCacheFile::Desc desc;
+                desc.vertexCount = meta.vertexCount;
+                desc.vertexStride = sizeof(PackedStaticVertexData);
+                desc.positionOffset = offsetof(PackedStaticVertexData, position);
+                desc.positionTolerance = mStreamingOptions.positionTolerance;
+                auto getFrame = [&](uint32_t frame) { return cache.vertexData[frame].data(); };
+                std::string name = "AnimatedVertexCache::mpMeshVertexBuffers[" + std::to_string(mMeshVertexStreams.size()) + "]";
+                mMeshVertexStreams.push_back(createFrameStream(name, desc, (uint32_t)cache.vertexData.size(), getFrame));
+                const auto& buffers = mMeshVertexStreams.back()->buffers;
+                mpMeshVertexBuffers.insert(mpMeshVertexBuffers.end(), buffers.begin(), buffers.end());
+                continue;
+            }
+
             // Create vertex buffer for each keyframe on this mesh
             for (size_t i = 0; i < cache.vertexData.size(); i++)
             {
                 auto& data = cache.vertexData[i];
-                size_t index = keyframeOffset + i;
-                mpMeshVertexBuffers[index] = mpDevice->createStructuredBuffer(sizeof(PackedStaticVertexData), (uint32_t)data.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, data.data(), false);
+                size_t index = mpMeshVertexBuffers.size();
+                mpMeshVertexBuffers.push_back(mpDevice->createStructuredBuffer(sizeof(PackedStaticVertexData), (uint32_t)data.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, data.data(), false));
                 mpMeshVertexBuffers[index]->setName("AnimatedVertexCache::mpMeshVertexBuffers[" + std::to_string(index) + "]");
             }
-
-            keyframeOffset += (uint32_t)cache.timeSamples.size();
         }
 
         mpMeshMetadataBuffer = mpDevice->createStructuredBuffer(sizeof(PerMeshMetadata), (uint32_t)meshMetadata.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, meshMetadata.data(), false);
@@ -478,7 +621,7 @@ namespace Falcor
         FALCOR_ASSERT(!mCachedMeshes.empty());
 
         DefineList defines;
-        defines.add("MESH_KEYFRAME_COUNT", std::to_string(mMeshKeyframeCount));
+        defines.add("MESH_KEYFRAME_COUNT", std::to_string(mpMeshVertexBuffers.size()));
         mpMeshVertexUpdatePass = ComputePass::create(mpDevice, "Scene/Animation/UpdateMeshVertices.slang", "main", defines);
 
         // Bind data
@@ -496,14 +639,14 @@ namespace Falcor
         FALCOR_ASSERT(mCurveLSSCount > 0);
 
         DefineList defines;
-        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mCurveKeyframeTimes.size()));
+        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mpCurveVertexBuffers.size()));
         mpCurveVertexUpdatePass = ComputePass::create(mpDevice, kUpdateCurveVerticesFilename, "main", defines);
 
         auto block = mpCurveVertexUpdatePass->getRootVar()["gCurveVertexUpdater"];
         auto var = block["curvePerKeyframe"];
 
         // Bind curve vertex data.
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++) var[i]["vertexData"] = mpCurveVertexBuffers[i];
+        for (uint32_t i = 0; i < mpCurveVertexBuffers.size(); i++) var[i]["vertexData"] = mpCurveVertexBuffers[i];
     }
 
     void AnimatedVertexCache::createCurveLSSAABBUpdatePass()
@@ -521,7 +664,7 @@ namespace Falcor
         FALCOR_ASSERT(mCurvePolyTubeCount > 0);
 
         DefineList defines;
-        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mCurveKeyframeTimes.size()));
+        defines.add("CURVE_KEYFRAME_COUNT", std::to_string(mpCurvePolyTubeVertexBuffers.size()));
         mpCurvePolyTubeVertexUpdatePass = ComputePass::create(mpDevice, kUpdateCurvePolyTubeVerticesFilename, "main", defines);
 
         auto block = mpCurvePolyTubeVertexUpdatePass->getRootVar()["gCurvePolyTubeVertexUpdater"];
@@ -531,7 +674,7 @@ namespace Falcor
         auto var = block["curvePerKeyframe"];
 
         // Bind curve vertex data.
-        for (uint32_t i = 0; i < mCurveKeyframeTimes.size(); i++) var[i]["vertexData"] = mpCurvePolyTubeVertexBuffers[i];
+        for (uint32_t i = 0; i < mpCurvePolyTubeVertexBuffers.size(); i++) var[i]["vertexData"] = mpCurvePolyTubeVertexBuffers[i];
     }
 
 
@@ -546,7 +689,9 @@ namespace Falcor
         {
             auto postInfinityBehavior = mLoopAnimations ? Animation::Behavior::Cycle : Animation::Behavior::Constant;
             mMeshInterpolationInfo[i] = calculateInterpolation(t, mCachedMeshes[i].timeSamples, mPreInfinityBehavior, postInfinityBehavior);
+            if (isStreaming() && !copyPrev) mMeshInterpolationInfo[i] = streamFrames(*mMeshVertexStreams[i], mMeshInterpolationInfo[i]);
         }
+        flushFrameLoads(pRenderContext);
 
         mpMeshInterpolationBuffer->setBlob(mMeshInterpolationInfo.data(), 0, mpMeshInterpolationBuffer->getSize());
 
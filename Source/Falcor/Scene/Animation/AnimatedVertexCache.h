@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "Animation.h"
+#include "VertexCacheStream.h"
 #include "SharedTypes.slang"
 #include "Core/API/Buffer.h"
 #include "Core/Pass/ComputePass.h"
@@ -36,7 +37,10 @@
 #include "Utils/Sampling/SampleGenerator.h"
 
 #include <algorithm>
+#include <filesystem>
+#include <future>
 #include <limits>
+#include <memory>
 #include <vector>
 
 namespace Falcor
@@ -73,8 +77,19 @@ namespace Falcor
     class FALCOR_API AnimatedVertexCache
     {
     public:
-        AnimatedVertexCache(ref<Device> pDevice, Scene* pScene, const ref<Buffer>& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes);
-        ~AnimatedVertexCache() = default;
+        /** Options for streaming keyframes from disk.
+            When enabled, the keyframes are written to a temporary file and only a sliding window of keyframes
+            around the current time is kept on the GPU. Keyframes ahead of the current time are loaded asynchronously.
+        */
+        struct StreamingOptions
+        {
+            bool enabled = false;               ///< Stream keyframes from disk instead of keeping all keyframes resident.
+            uint32_t windowSize = 4;            ///< Number of resident keyframes per vertex cache (at least 2).
+            float positionTolerance = 1e-4f;    ///< Maximum position error of the on-disk encoding in scene units.
+        };
+
+        AnimatedVertexCache(ref<Device> pDevice, Scene* pScene, const ref<Buffer>& pPrevVertexData, std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, const StreamingOptions& streamingOptions);
+        ~AnimatedVertexCache();
 
         void setIsLooped(bool looped) { mLoopAnimations = looped; }
 
@@ -98,7 +113,48 @@ namespace Falcor
 
         uint64_t getMemoryUsageInBytes() const;
 
+        bool isStreaming() const { return mStreamingOptions.enabled; }
+
     private:
+        /** Keyframes of a vertex cache streamed from disk.
+        */
+        struct FrameStream
+        {
+            std::filesystem::path path;
+            std::unique_ptr<VertexCacheFile> pFile;
+            std::unique_ptr<VertexCacheWindow> pWindow;
+            std::vector<ref<Buffer>> buffers;   ///< GPU buffer per window slot.
+
+            ~FrameStream();
+        };
+
+        struct FrameLoad
+        {
+            FrameStream* pStream;
+            VertexCacheWindow::Load load;
+            std::vector<uint8_t> data;
+        };
+
+        struct LoadBatch
+        {
+            std::vector<FrameLoad> loads;
+            std::future<void> done;
+        };
+
+        std::unique_ptr<FrameStream> createFrameStream(const std::string& name, const VertexCacheFile::Desc& desc, uint32_t frameCount, const VertexCacheFile::FrameFunc& getFrame);
+
+        /** Request the keyframes for an interpolation and prefetch the following keyframes.
+            \return Interpolation info referring to window slots instead of keyframes.
+        */
+        InterpolationInfo streamFrames(FrameStream& stream, const InterpolationInfo& info);
+
+        /** Start loading the requested keyframes, upload completed loads and wait for the keyframes required for rendering.
+        */
+        void flushFrameLoads(RenderContext* pRenderContext);
+        void completeLoadBatch(RenderContext* pRenderContext, LoadBatch& batch);
+
+        std::vector<DynamicCurveVertexData> getCurveKeyframeData(CurveTessellationMode tessellationMode, uint32_t vertexCount, uint32_t keyframe) const;
+
         void initCurveKeyframes();
         void bindCurveLSSBuffers();
         void bindCurvePolyTubeBuffers();
@@ -133,6 +189,12 @@ namespace Falcor
         ref<Buffer> mpPrevVertexData; ///< Owned by AnimationController
         Animation::Behavior mPreInfinityBehavior = Animation::Behavior::Constant; // How the animation behaves before the first keyframe.
 
+        // Keyframe streaming.
+        StreamingOptions mStreamingOptions;
+        std::vector<FrameLoad> mQueuedLoads;    ///< Loads requested since the last flush.
+        std::vector<LoadBatch> mLoadBatches;    ///< Loads in flight.
+        std::vector<std::pair<FrameStream*, uint32_t>> mRequiredFrames; ///< Keyframes that must be loaded before the next update pass.
+
         std::vector<CachedCurve> mCachedCurves;
         uint32_t mCurveLSSCount = 0;
         uint32_t mCurvePolyTubeCount = 0;
@@ -147,6 +209,7 @@ namespace Falcor
         uint32_t mCurveAABBOffset = 0;
 
         std::vector<ref<Buffer>> mpCurveVertexBuffers;
+        std::unique_ptr<FrameStream> mpCurveVertexStream;
         ref<Buffer> mpPrevCurveVertexBuffer;
         ref<Buffer> mpCurveIndexBuffer;
 
@@ -158,6 +221,7 @@ namespace Falcor
         uint32_t mMaxCurvePolyTubeVertexCount = 0; ///< Greatest vertex count a curve has
 
         std::vector<ref<Buffer>> mpCurvePolyTubeVertexBuffers;
+        std::unique_ptr<FrameStream> mpCurvePolyTubeVertexStream;
         ref<Buffer> mpCurvePolyTubeStrandIndexBuffer;
         ref<Buffer> mpCurvePolyTubeCurveMetadataBuffer;
         ref<Buffer> mpCurvePolyTubeMeshMetadataBuffer;
@@ -172,6 +236,7 @@ namespace Falcor
         uint32_t mMaxMeshVertexCount = 0; ///< Greatest vertex count a mesh has
 
         std::vector<ref<Buffer>> mpMeshVertexBuffers;
+        std::vector<std::unique_ptr<FrameStream>> mMeshVertexStreams;
         ref<Buffer> mpMeshInterpolationBuffer;
         ref<Buffer> mpMeshMetadataBuffer;
     };
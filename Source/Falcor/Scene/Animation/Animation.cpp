@@ -31,6 +31,8 @@
 #include "Utils/Math/Common.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Scene/Transform.h"
+#include <algorithm>
+#include <iterator>
 
 namespace Falcor
 {
@@ -38,6 +40,13 @@ namespace Falcor
     {
         const double kEpsilonTime = 1e-5f;
 
+        // Rotation components are quantized to 15 bits.
+        const uint32_t kRotationComponentMax = (1u << 15) - 1;
+
+        // Upper bound on the number of keyframes covered by a single linear segment during compression.
+        // This bounds the cost of compressing long constant clips.
+        const size_t kMaxCompressedSegmentLength = 256;
+
         const Gui::DropdownList kChannelLoopModeDropdown =
         {
             { (uint32_t)Animation::Behavior::Constant, "Constant" },
@@ -103,6 +112,168 @@ namespace Falcor
             result.time = math::lerp(k1.time, k2.time, (double)t);
             return result;
         }
+
+        // Compose translation, rotation and scaling into the matrix T * R * S.
+        // The rotation is scaled column-wise and the translation is written directly, avoiding two general 4x4 multiplies.
+        float4x4 composeTRS(const float3& translation, const quatf& rotation, const float3& scaling)
+        {
+            const float3x3 R = math::matrixFromQuat(rotation);
+            return float4x4{
+                R[0][0] * scaling.x, R[0][1] * scaling.y, R[0][2] * scaling.z, translation.x,
+                R[1][0] * scaling.x, R[1][1] * scaling.y, R[1][2] * scaling.z, translation.y,
+                R[2][0] * scaling.x, R[2][1] * scaling.y, R[2][2] * scaling.z, translation.z,
+                0.f, 0.f, 0.f, 1.f
+            };
+        }
+
+        template<typename T>
+        size_t findKeyframeIndex(const std::vector<T>& times, double time, size_t cachedIndex)
+        {
+            // Find the last keyframe at or before the given time, or the first keyframe if there is none.
+            // The search starts at the keyframe found in the previous call and gallops away from it with doubling
+            // step sizes until the result is bracketed, followed by a binary search within the bracket.
+            // This is constant time for regular playback and logarithmic in the distance to the previous keyframe otherwise.
+            FALCOR_ASSERT(!times.empty());
+            const size_t count = times.size();
+            const size_t cached = std::min(cachedIndex, count - 1);
+
+            size_t first, last; // The first keyframe after the given time is in [first, last].
+            if (times[cached] <= time)
+            {
+                size_t step = 1;
+                while (cached + step < count && times[cached + step] <= time) step *= 2;
+                first = cached + step / 2 + 1;
+                last = std::min(cached + step, count);
+            }
+            else
+            {
+                size_t step = 1;
+                while (step <= cached && times[cached - step] > time) step *= 2;
+                first = step > cached ? 0 : cached - step + 1;
+                last = cached - step / 2;
+            }
+
+            size_t next = std::upper_bound(times.begin() + first, times.begin() + last, time) - times.begin();
+            return next > 0 ? next - 1 : 0;
+        }
+
+        // Smallest-three rotation encoding. The largest quaternion component is dropped and reconstructed from the unit length.
+        // It is made positive by negating the quaternion, and a sign bit restores the original sign when decoding. q and -q
+        // represent the same rotation, but Hermite interpolation depends on the signs of the neighboring keyframes.
+        // The remaining components lie in [-1/sqrt(2), 1/sqrt(2)] and are quantized to 15 bits each, which together with
+        // the 2-bit index of the dropped component and the sign bit fits into three 16-bit words.
+        void encodeRotation(quatf q, uint16_t* pDst)
+        {
+            q = normalize(q);
+            uint32_t largest = 0;
+            for (uint32_t i = 1; i < 4; i++)
+            {
+                if (std::abs(q[i]) > std::abs(q[largest])) largest = i;
+            }
+
+            uint64_t bits = largest;
+            if (q[largest] < 0.f)
+            {
+                q = -q;
+                bits |= 1ull << 47;
+            }
+
+            for (uint32_t i = 0, j = 0; i < 4; i++)
+            {
+                if (i == largest) continue;
+                float v = std::clamp(q[i] * (float)M_SQRT1_2 + 0.5f, 0.f, 1.f);
+                bits |= (uint64_t)std::lround(v * kRotationComponentMax) << (2 + 15 * j++);
+            }
+            pDst[0] = (uint16_t)bits;
+            pDst[1] = (uint16_t)(bits >> 16);
+            pDst[2] = (uint16_t)(bits >> 32);
+        }
+
+        quatf decodeRotation(const uint16_t* pSrc)
+        {
+            uint64_t bits = (uint64_t)pSrc[0] | ((uint64_t)pSrc[1] << 16) | ((uint64_t)pSrc[2] << 32);
+            uint32_t largest = (uint32_t)(bits & 0x3);
+
+            quatf q;
+            float sum = 0.f;
+            for (uint32_t i = 0, j = 0; i < 4; i++)
+            {
+                if (i == largest) continue;
+                uint32_t u = (uint32_t)(bits >> (2 + 15 * j++)) & kRotationComponentMax;
+                float v = ((float)u / kRotationComponentMax - 0.5f) * (float)M_SQRT2;
+                q[i] = v;
+                sum += v * v;
+            }
+            q[largest] = std::sqrt(std::max(0.f, 1.f - sum));
+            return (bits >> 47) ? -q : q;
+        }
+
+        Animation::QuantizedTrack encodeTrack(const std::vector<float3>& values, float tolerance)
+        {
+            FALCOR_ASSERT(!values.empty());
+            Animation::QuantizedTrack track;
+
+            float3 minValue = values[0];
+            float3 maxValue = values[0];
+            for (const auto& v : values)
+            {
+                minValue = min(minValue, v);
+                maxValue = max(maxValue, v);
+            }
+            track.minValue = minValue;
+            if (all(minValue == maxValue)) return track;
+
+            // The quantization error is at most half a step. Keep full precision if this would use up more than half
+            // of the tolerance, which leaves the other half for the keyframe reduction.
+            const float3 step = (maxValue - minValue) / 65535.f;
+            if (length(step) > tolerance)
+            {
+                track.values = values;
+                return track;
+            }
+
+            track.step = step;
+            track.quantized.resize(3 * values.size());
+            for (size_t i = 0; i < values.size(); i++)
+            {
+                for (int c = 0; c < 3; c++)
+                {
+                    float u = step[c] > 0.f ? (values[i][c] - minValue[c]) / step[c] : 0.f;
+                    track.quantized[3 * i + c] = (uint16_t)std::clamp(std::lround(u), 0l, 65535l);
+                }
+            }
+            return track;
+        }
+
+        float3 decodeTrack(const Animation::QuantizedTrack& track, size_t index)
+        {
+            if (!track.values.empty()) return track.values[index];
+            if (track.quantized.empty()) return track.minValue;
+            const uint16_t* pSrc = &track.quantized[3 * index];
+            return track.minValue + track.step * float3((float)pSrc[0], (float)pSrc[1], (float)pSrc[2]);
+        }
+
+        /// Select a subset of the keyframes of a track.
+        Animation::QuantizedTrack selectTrack(const Animation::QuantizedTrack& track, const std::vector<size_t>& indices)
+        {
+            Animation::QuantizedTrack selected;
+            selected.minValue = track.minValue;
+            selected.step = track.step;
+            for (size_t i : indices)
+            {
+                if (!track.values.empty()) selected.values.push_back(track.values[i]);
+                if (!track.quantized.empty()) selected.quantized.insert(selected.quantized.end(), &track.quantized[3 * i], &track.quantized[3 * i] + 3);
+            }
+            return selected;
+        }
+
+        /// Returns the angle of the rotation between two unit quaternions.
+        /// Computed from the chord length between the quaternions, which unlike acos(dot(a, b)) is accurate for small angles.
+        float rotationError(const quatf& a, const quatf& b)
+        {
+            quatf d = dot(a, b) < 0.f ? a + b : a - b;
+            return 4.f * std::asin(std::min(0.5f * std::sqrt(dot(d, d)), 1.f));
+        }
     }
 
     Animation::Animation(const std::string& name, NodeID nodeID, double duration)
@@ -114,29 +285,33 @@ namespace Falcor
     float4x4 Animation::animate(double currentTime)
     {
         // Calculate the sample time.
+        const size_t keyframeCount = getKeyframeCount();
+        const double firstKeyframeTime = getKeyframeTime(0);
+        const double lastKeyframeTime = getKeyframeTime(keyframeCount - 1);
+
         double time = currentTime;
-        if (time < mKeyframes.front().time || time > mKeyframes.back().time)
+        if (time < firstKeyframeTime || time > lastKeyframeTime)
         {
             time = calcSampleTime(currentTime);
         }
 
         // Determine if the animation behaves linearly outside of defined keyframes.
-        bool isLinearPostInfinity = time > mKeyframes.back().time && this->getPostInfinityBehavior() == Behavior::Linear;
-        bool isLinearPreInfinity = time < mKeyframes.front().time && this->getPreInfinityBehavior() == Behavior::Linear;
+        bool isLinearPostInfinity = time > lastKeyframeTime && this->getPostInfinityBehavior() == Behavior::Linear;
+        bool isLinearPreInfinity = time < firstKeyframeTime && this->getPreInfinityBehavior() == Behavior::Linear;
 
         Keyframe interpolated;
 
-        if (isLinearPreInfinity && mKeyframes.size() > 1)
+        if (isLinearPreInfinity && keyframeCount > 1)
         {
-            const auto& k0 = mKeyframes.front();
+            const Keyframe k0 = getKeyframeAt(0);
             auto k1 = interpolate(mInterpolationMode, k0.time + kEpsilonTime);
             double segmentDuration = k1.time - k0.time;
             float t = (float)((time - k0.time) / segmentDuration);
             interpolated = interpolateLinear(k0, k1, t);
         }
-        else if (isLinearPostInfinity && mKeyframes.size() > 1)
+        else if (isLinearPostInfinity && keyframeCount > 1)
         {
-            const auto& k1 = mKeyframes.back();
+            const Keyframe k1 = getKeyframeAt(keyframeCount - 1);
             auto k0 = interpolate(mInterpolationMode, k1.time - kEpsilonTime);
             double segmentDuration = k1.time - k0.time;
             float t = (float)((time - k0.time) / segmentDuration);
@@ -147,46 +322,258 @@ namespace Falcor
             interpolated = interpolate(mInterpolationMode, time);
         }
 
-        float4x4 T = math::matrixFromTranslation(interpolated.translation);
-        float4x4 R = math::matrixFromQuat(interpolated.rotation);
-        float4x4 S = math::matrixFromScaling(interpolated.scaling);
-        float4x4 transform = mul(mul(T, R), S);
+        return composeTRS(interpolated.translation, interpolated.rotation, interpolated.scaling);
+    }
 
-        return transform;
+    size_t Animation::findKeyframe(double time) const
+    {
+        return mIsCompressed ? findKeyframeIndex(mCompressed.times, time, mCachedFrameIndex) : findKeyframeIndex(mKeyframeTimes, time, mCachedFrameIndex);
     }
 
-    Animation::Keyframe Animation::interpolate(InterpolationMode mode, double time) const
+    double Animation::getKeyframeTime(size_t index) const
+    {
+        return mIsCompressed ? mCompressed.times[index] : mKeyframeTimes[index];
+    }
+
+    Animation::Keyframe Animation::getKeyframeAt(size_t index) const
+    {
+        if (!mIsCompressed) return mKeyframes[index];
+
+        Keyframe keyframe;
+        keyframe.time = mCompressed.times[index];
+        keyframe.translation = decodeTrack(mCompressed.translations, index);
+        keyframe.scaling = decodeTrack(mCompressed.scalings, index);
+        keyframe.rotation = mCompressed.rotationValues.empty() ? decodeRotation(&mCompressed.rotations[3 * index]) : mCompressed.rotationValues[index];
+        return keyframe;
+    }
+
+    void Animation::updateKeyframeTimes()
+    {
+        mKeyframeTimes.resize(mKeyframes.size());
+        for (size_t i = 0; i < mKeyframes.size(); i++) mKeyframeTimes[i] = mKeyframes[i].time;
+        mCachedFrameIndex = 0;
+    }
+
+    void Animation::compress(const CompressionOptions& options)
     {
-        FALCOR_ASSERT(!mKeyframes.empty());
+        if (mIsCompressed || mKeyframes.empty()) return;
 
-        // Validate cached frame index.
-        size_t frameIndex = std::clamp(mCachedFrameIndex, (size_t)0, mKeyframes.size() - 1);
-        if (time < mKeyframes[frameIndex].time) frameIndex = 0;
+        const size_t count = mKeyframes.size();
 
-        // Find frame index.
-        while (frameIndex < mKeyframes.size() - 1)
+        // Quantize all keyframes first, so that the keyframe reduction accounts for the quantization error.
+        std::vector<float3> translations(count);
+        std::vector<float3> scalings(count);
+        for (size_t i = 0; i < count; i++)
         {
-            if (mKeyframes[frameIndex + 1].time > time) break;
-            frameIndex++;
+            translations[i] = mKeyframes[i].translation;
+            scalings[i] = mKeyframes[i].scaling;
         }
 
-        // Cache frame index;
+        CompressedKeyframes quantized;
+        quantized.times.resize(count);
+        quantized.rotations.resize(3 * count);
+        quantized.translations = encodeTrack(translations, options.translationTolerance);
+        quantized.scalings = encodeTrack(scalings, options.scalingTolerance);
+        for (size_t i = 0; i < count; i++)
+        {
+            quantized.times[i] = (float)mKeyframes[i].time;
+            encodeRotation(mKeyframes[i].rotation, &quantized.rotations[3 * i]);
+        }
+
+        // Returns zero if the keyframe is within the tolerances, or the largest error relative to its tolerance otherwise.
+        auto calcError = [&](const Keyframe& k, const Keyframe& reference)
+        {
+            auto relativeError = [](float error, float tolerance) { return error <= tolerance ? 0.f : error / tolerance; };
+            float3 scalingError = abs(k.scaling - reference.scaling);
+            return std::max({
+                relativeError(length(k.translation - reference.translation), options.translationTolerance),
+                relativeError(std::max({scalingError.x, scalingError.y, scalingError.z}), options.scalingTolerance),
+                relativeError(rotationError(k.rotation, reference.rotation), options.rotationTolerance),
+            });
+        };
+
+        // Rotations are stored at full precision if the quantization alone exceeds the rotation tolerance.
+        std::vector<Keyframe> decoded(count);
+        bool fullPrecisionRotations = false;
+        for (size_t i = 0; i < count; i++)
+        {
+            decoded[i].time = quantized.times[i];
+            decoded[i].translation = decodeTrack(quantized.translations, i);
+            decoded[i].scaling = decodeTrack(quantized.scalings, i);
+            decoded[i].rotation = decodeRotation(&quantized.rotations[3 * i]);
+            fullPrecisionRotations |= rotationError(decoded[i].rotation, mKeyframes[i].rotation) > options.rotationTolerance;
+        }
+        if (fullPrecisionRotations)
+        {
+            for (size_t i = 0; i < count; i++) decoded[i].rotation = mKeyframes[i].rotation;
+        }
+
+        // Select the keyframes to keep. The first and last keyframes are always kept, as they define the animation range.
+        // A first pass greedily extends linear segments for as long as they reconstruct all keyframes they cover.
+        std::vector<bool> keep(count, false);
+        keep.front() = keep.back() = true;
+        size_t start = 0;
+        for (size_t end = 2; end < count; end++)
+        {
+            bool valid = end - start <= kMaxCompressedSegmentLength;
+            for (size_t i = start + 1; i < end && valid; i++)
+            {
+                float t = (float)((mKeyframes[i].time - decoded[start].time) / (decoded[end].time - decoded[start].time));
+                valid = calcError(interpolateLinear(decoded[start], decoded[end], t), mKeyframes[i]) == 0.f;
+            }
+            if (!valid)
+            {
+                start = end - 1;
+                keep[start] = true;
+            }
+        }
+
+        std::vector<size_t> indices;
+        for (size_t i = 0; i < count; i++)
+        {
+            if (keep[i]) indices.push_back(i);
+        }
+
+        // A second pass verifies the selection with the animation's interpolation mode and the quantized keyframes,
+        // and restores keyframes until all keyframes are reconstructed within the tolerances. This is needed for
+        // Hermite interpolation, which depends on the neighboring keyframes of a segment. Only the keyframe with the
+        // largest error in each segment is restored per iteration, as it usually brings its neighbors within the tolerances.
+        // Segments are indexed by their first keyframe. Only segments that use a restored keyframe are verified again.
+        std::vector<bool> dirty(count, true);
+        std::vector<bool> keptKeyframeFailed(count, false);
+        ref<Animation> pReduced = Animation::create(mName, mNodeID, mDuration);
+        pReduced->mInterpolationMode = mInterpolationMode;
+        pReduced->mEnableWarping = mEnableWarping;
+        while (true)
+        {
+            pReduced->mKeyframes.clear();
+            for (size_t i : indices) pReduced->mKeyframes.push_back(decoded[i]);
+            pReduced->updateKeyframeTimes();
+
+            std::vector<size_t> restored;
+            for (size_t j = 0; j + 1 < indices.size(); j++)
+            {
+                const size_t segment = indices[j];
+                if (!dirty[segment]) continue;
+                dirty[segment] = false;
+                keptKeyframeFailed[segment] = false;
+
+                // The first keyframe of the segment is verified as well, as the quantization of its time affects the interpolation.
+                size_t worst = 0;
+                float worstError = 0.f;
+                for (size_t i = segment; i < indices[j + 1]; i++)
+                {
+                    float error = calcError(pReduced->interpolate(mInterpolationMode, mKeyframes[i].time), mKeyframes[i]);
+                    if (error == 0.f) continue;
+                    if (keep[i]) keptKeyframeFailed[segment] = true;
+                    else if (error > worstError)
+                    {
+                        worst = i;
+                        worstError = error;
+                    }
+                }
+                if (worstError > 0.f) restored.push_back(worst);
+            }
+            if (restored.empty()) break;
+
+            const bool wasLinear = indices.size() < 4;
+            std::vector<size_t> merged;
+            merged.reserve(indices.size() + restored.size());
+            std::merge(indices.begin(), indices.end(), restored.begin(), restored.end(), std::back_inserter(merged));
+            indices = std::move(merged);
+            for (size_t i : restored) keep[i] = true;
+
+            // Hermite interpolation of a segment uses one keyframe before and two keyframes after its first keyframe.
+            // Interpolation falls back to linear with fewer than four keyframes, so all segments change when that limit is reached.
+            if (mInterpolationMode == InterpolationMode::Hermite && wasLinear && indices.size() >= 4)
+            {
+                std::fill(dirty.begin(), dirty.end(), true);
+            }
+            for (size_t i : restored)
+            {
+                size_t p = std::lower_bound(indices.begin(), indices.end(), i) - indices.begin();
+                for (size_t j = p >= 2 ? p - 2 : 0; j <= std::min(p + 1, indices.size() - 2); j++) dirty[indices[j]] = true;
+            }
+        }
+
+        // Kept keyframes cannot be improved by restoring more keyframes. This happens if the single precision times
+        // are not accurate enough for the tolerances.
+        for (size_t j = 0; j + 1 < indices.size(); j++)
+        {
+            if (keptKeyframeFailed[indices[j]])
+            {
+                logWarning("Animation '{}' is not compressed, as its keyframes cannot be reconstructed within the tolerances.", mName);
+                mCachedFrameIndex = 0;
+                return;
+            }
+        }
+
+        mCompressed.times.clear();
+        mCompressed.rotations.clear();
+        mCompressed.rotationValues.clear();
+        for (size_t i : indices)
+        {
+            mCompressed.times.push_back(quantized.times[i]);
+            if (fullPrecisionRotations) mCompressed.rotationValues.push_back(mKeyframes[i].rotation);
+            else mCompressed.rotations.insert(mCompressed.rotations.end(), &quantized.rotations[3 * i], &quantized.rotations[3 * i] + 3);
+        }
+        mCompressed.translations = selectTrack(quantized.translations, indices);
+        mCompressed.scalings = selectTrack(quantized.scalings, indices);
+
+        mKeyframes = {};
+        mKeyframeTimes = {};
+        mIsCompressed = true;
+        mCachedFrameIndex = 0;
+    }
+
+    void Animation::decompress()
+    {
+        if (!mIsCompressed) return;
+
+        mKeyframes.resize(getKeyframeCount());
+        for (size_t i = 0; i < mKeyframes.size(); i++) mKeyframes[i] = getKeyframeAt(i);
+        mCompressed = {};
+        mIsCompressed = false;
+        updateKeyframeTimes();
+    }
+
+    uint64_t Animation::getMemoryUsageInBytes() const
+    {
+        auto trackSize = [](const QuantizedTrack& track) { return track.quantized.size() * sizeof(uint16_t) + track.values.size() * sizeof(float3); };
+
+        uint64_t m = 0;
+        m += mKeyframes.size() * sizeof(Keyframe);
+        m += mKeyframeTimes.size() * sizeof(double);
+        m += mCompressed.times.size() * sizeof(float);
+        m += mCompressed.rotations.size() * sizeof(uint16_t);
+        m += mCompressed.rotationValues.size() * sizeof(quatf);
+        m += trackSize(mCompressed.translations);
+        m += trackSize(mCompressed.scalings);
+        return m;
+    }
+
+    Animation::Keyframe Animation::interpolate(InterpolationMode mode, double time) const
+    {
+        FALCOR_ASSERT(getKeyframeCount() > 0);
+
+        // Find and cache frame index.
+        size_t frameIndex = findKeyframe(time);
         mCachedFrameIndex = frameIndex;
 
         // Compute index of adjacent frame including optional warping.
         auto adjacentFrame = [this] (size_t frame, int32_t offset = 1)
         {
-            size_t count = mKeyframes.size();
+            size_t count = getKeyframeCount();
             return mEnableWarping ? (frame + count + offset) % count : std::clamp(frame + offset, (size_t)0, count - 1);
         };
 
-        if (mode == InterpolationMode::Linear || mKeyframes.size() < 4)
+        if (mode == InterpolationMode::Linear || getKeyframeCount() < 4)
         {
             size_t i0 = frameIndex;
             size_t i1 = adjacentFrame(i0);
 
-            const Keyframe& k0 = mKeyframes[i0];
-            const Keyframe& k1 = mKeyframes[i1];
+            const Keyframe k0 = getKeyframeAt(i0);
+            const Keyframe k1 = getKeyframeAt(i1);
 
             double segmentDuration = k1.time - k0.time;
             if (mEnableWarping && segmentDuration < 0.0) segmentDuration += mDuration;
@@ -201,10 +588,10 @@ namespace Falcor
             size_t i2 = adjacentFrame(i1, 1);
             size_t i3 = adjacentFrame(i1, 2);
 
-            const Keyframe& k0 = mKeyframes[i0];
-            const Keyframe& k1 = mKeyframes[i1];
-            const Keyframe& k2 = mKeyframes[i2];
-            const Keyframe& k3 = mKeyframes[i3];
+            const Keyframe k0 = getKeyframeAt(i0);
+            const Keyframe k1 = getKeyframeAt(i1);
+            const Keyframe k2 = getKeyframeAt(i2);
+            const Keyframe k3 = getKeyframeAt(i3);
 
             double segmentDuration = k2.time - k1.time;
             if (mEnableWarping && segmentDuration < 0.0) segmentDuration += mDuration;
@@ -225,8 +612,8 @@ namespace Falcor
     double Animation::calcSampleTime(double currentTime)
     {
         double modifiedTime = currentTime;
-        double firstKeyframeTime = mKeyframes.front().time;
-        double lastKeyframeTime = mKeyframes.back().time;
+        double firstKeyframeTime = getKeyframeTime(0);
+        double lastKeyframeTime = getKeyframeTime(getKeyframeCount() - 1);
         double duration = lastKeyframeTime - firstKeyframeTime;
 
         FALCOR_ASSERT(currentTime < firstKeyframeTime || currentTime > lastKeyframeTime);
@@ -257,59 +644,34 @@ namespace Falcor
     {
         FALCOR_ASSERT(keyframe.time <= mDuration);
 
-        if (mKeyframes.size() == 0 || mKeyframes[0].time > keyframe.time)
-        {
-            mKeyframes.insert(mKeyframes.begin(), keyframe);
-        }
-        else if (mKeyframes.back().time < keyframe.time)
-        {
-            mKeyframes.push_back(keyframe);
-        }
-        else
-        {
-            for (size_t i = 0; i < mKeyframes.size(); i++)
-            {
-                auto& current = mKeyframes[i];
-                // If we already have a key-frame at the same time, replace it
-                if (current.time == keyframe.time)
-                {
-                    current = keyframe;
-                    return;
-                }
+        decompress();
 
-                // If this is not the last frame, Check if we are in between frames
-                if (i < mKeyframes.size() - 1)
-                {
-                    auto& Next = mKeyframes[i + 1];
-                    if (current.time < keyframe.time && Next.time > keyframe.time)
-                    {
-                        mKeyframes.insert(mKeyframes.begin() + i + 1, keyframe);
-                        return;
-                    }
-                }
-            }
+        // Keyframes are usually added in order, in which case this appends.
+        auto it = std::lower_bound(mKeyframeTimes.begin(), mKeyframeTimes.end(), keyframe.time);
+        size_t index = it - mKeyframeTimes.begin();
 
-            // If we got here, need to push it to the end of the list
-            mKeyframes.push_back(keyframe);
+        // If we already have a key-frame at the same time, replace it
+        if (it != mKeyframeTimes.end() && *it == keyframe.time)
+        {
+            mKeyframes[index] = keyframe;
+            return;
         }
+
+        mKeyframes.insert(mKeyframes.begin() + index, keyframe);
+        mKeyframeTimes.insert(it, keyframe.time);
     }
 
-    const Animation::Keyframe& Animation::getKeyframe(double time) const
+    Animation::Keyframe Animation::getKeyframe(double time) const
     {
-        for (const auto& k : mKeyframes)
-        {
-            if (k.time == time) return k;
-        }
-        FALCOR_THROW("'time' ({}) does not refer to an existing keyframe", time);
+        if (!doesKeyframeExists(time)) FALCOR_THROW("'time' ({}) does not refer to an existing keyframe", time);
+        return getKeyframeAt(findKeyframe(mIsCompressed ? (float)time : time));
     }
 
     bool Animation::doesKeyframeExists(double time) const
     {
-        for (const auto& k : mKeyframes)
-        {
-            if (k.time == time) return true;
-        }
-        return false;
+        // Compressed keyframe times are stored in single precision.
+        if (mIsCompressed) time = (float)time;
+        return getKeyframeCount() > 0 && getKeyframeTime(findKeyframe(time)) == time;
     }
 
     void Animation::renderUI(Gui::Widgets& widget)
@@ -343,7 +705,16 @@ namespace Falcor
         animation.def_property("postInfinityBehavior", &Animation::getPostInfinityBehavior, &Animation::setPostInfinityBehavior);
         animation.def_property("interpolationMode", &Animation::getInterpolationMode, &Animation::setInterpolationMode);
         animation.def_property("enableWarping", &Animation::isWarpingEnabled, &Animation::setEnableWarping);
+        animation.def_property_readonly("compressed", &Animation::isCompressed);
         animation.def(pybind11::init(&Animation::create), "name"_a, "nodeID"_a, "duration"_a);
+        animation.def("compress", [] (Animation* pAnimation, float translationTolerance, float rotationTolerance, float scalingTolerance) {
+            Animation::CompressionOptions options;
+            options.translationTolerance = translationTolerance;
+            options.rotationTolerance = rotationTolerance;
+            options.scalingTolerance = scalingTolerance;
+            pAnimation->compress(options);
+        }, "translationTolerance"_a = Animation::CompressionOptions().translationTolerance, "rotationTolerance"_a = Animation::CompressionOptions().rotationTolerance,
+            "scalingTolerance"_a = Animation::CompressionOptions().scalingTolerance);
         animation.def("addKeyframe", [] (Animation* pAnimation, double time, const Transform& transform) {
             Animation::Keyframe keyframe{ time, transform.getTranslation(), transform.getScaling(), transform.getRotation() };
             pAnimation->addKeyframe(keyframe);
@@ -67,6 +67,41 @@ namespace Falcor
             quatf rotation = quatf::identity();
         };
 
+        /** Error tolerances for keyframe compression.
+        */
+        struct CompressionOptions
+        {
+            float translationTolerance = 1e-4f; ///< Maximum translation error in scene units.
+            float rotationTolerance = 1e-3f;    ///< Maximum rotation error in radians. Rotations are quantized with an error of about 1e-4 radians, smaller tolerances keep full precision rotations.
+            float scalingTolerance = 1e-4f;     ///< Maximum error per scaling component.
+
+            // Note: Empty constructor needed for clang due to the use of the nested struct constructor in the parent class.
+            CompressionOptions() {}
+        };
+
+        /** Track of vectors quantized to 16 bits per component relative to the value range.
+            Tracks whose quantization error would exceed the tolerance store full precision values instead.
+            Tracks with a constant value store neither.
+        */
+        struct QuantizedTrack
+        {
+            float3 minValue = float3(0.f);      ///< Smallest value per component, or the value of a constant track.
+            float3 step = float3(0.f);          ///< Quantization step per component.
+            std::vector<uint16_t> quantized;    ///< Quantized values, three per keyframe.
+            std::vector<float3> values;         ///< Full precision values.
+        };
+
+        /** Compressed keyframe streams.
+        */
+        struct CompressedKeyframes
+        {
+            std::vector<float> times;           ///< Keyframe times.
+            std::vector<uint16_t> rotations;    ///< Rotations in smallest-three encoding, three words per keyframe.
+            std::vector<quatf> rotationValues;  ///< Full precision rotations, used instead if the quantization exceeds the rotation tolerance.
+            QuantizedTrack translations;
+            QuantizedTrack scalings;
+        };
+
         static ref<Animation> create(const std::string& name, NodeID nodeID, double duration) { return make_ref<Animation>(name, nodeID, duration); }
 
         /** Create a new animation.
@@ -135,7 +170,7 @@ namespace Falcor
             \param[in] time Time of the keyframe.
             \return Returns the keyframe.
         */
-        const Keyframe& getKeyframe(double time) const;
+        Keyframe getKeyframe(double time) const;
 
         /** Check if a keyframe exists at the specified time.
             \param[in] time Time of the keyframe.
@@ -143,7 +178,33 @@ namespace Falcor
         */
         bool doesKeyframeExists(double time) const;
 
+        /** Get the number of keyframes.
+        */
+        size_t getKeyframeCount() const { return mIsCompressed ? mCompressed.times.size() : mKeyframes.size(); }
+
+        /** Compress the keyframes.
+            Keyframes that the interpolation reconstructs within the tolerances are removed. The remaining keyframes are
+            stored in compact streams with single precision times, smallest-three quantized rotations and range quantized
+            translations and scalings, which are decoded on the fly when the animation is evaluated.
+            The animation is verified against the quantized keyframes. If the keyframes cannot be reconstructed within the
+            tolerances, e.g. because the single precision times are not accurate enough, the animation is left uncompressed.
+            Compressing an animation that is already compressed has no effect. Adding a keyframe decompresses the animation.
+            \param[in] options Error tolerances.
+        */
+        void compress(const CompressionOptions& options = CompressionOptions());
+
+        /** Returns true if the keyframes are compressed.
+        */
+        bool isCompressed() const { return mIsCompressed; }
+
+        /** Get the memory used by the keyframes in bytes.
+        */
+        uint64_t getMemoryUsageInBytes() const;
+
         /** Compute the animation.
+            Keyframes are looked up with a galloping search from the keyframe used in the previous call, so playback
+            is constant time per frame and scrubbing is logarithmic in the number of keyframes.
+            This function is not thread-safe, but different animations can be evaluated in parallel.
             \param time The current time in seconds. This can be larger then the animation time, in which case the animation will loop.
             \return Returns the animation's transform matrix for the specified time.
         */
@@ -156,6 +217,11 @@ namespace Falcor
     private:
         Keyframe interpolate(InterpolationMode mode, double time) const;
         double calcSampleTime(double currentTime);
+        size_t findKeyframe(double time) const;
+        double getKeyframeTime(size_t index) const;
+        Keyframe getKeyframeAt(size_t index) const;
+        void updateKeyframeTimes();
+        void decompress();
 
         std::string mName;
         NodeID mNodeID;
@@ -168,8 +234,12 @@ namespace Falcor
         bool mEnableWarping = false;
 
         std::vector<Keyframe> mKeyframes;
+        std::vector<double> mKeyframeTimes; ///< Keyframe times, stored contiguously for the keyframe search.
         mutable size_t mCachedFrameIndex = 0;
 
+        bool mIsCompressed = false;         ///< True if the keyframes are stored in mCompressed instead of mKeyframes.
+        CompressedKeyframes mCompressed;
+
         friend class SceneCache;
     };
 }
@@ -29,6 +29,9 @@
 #include "Core/API/RenderContext.h"
 #include "Utils/Timing/Profiler.h"
 #include "Scene/Scene.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
 #include <fstream>
 
 namespace Falcor
@@ -39,6 +42,9 @@ namespace Falcor
         const std::string kInverseTransposeWorldMatrices = "inverseTransposeWorldMatrices";
         const std::string kPrevWorldMatrices = "prevWorldMatrices";
         const std::string kPrevInverseTransposeWorldMatrices = "prevInverseTransposeWorldMatrices";
+
+        // Animations are evaluated in parallel if there are at least this many.
+        const size_t kMinParallelAnimationCount = 64;
     }
 
     AnimationController::AnimationController(ref<Device> pDevice, Scene* pScene, const StaticVertexVector& staticVertexData, const SkinningVertexVector& skinningVertexData, uint32_t prevVertexCount, const std::vector<ref<Animation>>& animations)
@@ -92,7 +98,7 @@ namespace Falcor
         }
     }
 
-    void AnimationController::addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, const StaticVertexVector& staticVertexData)
+    void AnimationController::addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, const StaticVertexVector& staticVertexData, const AnimatedVertexCache::StreamingOptions& streamingOptions)
     {
         size_t totalAnimatedMeshVertexCount = 0;
 
@@ -156,7 +162,7 @@ namespace Falcor
             mpPrevVertexData->setBlob(prevVertexData.data(), byteOffset, prevVertexData.size() * sizeof(PrevVertexData));
         }
 
-        mpVertexCache = std::make_unique<AnimatedVertexCache>(mpDevice, mpScene, mpPrevVertexData, std::move(cachedCurves), std::move(cachedMeshes));
+        mpVertexCache = std::make_unique<AnimatedVertexCache>(mpDevice, mpScene, mpPrevVertexData, std::move(cachedCurves), std::move(cachedMeshes), streamingOptions);
 
         // Note: It is a workaround to have two pre-infinity behaviors for the cached animation.
         // We need `Cycle` behavior when the length of cached animation is smaller than the length of mesh animation (e.g., tiger forest).
@@ -289,11 +295,26 @@ namespace Falcor
 
     void AnimationController::updateLocalMatrices(double time)
     {
-        for (auto& pAnimation : mAnimations)
+        // Evaluate all animations into a batch of matrices, in parallel for larger scenes.
+        // The results are then written to the animated nodes in order, which keeps the result deterministic
+        // if several animations target the same node and avoids concurrent writes to the change flags.
+        mAnimationMatrices.resize(mAnimations.size());
+        auto evaluate = [&](size_t i) { mAnimationMatrices[i] = mAnimations[i]->animate(time); };
+        if (mAnimations.size() >= kMinParallelAnimationCount)
+        {
+            NumericRange<size_t> range(0, mAnimations.size());
+            std::for_each(std::execution::par, range.begin(), range.end(), evaluate);
+        }
+        else
+        {
+            for (size_t i = 0; i < mAnimations.size(); i++) evaluate(i);
+        }
+
+        for (size_t i = 0; i < mAnimations.size(); i++)
         {
-            NodeID nodeID = pAnimation->getNodeID();
+            NodeID nodeID = mAnimations[i]->getNodeID();
             FALCOR_ASSERT(nodeID.get() < mLocalMatrices.size());
-            mLocalMatrices[nodeID.get()] = pAnimation->animate(time);
+            mLocalMatrices[nodeID.get()] = mAnimationMatrices[i];
             mMatricesChanged[nodeID.get()] = true;
         }
     }
@@ -387,6 +408,7 @@ namespace Falcor
         m += mpSkinningVertexData ? mpSkinningVertexData->getSize() : 0;
         m += mpPrevVertexData ? mpPrevVertexData->getSize() : 0;
         m += mpVertexCache ? mpVertexCache->getMemoryUsageInBytes() : 0;
+        for (const auto& pAnimation : mAnimations) m += pAnimation->getMemoryUsageInBytes();
         return m;
     }
 
@@ -394,11 +416,10 @@ namespace Falcor
     {
         if (staticVertexData.empty()) return;
 
-        // We always copy the static data, to initialize the non-skinned vertices.
+        // The static data has been uploaded when creating the mesh VAO, which initializes the non-skinned vertices.
         FALCOR_ASSERT(mpScene->getMeshVao());
         const ref<Buffer>& pVB = mpScene->getMeshVao()->getVertexBuffer(Scene::kStaticDataBufferIndex);
         FALCOR_ASSERT(pVB->getSize() == staticVertexData.size() * sizeof(staticVertexData[0]));
-        pVB->setBlob(staticVertexData.data(), 0, pVB->getSize());
 
         if (!skinningVertexData.empty())
         {
@@ -54,7 +54,7 @@ namespace Falcor
 
         /** Add animated vertex caches (curves and meshes) to the controller.
         */
-        void addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, const StaticVertexVector& staticVertexData);
+        void addAnimatedVertexCaches(std::vector<CachedCurve>&& cachedCurves, std::vector<CachedMesh>&& cachedMeshes, const StaticVertexVector& staticVertexData, const AnimatedVertexCache::StreamingOptions& streamingOptions);
 
         /** Returns true if controller contains animations.
         */
@@ -160,6 +160,7 @@ namespace Falcor
 
         // Animation
         std::vector<ref<Animation>> mAnimations;
+        std::vector<float4x4> mAnimationMatrices;  ///< Matrices of the animations evaluated in the current frame.
         std::vector<bool> mNodesEdited;
         std::vector<float4x4> mLocalMatrices;
         std::vector<float4x4> mGlobalMatrices;
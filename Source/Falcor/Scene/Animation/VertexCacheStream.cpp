@@ -0,0 +1,333 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "VertexCacheStream.h"
+#include "Core/Error.h"
+#include "Utils/Math/Common.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Specifies the current file version.
+            This needs to be incremented every time the file format changes!
+        */
+        const uint32_t kVersion = 1;
+
+        const char* kMagic = "FalcorVC";
+
+        // Largest quantized coordinate. The grid step is increased if the tolerance cannot be met within this range.
+        const double kMaxCoord = double(1u << 30);
+
+        struct Header
+        {
+            uint8_t magic[8]{};
+            uint32_t version{};
+            uint32_t frameCount{};
+            uint32_t vertexCount{};
+            uint32_t vertexStride{};
+            uint32_t positionOffset{};
+            uint32_t intraFrameInterval{};
+            float3 boundsMin{};
+            float step{};
+        };
+
+        void writeVarint(std::vector<uint8_t>& dst, uint32_t value)
+        {
+            while (value >= 0x80)
+            {
+                dst.push_back(uint8_t(value | 0x80));
+                value >>= 7;
+            }
+            dst.push_back(uint8_t(value));
+        }
+
+        uint32_t readVarint(const uint8_t*& p, const uint8_t* pEnd)
+        {
+            uint32_t value = 0;
+            for (uint32_t shift = 0; shift < 35; shift += 7)
+            {
+                if (p == pEnd) break;
+                uint8_t byte = *p++;
+                value |= uint32_t(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0) return value;
+            }
+            FALCOR_THROW("Vertex cache file is corrupt.");
+        }
+
+        uint32_t encodeZigZag(int32_t value) { return (uint32_t(value) << 1) ^ uint32_t(value >> 31); }
+        int32_t decodeZigZag(uint32_t value) { return int32_t(value >> 1) ^ -int32_t(value & 1); }
+
+        bool isIntraFrame(uint32_t frame) { return frame % VertexCacheFile::kIntraFrameInterval == 0; }
+
+        /// Size of the vertex attributes other than the position.
+        uint32_t getAttributeSize(uint32_t vertexStride) { return vertexStride - (uint32_t)sizeof(float3); }
+    }
+
+    void VertexCacheFile::write(const std::filesystem::path& path, const Desc& desc, uint32_t frameCount, const FrameFunc& getFrame)
+    {
+        FALCOR_CHECK(desc.vertexStride >= desc.positionOffset + sizeof(float3), "Vertex position must be within the vertex record.");
+        FALCOR_CHECK(desc.positionTolerance > 0.f, "Position tolerance must be positive.");
+
+        auto getPosition = [&](const uint8_t* pFrame, uint32_t vertex)
+        {
+            float3 position;
+            std::memcpy(&position, pFrame + (size_t)vertex * desc.vertexStride + desc.positionOffset, sizeof(float3));
+            return position;
+        };
+
+        // Compute the bounds of all positions to define the quantization grid.
+        float3 boundsMin(std::numeric_limits<float>::max());
+        float3 boundsMax(-std::numeric_limits<float>::max());
+        for (uint32_t frame = 0; frame < frameCount; frame++)
+        {
+            const uint8_t* pFrame = static_cast<const uint8_t*>(getFrame(frame));
+            for (uint32_t vertex = 0; vertex < desc.vertexCount; vertex++)
+            {
+                float3 position = getPosition(pFrame, vertex);
+                boundsMin = min(boundsMin, position);
+                boundsMax = max(boundsMax, position);
+            }
+        }
+        if (frameCount == 0 || desc.vertexCount == 0) boundsMin = boundsMax = float3(0.f);
+
+        // The error per component is at most half a step, so the step is chosen for the vector error to be within the tolerance.
+        float3 extent = boundsMax - boundsMin;
+        float step = 2.f * desc.positionTolerance / std::sqrt(3.f);
+        step = std::max(step, (float)(std::max({extent.x, extent.y, extent.z}) / kMaxCoord));
+
+        Header header;
+        std::memcpy(header.magic, kMagic, sizeof(Header::magic));
+        header.version = kVersion;
+        header.frameCount = frameCount;
+        header.vertexCount = desc.vertexCount;
+        header.vertexStride = desc.vertexStride;
+        header.positionOffset = desc.positionOffset;
+        header.intraFrameInterval = kIntraFrameInterval;
+        header.boundsMin = boundsMin;
+        header.step = step;
+
+        std::ofstream file(path, std::ios::binary);
+        if (!file) FALCOR_THROW("Failed to create vertex cache file '{}'.", path);
+
+        // The frame offset table is written after the frames, once the offsets are known.
+        std::vector<uint64_t> frameOffsets(frameCount + 1);
+        uint64_t offset = sizeof(Header) + frameOffsets.size() * sizeof(uint64_t);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.seekp(offset);
+
+        const uint32_t attributeSize = getAttributeSize(desc.vertexStride);
+        std::vector<uint32_t> intraCoords(3 * (size_t)desc.vertexCount);
+        std::vector<uint8_t> data;
+        for (uint32_t frame = 0; frame < frameCount; frame++)
+        {
+            const uint8_t* pFrame = static_cast<const uint8_t*>(getFrame(frame));
+            const bool intra = isIntraFrame(frame);
+
+            data.clear();
+            for (uint32_t vertex = 0; vertex < desc.vertexCount; vertex++)
+            {
+                float3 position = getPosition(pFrame, vertex);
+                for (uint32_t c = 0; c < 3; c++)
+                {
+                    uint32_t coord = (uint32_t)std::llround(((double)position[c] - boundsMin[c]) / step);
+                    uint32_t& intraCoord = intraCoords[3 * (size_t)vertex + c];
+                    if (intra) intraCoord = coord;
+                    writeVarint(data, intra ? coord : encodeZigZag(int32_t(coord - intraCoord)));
+                }
+            }
+
+            // Store the remaining attributes as-is.
+            if (attributeSize > 0)
+            {
+                size_t attributeOffset = data.size();
+                data.resize(attributeOffset + (size_t)attributeSize * desc.vertexCount);
+                uint8_t* pDst = data.data() + attributeOffset;
+                for (uint32_t vertex = 0; vertex < desc.vertexCount; vertex++)
+                {
+                    const uint8_t* pSrc = pFrame + (size_t)vertex * desc.vertexStride;
+                    std::memcpy(pDst, pSrc, desc.positionOffset);
+                    pDst += desc.positionOffset;
+                    size_t tail = desc.vertexStride - desc.positionOffset - sizeof(float3);
+                    std::memcpy(pDst, pSrc + desc.positionOffset + sizeof(float3), tail);
+                    pDst += tail;
+                }
+            }
+
+            frameOffsets[frame] = offset;
+            file.write(reinterpret_cast<const char*>(data.data()), data.size());
+            offset += data.size();
+        }
+        frameOffsets[frameCount] = offset;
+
+        file.seekp(sizeof(Header));
+        file.write(reinterpret_cast<const char*>(frameOffsets.data()), frameOffsets.size() * sizeof(uint64_t));
+        if (!file) FALCOR_THROW("Failed to write vertex cache file '{}'.", path);
+    }
+
+    VertexCacheFile::VertexCacheFile(const std::filesystem::path& path)
+    {
+        if (!mFile.open(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::RandomAccess))
+            FALCOR_THROW("Failed to open vertex cache file '{}'.", path);
+
+        const uint8_t* pData = static_cast<const uint8_t*>(mFile.getData());
+        Header header;
+        if (mFile.getSize() < sizeof(Header)) FALCOR_THROW("Vertex cache file '{}' is corrupt.", path);
+        std::memcpy(&header, pData, sizeof(Header));
+        if (std::memcmp(header.magic, kMagic, sizeof(Header::magic)) != 0 || header.version != kVersion || header.intraFrameInterval != kIntraFrameInterval)
+            FALCOR_THROW("Vertex cache file '{}' has an unsupported format.", path);
+        if (header.vertexStride < header.positionOffset + sizeof(float3))
+            FALCOR_THROW("Vertex cache file '{}' is corrupt.", path);
+
+        mFrameCount = header.frameCount;
+        mVertexCount = header.vertexCount;
+        mVertexStride = header.vertexStride;
+        mPositionOffset = header.positionOffset;
+        mBoundsMin = header.boundsMin;
+        mStep = header.step;
+
+        // The header size is a multiple of 8 bytes, so the offset table is aligned in the mapping.
+        static_assert(sizeof(Header) % sizeof(uint64_t) == 0);
+        if (mFile.getSize() < sizeof(Header) + ((size_t)mFrameCount + 1) * sizeof(uint64_t))
+            FALCOR_THROW("Vertex cache file '{}' is corrupt.", path);
+        mpFrameOffsets = reinterpret_cast<const uint64_t*>(pData + sizeof(Header));
+        for (uint32_t frame = 0; frame < mFrameCount; frame++)
+        {
+            if (mpFrameOffsets[frame] > mpFrameOffsets[frame + 1] || mpFrameOffsets[frame + 1] > mFile.getSize())
+                FALCOR_THROW("Vertex cache file '{}' is corrupt.", path);
+        }
+    }
+
+    const uint8_t* VertexCacheFile::getFrameData(uint32_t frame, size_t& size) const
+    {
+        FALCOR_CHECK(frame < mFrameCount, "Keyframe index {} is out of range.", frame);
+        size = mpFrameOffsets[frame + 1] - mpFrameOffsets[frame];
+        return static_cast<const uint8_t*>(mFile.getData()) + mpFrameOffsets[frame];
+    }
+
+    void VertexCacheFile::readFrame(uint32_t frame, void* pDst) const
+    {
+        const size_t coordCount = 3 * (size_t)mVertexCount;
+        std::vector<uint32_t> coords(coordCount);
+
+        // Decode the absolute coordinates of the preceding intra frame.
+        size_t size;
+        const uint32_t intraFrame = frame - frame % kIntraFrameInterval;
+        const uint8_t* p = getFrameData(intraFrame, size);
+        const uint8_t* pEnd = p + size;
+        for (size_t i = 0; i < coordCount; i++) coords[i] = readVarint(p, pEnd);
+
+        // Apply the deltas of the requested frame.
+        if (frame != intraFrame)
+        {
+            p = getFrameData(frame, size);
+            pEnd = p + size;
+            for (size_t i = 0; i < coordCount; i++) coords[i] += (uint32_t)decodeZigZag(readVarint(p, pEnd));
+        }
+
+        const uint32_t attributeSize = getAttributeSize(mVertexStride);
+        if ((size_t)(pEnd - p) != (size_t)attributeSize * mVertexCount) FALCOR_THROW("Vertex cache file is corrupt.");
+
+        uint8_t* pDstFrame = static_cast<uint8_t*>(pDst);
+        const size_t tail = mVertexStride - mPositionOffset - sizeof(float3);
+        for (uint32_t vertex = 0; vertex < mVertexCount; vertex++)
+        {
+            uint8_t* pDstVertex = pDstFrame + (size_t)vertex * mVertexStride;
+            const uint32_t* pCoords = &coords[3 * (size_t)vertex];
+            float3 position;
+            for (uint32_t c = 0; c < 3; c++) position[c] = (float)((double)mBoundsMin[c] + (double)mStep * pCoords[c]);
+
+            std::memcpy(pDstVertex, p, mPositionOffset);
+            p += mPositionOffset;
+            std::memcpy(pDstVertex + mPositionOffset, &position, sizeof(float3));
+            std::memcpy(pDstVertex + mPositionOffset + sizeof(float3), p, tail);
+            p += tail;
+        }
+    }
+
+    VertexCacheWindow::VertexCacheWindow(uint32_t slotCount)
+        : mSlots(slotCount)
+    {
+        FALCOR_CHECK(slotCount > 0, "Vertex cache window needs at least one slot.");
+    }
+
+    uint32_t VertexCacheWindow::findSlot(uint32_t frame) const
+    {
+        for (uint32_t i = 0; i < mSlots.size(); i++)
+        {
+            if (mSlots[i].frame == frame) return i;
+        }
+        return kInvalidSlot;
+    }
+
+    bool VertexCacheWindow::isLoaded(uint32_t frame) const
+    {
+        uint32_t slot = findSlot(frame);
+        return slot != kInvalidSlot && mSlots[slot].loaded;
+    }
+
+    std::vector<VertexCacheWindow::Load> VertexCacheWindow::update(const std::vector<uint32_t>& frames)
+    {
+        // Select the resident keyframes in order of priority.
+        std::vector<uint32_t> resident;
+        for (uint32_t frame : frames)
+        {
+            if (resident.size() == mSlots.size()) break;
+            if (std::find(resident.begin(), resident.end(), frame) == resident.end()) resident.push_back(frame);
+        }
+
+        // Release the slots of keyframes that are no longer resident.
+        for (auto& slot : mSlots)
+        {
+            if (std::find(resident.begin(), resident.end(), slot.frame) == resident.end()) slot = {};
+        }
+
+        std::vector<Load> loads;
+        uint32_t freeSlot = 0;
+        for (uint32_t frame : resident)
+        {
+            if (findSlot(frame) != kInvalidSlot) continue;
+            while (mSlots[freeSlot].frame != kInvalidFrame) freeSlot++;
+            mSlots[freeSlot].frame = frame;
+            loads.push_back({ frame, freeSlot });
+        }
+        return loads;
+    }
+
+    bool VertexCacheWindow::markLoaded(const Load& load)
+    {
+        FALCOR_ASSERT(load.slot < mSlots.size());
+        auto& slot = mSlots[load.slot];
+        if (slot.frame != load.frame) return false;
+        slot.loaded = true;
+        return true;
+    }
+}
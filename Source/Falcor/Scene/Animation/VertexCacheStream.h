@@ -0,0 +1,158 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/Math/Vector.h"
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+    /** On-disk storage of the keyframes of a vertex cache.
+
+        Each keyframe holds the same number of fixed-size vertex records. The vertex positions are quantized to a
+        uniform grid derived from the position tolerance. Every kIntraFrameInterval-th keyframe stores the absolute
+        grid coordinates, the keyframes in between store the difference to the preceding such frame as variable-length
+        integers, which is small for the coherent motion of simulated meshes. All other vertex attributes are stored
+        as-is. Any keyframe can be decoded independently from the memory-mapped file, and decoding is thread-safe.
+    */
+    class FALCOR_API VertexCacheFile
+    {
+    public:
+        /// Keyframes with absolute positions are stored at this interval, bounding the work for random access.
+        static constexpr uint32_t kIntraFrameInterval = 16;
+
+        struct Desc
+        {
+            uint32_t vertexCount = 0;           ///< Number of vertices per keyframe.
+            uint32_t vertexStride = 0;          ///< Size of a vertex record in bytes.
+            uint32_t positionOffset = 0;        ///< Byte offset of the float3 position in a vertex record.
+            float positionTolerance = 1e-4f;    ///< Maximum position error in scene units.
+        };
+
+        /** Function returning the vertex records of a keyframe. The data only needs to stay valid until the next call.
+        */
+        using FrameFunc = std::function<const void*(uint32_t frame)>;
+
+        /** Write a vertex cache file. Throws an exception on failure.
+            \param[in] path File path.
+            \param[in] desc Vertex layout and encoding tolerance.
+            \param[in] frameCount Number of keyframes.
+            \param[in] getFrame Function returning the vertex records of a keyframe. Called twice per keyframe.
+        */
+        static void write(const std::filesystem::path& path, const Desc& desc, uint32_t frameCount, const FrameFunc& getFrame);
+
+        /** Open a vertex cache file. Throws an exception if the file is missing or invalid.
+        */
+        VertexCacheFile(const std::filesystem::path& path);
+
+        uint32_t getFrameCount() const { return mFrameCount; }
+        uint32_t getVertexCount() const { return mVertexCount; }
+        uint32_t getVertexStride() const { return mVertexStride; }
+
+        /** Get the size of a decoded keyframe in bytes.
+        */
+        size_t getFrameSize() const { return (size_t)mVertexCount * mVertexStride; }
+
+        /** Get the size of the file in bytes.
+        */
+        size_t getFileSize() const { return mFile.getSize(); }
+
+        /** Decode a keyframe.
+            \param[in] frame Keyframe index.
+            \param[out] pDst Destination for getFrameSize() bytes of vertex records.
+        */
+        void readFrame(uint32_t frame, void* pDst) const;
+
+    private:
+        const uint8_t* getFrameData(uint32_t frame, size_t& size) const;
+
+        MemoryMappedFile mFile;
+        uint32_t mFrameCount = 0;
+        uint32_t mVertexCount = 0;
+        uint32_t mVertexStride = 0;
+        uint32_t mPositionOffset = 0;
+        float3 mBoundsMin = float3(0.f);
+        float mStep = 0.f;
+        const uint64_t* mpFrameOffsets = nullptr;
+    };
+
+    /** Residency policy for a sliding window of keyframes.
+        Keeps track of which keyframe occupies each of a fixed number of slots and whether it has been loaded.
+    */
+    class FALCOR_API VertexCacheWindow
+    {
+    public:
+        static constexpr uint32_t kInvalidSlot = std::numeric_limits<uint32_t>::max();
+
+        struct Load
+        {
+            uint32_t frame;
+            uint32_t slot;
+        };
+
+        VertexCacheWindow(uint32_t slotCount);
+
+        uint32_t getSlotCount() const { return (uint32_t)mSlots.size(); }
+
+        /** Get the slot assigned to a keyframe, or kInvalidSlot if it is not resident.
+        */
+        uint32_t findSlot(uint32_t frame) const;
+
+        /** Check if a keyframe is assigned to a slot and its data has been loaded.
+        */
+        bool isLoaded(uint32_t frame) const;
+
+        /** Update the resident keyframes.
+            Keyframes earlier in the list take priority, keyframes beyond the slot count are ignored.
+            Keyframes that are already resident keep their slot, all other slots are reused.
+            \param[in] frames Keyframes in order of priority.
+            \return List of keyframes that need to be loaded into their newly assigned slots.
+        */
+        std::vector<Load> update(const std::vector<uint32_t>& frames);
+
+        /** Mark a load as completed.
+            \return True if the slot is still assigned to the keyframe, false if the load is stale and its data should be discarded.
+        */
+        bool markLoaded(const Load& load);
+
+    private:
+        static constexpr uint32_t kInvalidFrame = std::numeric_limits<uint32_t>::max();
+
+        struct Slot
+        {
+            uint32_t frame = kInvalidFrame;
+            bool loaded = false;
+        };
+
+        std::vector<Slot> mSlots;
+    };
+}
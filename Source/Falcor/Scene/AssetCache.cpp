@@ -0,0 +1,171 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AssetCache.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include <fmt/format.h>
+#include <fstream>
+#include <random>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Specifies the current entry file version.
+            This needs to be incremented every time the file format changes!
+        */
+        const uint32_t kVersion = 1;
+
+        /** Asset cache directory (subdirectory in the application data directory).
+        */
+        const std::string kDirectory = "NVIDIA/Falcor/AssetCache";
+
+        const char* kMagic = "FalcorA$";
+        struct Header
+        {
+            uint8_t magic[8]{};
+            uint32_t version{};
+            uint64_t size{};
+
+            bool isValid() const
+            {
+                return std::memcmp(magic, kMagic, sizeof(Header::magic)) == 0 && version == kVersion;
+            }
+        };
+
+        /** Create a unique suffix for temporary files, so that threads and processes writing the same entry don't collide.
+        */
+        std::string createTempSuffix()
+        {
+            thread_local std::mt19937_64 rng{std::random_device{}()};
+            return fmt::format(".{:016x}.tmp", rng());
+        }
+    }
+
+    AssetCache::AssetCache(const std::filesystem::path& directory)
+        : mDirectory(directory)
+    {}
+
+    std::filesystem::path AssetCache::getDefaultDirectory()
+    {
+        return getAppDataDirectory() / kDirectory;
+    }
+
+    bool AssetCache::read(const Key& key, std::vector<uint8_t>& data)
+    {
+        auto entryPath = getEntryPath(key);
+
+        auto readEntry = [&]()
+        {
+            std::ifstream fs(entryPath, std::ios_base::binary);
+            if (!fs.good()) return false;
+
+            Header header;
+            fs.read(reinterpret_cast<char*>(&header), sizeof(header));
+            if (!fs.good() || !header.isValid()) return false;
+
+            // Reject truncated entries before allocating the data.
+            std::error_code ec;
+            auto fileSize = std::filesystem::file_size(entryPath, ec);
+            if (ec || fileSize != sizeof(Header) + header.size) return false;
+
+            data.resize(header.size);
+            fs.read(reinterpret_cast<char*>(data.data()), header.size);
+            return fs.good();
+        };
+
+        if (!readEntry())
+        {
+            data.clear();
+            mMissCount++;
+            return false;
+        }
+
+        mHitCount++;
+        mBytesRead += data.size();
+        return true;
+    }
+
+    void AssetCache::write(const Key& key, const std::vector<uint8_t>& data)
+    {
+        auto entryPath = getEntryPath(key);
+        auto tempPath = entryPath;
+        tempPath += createTempSuffix();
+
+        std::error_code ec;
+        std::filesystem::create_directories(entryPath.parent_path(), ec);
+
+        {
+            std::ofstream fs(tempPath, std::ios_base::binary);
+            Header header;
+            std::memcpy(header.magic, kMagic, sizeof(Header::magic));
+            header.version = kVersion;
+            header.size = data.size();
+            fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            fs.write(reinterpret_cast<const char*>(data.data()), data.size());
+            if (!fs.good())
+            {
+                fs.close();
+                std::filesystem::remove(tempPath, ec);
+                logWarning("Failed to write asset cache entry '{}'.", entryPath);
+                return;
+            }
+        }
+
+        // Renaming is atomic, readers either see the old entry or the complete new one.
+        std::filesystem::rename(tempPath, entryPath, ec);
+        if (ec)
+        {
+            std::filesystem::remove(tempPath, ec);
+            logWarning("Failed to write asset cache entry '{}'.", entryPath);
+            return;
+        }
+
+        mWriteCount++;
+        mBytesWritten += data.size();
+    }
+
+    AssetCache::Stats AssetCache::getStats() const
+    {
+        Stats stats;
+        stats.hitCount = mHitCount;
+        stats.missCount = mMissCount;
+        stats.writeCount = mWriteCount;
+        stats.bytesRead = mBytesRead;
+        stats.bytesWritten = mBytesWritten;
+        return stats;
+    }
+
+    std::filesystem::path AssetCache::getEntryPath(const Key& key) const
+    {
+        // Entries are spread over subdirectories by the first byte of the key to keep directories small.
+        std::string name = SHA1::toString(key);
+        return mDirectory / name.substr(0, 2) / name;
+    }
+}
@@ -0,0 +1,194 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/CryptoUtils.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Falcor
+{
+    /** Disk cache for data processed from individual assets during scene import.
+
+        Entries are opaque blobs addressed by a key. The key should hash the asset content together with
+        all settings that affect the processing, so that an entry never needs to be invalidated. Each entry
+        is stored in a separate file, which means re-importing a scene in which a single asset changed only
+        re-processes that asset. Entries are written to a temporary file and renamed, so concurrent imports
+        never observe partially written entries.
+
+        All functions are thread-safe.
+    */
+    class FALCOR_API AssetCache
+    {
+    public:
+        using Key = SHA1::MD;
+
+        struct Stats
+        {
+            uint64_t hitCount = 0;      ///< Number of successful reads.
+            uint64_t missCount = 0;     ///< Number of reads that found no valid entry.
+            uint64_t writeCount = 0;    ///< Number of written entries.
+            uint64_t bytesRead = 0;     ///< Total size of read entries in bytes.
+            uint64_t bytesWritten = 0;  ///< Total size of written entries in bytes.
+        };
+
+        /** Helper for serializing the data of a cache entry.
+        */
+        class Writer
+        {
+        public:
+            void write(const void* pData, size_t size)
+            {
+                const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+                mData.insert(mData.end(), pBytes, pBytes + size);
+            }
+
+            template<typename T>
+            void write(const T& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                write(&value, sizeof(T));
+            }
+
+            template<typename T>
+            void write(const std::vector<T>& vec)
+            {
+                write((uint64_t)vec.size());
+                write(vec.data(), vec.size() * sizeof(T));
+            }
+
+            void write(const std::string& str)
+            {
+                write((uint64_t)str.size());
+                write(str.data(), str.size());
+            }
+
+            const std::vector<uint8_t>& getData() const { return mData; }
+
+        private:
+            std::vector<uint8_t> mData;
+        };
+
+        /** Helper for deserializing the data of a cache entry.
+            All reads return false if the entry holds less data than requested.
+        */
+        class Reader
+        {
+        public:
+            Reader(const std::vector<uint8_t>& data) : mData(data) {}
+
+            bool read(void* pData, size_t size)
+            {
+                if (size > mData.size() - mOffset) return false;
+                std::memcpy(pData, mData.data() + mOffset, size);
+                mOffset += size;
+                return true;
+            }
+
+            template<typename T>
+            bool read(T& value)
+            {
+                static_assert(std::is_trivially_copyable_v<T>);
+                return read(&value, sizeof(T));
+            }
+
+            template<typename T>
+            bool read(std::vector<T>& vec)
+            {
+                uint64_t count = 0;
+                if (!read(count) || count > (mData.size() - mOffset) / std::max(sizeof(T), size_t(1))) return false;
+                vec.resize(count);
+                return read(vec.data(), count * sizeof(T));
+            }
+
+            bool read(std::string& str)
+            {
+                uint64_t size = 0;
+                if (!read(size) || size > mData.size() - mOffset) return false;
+                str.resize(size);
+                return read(str.data(), size);
+            }
+
+            /** Check if all data has been read.
+            */
+            bool isAtEnd() const { return mOffset == mData.size(); }
+
+        private:
+            const std::vector<uint8_t>& mData;
+            size_t mOffset = 0;
+        };
+
+        /** Create a cache.
+            \param[in] directory Directory holding the cache entries. It is created when the first entry is written.
+        */
+        AssetCache(const std::filesystem::path& directory = getDefaultDirectory());
+
+        /** Get the default cache directory (subdirectory in the application data directory).
+        */
+        static std::filesystem::path getDefaultDirectory();
+
+        /** Read a cache entry.
+            \param[in] key Cache key.
+            \param[out] data Data of the entry.
+            \return Returns true if a valid entry exists.
+        */
+        bool read(const Key& key, std::vector<uint8_t>& data);
+
+        /** Write a cache entry, replacing an existing entry with the same key.
+            Failing to write an entry is not an error, the asset is processed again on the next import.
+            \param[in] key Cache key.
+            \param[in] data Data of the entry.
+        */
+        void write(const Key& key, const std::vector<uint8_t>& data);
+
+        /** Get the cache directory.
+        */
+        const std::filesystem::path& getDirectory() const { return mDirectory; }
+
+        /** Get the cache statistics.
+        */
+        Stats getStats() const;
+
+    private:
+        std::filesystem::path getEntryPath(const Key& key) const;
+
+        std::filesystem::path mDirectory;
+
+        std::atomic<uint64_t> mHitCount{0};
+        std::atomic<uint64_t> mMissCount{0};
+        std::atomic<uint64_t> mWriteCount{0};
+        std::atomic<uint64_t> mBytesRead{0};
+        std::atomic<uint64_t> mBytesWritten{0};
+    };
+}
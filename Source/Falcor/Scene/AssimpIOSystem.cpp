@@ -0,0 +1,135 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AssimpIOSystem.h"
+#include "Core/Error.h"
+#include "Core/Platform/IOService.h"
+#include "Utils/Logger.h"
+#include <assimp/IOStream.hpp>
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Stream over the contents of a file in memory.
+        */
+        class MemoryStream : public Assimp::IOStream
+        {
+        public:
+            MemoryStream(std::string data) : mData(std::move(data)) {}
+
+            size_t Read(void* pvBuffer, size_t pSize, size_t pCount) override
+            {
+                if (pSize == 0) return 0;
+                size_t count = std::min(pCount, (mData.size() - mPos) / pSize);
+                std::memcpy(pvBuffer, mData.data() + mPos, count * pSize);
+                mPos += count * pSize;
+                return count;
+            }
+
+            size_t Write(const void*, size_t, size_t) override { return 0; }
+
+            aiReturn Seek(size_t pOffset, aiOrigin pOrigin) override
+            {
+                size_t pos = 0;
+                switch (pOrigin)
+                {
+                case aiOrigin_SET:
+                    pos = pOffset;
+                    break;
+                case aiOrigin_CUR:
+                    pos = mPos + pOffset;
+                    break;
+                case aiOrigin_END:
+                    if (pOffset > mData.size()) return aiReturn_FAILURE;
+                    pos = mData.size() - pOffset;
+                    break;
+                default:
+                    return aiReturn_FAILURE;
+                }
+                if (pos > mData.size()) return aiReturn_FAILURE;
+                mPos = pos;
+                return aiReturn_SUCCESS;
+            }
+
+            size_t Tell() const override { return mPos; }
+            size_t FileSize() const override { return mData.size(); }
+            void Flush() override {}
+
+        private:
+            std::string mData;
+            size_t mPos = 0;
+        };
+    }
+
+    bool AssimpIOSystem::Exists(const char* pFile) const
+    {
+        std::error_code ec;
+        return std::filesystem::is_regular_file(std::filesystem::path(pFile), ec);
+    }
+
+    char AssimpIOSystem::getOsSeparator() const
+    {
+#if FALCOR_WINDOWS
+        return '\\';
+#else
+        return '/';
+#endif
+    }
+
+    Assimp::IOStream* AssimpIOSystem::Open(const char* pFile, const char* pMode)
+    {
+        if (std::strpbrk(pMode, "wa+"))
+        {
+            logWarning("AssimpIOSystem: Writing files is not supported ('{}').", pFile);
+            return nullptr;
+        }
+
+        std::filesystem::path path(pFile);
+        std::string data;
+        try
+        {
+            data = IOService::get().read(path);
+        }
+        catch (const RuntimeError&)
+        {
+            return nullptr;
+        }
+
+        if (mFileCallback) mFileCallback(std::filesystem::absolute(path).lexically_normal());
+        return new MemoryStream(std::move(data));
+    }
+
+    void AssimpIOSystem::Close(Assimp::IOStream* pFile)
+    {
+        delete pFile;
+    }
+}
@@ -0,0 +1,61 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <assimp/IOSystem.hpp>
+#include <filesystem>
+#include <functional>
+
+namespace Falcor
+{
+    /** Assimp file system that reads files through the IOService.
+        Files are read as a whole on open, so read-ahead hints issued for them are picked up by the importer.
+        Only reading is supported.
+    */
+    class FALCOR_API AssimpIOSystem : public Assimp::IOSystem
+    {
+    public:
+        /** Callback invoked with the normalized absolute path of every file that is opened.
+        */
+        using FileCallback = std::function<void(const std::filesystem::path&)>;
+
+        /** Create the file system.
+            \param[in] fileCallback Optional callback invoked for every file the importer reads, including side files
+                such as material libraries or buffers. Importers use it to register the files as scene dependencies.
+        */
+        AssimpIOSystem(FileCallback fileCallback = {}) : mFileCallback(std::move(fileCallback)) {}
+
+        bool Exists(const char* pFile) const override;
+        char getOsSeparator() const override;
+        Assimp::IOStream* Open(const char* pFile, const char* pMode = "rb") override;
+        void Close(Assimp::IOStream* pFile) override;
+
+    private:
+        FileCallback mFileCallback;
+    };
+}
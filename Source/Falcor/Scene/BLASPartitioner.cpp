@@ -0,0 +1,240 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BLASPartitioner.h"
+#include "Core/Error.h"
+#include "Utils/Math/Common.h"
+#include <algorithm>
+#include <limits>
+
+namespace Falcor
+{
+    namespace
+    {
+        struct Bin
+        {
+            AABB bounds;
+            uint64_t triangleCount = 0;
+            uint32_t itemCount = 0;
+        };
+
+        class Partitioner
+        {
+        public:
+            Partitioner(const std::vector<BLASPartitioner::Item>& items, const BLASPartitioner::Options& options)
+                : mItems(items)
+                , mOptions(options)
+                , mMaxTrianglesPerGroup(std::max<uint64_t>(1, options.maxGroupMemory / std::max<uint64_t>(1, options.bytesPerTriangle)))
+            {}
+
+            void split(std::vector<uint32_t> items, BLASPartitioner::Partition& partition) const
+            {
+                uint64_t triangleCount = 0;
+                AABB centroidBounds;
+                for (uint32_t i : items)
+                {
+                    triangleCount += mItems[i].triangleCount;
+                    centroidBounds.include(mItems[i].bounds.center());
+                }
+
+                // Stop when the group fits the budget or cannot be split further.
+                if (triangleCount <= mMaxTrianglesPerGroup || items.size() <= 1)
+                {
+                    partition.push_back(std::move(items));
+                    return;
+                }
+
+                // Find the best binned split. Splits resulting in fewer groups are preferred, then lower SAH cost.
+                const uint32_t binCount = std::max(2u, mOptions.binCount);
+                std::vector<Bin> bins(binCount);
+                std::vector<AABB> rightBounds(binCount);
+                std::vector<uint64_t> rightTriangles(binCount);
+                std::vector<uint32_t> rightItems(binCount);
+
+                int bestAxis = -1;
+                uint32_t bestBin = 0;
+                uint64_t bestGroupCount = std::numeric_limits<uint64_t>::max();
+                float bestCost = std::numeric_limits<float>::infinity();
+
+                const float3 extent = centroidBounds.extent();
+                for (int axis = 0; axis < 3; axis++)
+                {
+                    if (!(extent[axis] > 0.f)) continue;
+
+                    std::fill(bins.begin(), bins.end(), Bin());
+                    for (uint32_t i : items)
+                    {
+                        const auto& item = mItems[i];
+                        Bin& bin = bins[getBin(item.bounds.center()[axis], centroidBounds.minPoint[axis], extent[axis], binCount)];
+                        bin.bounds.include(item.bounds);
+                        bin.triangleCount += item.triangleCount;
+                        bin.itemCount++;
+                    }
+
+                    // Sweep from the right to accumulate the bounds of the right side of each split.
+                    AABB bounds;
+                    uint64_t triangles = 0;
+                    uint32_t count = 0;
+                    for (uint32_t b = binCount - 1; b > 0; b--)
+                    {
+                        bounds.include(bins[b].bounds);
+                        triangles += bins[b].triangleCount;
+                        count += bins[b].itemCount;
+                        rightBounds[b] = bounds;
+                        rightTriangles[b] = triangles;
+                        rightItems[b] = count;
+                    }
+
+                    // Sweep from the left and evaluate the split between bin b-1 and b.
+                    bounds.invalidate();
+                    triangles = 0;
+                    count = 0;
+                    for (uint32_t b = 1; b < binCount; b++)
+                    {
+                        bounds.include(bins[b - 1].bounds);
+                        triangles += bins[b - 1].triangleCount;
+                        count += bins[b - 1].itemCount;
+                        if (count == 0 || rightItems[b] == 0) continue;
+
+                        uint64_t groupCount = getGroupCount(triangles) + getGroupCount(rightTriangles[b]);
+                        float cost = bounds.area() * (float)triangles + rightBounds[b].area() * (float)rightTriangles[b];
+                        if (groupCount < bestGroupCount || (groupCount == bestGroupCount && cost < bestCost))
+                        {
+                            bestAxis = axis;
+                            bestBin = b;
+                            bestGroupCount = groupCount;
+                            bestCost = cost;
+                        }
+                    }
+                }
+
+                std::vector<uint32_t> leftItems, rightItemList;
+                if (bestAxis >= 0)
+                {
+                    for (uint32_t i : items)
+                    {
+                        float c = mItems[i].bounds.center()[bestAxis];
+                        uint32_t b = getBin(c, centroidBounds.minPoint[bestAxis], extent[bestAxis], binCount);
+                        (b < bestBin ? leftItems : rightItemList).push_back(i);
+                    }
+                }
+                else
+                {
+                    // All centroids coincide. Fall back on splitting at the median in terms of triangle count.
+                    size_t splitIndex = 0;
+                    uint64_t triangles = 0;
+                    auto fitsLeft = [&](size_t i) { return triangles + mItems[items[i]].triangleCount <= triangleCount / 2; };
+                    while (splitIndex + 1 < items.size() && (splitIndex == 0 || fitsLeft(splitIndex)))
+                    {
+                        triangles += mItems[items[splitIndex++]].triangleCount;
+                    }
+                    leftItems.assign(items.begin(), items.begin() + splitIndex);
+                    rightItemList.assign(items.begin() + splitIndex, items.end());
+                }
+                FALCOR_ASSERT(!leftItems.empty() && !rightItemList.empty());
+
+                split(std::move(leftItems), partition);
+                split(std::move(rightItemList), partition);
+            }
+
+        private:
+            static uint32_t getBin(float c, float minPos, float extent, uint32_t binCount)
+            {
+                float t = (c - minPos) / extent;
+                return std::min(binCount - 1, (uint32_t)std::max(0.f, t * (float)binCount));
+            }
+
+            uint64_t getGroupCount(uint64_t triangleCount) const
+            {
+                return std::max<uint64_t>(1, div_round_up(triangleCount, mMaxTrianglesPerGroup));
+            }
+
+            const std::vector<BLASPartitioner::Item>& mItems;
+            const BLASPartitioner::Options& mOptions;
+            const uint64_t mMaxTrianglesPerGroup;
+        };
+    }
+
+    BLASPartitioner::Partition BLASPartitioner::partition(const std::vector<Item>& items, const Options& options)
+    {
+        FALCOR_CHECK(options.maxGroupMemory > 0, "Memory budget per group must be larger than zero.");
+
+        Partition partition;
+        if (items.empty()) return partition;
+
+        std::vector<uint32_t> indices(items.size());
+        for (uint32_t i = 0; i < (uint32_t)items.size(); i++) indices[i] = i;
+
+        Partitioner(items, options).split(std::move(indices), partition);
+        return partition;
+    }
+
+    BLASPartitioner::Metrics BLASPartitioner::evaluate(const std::vector<Item>& items, const Partition& partition, const Options& options)
+    {
+        Metrics metrics;
+        metrics.groupCount = (uint32_t)partition.size();
+
+        AABB sceneBounds;
+        std::vector<AABB> groupBounds(partition.size());
+        std::vector<uint64_t> groupTriangles(partition.size(), 0);
+
+        for (size_t g = 0; g < partition.size(); g++)
+        {
+            for (uint32_t i : partition[g])
+            {
+                FALCOR_CHECK(i < items.size(), "Item index {} is out of range.", i);
+                groupBounds[g].include(items[i].bounds);
+                groupTriangles[g] += items[i].triangleCount;
+            }
+            sceneBounds.include(groupBounds[g]);
+            metrics.maxGroupMemory = std::max(metrics.maxGroupMemory, groupTriangles[g] * options.bytesPerTriangle);
+        }
+
+        if (!sceneBounds.valid()) return metrics;
+        const float sceneArea = sceneBounds.area() > 0.f ? sceneBounds.area() : 1.f;
+
+        for (size_t g = 0; g < partition.size(); g++)
+        {
+            if (!groupBounds[g].valid()) continue;
+            metrics.sahCost += groupBounds[g].area() * (float)groupTriangles[g] / sceneArea;
+
+            for (size_t h = g + 1; h < partition.size(); h++)
+            {
+                if (!groupBounds[h].valid()) continue;
+                AABB overlap = groupBounds[g];
+                overlap.intersection(groupBounds[h]);
+                if (overlap.valid() && overlap.area() > 0.f)
+                {
+                    metrics.overlapArea += overlap.area() / sceneArea;
+                    metrics.overlappingPairs++;
+                }
+            }
+        }
+
+        return metrics;
+    }
+}
@@ -0,0 +1,93 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/AABB.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Partitions a set of meshes into groups, where each group is built into one BLAS.
+
+        The partitioner recursively splits the set of meshes until every group fits the memory budget.
+        Split planes are selected using a binned surface area heuristic (SAH) on the mesh bounding boxes,
+        among the splits that result in the fewest groups. Meshes are not split, so groups may still overlap
+        if individual meshes are large.
+
+        The partitioner operates on bounding boxes and sizes only and is independent of the scene builder,
+        so partitions can be evaluated and compared offline. The scene builder passes the mesh bounding boxes,
+        which are in object space. All meshes in a mesh group share the same instance transforms, so their bounds
+        are in a common space. For static meshes, which are pre-transformed, this is the world space.
+    */
+    class FALCOR_API BLASPartitioner
+    {
+    public:
+        struct Item
+        {
+            AABB bounds;                ///< Object-space bounds of the mesh. All items must share the same space, i.e. the space the BLAS is built in.
+            uint64_t triangleCount = 0; ///< Number of triangles in the mesh.
+        };
+
+        struct Options
+        {
+            uint64_t maxGroupMemory = 512ull << 20; ///< Memory budget per group in bytes. Groups with a single item may exceed the budget.
+            uint64_t bytesPerTriangle = 32;         ///< Estimated BLAS memory per triangle (post-compaction).
+            uint32_t binCount = 16;                 ///< Number of bins per axis used to evaluate split candidates.
+        };
+
+        /** Metrics describing the quality of a partition.
+        */
+        struct Metrics
+        {
+            uint32_t groupCount = 0;        ///< Number of groups.
+            uint64_t maxGroupMemory = 0;    ///< Estimated memory of the largest group in bytes.
+            float sahCost = 0.f;            ///< Sum of group surface area times triangle count, relative to the scene surface area.
+            float overlapArea = 0.f;        ///< Summed surface area of pairwise group bounds intersections, relative to the scene area.
+            uint32_t overlappingPairs = 0;  ///< Number of group pairs with overlapping bounds.
+        };
+
+        using Group = std::vector<uint32_t>;
+        using Partition = std::vector<Group>;
+
+        /** Partition items into groups.
+            \param[in] items Items to partition.
+            \param[in] options Partitioning options.
+            \return List of groups holding item indices. Every item is in exactly one group.
+        */
+        static Partition partition(const std::vector<Item>& items, const Options& options);
+
+        /** Evaluate the quality of a partition.
+            \param[in] items Items that were partitioned.
+            \param[in] partition Groups of item indices.
+            \param[in] options Options used for estimating the group memory.
+            \return Partition metrics.
+        */
+        static Metrics evaluate(const std::vector<Item>& items, const Partition& partition, const Options& options);
+    };
+}
@@ -32,6 +32,11 @@
 #include "Utils/Math/CubicSpline.h"
 #include "Utils/Math/Matrix.h"
 #include "Utils/Math/Quaternion.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
+#include <limits>
+#include <numeric>
 #include <cmath>
 
 namespace Falcor
@@ -203,7 +208,7 @@ namespace Falcor
             FALCOR_ASSERT_LT(std::abs(length(t) - 1.f), 1e-3f);
         }
 
-        void updateMeshResultBuffers(CurveTessellation::MeshResult& result, const CurveArrays& curveArrays, StrandArrays& optimizedStrandArrays, const float3& fwd, const float3& s, const float3& t, uint32_t pointCountPerCrossSection, uint32_t j)
+        void updateMeshResultBuffers(CurveTessellation::MeshResult& result, const CurveArrays& curveArrays, StrandArrays& optimizedStrandArrays, const float3& fwd, const float3& s, const float3& t, uint32_t pointCountPerCrossSection, uint32_t meshVertexOffset, uint32_t j)
         {
             // Mesh vertices, normals, tangents, and texCrds (if any).
             for (uint32_t k = 0; k < pointCountPerCrossSection; k++)
@@ -212,32 +217,117 @@ namespace Falcor
                 float3 vNormal = std::cos(phi) * s + std::sin(phi) * t;
 
                 float curveRadius = 0.5f * optimizedStrandArrays.widths[j];
-                result.vertices.push_back(optimizedStrandArrays.controlPoints[j] + curveRadius * vNormal);
-                result.normals.push_back(vNormal);
-                result.tangents.push_back(float4(fwd.x, fwd.y, fwd.z, 1));
-                result.radii.push_back(curveRadius);
+                uint32_t vertexIndex = meshVertexOffset + j * pointCountPerCrossSection + k;
+                result.vertices[vertexIndex] = optimizedStrandArrays.controlPoints[j] + curveRadius * vNormal;
+                result.normals[vertexIndex] = vNormal;
+                result.tangents[vertexIndex] = float4(fwd.x, fwd.y, fwd.z, 1);
+                result.radii[vertexIndex] = curveRadius;
 
                 if (curveArrays.UVs)
                 {
-                    result.texCrds.push_back(optimizedStrandArrays.UVs[j]);
+                    result.texCrds[vertexIndex] = optimizedStrandArrays.UVs[j];
                 }
             }
         }
 
-        void connectFaceVertices(CurveTessellation::MeshResult& result, uint32_t meshVertexOffset, uint32_t pointCountPerCrossSection, uint32_t quadCountLimit, uint32_t nextCrossSectionVertexOffset, uint32_t multiplier, uint32_t j)
+        void connectFaceVertices(CurveTessellation::MeshResult& result, uint32_t meshVertexOffset, size_t meshFaceOffset, uint32_t pointCountPerCrossSection, uint32_t quadCountLimit, uint32_t nextCrossSectionVertexOffset, uint32_t multiplier, uint32_t j)
         {
+            size_t faceIndex = meshFaceOffset + 2 * (size_t)j * quadCountLimit;
             for (uint32_t k = 0; k < quadCountLimit; k++)
             {
-                result.faceVertexCounts.push_back(3);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-
-                result.faceVertexCounts.push_back(3);
-                result.faceVertexIndices.push_back(meshVertexOffset + multiplier * j * pointCountPerCrossSection + k);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection);
-                result.faceVertexIndices.push_back(meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + k);
+                uint32_t* indices = &result.faceVertexIndices[3 * faceIndex];
+
+                result.faceVertexCounts[faceIndex++] = 3;
+                indices[0] = meshVertexOffset + multiplier * j * pointCountPerCrossSection + k;
+                indices[1] = meshVertexOffset + multiplier * j * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection;
+                indices[2] = meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection;
+
+                result.faceVertexCounts[faceIndex++] = 3;
+                indices[3] = meshVertexOffset + multiplier * j * pointCountPerCrossSection + k;
+                indices[4] = meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + (k + nextCrossSectionVertexOffset) % pointCountPerCrossSection;
+                indices[5] = meshVertexOffset + (multiplier * j + 1) * pointCountPerCrossSection + k;
+            }
+        }
+
+        /** Layout of the tessellated strands in the output arrays.
+            Strands are tessellated in two passes. The first pass counts the number of points each kept strand is tessellated into
+            and computes the output offsets with a prefix sum. The second pass tessellates the strands in parallel, writing directly
+            into the preallocated output arrays.
+        */
+        struct StrandLayout
+        {
+            std::vector<uint32_t> inputOffsets;     ///< Offset of the first control point of each kept strand in the input arrays.
+            std::vector<uint32_t> pointCounts;      ///< Number of tessellated points of each kept strand.
+            std::vector<uint32_t> pointOffsets;     ///< Offset of the first tessellated point of each kept strand.
+            uint32_t strandCount = 0;               ///< Number of kept strands.
+            uint64_t totalPointCount = 0;           ///< Total number of tessellated points.
+        };
+
+        /// Number of kept strands tessellated by each parallel task.
+        const uint32_t kStrandsPerTask = 64;
+
+        /// Scratch memory used by a parallel task.
+        struct StrandScratch
+        {
+            StrandArrays strandArrays;
+            StrandArrays optimizedStrandArrays;
+            CubicSplineCache splineCache;
+        };
+
+        /** Compute the number of tessellated points of a strand.
+            This matches the number of points generated by optimizeStrandGeometry().
+        */
+        uint32_t countStrandPoints(const float3* controlPoints, uint32_t vertexCount, uint32_t subdivPerSegment, uint32_t keepOneEveryXVerticesPerStrand)
+        {
+            // Duplicate control points are removed before tessellation.
+            uint32_t optimizedVertexCount = 1;
+            for (uint32_t j = 0; j < vertexCount - 1; j++)
+            {
+                if (any(controlPoints[j] != controlPoints[j + 1])) optimizedVertexCount++;
             }
+            return div_round_up(subdivPerSegment * (optimizedVertexCount - 1), keepOneEveryXVerticesPerStrand) + 1;
+        }
+
+        StrandLayout computeStrandLayout(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand)
+        {
+            StrandLayout layout;
+            layout.strandCount = div_round_up(strandCount, keepOneEveryXStrands);
+
+            // Offsets of all strands in the input arrays.
+            std::vector<uint32_t> inputOffsets(strandCount);
+            std::exclusive_scan(vertexCountsPerStrand, vertexCountsPerStrand + strandCount, inputOffsets.begin(), 0u);
+
+            layout.inputOffsets.resize(layout.strandCount);
+            layout.pointCounts.resize(layout.strandCount);
+            layout.pointOffsets.resize(layout.strandCount);
+
+            // Count pass.
+            NumericRange<uint32_t> range(0, layout.strandCount);
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t strand)
+            {
+                uint32_t i = strand * keepOneEveryXStrands;
+                layout.inputOffsets[strand] = inputOffsets[i];
+                layout.pointCounts[strand] = countStrandPoints(controlPoints + inputOffsets[i], vertexCountsPerStrand[i], subdivPerSegment, keepOneEveryXVerticesPerStrand);
+            });
+
+            // Compute output offsets.
+            std::exclusive_scan(layout.pointCounts.begin(), layout.pointCounts.end(), layout.pointOffsets.begin(), 0u);
+            for (uint32_t count : layout.pointCounts) layout.totalPointCount += count;
+
+            return layout;
+        }
+
+        /// Run func(scratch, strand) for all kept strands in parallel.
+        template<typename Func>
+        void forEachStrand(const StrandLayout& layout, Func func)
+        {
+            NumericRange<uint32_t> range(0, div_round_up(layout.strandCount, kStrandsPerTask));
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t task)
+            {
+                StrandScratch scratch;
+                uint32_t endStrand = std::min(layout.strandCount, (task + 1) * kStrandsPerTask);
+                for (uint32_t strand = task * kStrandsPerTask; strand < endStrand; strand++) func(scratch, strand);
+            });
         }
     }
 
@@ -250,44 +340,37 @@ namespace Falcor
         FALCOR_ASSERT(degree == 1);
         result.degree = degree;
 
-        uint32_t pointCounts = 0;
-        uint32_t segCounts = 0;
-        uint32_t maxVertexCountsPerStrand = 0;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
-            pointCounts += tmpPointCount;
-            segCounts += tmpPointCount - 1;
-            maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
-        }
-        result.indices.reserve(segCounts);
-        result.points.reserve(pointCounts);
-        result.radius.reserve(pointCounts);
-        result.texCrds.reserve(pointCounts);
+        // Count pass. Each strand with N tessellated points contributes N - 1 segments.
+        StrandLayout layout = computeStrandLayout(strandCount, vertexCountsPerStrand, controlPoints, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand);
+        FALCOR_CHECK(layout.totalPointCount <= std::numeric_limits<uint32_t>::max(), "Too many curve points ({}).", layout.totalPointCount);
 
-        uint32_t pointOffset = 0;
+        result.indices.resize(layout.totalPointCount - layout.strandCount);
+        result.points.resize(layout.totalPointCount);
+        result.radius.resize(layout.totalPointCount);
+        if (UVs) result.texCrds.resize(layout.totalPointCount);
 
-        StrandArrays strandArrays;
-        strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
-        strandArrays.widths.reserve(maxVertexCountsPerStrand);
-        strandArrays.UVs.reserve(maxVertexCountsPerStrand);
         CurveArrays curveArrays(controlPoints, widths, UVs);
 
-        StrandArrays optimizedStrandArrays;
-        CubicSplineCache splineCache;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+        // Fill pass.
+        forEachStrand(layout, [&](StrandScratch& scratch, uint32_t strand)
         {
+            StrandArrays& strandArrays = scratch.strandArrays;
+            StrandArrays& optimizedStrandArrays = scratch.optimizedStrandArrays;
+            CubicSplineCache& splineCache = scratch.splineCache;
+
             optimizedStrandArrays.controlPoints.clear();
             optimizedStrandArrays.UVs.clear();
             optimizedStrandArrays.widths.clear();
             optimizedStrandArrays.vertexCount = 0;
-            strandArrays.vertexCount = vertexCountsPerStrand[i];
+            strandArrays.vertexCount = vertexCountsPerStrand[strand * keepOneEveryXStrands];
 
-            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, layout.inputOffsets[strand], subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
 
             const CubicSpline<float3>& splinePoints = splineCache.splinePoints.setup(strandArrays.controlPoints.data(), optimizedStrandArrays.vertexCount);
             const CubicSpline<float>& splineWidths = splineCache.splineWidths.setup(strandArrays.widths.data(), optimizedStrandArrays.vertexCount);
 
+            uint32_t pointIndex = layout.pointOffsets[strand];
+            uint32_t segmentIndex = pointIndex - strand;
             uint32_t tmpCount = 0;
             for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
             {
@@ -296,13 +379,14 @@ namespace Falcor
                     if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
                     {
                         float t = (float)k / (float)subdivPerSegment;
-                        result.indices.push_back((uint32_t)result.points.size());
+                        result.indices[segmentIndex++] = pointIndex;
 
                         // Pre-transform curve points.
                         float4 sph = transformSphere(xform, float4(splinePoints.interpolate(j, t), sanitizeWidth(splineWidths.interpolate(j, t) * 0.5f * widthScale)));
 
-                        result.points.push_back(sph.xyz());
-                        result.radius.push_back(sph.w);
+                        result.points[pointIndex] = sph.xyz();
+                        result.radius[pointIndex] = sph.w;
+                        pointIndex++;
                     }
                     tmpCount++;
                 }
@@ -310,13 +394,16 @@ namespace Falcor
 
             // Always keep the last vertex.
             float4 sph = transformSphere(xform, float4(splinePoints.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f), sanitizeWidth(splineWidths.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f) * 0.5f * widthScale)));
-            result.points.push_back(sph.xyz());
-            result.radius.push_back(sph.w);
+            result.points[pointIndex] = sph.xyz();
+            result.radius[pointIndex] = sph.w;
+            pointIndex++;
+            FALCOR_ASSERT_EQ(pointIndex, layout.pointOffsets[strand] + layout.pointCounts[strand]);
 
             // Texture coordinates.
             if (UVs)
             {
                 const CubicSpline<float2>& splineUVs = splineCache.splineUVs.setup(strandArrays.UVs.data(), optimizedStrandArrays.vertexCount);
+                uint32_t uvIndex = layout.pointOffsets[strand];
                 tmpCount = 0;
                 for (uint32_t j = 0; j < optimizedStrandArrays.vertexCount - 1; j++)
                 {
@@ -325,18 +412,16 @@ namespace Falcor
                         if (tmpCount % keepOneEveryXVerticesPerStrand == 0)
                         {
                             float t = (float)k / (float)subdivPerSegment;
-                            result.texCrds.push_back(splineUVs.interpolate(j, t));
+                            result.texCrds[uvIndex++] = splineUVs.interpolate(j, t);
                         }
                         tmpCount++;
                     }
                 }
 
                 // Always keep the last vertex.
-                result.texCrds.push_back(splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f));
+                result.texCrds[uvIndex] = splineUVs.interpolate(optimizedStrandArrays.vertexCount - 2, 1.f);
             }
-
-            for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
-        }
+        });
 
         return result;
     }
@@ -344,47 +429,41 @@ namespace Falcor
     CurveTessellation::MeshResult CurveTessellation::convertToPolytube(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, uint32_t subdivPerSegment, uint32_t keepOneEveryXStrands, uint32_t keepOneEveryXVerticesPerStrand, float widthScale, uint32_t pointCountPerCrossSection)
     {
         MeshResult result;
-        uint32_t vertexCounts = 0;
-        uint32_t faceCounts = 0;
-        uint32_t maxVertexCountsPerStrand = 0;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
-        {
-            uint32_t tmpPointCount = div_round_up(subdivPerSegment * (vertexCountsPerStrand[i] - 1), keepOneEveryXVerticesPerStrand) + 1;
-            vertexCounts += pointCountPerCrossSection * tmpPointCount;
-            faceCounts += 2 * pointCountPerCrossSection * (tmpPointCount - 1);
-            maxVertexCountsPerStrand = std::max(maxVertexCountsPerStrand, vertexCountsPerStrand[i]);
-        }
-        result.vertices.reserve(vertexCounts);
-        result.normals.reserve(vertexCounts);
-        result.tangents.reserve(vertexCounts);
-        result.texCrds.reserve(vertexCounts);
-        result.radii.reserve(vertexCounts);
-        result.faceVertexCounts.reserve(faceCounts);
-        result.faceVertexIndices.reserve(faceCounts * 3);
-
-        uint32_t pointOffset = 0;
-        uint32_t meshVertexOffset = 0;
-
-        StrandArrays strandArrays;
-        strandArrays.controlPoints.reserve(maxVertexCountsPerStrand);
-        strandArrays.widths.reserve(maxVertexCountsPerStrand);
-        strandArrays.UVs.reserve(maxVertexCountsPerStrand);
+
+        // Count pass. Each tessellated point is a cross-section of the tube, and consecutive cross-sections are connected with quads.
+        StrandLayout layout = computeStrandLayout(strandCount, vertexCountsPerStrand, controlPoints, subdivPerSegment, keepOneEveryXStrands, keepOneEveryXVerticesPerStrand);
+        const uint64_t vertexCounts = pointCountPerCrossSection * layout.totalPointCount;
+        const uint64_t faceCounts = 2 * pointCountPerCrossSection * (layout.totalPointCount - layout.strandCount);
+        FALCOR_CHECK(vertexCounts <= std::numeric_limits<uint32_t>::max(), "Too many polytube vertices ({}).", vertexCounts);
+
+        result.vertices.resize(vertexCounts);
+        result.normals.resize(vertexCounts);
+        result.tangents.resize(vertexCounts);
+        if (UVs) result.texCrds.resize(vertexCounts);
+        result.radii.resize(vertexCounts);
+        result.faceVertexCounts.resize(faceCounts);
+        result.faceVertexIndices.resize(faceCounts * 3);
+
         CurveArrays curveArrays(controlPoints, widths, UVs);
 
-        StrandArrays optimizedStrandArrays;
-        CubicSplineCache splineCache;
-        for (uint32_t i = 0; i < strandCount; i += keepOneEveryXStrands)
+        // Fill pass.
+        forEachStrand(layout, [&](StrandScratch& scratch, uint32_t strand)
         {
+            StrandArrays& strandArrays = scratch.strandArrays;
+            StrandArrays& optimizedStrandArrays = scratch.optimizedStrandArrays;
+
             optimizedStrandArrays.controlPoints.clear();
             optimizedStrandArrays.UVs.clear();
             optimizedStrandArrays.widths.clear();
             optimizedStrandArrays.vertexCount = 0;
 
-            strandArrays.vertexCount = vertexCountsPerStrand[i];
+            strandArrays.vertexCount = vertexCountsPerStrand[strand * keepOneEveryXStrands];
 
-            optimizeStrandGeometry(splineCache, curveArrays, strandArrays, optimizedStrandArrays, pointOffset, subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+            optimizeStrandGeometry(scratch.splineCache, curveArrays, strandArrays, optimizedStrandArrays, layout.inputOffsets[strand], subdivPerSegment, keepOneEveryXVerticesPerStrand, widthScale);
+            FALCOR_ASSERT_EQ(optimizedStrandArrays.controlPoints.size(), layout.pointCounts[strand]);
 
-            for (uint32_t j = i; j < std::min(strandCount, i + keepOneEveryXStrands); j++) pointOffset += vertexCountsPerStrand[j];
+            const uint32_t meshVertexOffset = pointCountPerCrossSection * layout.pointOffsets[strand];
+            const size_t meshFaceOffset = 2 * (size_t)pointCountPerCrossSection * (layout.pointOffsets[strand] - strand);
 
             // Build the initial frame.
             float3 fwd, s, t;
@@ -399,21 +478,17 @@ namespace Falcor
                 updateCurveFrame(optimizedStrandArrays, fwd, s, t, j);
 
                 // Mesh vertices, normals, tangents, and texCrds (if any).
-                updateMeshResultBuffers(result, curveArrays, optimizedStrandArrays, fwd, s, t, pointCountPerCrossSection, j);
+                updateMeshResultBuffers(result, curveArrays, optimizedStrandArrays, fwd, s, t, pointCountPerCrossSection, meshVertexOffset, j);
 
                 // Mesh faces.
                 if (j < optimizedStrandArrays.controlPoints.size() - 1)
                 {
                     uint32_t quadCountLimit = pointCountPerCrossSection;
-                    connectFaceVertices(result, meshVertexOffset, pointCountPerCrossSection, quadCountLimit, 1, 1, j);
+                    connectFaceVertices(result, meshVertexOffset, meshFaceOffset, pointCountPerCrossSection, quadCountLimit, 1, 1, j);
                 }
             }
-
-            meshVertexOffset += pointCountPerCrossSection * (uint32_t)optimizedStrandArrays.controlPoints.size();
-        }
+        });
 
         return result;
     }
-
-
 }
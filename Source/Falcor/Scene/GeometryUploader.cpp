@@ -0,0 +1,123 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GeometryUploader.h"
+#include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Math/Common.h"
+#include <algorithm>
+#include <cstring>
+
+namespace Falcor
+{
+    namespace
+    {
+        // Staging offsets are kept aligned so that copies of structured data stay on natural boundaries.
+        const size_t kStagingAlignment = 256;
+    }
+
+    GeometryUploader::GeometryUploader(ref<Device> pDevice, size_t stagingBudget, uint32_t stagingBufferCount)
+        : mpDevice(pDevice)
+    {
+        FALCOR_CHECK(stagingBufferCount > 0, "Staging buffer count must be larger than zero.");
+        mStagingBufferSize = std::max(kStagingAlignment, stagingBudget / stagingBufferCount / kStagingAlignment * kStagingAlignment);
+        mStagingBuffers.resize(stagingBufferCount);
+        mpFence = mpDevice->createFence();
+    }
+
+    GeometryUploader::~GeometryUploader()
+    {
+        finish();
+        for (auto& staging : mStagingBuffers)
+        {
+            if (staging.pBuffer) staging.pBuffer->unmap();
+        }
+    }
+
+    void GeometryUploader::upload(const Buffer* pDst, uint64_t dstOffset, const void* pData, size_t size)
+    {
+        FALCOR_CHECK(pDst && dstOffset + size <= pDst->getSize(), "Upload exceeds the destination buffer size.");
+
+        RenderContext* pRenderContext = mpDevice->getRenderContext();
+        const uint8_t* pSrc = static_cast<const uint8_t*>(pData);
+
+        while (size > 0)
+        {
+            StagingBuffer& staging = acquireStagingBuffer();
+            size_t chunkSize = std::min(size, mStagingBufferSize - staging.usedBytes);
+
+            std::memcpy(staging.pData + staging.usedBytes, pSrc, chunkSize);
+            pRenderContext->copyBufferRegion(pDst, dstOffset, staging.pBuffer.get(), staging.usedBytes, chunkSize);
+
+            staging.usedBytes = align_to(kStagingAlignment, staging.usedBytes + chunkSize);
+            pSrc += chunkSize;
+            dstOffset += chunkSize;
+            size -= chunkSize;
+            mUploadedBytes += chunkSize;
+        }
+    }
+
+    void GeometryUploader::finish()
+    {
+        if (mStagingBuffers[mCurrent].usedBytes > 0) submitStagingBuffer();
+        mpFence->wait();
+    }
+
+    GeometryUploader::StagingBuffer& GeometryUploader::acquireStagingBuffer()
+    {
+        // Move on to the next staging buffer once the current one is full.
+        if (mStagingBuffers[mCurrent].usedBytes >= mStagingBufferSize)
+        {
+            submitStagingBuffer();
+            mCurrent = (mCurrent + 1) % (uint32_t)mStagingBuffers.size();
+        }
+
+        StagingBuffer& staging = mStagingBuffers[mCurrent];
+        if (!staging.pBuffer)
+        {
+            staging.pBuffer = mpDevice->createBuffer(mStagingBufferSize, ResourceBindFlags::None, MemoryType::Upload);
+            staging.pBuffer->setName("GeometryUploader::StagingBuffer");
+            staging.pData = static_cast<uint8_t*>(staging.pBuffer->map());
+        }
+        else if (staging.usedBytes == 0 && staging.fenceValue > 0)
+        {
+            // Wait for the GPU to finish copying from the buffer before overwriting it.
+            mpFence->wait(staging.fenceValue);
+        }
+        return staging;
+    }
+
+    void GeometryUploader::submitStagingBuffer()
+    {
+        RenderContext* pRenderContext = mpDevice->getRenderContext();
+        pRenderContext->submit(false);
+
+        StagingBuffer& staging = mStagingBuffers[mCurrent];
+        staging.fenceValue = pRenderContext->signal(mpFence.get());
+        staging.usedBytes = 0;
+    }
+}
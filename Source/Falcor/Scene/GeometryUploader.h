@@ -0,0 +1,113 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Object.h"
+#include "Core/API/Buffer.h"
+#include "Core/API/Fence.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Uploads data to device-local buffers through a ring of staging buffers.
+
+        Buffer::setBlob() and buffer creation with initial data allocate a staging copy of the full upload,
+        so uploading large geometry buffers temporarily doubles their memory footprint. The uploader instead
+        copies the data in chunks through a fixed number of staging buffers. When all staging buffers are in
+        flight, it waits for the GPU to finish with the oldest one before reusing it, which bounds the staging
+        memory to the given budget.
+
+        The copies are recorded on the device's render context. The uploader may be used from a worker thread,
+        but not while other work is recorded on the render context.
+    */
+    class FALCOR_API GeometryUploader
+    {
+    public:
+        static constexpr size_t kDefaultStagingBudget = 64ull << 20;
+        static constexpr uint32_t kDefaultStagingBufferCount = 4;
+
+        /** Create an uploader. Staging buffers are allocated on first use.
+            \param[in] pDevice GPU device.
+            \param[in] stagingBudget Total size of all staging buffers in bytes.
+            \param[in] stagingBufferCount Number of staging buffers in the ring.
+        */
+        GeometryUploader(ref<Device> pDevice, size_t stagingBudget = kDefaultStagingBudget, uint32_t stagingBufferCount = kDefaultStagingBufferCount);
+
+        /** Destructor. Waits for all pending copies to complete.
+        */
+        ~GeometryUploader();
+
+        GeometryUploader(const GeometryUploader&) = delete;
+        GeometryUploader& operator=(const GeometryUploader&) = delete;
+
+        /** Copy data to a region of a buffer. The source data can be released once the call returns.
+            \param[in] pDst Destination buffer.
+            \param[in] dstOffset Offset in bytes into the destination buffer.
+            \param[in] pData Source data.
+            \param[in] size Size of the data in bytes.
+        */
+        void upload(const Buffer* pDst, uint64_t dstOffset, const void* pData, size_t size);
+
+        /** Copy a vector to the start of a buffer.
+        */
+        template<typename T>
+        void upload(const Buffer* pDst, const std::vector<T>& data) { upload(pDst, 0, data.data(), data.size() * sizeof(T)); }
+
+        /** Submit all pending copies and wait for them to complete.
+        */
+        void finish();
+
+        /** Get the total number of bytes uploaded.
+        */
+        uint64_t getUploadedBytes() const { return mUploadedBytes; }
+
+        /** Get the size of a single staging buffer in bytes.
+        */
+        size_t getStagingBufferSize() const { return mStagingBufferSize; }
+
+    private:
+        struct StagingBuffer
+        {
+            ref<Buffer> pBuffer;
+            uint8_t* pData = nullptr;
+            uint64_t fenceValue = 0;    ///< Fence value signaled when the GPU is done with the buffer.
+            size_t usedBytes = 0;
+        };
+
+        StagingBuffer& acquireStagingBuffer();
+        void submitStagingBuffer();
+
+        ref<Device> mpDevice;
+        ref<Fence> mpFence;
+        size_t mStagingBufferSize = 0;
+        std::vector<StagingBuffer> mStagingBuffers;
+        uint32_t mCurrent = 0;
+        uint64_t mUploadedBytes = 0;
+    };
+}
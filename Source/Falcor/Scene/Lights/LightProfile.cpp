@@ -27,13 +27,13 @@
  **************************************************************************/
 #include "LightProfile.h"
 #include "Core/Platform/OS.h"
+#include "Core/Platform/IOService.h"
 #include "Core/API/RenderContext.h"
 #include "Utils/Logger.h"
 #include "Utils/Algorithm/ParallelReduction.h"
 #include "Core/Pass/ComputePass.h"
 
 #include <filesystem>
-#include <fstream>
 
 namespace Falcor
 {
@@ -190,19 +190,17 @@ namespace Falcor
 
     ref<LightProfile> LightProfile::createFromIesProfile(ref<Device> pDevice, const std::filesystem::path& path, bool normalize)
     {
-        std::ifstream ifs(path);
-        if (!ifs.good())
+        std::string str;
+        try
+        {
+            str = IOService::get().read(path);
+        }
+        catch (const RuntimeError&)
         {
             logWarning("Error when loading light profile. Can't open file '{}'", path);
             return nullptr;
         }
 
-        std::string str;
-        ifs.seekg(0, std::ios::end);
-        str.reserve(ifs.tellg());
-        ifs.seekg(0, std::ios::beg);
-        str.assign((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
-
         std::vector<float> numericData;
         float maxCandelas;
         IesStatus status = parseIesFile(str.data(), numericData, maxCandelas);
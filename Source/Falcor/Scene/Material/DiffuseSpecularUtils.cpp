@@ -27,10 +27,10 @@
  **************************************************************************/
 #include "DiffuseSpecularUtils.h"
 #include "DiffuseSpecularData.slang"
+#include "Core/Platform/IOService.h"
 #include "Utils/Logger.h"
 #include "Utils/Color/ColorHelpers.slang"
 #include <nlohmann/json.hpp>
-#include <fstream>
 
 using json = nlohmann::json;
 
@@ -61,8 +61,12 @@ namespace Falcor
         data.metallic = 0.5f;
 
         // Try loading data from json file.
-        std::ifstream ifs(path);
-        if (!ifs.good())
+        std::string contents;
+        try
+        {
+            contents = IOService::get().read(path);
+        }
+        catch (const RuntimeError&)
         {
             logWarning("DiffuseSpecularUtils: Failed to open file '{}' for reading.", path);
             return false;
@@ -70,7 +74,7 @@ namespace Falcor
 
         try
         {
-            json doc = json::parse(ifs);
+            json doc = json::parse(contents);
 
             DiffuseSpecularData d = {};
             float3 baseColorSRGB = {};
@@ -26,12 +26,13 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "MERLFile.h"
+#include "Core/Platform/IOService.h"
 #include "Utils/Logger.h"
 #include "Utils/Image/ImageIO.h"
 #include "Scene/Material/MERLMaterial.h"
 #include "Scene/Material/DiffuseSpecularUtils.h"
 #include "Rendering/Materials/BSDFIntegrator.h"
-#include <fstream>
+#include <cstring>
 
 namespace Falcor
 {
@@ -48,30 +49,84 @@ namespace Falcor
         const double kBlueScale = 1.66 / 1500.0;
 
         const uint32_t kAlbedoLUTSize = MERLMaterialData::kAlbedoLUTSize;
+
+        /** Specifies the version of the cached data.
+            This needs to be incremented every time the preprocessing or the cache entry format changes!
+        */
+        const uint32_t kCacheVersion = 1;
+
+        /** Compute the cache key of a MERL BRDF.
+            The key covers the BRDF file and the JSON sidecar file, which provides the extra data.
+        */
+        AssetCache::Key computeCacheKey(const std::string& contents, const std::filesystem::path& jsonPath)
+        {
+            SHA1 sha1;
+            sha1.update(std::string_view("MERLFile"));
+            sha1.update(kCacheVersion);
+            sha1.update((uint64_t)contents.size());
+            sha1.update(contents.data(), contents.size());
+
+            std::string json;
+            if (std::filesystem::is_regular_file(jsonPath))
+            {
+                try
+                {
+                    json = IOService::get().read(jsonPath);
+                }
+                catch (const RuntimeError&)
+                {
+                    // Hash as missing sidecar, loading the extra data fails in the same way.
+                }
+            }
+            sha1.update((uint64_t)json.size());
+            sha1.update(json.data(), json.size());
+            return sha1.finalize();
+        }
     }
 
-    MERLFile::MERLFile(const std::filesystem::path& path)
+    MERLFile::MERLFile(const std::filesystem::path& path, AssetCache* pCache)
     {
-        if (!loadBRDF(path))
+        if (!loadBRDF(path, pCache))
             FALCOR_THROW("Failed to load MERL BRDF from '{}'", path);
     }
 
-    bool MERLFile::loadBRDF(const std::filesystem::path& path)
+    bool MERLFile::loadBRDF(const std::filesystem::path& path, AssetCache* pCache)
     {
         mDesc = {};
         mData.clear();
         mAlbedoLUT.clear();
+        mpCache = pCache;
+        mCacheKey.reset();
 
-        std::ifstream ifs(path, std::ios_base::in | std::ios_base::binary);
-        if (!ifs.good())
+        std::string contents;
+        try
+        {
+            contents = IOService::get().read(path);
+        }
+        catch (const RuntimeError&)
         {
             logWarning("MERLFile: Failed to open file '{}'.", path);
             return false;
         }
 
+        const auto jsonPath = std::filesystem::path(path).replace_extension("json");
+
+        // Try loading the preprocessed data from the cache.
+        if (mpCache)
+        {
+            mCacheKey = computeCacheKey(contents, jsonPath);
+            if (readCache())
+            {
+                mDesc.path = path;
+                mDesc.name = path.stem().string();
+                logInfo("Loaded MERL BRDF '{}' from cache.", mDesc.name);
+                return true;
+            }
+        }
+
         // Load header.
         int dims[3] = {};
-        ifs.read(reinterpret_cast<char*>(dims), sizeof(int) * 3);
+        std::memcpy(dims, contents.data(), std::min(sizeof(dims), contents.size()));
 
         size_t n = (size_t)dims[0] * dims[1] * dims[2];
         if (n != kBRDFSamplingResThetaH * kBRDFSamplingResThetaD * kBRDFSamplingResPhiD / 2)
@@ -82,12 +137,12 @@ namespace Falcor
 
         // Load BRDF data.
         std::vector<double> data(3 * n);
-        ifs.read(reinterpret_cast<char*>(data.data()), sizeof(double) * 3 * n);
-        if (!ifs.good())
+        if (contents.size() < sizeof(dims) + sizeof(double) * 3 * n)
         {
             logWarning("MERLFile: Failed to load BRDF data from file '{}'.", path);
             return false;
         }
+        std::memcpy(data.data(), contents.data() + sizeof(dims), sizeof(double) * 3 * n);
 
         mDesc.path = path;
         mDesc.name = path.stem().string();
@@ -95,10 +150,11 @@ namespace Falcor
         prepareData(dims, data);
 
         // Load JSON sidecar file if it exists.
-        const auto jsonPath = std::filesystem::path(path).replace_extension("json");
         if (!DiffuseSpecularUtils::loadJSONData(jsonPath, mDesc.extraData))
             logWarning("MERLFile: Failed to load associated JSON data for BRDF '{}'.", mDesc.name);
 
+        if (mpCache) writeCache();
+
         logInfo("Loaded MERL BRDF '{}'.", mDesc.name);
         return true;
     }
@@ -148,7 +204,7 @@ namespace Falcor
             return mAlbedoLUT;
 
         FALCOR_CHECK(!mDesc.path.empty(), "No BRDF loaded");
-        const auto texPath = mDesc.path.replace_extension("dds");
+        const auto texPath = std::filesystem::path(mDesc.path).replace_extension("dds");
 
         // Try loading cached albedo lookup table.
         if (std::filesystem::is_regular_file(texPath))
@@ -163,6 +219,7 @@ namespace Falcor
                 std::copy(data, data + kAlbedoLUTSize, mAlbedoLUT.begin());
 
                 logInfo("Loaded albedo LUT from '{}'.", texPath.string());
+                if (mpCache) writeCache();
                 return mAlbedoLUT;
             }
         }
@@ -180,9 +237,45 @@ namespace Falcor
             logInfo("Saved albedo LUT to '{}'.", texPath);
         }
 
+        if (mpCache) writeCache();
+
         return mAlbedoLUT;
     }
 
+    bool MERLFile::readCache()
+    {
+        FALCOR_ASSERT(mpCache && mCacheKey);
+
+        std::vector<uint8_t> data;
+        if (!mpCache->read(*mCacheKey, data)) return false;
+
+        AssetCache::Reader reader(data);
+        DiffuseSpecularData extraData;
+        std::vector<float3> brdf;
+        std::vector<float4> albedoLut;
+        if (!reader.read(extraData) || !reader.read(brdf) || !reader.read(albedoLut) || !reader.isAtEnd()) return false;
+
+        // The albedo lookup table is optional, it is added to the entry once it has been prepared.
+        const size_t n = kBRDFSamplingResThetaH * kBRDFSamplingResThetaD * kBRDFSamplingResPhiD / 2;
+        if (brdf.size() != n || (!albedoLut.empty() && albedoLut.size() != kAlbedoLUTSize)) return false;
+
+        mDesc.extraData = extraData;
+        mData = std::move(brdf);
+        mAlbedoLUT = std::move(albedoLut);
+        return true;
+    }
+
+    void MERLFile::writeCache() const
+    {
+        FALCOR_ASSERT(mpCache && mCacheKey);
+
+        AssetCache::Writer writer;
+        writer.write(mDesc.extraData);
+        writer.write(mData);
+        writer.write(mAlbedoLUT);
+        mpCache->write(*mCacheKey, writer.getData());
+    }
+
     void MERLFile::computeAlbedoLUT(ref<Device> pDevice, const size_t binCount)
     {
         logInfo("MERLFile: Computing albedo LUT for MERL BRDF '{}'...", mDesc.name);
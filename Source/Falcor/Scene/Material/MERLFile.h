@@ -29,9 +29,11 @@
 #include "Core/API/fwd.h"
 #include "Core/API/Formats.h"
 #include "Utils/Math/Vector.h"
+#include "Scene/AssetCache.h"
 #include "Scene/Material/DiffuseSpecularData.slang"
 #include <filesystem>
 #include <memory>
+#include <optional>
 
 namespace Falcor
 {
@@ -56,17 +58,21 @@ namespace Falcor
 
         /** Constructs a new object and loads a MERL BRDF. Throws on error.
             \param[in] path Path to the binary MERL file.
+            \param[in] pCache Optional cache for the preprocessed BRDF data and albedo lookup table. Must outlive the object.
         */
-        MERLFile(const std::filesystem::path& path);
+        MERLFile(const std::filesystem::path& path, AssetCache* pCache = nullptr);
 
         /** Loads a MERL BRDF.
+            When a cache is given, the preprocessed data is looked up by the hash of the file contents
+            and written to the cache on a miss. This function is thread-safe for different objects.
             \param[in] path Path to the binary MERL file.
+            \param[in] pCache Optional cache for the preprocessed BRDF data and albedo lookup table. Must outlive the object.
             \return True if the BRDF was successfully loaded.
         */
-        bool loadBRDF(const std::filesystem::path& path);
+        bool loadBRDF(const std::filesystem::path& path, AssetCache* pCache = nullptr);
 
         /** Prepare an albedo lookup table.
-            The table is loaded from disk or recomputed if needed.
+            The table is loaded from the cache or disk, or recomputed if needed.
             \param[in] pDevice The device.
             \return Albedo lookup table that can be used with `kAlbedoLUTFormat`.
         */
@@ -78,9 +84,14 @@ namespace Falcor
     private:
         void prepareData(const int dims[3], const std::vector<double>& data);
         void computeAlbedoLUT(ref<Device> pDevice, const size_t binCount);
+        bool readCache();
+        void writeCache() const;
 
         Desc mDesc;                     ///< BRDF description and sampling parameters.
         std::vector<float3> mData;      ///< BRDF data in RGB float format.
         std::vector<float4> mAlbedoLUT; ///< Precomputed albedo lookup table.
+
+        AssetCache* mpCache = nullptr;              ///< Cache for the preprocessed data, or nullptr if disabled.
+        std::optional<AssetCache::Key> mCacheKey;   ///< Cache key of the loaded BRDF.
     };
 }
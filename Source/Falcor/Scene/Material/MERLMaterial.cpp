@@ -43,10 +43,10 @@ namespace Falcor
         const char kShaderFile[] = "Rendering/Materials/MERLMaterial.slang";
     }
 
-    MERLMaterial::MERLMaterial(ref<Device> pDevice, const std::string& name, const std::filesystem::path& path)
+    MERLMaterial::MERLMaterial(ref<Device> pDevice, const std::string& name, const std::filesystem::path& path, AssetCache* pCache)
         : Material(pDevice, name, MaterialType::MERL)
     {
-        MERLFile merlFile(path);
+        MERLFile merlFile(path, pCache);
         init(merlFile);
 
         // Create albedo LUT texture.
@@ -158,7 +158,8 @@ namespace Falcor
         pybind11::class_<MERLMaterial, Material, ref<MERLMaterial>> material(m, "MERLMaterial");
         auto create = [] (const std::string& name, const std::filesystem::path& path)
         {
-            return MERLMaterial::create(accessActivePythonSceneBuilder().getDevice(), name, getActiveAssetResolver().resolvePath(path));
+            auto& sceneBuilder = accessActivePythonSceneBuilder();
+            return MERLMaterial::create(sceneBuilder.getDevice(), name, getActiveAssetResolver().resolvePath(path), sceneBuilder.getAssetCache());
         };
         material.def(pybind11::init(create), "name"_a, "path"_a); // PYTHONDEPRECATED
     }
@@ -32,6 +32,7 @@
 namespace Falcor
 {
     class MERLFile;
+    class AssetCache;
 
     /** Class representing a measured material from the MERL BRDF database.
 
@@ -44,9 +45,15 @@ namespace Falcor
     {
         FALCOR_OBJECT(MERLMaterial)
     public:
-        static ref<MERLMaterial> create(ref<Device> pDevice, const std::string& name, const std::filesystem::path& path) { return make_ref<MERLMaterial>(pDevice, name, path); }
+        static ref<MERLMaterial> create(ref<Device> pDevice, const std::string& name, const std::filesystem::path& path, AssetCache* pCache = nullptr) { return make_ref<MERLMaterial>(pDevice, name, path, pCache); }
 
-        MERLMaterial(ref<Device> pDevice, const std::string& name, const std::filesystem::path& path);
+        /** Create a material from a MERL BRDF file. Throws on error.
+            \param[in] pDevice The device.
+            \param[in] name The material name.
+            \param[in] path Path to the binary MERL file.
+            \param[in] pCache Optional cache for the preprocessed BRDF data and albedo lookup table.
+        */
+        MERLMaterial(ref<Device> pDevice, const std::string& name, const std::filesystem::path& path, AssetCache* pCache = nullptr);
         MERLMaterial(ref<Device> pDevice, const MERLFile& merlFile);
 
         bool renderUI(Gui::Widgets& widget) override;
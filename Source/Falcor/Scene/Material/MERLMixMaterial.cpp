@@ -27,13 +27,16 @@
  **************************************************************************/
 #include "MERLMixMaterial.h"
 #include "Core/API/Device.h"
+#include "Core/Platform/IOService.h"
 #include "Utils/Logger.h"
 #include "Utils/BufferAllocator.h"
+#include "Utils/NumericRange.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "GlobalState.h"
 #include "Scene/Material/MERLFile.h"
 #include "Scene/Material/MaterialSystem.h"
 #include "Scene/Material/DiffuseSpecularUtils.h"
+#include <execution>
 #include <fstream>
 
 namespace Falcor
@@ -46,7 +49,7 @@ namespace Falcor
         const char kShaderFile[] = "Rendering/Materials/MERLMixMaterial.slang";
     }
 
-    MERLMixMaterial::MERLMixMaterial(ref<Device> pDevice, const std::string& name, const std::vector<std::filesystem::path>& paths)
+    MERLMixMaterial::MERLMixMaterial(ref<Device> pDevice, const std::string& name, const std::vector<std::filesystem::path>& paths, AssetCache* pCache)
         : Material(pDevice, name, MaterialType::MERLMix)
     {
         FALCOR_CHECK(!paths.empty(), "MERLMixMaterial: Expected at least one path.");
@@ -55,18 +58,34 @@ namespace Falcor
         mTextureSlotInfo[(uint32_t)TextureSlot::Normal] = { "normal", TextureChannelFlags::RGB, false };
         mTextureSlotInfo[(uint32_t)TextureSlot::Index] = { "index", TextureChannelFlags::Red, false };
 
-        // Load all BRDFs.
+        // Start reading the BRDFs and their JSON sidecar files in the background.
+        // The hints are dropped when leaving the constructor, also if loading fails.
+        std::vector<std::filesystem::path> readAheadPaths;
+        for (const auto& path : paths)
+        {
+            readAheadPaths.push_back(path);
+            readAheadPaths.push_back(std::filesystem::path(path).replace_extension("json"));
+        }
+        auto readAhead = IOService::get().readAhead(readAheadPaths);
+
+        // Load and preprocess all BRDFs in parallel.
+        std::vector<MERLFile> merlFiles(paths.size());
+        std::vector<uint8_t> loaded(paths.size());
+        auto range = NumericRange<size_t>(0, paths.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) { loaded[i] = merlFiles[i].loadBRDF(paths[i], pCache); });
+
+        // Gather the BRDFs. The albedo lookup tables may need to be computed on the GPU, which is done serially.
         mBRDFs.resize(paths.size());
         std::vector<DiffuseSpecularData> extraData(paths.size());
         std::vector<float4> albedoLut;
         BufferAllocator buffer(128, 0 /* raw buffer */, 128, ResourceBindFlags::ShaderResource);
-        MERLFile merlFile;
 
         for (size_t i = 0; i < paths.size(); i++)
         {
-            if (!merlFile.loadBRDF(paths[i]))
+            if (!loaded[i])
                 FALCOR_THROW("MERLMixMaterial: Failed to load BRDF from '{}'.", paths[i]);
 
+            auto& merlFile = merlFiles[i];
             auto& desc = mBRDFs[i];
             desc.path = merlFile.getDesc().path;
             desc.name = merlFile.getDesc().name;
@@ -83,6 +102,9 @@ namespace Falcor
             const auto& lut = merlFile.prepareAlbedoLUT(mpDevice);
             FALCOR_CHECK(lut.size() == MERLMixMaterialData::kAlbedoLUTSize, "MERLMixMaterial: Unexpected albedo LUT size.");
             albedoLut.insert(albedoLut.end(), lut.begin(), lut.end());
+
+            // Release the BRDF samples once they are copied.
+            merlFile = MERLFile();
         }
 
         mData.brdfCount = static_cast<uint32_t>(mBRDFs.size());
@@ -317,7 +339,8 @@ namespace Falcor
         pybind11::class_<MERLMixMaterial, Material, ref<MERLMixMaterial>> material(m, "MERLMixMaterial");
         auto create = [](const std::string& name, const std::vector<std::filesystem::path>& paths)
         {
-            return MERLMixMaterial::create(accessActivePythonSceneBuilder().getDevice(), name, paths);
+            auto& sceneBuilder = accessActivePythonSceneBuilder();
+            return MERLMixMaterial::create(sceneBuilder.getDevice(), name, paths, sceneBuilder.getAssetCache());
         };
         material.def(pybind11::init(create), "name"_a, "paths"_a); // PYTHONDEPRECATED
     }
@@ -31,6 +31,7 @@
 
 namespace Falcor
 {
+    class AssetCache;
     class BufferAllocator;
 
     /** Measured material that can mix BRDFs from the MERL BRDF database.
@@ -47,9 +48,15 @@ namespace Falcor
     {
         FALCOR_OBJECT(MERLMixMaterial)
     public:
-        static ref<MERLMixMaterial> create(ref<Device> pDevice, const std::string& name, const std::vector<std::filesystem::path>& paths) { return make_ref<MERLMixMaterial>(pDevice, name, paths); }
+        static ref<MERLMixMaterial> create(ref<Device> pDevice, const std::string& name, const std::vector<std::filesystem::path>& paths, AssetCache* pCache = nullptr) { return make_ref<MERLMixMaterial>(pDevice, name, paths, pCache); }
 
-        MERLMixMaterial(ref<Device> pDevice, const std::string& name, const std::vector<std::filesystem::path>& paths);
+        /** Create a material mixing a set of MERL BRDFs. The BRDFs are loaded in parallel. Throws on error.
+            \param[in] pDevice The device.
+            \param[in] name The material name.
+            \param[in] paths Paths to the binary MERL files.
+            \param[in] pCache Optional cache for the preprocessed BRDF data and albedo lookup tables.
+        */
+        MERLMixMaterial(ref<Device> pDevice, const std::string& name, const std::vector<std::filesystem::path>& paths, AssetCache* pCache = nullptr);
 
         bool renderUI(Gui::Widgets& widget) override;
         Material::UpdateFlags update(MaterialSystem* pOwner) override;
@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "RGLFile.h"
 #include "Core/Error.h"
+#include <cstring>
 
 namespace Falcor
 {
@@ -133,11 +134,15 @@ namespace Falcor
         mMeasurement = MeasurementData{thetaI, phiI, sigma, ndf, vndf, rgb, luminance, isotropic, std::move(descString)};
     }
 
-    RGLFile::RGLFile(std::ifstream& in)
+    RGLFile::RGLFile(const void* pData, size_t size)
     {
-        auto readBytes = [&](void* dst, size_t size)
+        const uint8_t* pBytes = reinterpret_cast<const uint8_t*>(pData);
+        uint64_t pos = 0;
+        auto readBytes = [&](void* dst, size_t byteCount)
         {
-            in.read(reinterpret_cast<char*>(dst), size);
+            if (pos + byteCount > size) FALCOR_THROW("Error parsing RGL field: File truncated");
+            std::memcpy(dst, pBytes + pos, byteCount);
+            pos += byteCount;
         };
 
         uint8_t header[12];
@@ -182,8 +187,6 @@ namespace Falcor
             field.shape.reset(new uint64_t[fieldDim]);
             readBytes(field.shape.get(), 8 * fieldDim);
 
-            if (!in.good()) FALCOR_THROW("Error parsing RGL field: File truncated");
-
             size_t elemSize = fieldSize(FieldType(fieldType));
             if (elemSize == 0)
             {
@@ -200,10 +203,10 @@ namespace Falcor
 
             field.data.reset(new uint8_t[N * elemSize]);
 
-            uint64_t pos = in.tellg();
-            in.seekg(offset);
+            uint64_t fieldPos = pos;
+            pos = offset;
             readBytes(field.data.get(), N * elemSize);
-            in.seekg(pos);
+            pos = fieldPos;
 
             mFieldMap.insert(std::make_pair(std::string(fieldName), int(mFields.size())));
             mFields.emplace_back(std::move(field));
@@ -75,9 +75,11 @@ namespace Falcor
 
         RGLFile() = default;
 
-        /** Loads RGL measured BRDF file and validates contents. Throws Falcor::Exception on failure.
+        /** Loads RGL measured BRDF file from memory and validates contents. Throws Falcor::Exception on failure.
+            \param[in] pData Pointer to the file contents.
+            \param[in] size Size of the file contents in bytes.
         */
-        RGLFile(std::ifstream& in);
+        RGLFile(const void* pData, size_t size);
 
         void saveFile(std::ofstream& out) const;
 
@@ -29,12 +29,12 @@
 #include "RGLFile.h"
 #include "RGLCommon.h"
 #include "Core/API/Device.h"
+#include "Core/Platform/IOService.h"
 #include "Utils/Logger.h"
 #include "Utils/Image/ImageIO.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "GlobalState.h"
 #include "Rendering/Materials/BSDFIntegrator.h"
-#include <fstream>
 
 namespace Falcor
 {
@@ -48,15 +48,96 @@ namespace Falcor
         const ResourceFormat kAlbedoLUTFormat = ResourceFormat::RGBA32Float;
 
         const std::string kLoadFile = "load";
+
+        /** Specifies the version of the cached data.
+            This needs to be incremented every time the preprocessing or the cache entry format changes!
+        */
+        const uint32_t kCacheVersion = 1;
+
+        AssetCache::Key computeCacheKey(const std::string& contents)
+        {
+            SHA1 sha1;
+            sha1.update(std::string_view("RGLMaterial"));
+            sha1.update(kCacheVersion);
+            sha1.update((uint64_t)contents.size());
+            sha1.update(contents.data(), contents.size());
+            return sha1.finalize();
+        }
+
+        std::vector<float> getFieldData(const RGLFile::Field* field)
+        {
+            const float* pData = reinterpret_cast<const float*>(field->data.get());
+            return std::vector<float>(pData, pData + field->numElems);
+        }
+
+        void writeBRDFData(AssetCache::Writer& writer, const RGLMaterial::BRDFData& brdf, const std::vector<float4>& albedoLUT)
+        {
+            writer.write(brdf.description);
+            writer.write(brdf.phiSize);
+            writer.write(brdf.thetaSize);
+            writer.write(brdf.sigmaSize);
+            writer.write(brdf.ndfSize);
+            writer.write(brdf.vndfSize);
+            writer.write(brdf.lumiSize);
+            writer.write(brdf.theta);
+            writer.write(brdf.phi);
+            writer.write(brdf.sigma);
+            writer.write(brdf.ndf);
+            writer.write(brdf.rgb);
+            writer.write(brdf.vndfPDF);
+            writer.write(brdf.vndfMarginal);
+            writer.write(brdf.vndfConditional);
+            writer.write(brdf.lumiPDF);
+            writer.write(brdf.lumiMarginal);
+            writer.write(brdf.lumiConditional);
+            writer.write(albedoLUT);
+        }
+
+        bool readBRDFData(AssetCache::Reader& reader, RGLMaterial::BRDFData& brdf)
+        {
+            if (!(reader.read(brdf.description) && reader.read(brdf.phiSize) && reader.read(brdf.thetaSize) &&
+                reader.read(brdf.sigmaSize) && reader.read(brdf.ndfSize) && reader.read(brdf.vndfSize) && reader.read(brdf.lumiSize) &&
+                reader.read(brdf.theta) && reader.read(brdf.phi) && reader.read(brdf.sigma) && reader.read(brdf.ndf) && reader.read(brdf.rgb) &&
+                reader.read(brdf.vndfPDF) && reader.read(brdf.vndfMarginal) && reader.read(brdf.vndfConditional) &&
+                reader.read(brdf.lumiPDF) && reader.read(brdf.lumiMarginal) && reader.read(brdf.lumiConditional) &&
+                reader.read(brdf.albedoLUT) && reader.isAtEnd()))
+            {
+                return false;
+            }
+
+            // Validate table sizes, the GPU buffers are created from these.
+            const size_t sliceCount = (size_t)brdf.phiSize * brdf.thetaSize;
+            const size_t vndfSize = sliceCount * brdf.vndfSize.x * brdf.vndfSize.y;
+            const size_t lumiSize = sliceCount * brdf.lumiSize.x * brdf.lumiSize.y;
+            return brdf.phi.size() == brdf.phiSize && brdf.theta.size() == brdf.thetaSize &&
+                brdf.sigma.size() == (size_t)brdf.sigmaSize.x * brdf.sigmaSize.y && brdf.ndf.size() == (size_t)brdf.ndfSize.x * brdf.ndfSize.y &&
+                brdf.rgb.size() == 3 * lumiSize &&
+                brdf.vndfPDF.size() == vndfSize && brdf.vndfConditional.size() == vndfSize && brdf.vndfMarginal.size() == sliceCount * brdf.vndfSize.y &&
+                brdf.lumiPDF.size() == lumiSize && brdf.lumiConditional.size() == lumiSize && brdf.lumiMarginal.size() == sliceCount * brdf.lumiSize.y &&
+                (brdf.albedoLUT.empty() || brdf.albedoLUT.size() == kAlbedoLUTSize);
+        }
     }
 
-    RGLMaterial::RGLMaterial(ref<Device> pDevice, const std::string& name, const std::filesystem::path& path)
+    RGLMaterial::RGLMaterial(ref<Device> pDevice, const std::string& name, const std::filesystem::path& path, AssetCache* pCache)
         : Material(pDevice, name, MaterialType::RGL)
     {
-        if (!loadBRDF(path))
+        BRDFData brdf;
+        if (!prepareBRDF(path, pCache, brdf))
         {
             FALCOR_THROW("RGLMaterial() - Failed to load BRDF from '{}'.", path);
         }
+        init(brdf, pCache);
+    }
+
+    RGLMaterial::RGLMaterial(ref<Device> pDevice, const std::string& name, const BRDFData& brdf, AssetCache* pCache)
+        : Material(pDevice, name, MaterialType::RGL)
+    {
+        init(brdf, pCache);
+    }
+
+    void RGLMaterial::init(const BRDFData& brdf, AssetCache* pCache)
+    {
+        uploadBRDF(brdf);
 
         // Create resources for albedo lookup table.
         Sampler::Desc desc;
@@ -65,7 +146,7 @@ namespace Falcor
         desc.setMaxAnisotropy(1);
         mpSampler = mpDevice->createSampler(desc);
 
-        prepareAlbedoLUT(mpDevice->getRenderContext());
+        prepareAlbedoLUT(mpDevice->getRenderContext(), brdf, pCache);
     }
 
     bool RGLMaterial::renderUI(Gui::Widgets& widget)
@@ -145,17 +226,50 @@ namespace Falcor
 
     bool RGLMaterial::loadBRDF(const std::filesystem::path& path)
     {
-        std::ifstream ifs(path, std::ios_base::in | std::ios_base::binary);
-        if (!ifs.good())
+        BRDFData brdf;
+        if (!prepareBRDF(path, nullptr, brdf)) return false;
+        uploadBRDF(brdf);
+        return true;
+    }
+
+    bool RGLMaterial::prepareBRDF(const std::filesystem::path& path, AssetCache* pCache, BRDFData& brdf)
+    {
+        brdf = {};
+
+        std::string contents;
+        try
+        {
+            contents = IOService::get().read(path);
+        }
+        catch (const RuntimeError&)
         {
             logWarning("RGLMaterial::loadBRDF() - Failed to open file '{}'.", path);
             return false;
         }
 
+        // Try loading the preprocessed data from the cache.
+        if (pCache)
+        {
+            brdf.cacheKey = computeCacheKey(contents);
+            std::vector<uint8_t> data;
+            if (pCache->read(*brdf.cacheKey, data))
+            {
+                AssetCache::Reader reader(data);
+                BRDFData cached;
+                if (readBRDFData(reader, cached))
+                {
+                    cached.path = path;
+                    cached.cacheKey = brdf.cacheKey;
+                    brdf = std::move(cached);
+                    return true;
+                }
+            }
+        }
+
         std::unique_ptr<RGLFile> file;
         try
         {
-            file.reset(new RGLFile(ifs));
+            file.reset(new RGLFile(contents.data(), contents.size()));
         }
         catch(const RuntimeError& e)
         {
@@ -163,12 +277,6 @@ namespace Falcor
             return false;
         }
 
-        if (!ifs.good())
-        {
-            logWarning("RGLMaterial::loadBRDF() - Failed to load BRDF data from file '{}': Read error.", path);
-            return false;
-        }
-
         auto theta = file->data().thetaI;
         auto phi   = file->data().phiI;
         auto sigma = file->data().sigma;
@@ -186,82 +294,142 @@ namespace Falcor
             return false;
         }
 
-        mPath = path;
-        mBRDFName = std::filesystem::path(path).stem().string();
-        mBRDFDescription = file->data().description;
+        brdf.path = path;
+        brdf.description = file->data().description;
 
-        mData.phiSize = uint(phi->shape[0]);
-        mData.thetaSize = uint(theta->shape[0]);
-        mData.sigmaSize = uint2(sigma->shape[1], sigma->shape[0]);
-        mData.  ndfSize = uint2(ndf  ->shape[1], ndf  ->shape[0]);
-        mData. vndfSize = uint2(vndf ->shape[3], vndf ->shape[2]);
-        mData. lumiSize = uint2(lumi ->shape[3], lumi ->shape[2]);
+        brdf.phiSize = uint(phi->shape[0]);
+        brdf.thetaSize = uint(theta->shape[0]);
+        brdf.sigmaSize = uint2(sigma->shape[1], sigma->shape[0]);
+        brdf.  ndfSize = uint2(ndf  ->shape[1], ndf  ->shape[0]);
+        brdf. vndfSize = uint2(vndf ->shape[3], vndf ->shape[2]);
+        brdf. lumiSize = uint2(lumi ->shape[3], lumi ->shape[2]);
 
-        uint4 vndfSize = uint4(mData.phiSize, mData.thetaSize, mData.vndfSize.x, mData.vndfSize.y);
-        uint4 lumiSize = uint4(mData.phiSize, mData.thetaSize, mData.lumiSize.x, mData.lumiSize.y);
-        auto prod3 = [&](uint4 v) { return v.x * v.y * v.z; };
+        uint4 vndfSize = uint4(brdf.phiSize, brdf.thetaSize, brdf.vndfSize.x, brdf.vndfSize.y);
+        uint4 lumiSize = uint4(brdf.phiSize, brdf.thetaSize, brdf.lumiSize.x, brdf.lumiSize.y);
+        auto marginalSize = [&](uint4 v) { return v.x * v.y * v.w; };
         auto prod4 = [&](uint4 v) { return v.x * v.y * v.z * v.w; };
 
         SamplableDistribution4D vndfDist(reinterpret_cast<float*>(vndf->data.get()), vndfSize);
         SamplableDistribution4D lumiDist(reinterpret_cast<float*>(lumi->data.get()), lumiSize);
 
-        mpVNDFMarginalBuf    = mpDevice->createBuffer(prod3(vndfSize) * 4, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, vndfDist.getMarginal());
-        mpLumiMarginalBuf    = mpDevice->createBuffer(prod3(lumiSize) * 4, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, lumiDist.getMarginal());
-        mpVNDFConditionalBuf = mpDevice->createBuffer(prod4(vndfSize) * 4, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, vndfDist.getConditional());
-        mpLumiConditionalBuf = mpDevice->createBuffer(prod4(lumiSize) * 4, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, lumiDist.getConditional());
+        brdf.vndfMarginal.assign(vndfDist.getMarginal(), vndfDist.getMarginal() + marginalSize(vndfSize));
+        brdf.lumiMarginal.assign(lumiDist.getMarginal(), lumiDist.getMarginal() + marginalSize(lumiSize));
+        brdf.vndfConditional.assign(vndfDist.getConditional(), vndfDist.getConditional() + prod4(vndfSize));
+        brdf.lumiConditional.assign(lumiDist.getConditional(), lumiDist.getConditional() + prod4(lumiSize));
+        brdf.vndfPDF.assign(vndfDist.getPDF(), vndfDist.getPDF() + vndf->numElems);
+        brdf.lumiPDF.assign(lumiDist.getPDF(), lumiDist.getPDF() + lumi->numElems);
+
+        brdf.theta = getFieldData(theta);
+        brdf.phi   = getFieldData(phi);
+        brdf.sigma = getFieldData(sigma);
+        brdf.ndf   = getFieldData(ndf);
+        brdf.rgb   = getFieldData(rgb);
 
-        mpThetaBuf = mpDevice->createBuffer(theta->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, theta->data.get());
-        mpPhiBuf   = mpDevice->createBuffer(phi  ->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, phi  ->data.get());
-        mpSigmaBuf = mpDevice->createBuffer(sigma->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, sigma->data.get());
-        mpNDFBuf   = mpDevice->createBuffer(ndf  ->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, ndf  ->data.get());
-        mpVNDFBuf  = mpDevice->createBuffer(vndf ->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, vndfDist.getPDF());
-        mpLumiBuf  = mpDevice->createBuffer(lumi ->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, lumiDist.getPDF());
-        mpRGBBuf   = mpDevice->createBuffer(rgb  ->numElems * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, rgb  ->data.get());
+        if (pCache)
+        {
+            AssetCache::Writer writer;
+            writeBRDFData(writer, brdf, {});
+            pCache->write(*brdf.cacheKey, writer.getData());
+        }
+
+        return true;
+    }
+
+    void RGLMaterial::uploadBRDF(const BRDFData& brdf)
+    {
+        mPath = brdf.path;
+        mBRDFName = std::filesystem::path(brdf.path).stem().string();
+        mBRDFDescription = brdf.description;
+
+        mData.phiSize = brdf.phiSize;
+        mData.thetaSize = brdf.thetaSize;
+        mData.sigmaSize = brdf.sigmaSize;
+        mData.  ndfSize = brdf.ndfSize;
+        mData. vndfSize = brdf.vndfSize;
+        mData. lumiSize = brdf.lumiSize;
+
+        auto createBuffer = [&](const std::vector<float>& data)
+        {
+            return mpDevice->createBuffer(data.size() * sizeof(float), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, data.data());
+        };
+
+        mpVNDFMarginalBuf    = createBuffer(brdf.vndfMarginal);
+        mpLumiMarginalBuf    = createBuffer(brdf.lumiMarginal);
+        mpVNDFConditionalBuf = createBuffer(brdf.vndfConditional);
+        mpLumiConditionalBuf = createBuffer(brdf.lumiConditional);
+
+        mpThetaBuf = createBuffer(brdf.theta);
+        mpPhiBuf   = createBuffer(brdf.phi);
+        mpSigmaBuf = createBuffer(brdf.sigma);
+        mpNDFBuf   = createBuffer(brdf.ndf);
+        mpVNDFBuf  = createBuffer(brdf.vndfPDF);
+        mpLumiBuf  = createBuffer(brdf.lumiPDF);
+        mpRGBBuf   = createBuffer(brdf.rgb);
 
         markUpdates(Material::UpdateFlags::ResourcesChanged);
 
         logInfo("Loaded RGL BRDF '{}': {}.", mBRDFName, mBRDFDescription);
-
-        return true;
     }
 
-    void RGLMaterial::prepareAlbedoLUT(RenderContext* pRenderContext) // TODO
+    void RGLMaterial::prepareAlbedoLUT(RenderContext* pRenderContext, const BRDFData& brdf, AssetCache* pCache)
     {
-        const auto texPath = mPath.replace_extension("dds");
+        std::vector<float4> albedoLUT = brdf.albedoLUT;
 
-        // Try loading albedo lookup table.
-        if (std::filesystem::is_regular_file(texPath))
+        if (albedoLUT.empty())
         {
-            // Load 1D texture in non-SRGB format, no mips.
-            // If successful, verify dimensions/format/etc. match the expectations.
-            mpAlbedoLUT = Texture::createFromFile(mpDevice, texPath.string(), false, false, ResourceBindFlags::ShaderResource);
+            const auto texPath = std::filesystem::path(mPath).replace_extension("dds");
 
-            if (mpAlbedoLUT)
+            // Try loading albedo lookup table.
+            // If successful, verify dimensions/format match the expectations.
+            if (std::filesystem::is_regular_file(texPath))
             {
-                if (mpAlbedoLUT->getFormat() == kAlbedoLUTFormat &&
-                    mpAlbedoLUT->getWidth() == kAlbedoLUTSize &&
-                    mpAlbedoLUT->getHeight() == 1 && mpAlbedoLUT->getDepth() == 1 &&
-                    mpAlbedoLUT->getMipCount() == 1 && mpAlbedoLUT->getArraySize() == 1)
+                Bitmap::UniqueConstPtr pBitmap;
+                try
                 {
+                    pBitmap = ImageIO::loadBitmapFromDDS(texPath);
+                }
+                catch (const RuntimeError& e)
+                {
+                    logWarning("Failed to load albedo LUT from '{}': {}", texPath.string(), e.what());
+                }
+
+                if (pBitmap && pBitmap->getFormat() == kAlbedoLUTFormat &&
+                    pBitmap->getWidth() == kAlbedoLUTSize && pBitmap->getHeight() == 1)
+                {
+                    const float4* data = reinterpret_cast<const float4*>(pBitmap->getData());
+                    albedoLUT.assign(data, data + kAlbedoLUTSize);
+
                     logInfo("Loaded albedo LUT from '{}'.", texPath.string());
-                    return;
                 }
             }
-        }
 
-        // Failed to load a valid lookup table. We'll recompute it.
-        computeAlbedoLUT(pRenderContext);
+            if (albedoLUT.empty())
+            {
+                // Failed to load a valid lookup table. We'll recompute it.
+                albedoLUT = computeAlbedoLUT(pRenderContext);
+
+                // Cache lookup table in texture on disk.
+                const auto pBitmap = Bitmap::create(kAlbedoLUTSize, 1, kAlbedoLUTFormat, reinterpret_cast<const uint8_t*>(albedoLUT.data()));
+                ImageIO::saveToDDS(texPath, *pBitmap, ImageIO::CompressionMode::None, false);
+
+                logInfo("Saved albedo LUT to '{}'.", texPath.string());
+            }
 
-        // Cache lookup table in texture on disk.
-        // TODO: Capture texture to DDS is not yet supported. Calling ImageIO directly for now.
-        //mpAlbedoLUT->captureToFile(0, 0, texPath.string(), Bitmap::FileFormat::DdsFile, Bitmap::ExportFlags::Uncompressed);
-        FALCOR_ASSERT(mpAlbedoLUT);
-        ImageIO::saveToDDS(pRenderContext, texPath.string(), mpAlbedoLUT, ImageIO::CompressionMode::None, false);
+            // Add the lookup table to the cache entry.
+            if (pCache && brdf.cacheKey)
+            {
+                AssetCache::Writer writer;
+                writeBRDFData(writer, brdf, albedoLUT);
+                pCache->write(*brdf.cacheKey, writer.getData());
+            }
+        }
 
-        logInfo("Saved albedo LUT to '{}'.", texPath.string());
+        // Create albedo LUT texture.
+        static_assert(kAlbedoLUTFormat == ResourceFormat::RGBA32Float);
+        mpAlbedoLUT = mpDevice->createTexture2D(kAlbedoLUTSize, 1, kAlbedoLUTFormat, 1, 1, albedoLUT.data(), ResourceBindFlags::ShaderResource);
     }
 
-    void RGLMaterial::computeAlbedoLUT(RenderContext* pRenderContext) // TODO
+    std::vector<float4> RGLMaterial::computeAlbedoLUT(RenderContext* pRenderContext)
     {
         logInfo("Computing albedo LUT for RGL BRDF '{}'...", mBRDFName);
 
@@ -289,12 +457,9 @@ namespace Falcor
         auto albedos = integrator.integrateIsotropic(pRenderContext, materialID, cosThetas);
 
         // Copy result into format needed for texture creation.
-        static_assert(kAlbedoLUTFormat == ResourceFormat::RGBA32Float);
-        std::vector<float4> initData(kAlbedoLUTSize, float4(0.f));
-        for (uint32_t i = 0; i < kAlbedoLUTSize; i++) initData[i] = float4(albedos[i], 1.f);
-
-        // Create albedo LUT texture.
-        mpAlbedoLUT = mpDevice->createTexture2D(kAlbedoLUTSize, 1, kAlbedoLUTFormat, 1, 1, initData.data(), ResourceBindFlags::ShaderResource);
+        std::vector<float4> albedoLUT(kAlbedoLUTSize, float4(0.f));
+        for (uint32_t i = 0; i < kAlbedoLUTSize; i++) albedoLUT[i] = float4(albedos[i], 1.f);
+        return albedoLUT;
     }
 
     FALCOR_SCRIPT_BINDING(RGLMaterial)
@@ -306,7 +471,8 @@ namespace Falcor
         pybind11::class_<RGLMaterial, Material, ref<RGLMaterial>> material(m, "RGLMaterial");
         auto create = [] (const std::string& name, const std::filesystem::path& path)
         {
-            return RGLMaterial::create(accessActivePythonSceneBuilder().getDevice(), name, getActiveAssetResolver().resolvePath(path));
+            auto& sceneBuilder = accessActivePythonSceneBuilder();
+            return RGLMaterial::create(sceneBuilder.getDevice(), name, getActiveAssetResolver().resolvePath(path), sceneBuilder.getAssetCache());
         };
         material.def(pybind11::init(create), "name"_a, "path"_a); // PYTHONDEPRECATED
         material.def(kLoadFile.c_str(), &RGLMaterial::loadBRDF, "path"_a);
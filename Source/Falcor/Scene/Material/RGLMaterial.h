@@ -28,7 +28,11 @@
 #pragma once
 #include "Material.h"
 #include "RGLMaterialData.slang"
+#include "Scene/AssetCache.h"
 #include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace Falcor
 {
@@ -43,9 +47,65 @@ namespace Falcor
     {
         FALCOR_OBJECT(RGLMaterial)
     public:
-        static ref<RGLMaterial> create(ref<Device> pDevice, const std::string& name, const std::filesystem::path& path) { return make_ref<RGLMaterial>(pDevice, name, path); }
+        /** Preprocessed BRDF data, ready to be uploaded to the GPU.
+        */
+        struct BRDFData
+        {
+            std::filesystem::path path;         ///< Full path to the BRDF file.
+            std::string description;            ///< Description of the BRDF given in the BRDF file.
 
-        RGLMaterial(ref<Device> pDevice, const std::string& name, const std::filesystem::path& path);
+            uint32_t phiSize = 0;
+            uint32_t thetaSize = 0;
+            uint2 sigmaSize = {};
+            uint2 ndfSize = {};
+            uint2 vndfSize = {};
+            uint2 lumiSize = {};
+
+            std::vector<float> theta;
+            std::vector<float> phi;
+            std::vector<float> sigma;
+            std::vector<float> ndf;
+            std::vector<float> rgb;
+            std::vector<float> vndfPDF;
+            std::vector<float> vndfMarginal;
+            std::vector<float> vndfConditional;
+            std::vector<float> lumiPDF;
+            std::vector<float> lumiMarginal;
+            std::vector<float> lumiConditional;
+
+            std::vector<float4> albedoLUT;              ///< Albedo lookup table, or empty if not cached.
+            std::optional<AssetCache::Key> cacheKey;    ///< Cache key, or empty if loaded without a cache.
+        };
+
+        static ref<RGLMaterial> create(ref<Device> pDevice, const std::string& name, const std::filesystem::path& path, AssetCache* pCache = nullptr) { return make_ref<RGLMaterial>(pDevice, name, path, pCache); }
+        static ref<RGLMaterial> create(ref<Device> pDevice, const std::string& name, const BRDFData& brdf, AssetCache* pCache = nullptr) { return make_ref<RGLMaterial>(pDevice, name, brdf, pCache); }
+
+        /** Create a material from an RGL BRDF file. Throws on error.
+            \param[in] pDevice The device.
+            \param[in] name The material name.
+            \param[in] path Path to the RGL file.
+            \param[in] pCache Optional cache for the preprocessed BRDF data and albedo lookup table.
+        */
+        RGLMaterial(ref<Device> pDevice, const std::string& name, const std::filesystem::path& path, AssetCache* pCache = nullptr);
+
+        /** Create a material from preprocessed BRDF data, see prepareBRDF().
+            \param[in] pDevice The device.
+            \param[in] name The material name.
+            \param[in] brdf Preprocessed BRDF data.
+            \param[in] pCache Optional cache to store the albedo lookup table in, if it is not part of the BRDF data.
+        */
+        RGLMaterial(ref<Device> pDevice, const std::string& name, const BRDFData& brdf, AssetCache* pCache = nullptr);
+
+        /** Load and preprocess an RGL BRDF file without accessing the GPU.
+            This function is thread-safe, which allows preparing the BRDFs of a scene in parallel.
+            When a cache is given, the preprocessed data is looked up by the hash of the file contents
+            and written to the cache on a miss.
+            \param[in] path Path to the RGL file.
+            \param[in] pCache Optional cache for the preprocessed BRDF data.
+            \param[out] brdf Preprocessed BRDF data.
+            \return True if the BRDF was successfully loaded.
+        */
+        static bool prepareBRDF(const std::filesystem::path& path, AssetCache* pCache, BRDFData& brdf);
 
         bool renderUI(Gui::Widgets& widget) override;
         Material::UpdateFlags update(MaterialSystem* pOwner) override;
@@ -59,9 +119,10 @@ namespace Falcor
         bool loadBRDF(const std::filesystem::path& path);
 
     protected:
-        void prepareData(const int dims[3], const std::vector<double>& data);
-        void prepareAlbedoLUT(RenderContext* pRenderContext);
-        void computeAlbedoLUT(RenderContext* pRenderContext);
+        void init(const BRDFData& brdf, AssetCache* pCache);
+        void uploadBRDF(const BRDFData& brdf);
+        void prepareAlbedoLUT(RenderContext* pRenderContext, const BRDFData& brdf, AssetCache* pCache);
+        std::vector<float4> computeAlbedoLUT(RenderContext* pRenderContext);
 
         std::filesystem::path mPath;        ///< Full path to the BRDF loaded.
         std::string mBRDFName;              ///< This is the file basename without extension.
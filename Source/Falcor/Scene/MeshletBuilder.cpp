@@ -0,0 +1,210 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshletBuilder.h"
+#include "Core/Error.h"
+#include "Utils/Math/AABB.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kInvalidIndex = 0xffffffff;
+
+        /** Compute the bounding sphere and normal cone of a meshlet.
+        */
+        void computeBounds(MeshletDesc& meshlet, const MeshletBuilder::Meshlets& result, fstd::span<const float3> positions)
+        {
+            AABB bounds;
+            for (uint32_t i = 0; i < meshlet.vertexCount; i++) bounds.include(positions[result.vertices[meshlet.vertexOffset + i]]);
+
+            meshlet.center = bounds.center();
+            meshlet.radius = 0.f;
+            for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+            {
+                meshlet.radius = std::max(meshlet.radius, length(positions[result.vertices[meshlet.vertexOffset + i]] - meshlet.center));
+            }
+
+            // The cone axis is the average of the unit triangle normals, and the half-angle is the largest deviation from it.
+            std::vector<float3> normals;
+            normals.reserve(meshlet.triangleCount);
+            float3 axis(0.f);
+            for (uint32_t t = 0; t < meshlet.triangleCount; t++)
+            {
+                uint3 local = MeshletBuilder::unpackTriangle(result.triangles[meshlet.triangleOffset + t]);
+                const float3& p0 = positions[result.vertices[meshlet.vertexOffset + local.x]];
+                const float3& p1 = positions[result.vertices[meshlet.vertexOffset + local.y]];
+                const float3& p2 = positions[result.vertices[meshlet.vertexOffset + local.z]];
+                float3 n = cross(p1 - p0, p2 - p0);
+                float len = length(n);
+                if (len == 0.f) continue; // Degenerate triangles don't affect the cone.
+                normals.push_back(n / len);
+                axis += normals.back();
+            }
+
+            meshlet.coneAxis = float3(0.f, 0.f, 1.f);
+            meshlet.coneCutoff = 1.f;
+
+            float axisLength = length(axis);
+            if (normals.empty() || axisLength < 1e-6f) return;
+            axis /= axisLength;
+
+            float minDot = 1.f;
+            for (const auto& n : normals) minDot = std::min(minDot, dot(n, axis));
+
+            meshlet.coneAxis = axis;
+            if (minDot > 0.f) meshlet.coneCutoff = std::sqrt(std::max(0.f, 1.f - minDot * minDot));
+        }
+    }
+
+    MeshletBuilder::Meshlets MeshletBuilder::build(fstd::span<const uint32_t> indices, fstd::span<const float3> positions, const Options& options)
+    {
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count must be a multiple of 3.");
+        FALCOR_CHECK(options.maxVertices >= 3 && options.maxVertices <= kMaxVertexCount, "Meshlet vertex limit must be in [3, {}].", kMaxVertexCount);
+        FALCOR_CHECK(options.maxTriangles >= 1 && options.maxTriangles <= kMaxTriangleCount, "Meshlet triangle limit must be in [1, {}].", kMaxTriangleCount);
+
+        const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+        const uint32_t vertexCount = (uint32_t)positions.size();
+
+        Meshlets result;
+        if (triangleCount == 0) return result;
+
+        // Build vertex to triangle adjacency.
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (uint32_t v : indices)
+        {
+            FALCOR_CHECK(v < vertexCount, "Vertex index {} is out of range.", v);
+            adjacencyOffsets[v + 1]++;
+        }
+        for (uint32_t v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (uint32_t t = 0; t < triangleCount; t++)
+            {
+                for (uint32_t k = 0; k < 3; k++) adjacency[fill[indices[t * 3 + k]]++] = t;
+            }
+        }
+
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> localIndex(vertexCount, kInvalidIndex);  // Meshlet-local index of each vertex in the current meshlet.
+        std::vector<uint32_t> candidates;                               // Triangles adjacent to the current meshlet.
+        uint32_t seedCursor = 0;
+
+        MeshletDesc meshlet = {};
+
+        auto countNewVertices = [&](uint32_t t)
+        {
+            uint32_t count = 0;
+            for (uint32_t k = 0; k < 3; k++) count += localIndex[indices[t * 3 + k]] == kInvalidIndex ? 1 : 0;
+            return count;
+        };
+
+        auto fits = [&](uint32_t t)
+        {
+            return meshlet.triangleCount < options.maxTriangles && meshlet.vertexCount + countNewVertices(t) <= options.maxVertices;
+        };
+
+        auto addTriangle = [&](uint32_t t)
+        {
+            uint32_t packed = 0;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                uint32_t v = indices[t * 3 + k];
+                if (localIndex[v] == kInvalidIndex)
+                {
+                    localIndex[v] = meshlet.vertexCount++;
+                    result.vertices.push_back(v);
+                    for (uint32_t i = adjacencyOffsets[v]; i < adjacencyOffsets[v + 1]; i++)
+                    {
+                        if (!emitted[adjacency[i]]) candidates.push_back(adjacency[i]);
+                    }
+                }
+                packed |= localIndex[v] << (8 * k);
+            }
+            result.triangles.push_back(packed);
+            meshlet.triangleCount++;
+            emitted[t] = true;
+        };
+
+        auto finishMeshlet = [&]()
+        {
+            computeBounds(meshlet, result, positions);
+            for (uint32_t i = 0; i < meshlet.vertexCount; i++) localIndex[result.vertices[meshlet.vertexOffset + i]] = kInvalidIndex;
+            result.meshlets.push_back(meshlet);
+
+            meshlet = {};
+            meshlet.vertexOffset = (uint32_t)result.vertices.size();
+            meshlet.triangleOffset = (uint32_t)result.triangles.size();
+            candidates.clear();
+        };
+
+        uint32_t remaining = triangleCount;
+        while (remaining > 0)
+        {
+            // Pick the adjacent triangle that adds the fewest new vertices.
+            uint32_t best = kInvalidIndex;
+            uint32_t bestNewVertices = 4;
+            size_t writeIndex = 0;
+            for (size_t i = 0; i < candidates.size(); i++)
+            {
+                uint32_t t = candidates[i];
+                if (emitted[t]) continue;
+                candidates[writeIndex++] = t; // Compact the candidate list while scanning.
+                uint32_t newVertices = countNewVertices(t);
+                if (newVertices < bestNewVertices && fits(t))
+                {
+                    best = t;
+                    bestNewVertices = newVertices;
+                }
+            }
+            candidates.resize(writeIndex);
+
+            if (best == kInvalidIndex)
+            {
+                // No adjacent triangle fits. Continue with the next triangle in order if the meshlet has run out of
+                // adjacent triangles and there is room, otherwise start a new meshlet.
+                while (emitted[seedCursor]) seedCursor++;
+                if (meshlet.triangleCount > 0 && (!candidates.empty() || !fits(seedCursor)))
+                {
+                    finishMeshlet();
+                    continue;
+                }
+                best = seedCursor;
+            }
+
+            addTriangle(best);
+            remaining--;
+        }
+
+        if (meshlet.triangleCount > 0) finishMeshlet();
+
+        return result;
+    }
+}
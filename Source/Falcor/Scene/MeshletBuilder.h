@@ -0,0 +1,76 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SceneTypes.slang"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Partitions triangle meshes into meshlets with a bounded number of vertices and triangles.
+
+        Triangles are added greedily to the current meshlet, preferring triangles that share the most vertices with it,
+        which keeps meshlets spatially compact. A new meshlet is started when no adjacent triangle fits.
+        The triangle order of the input is used for seeding, so cache or spatially optimized meshes give better results.
+        Each meshlet stores a bounding sphere and a normal cone for cluster culling.
+    */
+    class FALCOR_API MeshletBuilder
+    {
+    public:
+        static constexpr uint32_t kMaxVertexCount = 256;     ///< Upper limit on vertices per meshlet due to 8-bit local indices.
+        static constexpr uint32_t kMaxTriangleCount = 256;   ///< Upper limit on triangles per meshlet.
+
+        struct Options
+        {
+            uint32_t maxVertices = 64;      ///< Maximum number of vertices per meshlet.
+            uint32_t maxTriangles = 124;    ///< Maximum number of triangles per meshlet.
+        };
+
+        struct Meshlets
+        {
+            std::vector<MeshletDesc> meshlets;  ///< Meshlets. Offsets are relative to the vertex and triangle lists below.
+            std::vector<uint32_t> vertices;     ///< Mesh-local vertex indices referenced by the meshlets.
+            std::vector<uint32_t> triangles;    ///< Meshlet-local vertex indices, three 8-bit indices packed per triangle.
+        };
+
+        /** Partition a triangle mesh into meshlets.
+            \param[in] indices Triangle list indices.
+            \param[in] positions Vertex positions.
+            \param[in] options Meshlet size limits.
+            \return Meshlets covering every triangle exactly once.
+        */
+        static Meshlets build(fstd::span<const uint32_t> indices, fstd::span<const float3> positions, const Options& options);
+
+        /** Unpack the meshlet-local vertex indices of a triangle.
+        */
+        static uint3 unpackTriangle(uint32_t packed) { return uint3(packed & 0xff, (packed >> 8) & 0xff, (packed >> 16) & 0xff); }
+    };
+}
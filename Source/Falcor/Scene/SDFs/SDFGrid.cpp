@@ -34,6 +34,7 @@
 #include "Core/Error.h"
 #include "Core/API/Device.h"
 #include "Core/API/RenderContext.h"
+#include "Core/Platform/IOService.h"
 #include "Utils/Logger.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/Matrix.h"
@@ -299,26 +300,29 @@ namespace Falcor
 
     bool SDFGrid::loadValuesFromFile(const std::filesystem::path& path)
     {
-        std::ifstream file(path, std::ios::in | std::ios::binary);
-
-        if (file.is_open())
+        std::string contents;
+        try
+        {
+            contents = IOService::get().read(path);
+        }
+        catch (const RuntimeError&)
         {
-            uint32_t gridWidth;
-            file.read(reinterpret_cast<char*>(&gridWidth), sizeof(uint32_t));
+            logWarning("SDFGrid::loadValuesFromFile() file '{}' could not be opened!", path);
+            return false;
+        }
 
-            uint32_t totalValueCount = (gridWidth + 1) * (gridWidth + 1) * (gridWidth + 1);
-            std::vector<float> cornerValues(totalValueCount, 0.0f);
-            file.read(reinterpret_cast<char*>(cornerValues.data()), totalValueCount * sizeof(float));
+        uint32_t gridWidth = 0;
+        std::memcpy(&gridWidth, contents.data(), std::min(sizeof(uint32_t), contents.size()));
 
-            file.close();
-            setValues(cornerValues, gridWidth);
+        uint32_t totalValueCount = (gridWidth + 1) * (gridWidth + 1) * (gridWidth + 1);
+        std::vector<float> cornerValues(totalValueCount, 0.0f);
+        if (contents.size() > sizeof(uint32_t))
+            std::memcpy(cornerValues.data(), contents.data() + sizeof(uint32_t), std::min(totalValueCount * sizeof(float), contents.size() - sizeof(uint32_t)));
 
-            mInitializedWithPrimitives = false;
-            return true;
-        }
+        setValues(cornerValues, gridWidth);
 
-        logWarning("SDFGrid::loadValuesFromFile() file '{}' could not be opened!", path);
-        return false;
+        mInitializedWithPrimitives = false;
+        return true;
     }
 
     void SDFGrid::generateCheeseValues(uint32_t gridWidth, uint32_t seed)
@@ -408,8 +412,12 @@ namespace Falcor
 
     uint32_t SDFGrid::loadPrimitivesFromFile(const std::filesystem::path& path, uint32_t gridWidth)
     {
-        std::ifstream ifs(path);
-        if (!ifs.good())
+        std::string contents;
+        try
+        {
+            contents = IOService::get().read(path);
+        }
+        catch (const RuntimeError&)
         {
             logWarning("Failed to open SDF grid file '{}' for reading.", path);
             return false;
@@ -418,7 +426,7 @@ namespace Falcor
         std::vector<SDF3DPrimitive> primitives;
         try
         {
-            json j = json::parse(ifs);
+            json j = json::parse(contents);
             primitives = j;
         }
         catch (const std::exception& e)
@@ -29,6 +29,8 @@
 #include "SceneDefines.slangh"
 #include "SceneBuilder.h"
 #include "Importer.h"
+#include "MeshIOTypes.slang"
+#include "GeometryUploader.h"
 #include "Scene/Material/SerializedMaterialParams.h"
 #include "Curves/CurveConfig.h"
 #include "SDFs/SDFGrid.h"
@@ -70,6 +72,9 @@ namespace Falcor
         const std::string kParameterBlockName = "gScene";
         const std::string kGeometryInstanceBufferName = "geometryInstances";
         const std::string kMeshBufferName = "meshes";
+        const std::string kMeshletBufferName = "meshlets";
+        const std::string kMeshletVertexBufferName = "meshletVertices";
+        const std::string kMeshletTriangleBufferName = "meshletTriangles";
         const std::string kIndexBufferName = "indexData";
         const std::string kVertexBufferName = "vertices";
         const std::string kPrevVertexBufferName = "prevVertices";
@@ -224,9 +229,10 @@ namespace Falcor
         setSDFGridConfig();
 
         // Create vertex array objects for meshes and curves.
-        createMeshVao(sceneData.meshDrawCount, sceneData.meshIndexData, sceneData.meshStaticData, sceneData.meshSkinningData);
+        createMeshVao(sceneData.meshDrawCount, sceneData.meshIndexData, sceneData.meshStaticData, sceneData.pMeshIndexBuffer, sceneData.pMeshStaticDataBuffer);
         createCurveVao(mCurveIndexData, mCurveStaticData);
         createMeshUVTiles(mMeshDesc, sceneData.meshIndexData, sceneData.meshStaticData);
+        createMeshletBuffers(sceneData.meshlets, sceneData.meshletVertices, sceneData.meshletTriangles);
 
         // Create animation controller.
         mpAnimationController = std::make_unique<AnimationController>(mpDevice, this, sceneData.meshStaticData, sceneData.meshSkinningData, sceneData.prevVertexCount, sceneData.animations);
@@ -257,7 +263,7 @@ namespace Falcor
         }
 
         // Must be placed after curve data/AABB creation.
-        mpAnimationController->addAnimatedVertexCaches(std::move(sceneData.cachedCurves), std::move(sceneData.cachedMeshes), sceneData.meshStaticData);
+        mpAnimationController->addAnimatedVertexCaches(std::move(sceneData.cachedCurves), std::move(sceneData.cachedMeshes), sceneData.meshStaticData, sceneData.vertexCacheStreaming);
 
         // Finalize scene.
         finalize();
@@ -424,7 +430,7 @@ namespace Falcor
         pRenderContext->raytrace(pProgram, pVars.get(), dispatchDims.x, dispatchDims.y, dispatchDims.z);
     }
 
-    void Scene::createMeshVao(uint32_t drawCount, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData, const std::vector<SkinningVertexData>& skinningData)
+    void Scene::createMeshVao(uint32_t drawCount, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData, ref<Buffer> pIB, ref<Buffer> pStaticBuffer)
     {
         if (drawCount == 0) return;
 
@@ -435,11 +441,19 @@ namespace Falcor
             FALCOR_THROW("Index buffer size exceeds 4GB");
         }
 
-        ref<Buffer> pIB;
-        if (ibSize > 0)
+        // The buffers may have been uploaded already by the scene builder.
+        // Otherwise the data is streamed through a bounded amount of staging memory.
+        GeometryUploader uploader(mpDevice);
+
+        if (pIB)
+        {
+            FALCOR_CHECK(pIB->getSize() == ibSize, "Mesh index buffer size mismatch.");
+        }
+        else if (ibSize > 0)
         {
             ResourceBindFlags ibBindFlags = ResourceBindFlags::Index | ResourceBindFlags::ShaderResource;
-            pIB = mpDevice->createBuffer(ibSize, ibBindFlags, MemoryType::DeviceLocal, indexData.data());
+            pIB = mpDevice->createBuffer(ibSize, ibBindFlags, MemoryType::DeviceLocal, nullptr);
+            uploader.upload(pIB.get(), indexData);
         }
 
         // Create the vertex data structured buffer.
@@ -450,12 +464,17 @@ namespace Falcor
             FALCOR_THROW("Vertex buffer size exceeds 4GB");
         }
 
-        ref<Buffer> pStaticBuffer;
-        if (vertexCount > 0)
+        if (pStaticBuffer)
+        {
+            FALCOR_CHECK(pStaticBuffer->getSize() == staticVbSize, "Mesh vertex buffer size mismatch.");
+        }
+        else if (vertexCount > 0)
         {
             ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::Vertex;
             pStaticBuffer = mpDevice->createStructuredBuffer(sizeof(PackedStaticVertexData), (uint32_t)vertexCount, vbBindFlags, MemoryType::DeviceLocal, nullptr, false);
+            uploader.upload(pStaticBuffer.get(), staticData);
         }
+        uploader.finish();
 
         Vao::BufferVec pVBs(kVertexBufferCount);
         pVBs[kStaticDataBufferIndex] = pStaticBuffer;
@@ -556,6 +575,18 @@ namespace Falcor
         mpCurveVao = Vao::create(Vao::Topology::LineStrip, pLayout, pVBs, pIB, ResourceFormat::R32Uint);
     }
 
+    void Scene::createMeshletBuffers(const std::vector<MeshletDesc>& meshlets, const std::vector<uint32_t>& meshletVertices, const std::vector<uint32_t>& meshletTriangles)
+    {
+        if (meshlets.empty()) return;
+
+        mpMeshletsBuffer = mpDevice->createStructuredBuffer(sizeof(MeshletDesc), (uint32_t)meshlets.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, meshlets.data(), false);
+        mpMeshletsBuffer->setName("Scene::mpMeshletsBuffer");
+        mpMeshletVerticesBuffer = mpDevice->createStructuredBuffer(sizeof(uint32_t), (uint32_t)meshletVertices.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, meshletVertices.data(), false);
+        mpMeshletVerticesBuffer->setName("Scene::mpMeshletVerticesBuffer");
+        mpMeshletTrianglesBuffer = mpDevice->createStructuredBuffer(sizeof(uint32_t), (uint32_t)meshletTriangles.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, meshletTriangles.data(), false);
+        mpMeshletTrianglesBuffer->setName("Scene::mpMeshletTrianglesBuffer");
+    }
+
     void Scene::createMeshUVTiles(const std::vector<MeshDesc>& meshDescs, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData)
     {
         const uint8_t* indexData8 = reinterpret_cast<const uint8_t*>(indexData.data());
@@ -829,6 +860,9 @@ namespace Falcor
         var[kMeshBufferName] = mpMeshesBuffer;
         var[kCurveBufferName] = mpCurvesBuffer;
         var[kGeometryInstanceBufferName] = mpGeometryInstancesBuffer;
+        var[kMeshletBufferName] = mpMeshletsBuffer;
+        var[kMeshletVertexBufferName] = mpMeshletVerticesBuffer;
+        var[kMeshletTriangleBufferName] = mpMeshletTrianglesBuffer;
 
         FALCOR_ASSERT(mpAnimationController);
         mpAnimationController->bindBuffers();
@@ -1328,6 +1362,7 @@ namespace Falcor
         auto& s = mSceneStats;
 
         s.meshCount = getMeshCount();
+        s.meshletCount = mpMeshletsBuffer ? mpMeshletsBuffer->getElementCount() : 0;
         s.meshInstanceCount = 0;
         s.meshInstanceOpaqueCount = 0;
         s.transformCount = getAnimationController()->getGlobalMatrices().size();
@@ -1432,6 +1467,9 @@ namespace Falcor
 
         s.geometryMemoryInBytes += mpGeometryInstancesBuffer ? mpGeometryInstancesBuffer->getSize() : 0;
         s.geometryMemoryInBytes += mpMeshesBuffer ? mpMeshesBuffer->getSize() : 0;
+        s.geometryMemoryInBytes += mpMeshletsBuffer ? mpMeshletsBuffer->getSize() : 0;
+        s.geometryMemoryInBytes += mpMeshletVerticesBuffer ? mpMeshletVerticesBuffer->getSize() : 0;
+        s.geometryMemoryInBytes += mpMeshletTrianglesBuffer ? mpMeshletTrianglesBuffer->getSize() : 0;
         s.geometryMemoryInBytes += mpCurvesBuffer ? mpCurvesBuffer->getSize() : 0;
         s.geometryMemoryInBytes += mpCustomPrimitivesBuffer ? mpCustomPrimitivesBuffer->getSize() : 0;
         s.geometryMemoryInBytes += mpRtAABBBuffer ? mpRtAABBBuffer->getSize() : 0;
@@ -2178,6 +2216,7 @@ namespace Falcor
             // Geometry stats.
             oss << "Geometry stats:" << std::endl
                 << "  Mesh count: " << s.meshCount << std::endl
+                << "  Meshlet count: " << s.meshletCount << std::endl
                 << "  Mesh instance count (total): " << s.meshInstanceCount << std::endl
                 << "  Mesh instance count (opaque): " << s.meshInstanceOpaqueCount << std::endl
                 << "  Mesh instance count (non-opaque): " << (s.meshInstanceCount - s.meshInstanceOpaqueCount) << std::endl
@@ -4135,12 +4174,102 @@ namespace Falcor
         updateForInverseRendering(mpDevice->getRenderContext(), false, true);
     }
 
+    void Scene::prepareMeshBatch(const std::vector<MeshID>& meshIDs, uint32_t& vertexCount, uint32_t& triangleCount)
+    {
+        std::vector<MeshIODesc> descs(meshIDs.size());
+        uint64_t totalVertexCount = 0;
+        uint64_t totalTriangleCount = 0;
+        for (size_t i = 0; i < meshIDs.size(); ++i)
+        {
+            FALCOR_CHECK(meshIDs[i].get() < mMeshDesc.size(), "Invalid mesh ID {}.", meshIDs[i].get());
+            const auto& meshDesc = getMesh(meshIDs[i]);
+            auto& desc = descs[i];
+            desc.vertexCount = meshDesc.vertexCount;
+            desc.vbOffset = meshDesc.vbOffset;
+            desc.triangleCount = meshDesc.getTriangleCount();
+            desc.ibOffset = meshDesc.ibOffset;
+            desc.vertexOffset = (uint32_t)totalVertexCount;
+            desc.triangleOffset = (uint32_t)totalTriangleCount;
+            desc.use16BitIndices = meshDesc.use16BitIndices() ? 1 : 0;
+            totalVertexCount += desc.vertexCount;
+            totalTriangleCount += desc.triangleCount;
+        }
+        FALCOR_CHECK(totalVertexCount <= std::numeric_limits<uint32_t>::max(), "Mesh batch has too many vertices.");
+        FALCOR_CHECK(totalTriangleCount <= std::numeric_limits<uint32_t>::max(), "Mesh batch has too many triangles.");
+
+        // Reuse the mesh desc buffer between batches, it only grows.
+        if (!mpMeshBatchBuffer || mpMeshBatchBuffer->getElementCount() < descs.size())
+        {
+            mpMeshBatchBuffer = mpDevice->createStructuredBuffer(sizeof(MeshIODesc), (uint32_t)descs.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
+            mpMeshBatchBuffer->setName("Scene::mpMeshBatchBuffer");
+        }
+        mpMeshBatchBuffer->setBlob(descs.data(), 0, descs.size() * sizeof(MeshIODesc));
+
+        vertexCount = (uint32_t)totalVertexCount;
+        triangleCount = (uint32_t)totalTriangleCount;
+    }
+
+    void Scene::getMeshBatchVerticesAndIndices(const std::vector<MeshID>& meshIDs, const std::map<std::string, ref<Buffer>>& buffers)
+    {
+        if (meshIDs.empty()) return;
+        if (!mpLoadMeshBatchPass)
+            mpLoadMeshBatchPass = ComputePass::create(mpDevice, kMeshIOShaderFilename, "getMeshBatchVerticesAndIndices", getSceneDefines());
+
+        uint32_t vertexCount = 0;
+        uint32_t triangleCount = 0;
+        prepareMeshBatch(meshIDs, vertexCount, triangleCount);
+
+        // Bind variables.
+        auto var = mpLoadMeshBatchPass->getRootVar()["meshBatchLoader"];
+        var["meshCount"] = (uint32_t)meshIDs.size();
+        var["vertexCount"] = vertexCount;
+        var["triangleCount"] = triangleCount;
+        var["meshes"] = mpMeshBatchBuffer;
+        bindShaderData(var["scene"]);
+        for (const auto& name : kMeshLoaderRequiredBufferNames)
+        {
+            FALCOR_CHECK(buffers.find(name) != buffers.end(), "Mesh data buffer '{}' is missing.", name);
+            var[name] = buffers.at(name);
+        }
+
+        mpLoadMeshBatchPass->execute(mpDevice->getRenderContext(), std::max(vertexCount, triangleCount), 1, 1);
+    }
+
+    void Scene::setMeshBatchVertices(const std::vector<MeshID>& meshIDs, const std::map<std::string, ref<Buffer>>& buffers)
+    {
+        if (meshIDs.empty()) return;
+        if (!mpUpdateMeshBatchPass)
+            mpUpdateMeshBatchPass = ComputePass::create(mpDevice, kMeshIOShaderFilename, "setMeshBatchVertices", getSceneDefines());
+
+        uint32_t vertexCount = 0;
+        uint32_t triangleCount = 0;
+        prepareMeshBatch(meshIDs, vertexCount, triangleCount);
+
+        // Bind variables.
+        auto var = mpUpdateMeshBatchPass->getRootVar()["meshBatchUpdater"];
+        var["meshCount"] = (uint32_t)meshIDs.size();
+        var["vertexCount"] = vertexCount;
+        var["meshes"] = mpMeshBatchBuffer;
+        var["vertexData"] = getMeshVao()->getVertexBuffer(kStaticDataBufferIndex);
+        for (const auto& name : kMeshUpdaterRequiredBufferNames)
+        {
+            FALCOR_CHECK(buffers.find(name) != buffers.end(), "Mesh data buffer '{}' is missing.", name);
+            var[name] = buffers.at(name);
+        }
+
+        mpUpdateMeshBatchPass->execute(mpDevice->getRenderContext(), vertexCount, 1, 1);
+
+        // Update BLAS/TLAS once for the whole batch.
+        updateForInverseRendering(mpDevice->getRenderContext(), false, true);
+    }
+
     inline pybind11::dict toPython(const Scene::SceneStats& stats)
     {
         pybind11::dict d;
 
         // Geometry stats
         d["meshCount"] = stats.meshCount;
+        d["meshletCount"] = stats.meshletCount;
         d["meshInstanceCount"] = stats.meshInstanceCount;
         d["meshInstanceOpaqueCount"] = stats.meshInstanceOpaqueCount;
         d["transformCount"] = stats.transformCount;
@@ -4307,6 +4436,44 @@ namespace Falcor
 #endif
     }
 
+    inline std::vector<MeshID> toMeshIDs(const std::vector<uint32_t>& meshIDs)
+    {
+        std::vector<MeshID> ids;
+        ids.reserve(meshIDs.size());
+        for (uint32_t meshID : meshIDs) ids.push_back(MeshID(meshID));
+        return ids;
+    }
+
+    inline void getMeshBatchVerticesAndIndicesPython(Scene& scene, const std::vector<uint32_t>& meshIDs, const pybind11::dict& dict)
+    {
+        std::map<std::string, ref<Buffer>> buffers;
+        for (auto item : dict)
+        {
+            std::string name = item.first.cast<std::string>();
+            ref<Buffer> buffer = item.second.cast<ref<Buffer>>();
+            buffers[name] = buffer;
+        }
+        scene.getMeshBatchVerticesAndIndices(toMeshIDs(meshIDs), buffers);
+#if FALCOR_HAS_CUDA
+        scene.getDevice()->getRenderContext()->waitForFalcor();
+#endif
+    }
+
+    inline void setMeshBatchVerticesPython(Scene& scene, const std::vector<uint32_t>& meshIDs, const pybind11::dict& dict)
+    {
+        std::map<std::string, ref<Buffer>> buffers;
+        for (auto item : dict)
+        {
+            std::string name = item.first.cast<std::string>();
+            ref<Buffer> buffer = item.second.cast<ref<Buffer>>();
+            buffers[name] = buffer;
+        }
+        scene.setMeshBatchVertices(toMeshIDs(meshIDs), buffers);
+#if FALCOR_HAS_CUDA
+        scene.getDevice()->getRenderContext()->waitForFalcor();
+#endif
+    }
+
     FALCOR_SCRIPT_BINDING(Scene)
     {
         using namespace pybind11::literals;
@@ -4409,5 +4576,7 @@ namespace Falcor
         scene.def("get_mesh", &Scene::getMesh, "mesh_id"_a);
         scene.def("get_mesh_vertices_and_indices", getMeshVerticesAndIndicesPython, "mesh_id"_a, "buffers"_a);
         scene.def("set_mesh_vertices", setMeshVerticesPython, "mesh_id"_a, "buffers"_a);
+        scene.def("get_mesh_batch_vertices_and_indices", getMeshBatchVerticesAndIndicesPython, "mesh_ids"_a, "buffers"_a);
+        scene.def("set_mesh_batch_vertices", setMeshBatchVerticesPython, "mesh_ids"_a, "buffers"_a);
     }
 }
@@ -335,9 +335,14 @@ namespace Falcor
             bool has32BitIndices = false;                           ///< True if 32-bit mesh indices are used.
             uint32_t meshDrawCount = 0;                             ///< Number of meshes to draw.
 
+            std::vector<MeshletDesc> meshlets;                      ///< Meshlets of all meshes, see MeshDesc::meshletOffset. Empty unless generated.
+            std::vector<uint32_t> meshletVertices;                  ///< Mesh-local vertex indices referenced by the meshlets.
+            std::vector<uint32_t> meshletTriangles;                 ///< Meshlet-local vertex indices, three 8-bit indices packed per triangle.
             std::vector<uint32_t> meshIndexData;                    ///< Vertex indices for all meshes in either 32-bit or 16-bit format packed tightly, decided per mesh.
             std::vector<PackedStaticVertexData> meshStaticData;     ///< Vertex attributes for all meshes in packed format.
             std::vector<SkinningVertexData> meshSkinningData;       ///< Additional vertex attributes for skinned meshes.
+            ref<Buffer> pMeshIndexBuffer;                           ///< Optional GPU buffer already holding meshIndexData. If null, the scene uploads the data.
+            ref<Buffer> pMeshStaticDataBuffer;                      ///< Optional GPU buffer already holding meshStaticData. If null, the scene uploads the data.
 
             // Curve data
             std::vector<CurveDesc> curveDesc;                       ///< List of curve descriptors.
@@ -347,6 +352,7 @@ namespace Falcor
             std::vector<uint32_t> curveIndexData;                   ///< Vertex indices for all curves in 32-bit.
             std::vector<StaticCurveVertexData> curveStaticData;     ///< Vertex attributes for all curves.
             std::vector<CachedCurve> cachedCurves;                  ///< Vertex cache for dynamic (vertex animated) curves.
+            AnimatedVertexCache::StreamingOptions vertexCacheStreaming; ///< Options for streaming the vertex caches from disk.
 
             // SDF grid data
             std::vector<ref<SDFGrid>> sdfGrids;                     ///< List of SDF grids.
@@ -365,6 +371,7 @@ namespace Falcor
         {
             // Geometry stats
             uint64_t meshCount = 0;                     ///< Number of meshes.
+            uint64_t meshletCount = 0;                  ///< Number of meshlets, or zero if meshlets were not generated.
             uint64_t meshInstanceCount = 0;             ///< Number if mesh instances.
             uint64_t meshInstanceOpaqueCount = 0;       ///< Number if mesh instances that are opaque.
             uint64_t transformCount = 0;                ///< Number of transform matrices.
@@ -375,7 +382,7 @@ namespace Falcor
             uint64_t indexMemoryInBytes = 0;            ///< Total memory in bytes used by the index buffer.
             uint64_t vertexMemoryInBytes = 0;           ///< Total memory in bytes used by the vertex buffer.
             uint64_t geometryMemoryInBytes = 0;         ///< Total memory in bytes used by the geometry data (meshes, curves, custom primitives, instances etc.).
-            uint64_t animationMemoryInBytes = 0;        ///< Total memory in bytes used by the animation system (transforms, skinning buffers).
+            uint64_t animationMemoryInBytes = 0;        ///< Total memory in bytes used by the animation system (transforms, skinning buffers, keyframes).
 
             // Curve stats
             uint64_t curveCount = 0;                    ///< Number of curves.
@@ -733,6 +740,21 @@ namespace Falcor
         */
         void setMeshVertices(MeshID meshID, const std::map<std::string, ref<Buffer>>& buffers);
 
+        /** Get vertex and index data for a batch of meshes using a single dispatch.
+            The data of all meshes is packed back to back in the buffers, in the order of the given mesh IDs.
+            That is, the vertices (triangles) of meshIDs[i] start after the vertices (triangles) of meshIDs[0..i-1].
+            \param[in] meshIDs List of mesh IDs.
+            \param[in] buffers Map of buffers containing mesh data: "triangleIndices", "positions", and "texcrds" are required.
+        */
+        void getMeshBatchVerticesAndIndices(const std::vector<MeshID>& meshIDs, const std::map<std::string, ref<Buffer>>& buffers);
+
+        /** Set vertex data for a batch of meshes using a single dispatch, and update the acceleration structures once for the whole batch.
+            The data of all meshes is packed back to back in the buffers, see getMeshBatchVerticesAndIndices().
+            \param[in] meshIDs List of mesh IDs.
+            \param[in] buffers Map of buffers containing mesh data: "positions", "normals", "tangents", and "texcrds" are required.
+        */
+        void setMeshBatchVertices(const std::vector<MeshID>& meshIDs, const std::map<std::string, ref<Buffer>>& buffers);
+
         /** Get the number of curves.
         */
         uint32_t getCurveCount() const { return (uint32_t)mCurveDesc.size(); }
@@ -1138,9 +1160,10 @@ namespace Falcor
         static constexpr uint32_t kDrawIdBufferIndex = kStaticDataBufferIndex + 1;
         static constexpr uint32_t kVertexBufferCount = kDrawIdBufferIndex + 1;
 
-        void createMeshVao(uint32_t drawCount, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData, const std::vector<SkinningVertexData>& skinningData);
+        void createMeshVao(uint32_t drawCount, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData, ref<Buffer> pIB, ref<Buffer> pStaticBuffer);
         void createCurveVao(const std::vector<uint32_t>& indexData, const std::vector<StaticCurveVertexData>& staticData);
         void createMeshUVTiles(const std::vector<MeshDesc>& meshDesc, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData);
+        void createMeshletBuffers(const std::vector<MeshletDesc>& meshlets, const std::vector<uint32_t>& meshletVertices, const std::vector<uint32_t>& meshletTriangles);
 
         void updateSceneDefines();
         DefineList getSceneSDFGridDefines() const;
@@ -1238,6 +1261,13 @@ namespace Falcor
         UpdateFlags updateDisplacement(RenderContext* pRenderContext, bool forceUpdate);
         UpdateFlags updateSDFGrids(RenderContext* pRenderContext);
 
+        /** Upload the mesh descs for a batched mesh vertex/index transfer.
+            \param[in] meshIDs List of mesh IDs.
+            \param[out] vertexCount Total vertex count of the batch.
+            \param[out] triangleCount Total triangle count of the batch.
+        */
+        void prepareMeshBatch(const std::vector<MeshID>& meshIDs, uint32_t& vertexCount, uint32_t& triangleCount);
+
         void updateGeometryStats();
         void updateMaterialStats();
         void updateRaytracingBLASStats();
@@ -1290,6 +1320,9 @@ namespace Falcor
         /// For Python bindings of triangle meshes.
         ref<ComputePass> mpLoadMeshPass;
         ref<ComputePass> mpUpdateMeshPass;
+        ref<ComputePass> mpLoadMeshBatchPass;
+        ref<ComputePass> mpUpdateMeshBatchPass;
+        ref<Buffer> mpMeshBatchBuffer;                              ///< Mesh descs (MeshIODesc) of the current mesh vertex/index batch.
 
         // Displacement mapping.
         struct
@@ -1360,6 +1393,9 @@ namespace Falcor
         // Scene block resources
         ref<Buffer> mpGeometryInstancesBuffer;
         ref<Buffer> mpMeshesBuffer;
+        ref<Buffer> mpMeshletsBuffer;
+        ref<Buffer> mpMeshletVerticesBuffer;
+        ref<Buffer> mpMeshletTrianglesBuffer;
         ref<Buffer> mpCurvesBuffer;
         ref<Buffer> mpCustomPrimitivesBuffer;
         ref<Buffer> mpLightsBuffer;
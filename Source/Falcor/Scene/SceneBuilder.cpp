@@ -28,6 +28,7 @@
 #include "SceneBuilder.h"
 #include "SceneCache.h"
 #include "Importer.h"
+#include "GeometryUploader.h"
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
 #include "Utils/Logger.h"
@@ -38,6 +39,9 @@
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/ObjectIDPython.h"
 #include "Utils/NumericRange.h"
+#include "Utils/StringUtils.h"
+#include "Utils/Geometry/MeshOptimizer.h"
+#include "Core/Platform/IOService.h"
 #include <mikktspace.h>
 #include <filesystem>
 #include <cmath>
@@ -51,13 +55,40 @@ namespace Falcor
     namespace
     {
         // Large mesh groups are split in order to reduce the size of the largest BLAS.
-        // The target is max 16M triangles per BLAS (= approx 0.5GB post-compaction). Note that this is not a strict limit.
-        const size_t kMaxTrianglesPerBLAS = 1ull << 24;
+        // The default target is max 16M triangles per BLAS (= approx 0.5GB post-compaction). Note that this is not a strict limit.
+        // The budget can be changed with the 'sceneBuilder:maxBLASMemory' option (in bytes).
+        const uint64_t kBLASBytesPerTriangle = 32;
+        const uint64_t kDefaultMaxBLASMemory = (1ull << 24) * kBLASBytesPerTriangle;
+
+        // Method used for splitting large mesh groups, selected with the 'sceneBuilder:blasPartitioner' option.
+        const std::string kDefaultBLASPartitioner = "sah";
+
+        // Meshlet size limits, which can be changed with the 'sceneBuilder:meshletMaxVertices' and 'sceneBuilder:meshletMaxTriangles' options.
+        const uint32_t kDefaultMeshletMaxVertices = 64;
+        const uint32_t kDefaultMeshletMaxTriangles = 124;
+
+        // Staging memory used for streaming mesh geometry to the GPU while the scene is built.
+        // The budget can be changed with the 'sceneBuilder:geometryStagingBudget' option. Zero disables streaming.
+        const uint64_t kDefaultGeometryStagingBudget = GeometryUploader::kDefaultStagingBudget;
+
+        // Animation keyframes are compressed if the 'sceneBuilder:compressAnimations' option is set.
+        // The error tolerances can be changed with the 'sceneBuilder:animationTranslationTolerance',
+        // 'sceneBuilder:animationRotationTolerance' and 'sceneBuilder:animationScalingTolerance' options.
+        const bool kDefaultCompressAnimations = false;
+
+        // Vertex cache keyframes are streamed from disk if the 'sceneBuilder:streamVertexCaches' option is set.
+        // The number of resident keyframes and the position tolerance of the on-disk encoding can be changed with the
+        // 'sceneBuilder:vertexCacheWindowSize' and 'sceneBuilder:vertexCachePositionTolerance' options.
+        const bool kDefaultStreamVertexCaches = false;
 
         // Texture coordinates for textured emissive materials are quantized for performance reasons.
         // We'll log a warning if the maximum quantization error exceeds this value.
         const float kMaxTexelError = 0.5f;
 
+        // Version of the processed mesh data stored in the asset cache.
+        // This needs to be incremented every time processMesh() changes its output!
+        const uint32_t kProcessedMeshCacheVersion = 1;
+
         int largestAxis(const float3& v)
         {
             if (v.x >= v.y && v.x >= v.z) return 0;
@@ -194,15 +225,74 @@ namespace Falcor
             return indexData;
         }
 
-        SceneCache::Key computeSceneCacheKey(const std::filesystem::path& path, SceneBuilder::Flags buildFlags)
+        SceneCache::Key computeSceneCacheKey(const std::filesystem::path& path, SceneBuilder::Flags buildFlags, const Settings& settings)
         {
-            SceneBuilder::Flags cacheFlags = buildFlags & (~(SceneBuilder::Flags::UseCache | SceneBuilder::Flags::RebuildCache));
+            SceneBuilder::Flags cacheFlags = buildFlags & (~(SceneBuilder::Flags::UseCache | SceneBuilder::Flags::RebuildCache | SceneBuilder::Flags::UseAssetCache));
             SHA1 sha1;
             auto pathStr = path.string();
             sha1.update(pathStr.data(), pathStr.size());
             sha1.update(&cacheFlags, sizeof(cacheFlags));
+            auto settingsStr = settings.toString();
+            sha1.update(settingsStr.data(), settingsStr.size());
+            return sha1.finalize();
+        }
+
+        template<typename T>
+        void hashMeshAttribute(SHA1& sha1, SceneBuilder::Mesh& mesh, const SceneBuilder::Mesh::Attribute<T>& attribute)
+        {
+            sha1.update((uint32_t)attribute.frequency);
+            sha1.update(attribute.pData != nullptr);
+            if (attribute.pData) sha1.update(attribute.pData, mesh.getAttributeCount(attribute) * sizeof(T));
+        }
+
+        /** Compute the asset cache key of a processed mesh.
+            The key covers everything processMesh() depends on: the mesh data, the build flags affecting the processing
+            and the material's texture transform, which is baked into the texture coordinates.
+        */
+        AssetCache::Key computeProcessedMeshKey(SceneBuilder::Mesh& mesh, SceneBuilder::Flags buildFlags)
+        {
+            const SceneBuilder::Flags processingFlags = buildFlags & (SceneBuilder::Flags::UseOriginalTangentSpace | SceneBuilder::Flags::NonIndexedVertices |
+                SceneBuilder::Flags::Force32BitIndices | SceneBuilder::Flags::OptimizeMeshes);
+
+            SHA1 sha1;
+            sha1.update(kProcessedMeshCacheVersion);
+            sha1.update((uint32_t)processingFlags);
+            sha1.update((uint32_t)mesh.topology);
+            sha1.update(mesh.faceCount);
+            sha1.update(mesh.vertexCount);
+            sha1.update(mesh.indexCount);
+            sha1.update(mesh.isAnimated);
+            sha1.update(mesh.useOriginalTangentSpace);
+            sha1.update(mesh.mergeDuplicateVertices);
+            sha1.update(mesh.pIndices, mesh.indexCount * sizeof(uint32_t));
+            hashMeshAttribute(sha1, mesh, mesh.positions);
+            hashMeshAttribute(sha1, mesh, mesh.normals);
+            hashMeshAttribute(sha1, mesh, mesh.tangents);
+            hashMeshAttribute(sha1, mesh, mesh.texCrds);
+            hashMeshAttribute(sha1, mesh, mesh.curveRadii);
+            hashMeshAttribute(sha1, mesh, mesh.boneIDs);
+            hashMeshAttribute(sha1, mesh, mesh.boneWeights);
+            if (mesh.texCrds.pData)
+            {
+                const float4x4 xform = mesh.pMaterial->getTextureTransform().getMatrix();
+                sha1.update(&xform, sizeof(xform));
+            }
             return sha1.finalize();
+        }
 
+        void writeProcessedMesh(AssetCache::Writer& writer, const SceneBuilder::ProcessedMesh& mesh)
+        {
+            writer.write(mesh.indexCount);
+            writer.write(mesh.use16BitIndices);
+            writer.write(mesh.indexData);
+            writer.write(mesh.staticData);
+            writer.write(mesh.skinningData);
+        }
+
+        bool readProcessedMesh(AssetCache::Reader& reader, SceneBuilder::ProcessedMesh& mesh)
+        {
+            return reader.read(mesh.indexCount) && reader.read(mesh.use16BitIndices) && reader.read(mesh.indexData) &&
+                reader.read(mesh.staticData) && reader.read(mesh.skinningData) && reader.isAtEnd();
         }
     }
 
@@ -213,6 +303,7 @@ namespace Falcor
     {
         mAssetResolver = AssetResolver::getDefaultResolver();
         mSceneData.pMaterials = std::make_unique<MaterialSystem>(mpDevice);
+        if (is_set(flags, Flags::UseAssetCache)) mpAssetCache = std::make_unique<AssetCache>();
     }
 
     SceneBuilder::SceneBuilder(ref<Device> pDevice, const std::filesystem::path& path, const Settings& settings, Flags flags)
@@ -224,8 +315,9 @@ namespace Falcor
             throw ImporterError(path, "Can't find scene file '{}'.", path);
         }
 
-        // Compute scene cache key based on absolute scene path and build flags.
-        mSceneCacheKey = computeSceneCacheKey(resolvedPath, flags);
+        // Compute scene cache key based on absolute scene path, build flags and settings.
+        // The files the scene is imported from are recorded in the cache and validated when it is loaded.
+        mSceneCacheKey = computeSceneCacheKey(resolvedPath, flags, settings);
 
         // Determine if scene cache should be written after import.
         bool useCache = is_set(flags, Flags::UseCache);
@@ -284,9 +376,14 @@ namespace Falcor
         }
 
         mSceneData.path = resolvedPath;
+        addDependency(resolvedPath);
         if (auto importer = Importer::create(getExtensionFromPath(resolvedPath)))
         {
+            IOService::get().resetStats();
             importer->importScene(resolvedPath, *this, materialToShortName);
+            auto ioStats = IOService::get().getStats();
+            logInfo("File I/O: {} reads, {} at {}/s.",
+                ioStats.readCount, formatByteSize(ioStats.bytesRead), formatByteSize((size_t)ioStats.getBytesPerSecond()));
         }
         else
         {
@@ -310,6 +407,28 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::addDependency(const std::filesystem::path& path)
+    {
+        if (!path.empty()) mDependencies.insert(path);
+    }
+
+    std::vector<SceneCache::Dependency> SceneBuilder::collectDependencies() const
+    {
+        // Hash the files in parallel, this reads every file once.
+        std::vector<std::filesystem::path> paths(mDependencies.begin(), mDependencies.end());
+        std::vector<std::optional<SceneCache::Dependency>> results(paths.size());
+        NumericRange<size_t> range(0, paths.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) { results[i] = SceneCache::createDependency(paths[i]); });
+
+        std::vector<SceneCache::Dependency> dependencies;
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            if (results[i]) dependencies.push_back(*results[i]);
+            else logWarning("Scene cache dependency '{}' cannot be read and is not tracked.", paths[i]);
+        }
+        return dependencies;
+    }
+
     void SceneBuilder::pushAssetResolver()
     {
         mAssetResolverStack.push_back(AssetResolver(mAssetResolver));
@@ -343,6 +462,13 @@ namespace Falcor
             addMeshInstance(nodeID, meshID);
         }
 
+        if (mpAssetCache)
+        {
+            auto stats = mpAssetCache->getStats();
+            logInfo("Asset cache: {} hits ({}), {} misses, {} entries written ({}).",
+                stats.hitCount, formatByteSize(stats.bytesRead), stats.missCount, stats.writeCount, formatByteSize(stats.bytesWritten));
+        }
+
         // Post-process the scene data.
         TimeReport timeReport;
 
@@ -374,9 +500,20 @@ namespace Falcor
 
         timeReport.measure("Optimizing materials");
 
+        compressAnimations();
+
+        timeReport.measure("Compressing animations");
+
+        // The mesh geometry is final at this point. Stream it to the GPU while the remaining scene data is prepared.
+        // The upload records on the device's render context from a worker thread. Until it is joined below, nothing
+        // else may use the render context: the steps in between only read the geometry and prepare CPU data, and
+        // material textures have finished loading above.
+        std::future<void> geometryUpload = uploadMeshGeometry();
+
         // Prepare scene resources.
         createSceneGraph();
         createMeshData();
+        createMeshlets();
         createMeshBoundingBoxes();
         createCurveData();
         calculateCurveBoundingBoxes();
@@ -390,13 +527,25 @@ namespace Falcor
 
         mSceneData.useCompressedHitInfo = is_set(mFlags, Flags::UseCompressedHitInfo);
 
+        const AnimatedVertexCache::StreamingOptions defaultStreamingOptions;
+        auto& streamingOptions = mSceneData.vertexCacheStreaming;
+        streamingOptions.enabled = mSettings.getOption<bool>("sceneBuilder:streamVertexCaches", kDefaultStreamVertexCaches);
+        streamingOptions.windowSize = mSettings.getOption<uint32_t>("sceneBuilder:vertexCacheWindowSize", defaultStreamingOptions.windowSize);
+        streamingOptions.positionTolerance = mSettings.getOption<float>("sceneBuilder:vertexCachePositionTolerance", defaultStreamingOptions.positionTolerance);
+
         // Write scene cache if requested.
         if (mWriteSceneCache)
         {
-            SceneCache::writeCache(mSceneData, mSceneCacheKey);
+            SceneCache::writeCache(mSceneData, mSceneCacheKey, collectDependencies());
             timeReport.measure("Writing cache");
         }
 
+        if (geometryUpload.valid())
+        {
+            geometryUpload.get();
+            timeReport.measure("Waiting for geometry upload");
+        }
+
         // Create the scene object.
         mpScene = Scene::create(mpDevice, std::move(mSceneData));
         mSceneData = {};
@@ -455,6 +604,7 @@ namespace Falcor
         //  - Error checking
         //  - Compute tangent space if needed
         //  - Merge identical vertices, compute new indices (optional)
+        //  - Reorder triangles and vertices for locality (optional)
         //  - Validate final vertex data
         //  - Compact vertices/indices into runtime format
 
@@ -498,6 +648,22 @@ namespace Falcor
             if (mesh.boneWeights.pData == nullptr) throw_on_missing_element("bone weights");
         }
 
+        // Look up the processed mesh in the asset cache.
+        // Meshes for which the caller requests attribute indices or tangents are always processed, as these outputs are not cached.
+        std::optional<AssetCache::Key> assetCacheKey;
+        if (mpAssetCache && !pAttributeIndices && !pTangents)
+        {
+            assetCacheKey = computeProcessedMeshKey(mesh, mFlags);
+            std::vector<uint8_t> data;
+            if (!is_set(mFlags, Flags::RebuildCache) && mpAssetCache->read(*assetCacheKey, data))
+            {
+                ProcessedMesh cachedMesh = processedMesh;
+                AssetCache::Reader reader(data);
+                if (readProcessedMesh(reader, cachedMesh)) return cachedMesh;
+                logWarning("Asset cache entry for mesh '{}' is invalid. Processing the mesh again.", mesh.name);
+            }
+        }
+
         // Generate tangent space if that's required.
         std::vector<float4> localTangents;
         if (!pTangents)
@@ -637,6 +803,36 @@ namespace Falcor
             logDebug("Mesh with name '{}' had original vertex count {}, new vertex count {}.", mesh.name, mesh.vertexCount, vertices.size());
         }
 
+        // Optimize the triangle and vertex order.
+        // Triangles are first sorted spatially and vertices renumbered in that order, so the cache optimization starts out coherent.
+        // Vertices are only reordered for meshes where the caller doesn't rely on the original vertex order.
+        if (is_set(mFlags, Flags::OptimizeMeshes))
+        {
+            const uint32_t vertexCount = (uint32_t)vertices.size();
+            std::vector<float3> positions(vertexCount);
+            for (uint32_t i = 0; i < vertexCount; i++) positions[i] = vertices[i].first.position;
+
+            const bool reorderVertices = mesh.mergeDuplicateVertices && !mesh.isAnimated;
+            auto reorderVerticesByFirstUse = [&]()
+            {
+                auto remap = optimizeVertexFetch(indices, vertexCount);
+                remapVertices(vertices, remap);
+                remapVertices(positions, remap);
+                if (pAttributeIndices) remapVertices(*pAttributeIndices, remap);
+            };
+
+            VertexCacheStats before = analyzeVertexCache(indices, vertexCount);
+
+            sortTrianglesSpatially(indices, positions);
+            if (reorderVertices) reorderVerticesByFirstUse();
+            optimizeVertexCache(indices, positions);
+            if (reorderVertices) reorderVerticesByFirstUse();
+
+            VertexCacheStats after = analyzeVertexCache(indices, vertexCount);
+            logInfo("Optimized mesh '{}' ({} triangles, {} vertices): ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}.",
+                mesh.name, after.triangleCount, after.vertexCount, before.acmr, after.acmr, before.atvr, after.atvr);
+        }
+
         // Validate vertex data to check for invalid numbers and missing tangent frame.
         size_t invalidCount = 0;
         size_t zeroCount = 0;
@@ -693,6 +889,13 @@ namespace Falcor
             }
         }
 
+        if (assetCacheKey)
+        {
+            AssetCache::Writer writer;
+            writeProcessedMesh(writer, processedMesh);
+            mpAssetCache->write(*assetCacheKey, writer.getData());
+        }
+
         return processedMesh;
     }
 
@@ -996,6 +1199,7 @@ namespace Falcor
             mpMaterialTextureLoader.reset(new MaterialTextureLoader(mSceneData.pMaterials->getTextureManager(), !is_set(mFlags, Flags::AssumeLinearSpaceTextures)));
         }
         std::filesystem::path resolvedPath = mAssetResolver.resolvePath(path);
+        addDependency(resolvedPath);
         mpMaterialTextureLoader->loadTexture(pMaterial, slot, resolvedPath);
     }
 
@@ -1052,7 +1256,9 @@ namespace Falcor
 
     void SceneBuilder::loadLightProfile(const std::string& filename, bool normalize)
     {
-        mSceneData.pLightProfile = LightProfile::createFromIesProfile(mpDevice, mAssetResolver.resolvePath(std::filesystem::path(filename)), normalize);
+        std::filesystem::path resolvedPath = mAssetResolver.resolvePath(std::filesystem::path(filename));
+        addDependency(resolvedPath);
+        mSceneData.pLightProfile = LightProfile::createFromIesProfile(mpDevice, resolvedPath, normalize);
     }
 
     // Cameras
@@ -2204,7 +2410,7 @@ namespace Falcor
 
         triangleCount = countTriangles(meshGroup);
 
-        if (triangleCount <= kMaxTrianglesPerBLAS)
+        if (triangleCount <= mMaxTrianglesPerBLAS)
         {
             return false;
         }
@@ -2219,7 +2425,7 @@ namespace Falcor
             return false;
         }
         FALCOR_ASSERT(meshGroup.meshList.size() > 1);
-        FALCOR_ASSERT(triangleCount > kMaxTrianglesPerBLAS);
+        FALCOR_ASSERT(triangleCount > mMaxTrianglesPerBLAS);
 
         return true;
     }
@@ -2236,7 +2442,7 @@ namespace Falcor
 
         // Each new group holds at least one mesh, or if multiple, up to the target number of triangles.
         FALCOR_ASSERT(triangleCount > 0);
-        size_t targetGroupCount = div_round_up(triangleCount, kMaxTrianglesPerBLAS);
+        size_t targetGroupCount = div_round_up(triangleCount, mMaxTrianglesPerBLAS);
         size_t targetTrianglesPerGroup = triangleCount / targetGroupCount;
 
         triangleCount = 0;
@@ -2361,26 +2567,80 @@ namespace Falcor
         return leftList;
     }
 
+    SceneBuilder::MeshGroupList SceneBuilder::splitMeshGroupSAH(MeshGroup& meshGroup, const BLASPartitioner::Options& options) const
+    {
+        // This function partitions a mesh group into groups that fit the memory budget, using a binned SAH on the mesh bounding boxes.
+        // Individual meshes are not split, but meshes are grouped to minimize the surface area and overlap of the resulting BLASes.
+
+        // Early out if splitting is not needed or possible.
+        size_t triangleCount = 0;
+        if (!needsSplit(meshGroup, triangleCount)) return MeshGroupList{ std::move(meshGroup) };
+
+        std::vector<BLASPartitioner::Item> items;
+        items.reserve(meshGroup.meshList.size());
+        for (auto meshID : meshGroup.meshList)
+        {
+            const auto& mesh = mMeshes[meshID.get()];
+            items.push_back({ mesh.boundingBox, mesh.getTriangleCount() });
+        }
+
+        auto partition = BLASPartitioner::partition(items, options);
+        auto metrics = BLASPartitioner::evaluate(items, partition, options);
+        logInfo("SceneBuilder::splitMeshGroupSAH() - Split {} meshes into {} groups (SAH cost {:.3f}, overlap {:.3f} in {} pairs, largest group {} MB).",
+            items.size(), metrics.groupCount, metrics.sahCost, metrics.overlapArea, metrics.overlappingPairs, metrics.maxGroupMemory >> 20);
+
+        MeshGroupList groups;
+        groups.reserve(partition.size());
+        for (const auto& group : partition)
+        {
+            MeshGroup meshGroupOut{ std::vector<MeshID>(), meshGroup.isStatic, meshGroup.isDisplaced };
+            meshGroupOut.meshList.reserve(group.size());
+            for (uint32_t i : group) meshGroupOut.meshList.push_back(meshGroup.meshList[i]);
+            groups.push_back(std::move(meshGroupOut));
+        }
+
+        FALCOR_ASSERT(!groups.empty());
+        return groups;
+    }
+
     void SceneBuilder::optimizeGeometry()
     {
         // This function optimizes the geometry for raytracing performance and memory usage.
         //
-        // There is a max triangles per group limit to reduce the worst-case memory requirements for BLAS builds.
-        // If the limit is exceeded, the geometry is split into multiple groups (BLASes).
+        // There is a max memory per group budget to reduce the worst-case memory requirements for BLAS builds.
+        // If the budget is exceeded, the geometry is split into multiple groups (BLASes).
         // Splitting has performance implications for the traversal due to spatial overlap between the BLASes.
         //
         // To reduce the perf impact we may perform these steps:
         //  - Split large mesh groups (BLASes) into multiple smaller ones.
         //  - Split large meshes into smaller to reduce spatial overlap between BLASes.
         //  - Sort meshes into BLASes based on spatial locality.
+        //
+        // The splitting method is selected with the 'sceneBuilder:blasPartitioner' option:
+        //  - "sah": Group meshes using a binned SAH on mesh bounding boxes (default).
+        //  - "midpoint": Recursive midpoint split, splitting meshes that straddle the splitting plane.
+        //  - "median": Recursive median split of meshes in terms of triangle count.
+        //  - "simple": Partition meshes in order by triangle count.
+
+        BLASPartitioner::Options options;
+        options.bytesPerTriangle = kBLASBytesPerTriangle;
+        options.maxGroupMemory = mSettings.getOption<uint64_t>("sceneBuilder:maxBLASMemory", kDefaultMaxBLASMemory);
+        FALCOR_CHECK(options.maxGroupMemory >= kBLASBytesPerTriangle, "'sceneBuilder:maxBLASMemory' must be at least {} bytes.", kBLASBytesPerTriangle);
+        mMaxTrianglesPerBLAS = options.maxGroupMemory / kBLASBytesPerTriangle;
+
+        std::string partitioner = mSettings.getOption<std::string>("sceneBuilder:blasPartitioner", kDefaultBLASPartitioner);
+        FALCOR_CHECK(partitioner == "sah" || partitioner == "midpoint" || partitioner == "median" || partitioner == "simple",
+            "Unknown BLAS partitioner '{}'. Expected 'sah', 'midpoint', 'median' or 'simple'.", partitioner);
 
         MeshGroupList optimizedGroups;
 
         for (auto& meshGroup : mMeshGroups)
         {
-            //auto groups = splitMeshGroupSimple(meshGroup);
-            //auto groups = splitMeshGroupMedian(meshGroup);
-            auto groups = splitMeshGroupMidpointMeshes(meshGroup);
+            MeshGroupList groups;
+            if (partitioner == "sah") groups = splitMeshGroupSAH(meshGroup, options);
+            else if (partitioner == "midpoint") groups = splitMeshGroupMidpointMeshes(meshGroup);
+            else if (partitioner == "median") groups = splitMeshGroupMedian(meshGroup);
+            else groups = splitMeshGroupSimple(meshGroup);
 
             if (groups.size() > 1) logWarning("SceneBuilder::optimizeGeometry() performance warning - Mesh group was split into {} groups.", groups.size());
 
@@ -2467,44 +2727,60 @@ namespace Falcor
             FALCOR_THROW("Trying to build a scene that exceeds supported mesh data size.");
         }
 
-        mSceneData.meshIndexData.reserve(totalIndexDataCount);
-        mSceneData.meshStaticData.reserve(totalStaticVertexCount);
-        mSceneData.meshSkinningData.reserve(totalSkinningVertexCount);
+        // Compute the offsets of all meshes into the global buffers (prefix sum over the mesh data sizes).
+        size_t indexOffset = 0;
+        size_t staticVertexOffset = 0;
+        size_t skinningVertexOffset = 0;
 
-        // Copy all vertex and index data into the global buffers.
         for (auto& mesh : mMeshes)
         {
-            mesh.staticVertexOffset = (uint32_t)mSceneData.meshStaticData.size();
-            mesh.skinningVertexOffset = (uint32_t)mSceneData.meshSkinningData.size();
+            mesh.staticVertexOffset = (uint32_t)staticVertexOffset;
+            mesh.skinningVertexOffset = (uint32_t)skinningVertexOffset;
             mesh.prevVertexOffset = mesh.skinningVertexOffset;
+            if (isIndexed) mesh.indexOffset = (uint32_t)indexOffset;
+
+            indexOffset += mesh.indexData.size();
+            staticVertexOffset += mesh.staticData.size();
+            skinningVertexOffset += mesh.skinningData.size();
+        }
+
+        mSceneData.meshIndexData.resize(isIndexed ? totalIndexDataCount : 0);
+        mSceneData.meshStaticData.resize(totalStaticVertexCount);
+        mSceneData.meshSkinningData.resize(totalSkinningVertexCount);
+
+        // Copy all vertex and index data into the global buffers.
+        // Meshes write to disjoint ranges, so they are processed in parallel.
+        NumericRange<size_t> range(0, mMeshes.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t meshIndex)
+        {
+            auto& mesh = mMeshes[meshIndex];
 
-            // Insert the static vertex data in the global array.
-            // The vertices are automatically converted to their packed format in this step.
-            mSceneData.meshStaticData.insert(mSceneData.meshStaticData.end(), mesh.staticData.begin(), mesh.staticData.end());
+            // Pack the static vertex data into the global array.
+            PackedStaticVertexData* pStaticData = mSceneData.meshStaticData.data() + mesh.staticVertexOffset;
+            for (size_t i = 0; i < mesh.staticData.size(); ++i) pStaticData[i].pack(mesh.staticData[i]);
 
             if (isIndexed)
             {
-                mesh.indexOffset = (uint32_t)mSceneData.meshIndexData.size();
-                mSceneData.meshIndexData.insert(mSceneData.meshIndexData.end(), mesh.indexData.begin(), mesh.indexData.end());
+                std::copy(mesh.indexData.begin(), mesh.indexData.end(), mSceneData.meshIndexData.begin() + mesh.indexOffset);
             }
 
             if (mesh.isSkinned())
             {
                 FALCOR_ASSERT(!mesh.skinningData.empty());
-                mSceneData.meshSkinningData.insert(mSceneData.meshSkinningData.end(), mesh.skinningData.begin(), mesh.skinningData.end());
-
-                // Patch vertex index references.
-                for (uint32_t i = 0; i < mesh.skinningData.size(); ++i)
+                SkinningVertexData* pSkinningData = mSceneData.meshSkinningData.data() + mesh.skinningVertexOffset;
+                for (size_t i = 0; i < mesh.skinningData.size(); ++i)
                 {
-                    mSceneData.meshSkinningData[mesh.skinningVertexOffset + i].staticIndex += mesh.staticVertexOffset;
+                    // Patch vertex index references.
+                    pSkinningData[i] = mesh.skinningData[i];
+                    pSkinningData[i].staticIndex += mesh.staticVertexOffset;
                 }
             }
 
-            // Free the mesh local data.
-            mesh.indexData.clear();
-            mesh.staticData.clear();
-            mesh.skinningData.clear();
-        }
+            // Free the mesh local data to reduce peak memory.
+            std::vector<uint32_t>().swap(mesh.indexData);
+            std::vector<StaticVertexData>().swap(mesh.staticData);
+            std::vector<SkinningVertexData>().swap(mesh.skinningData);
+        });
 
         // Initialize offsets for prev vertex data for vertex-animated meshes
         uint32_t prevOffset = (uint32_t)mSceneData.meshSkinningData.size();
@@ -2673,6 +2949,73 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::compressAnimations()
+    {
+        if (mSceneData.animations.empty() || !mSettings.getOption<bool>("sceneBuilder:compressAnimations", kDefaultCompressAnimations)) return;
+
+        const Animation::CompressionOptions defaults;
+        Animation::CompressionOptions options;
+        options.translationTolerance = mSettings.getOption<float>("sceneBuilder:animationTranslationTolerance", defaults.translationTolerance);
+        options.rotationTolerance = mSettings.getOption<float>("sceneBuilder:animationRotationTolerance", defaults.rotationTolerance);
+        options.scalingTolerance = mSettings.getOption<float>("sceneBuilder:animationScalingTolerance", defaults.scalingTolerance);
+
+        auto& animations = mSceneData.animations;
+        uint64_t sizeBefore = 0;
+        size_t keyframesBefore = 0;
+        for (const auto& pAnimation : animations)
+        {
+            sizeBefore += pAnimation->getMemoryUsageInBytes();
+            keyframesBefore += pAnimation->getKeyframeCount();
+        }
+
+        NumericRange<size_t> range(0, animations.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) { animations[i]->compress(options); });
+
+        uint64_t sizeAfter = 0;
+        size_t keyframesAfter = 0;
+        for (const auto& pAnimation : animations)
+        {
+            sizeAfter += pAnimation->getMemoryUsageInBytes();
+            keyframesAfter += pAnimation->getKeyframeCount();
+        }
+        logInfo("Compressed {} animations: {} -> {} keyframes, keyframe data size {} -> {}.",
+            animations.size(), keyframesBefore, keyframesAfter, formatByteSize(sizeBefore), formatByteSize(sizeAfter));
+    }
+
+    std::future<void> SceneBuilder::uploadMeshGeometry()
+    {
+        const uint64_t stagingBudget = mSettings.getOption<uint64_t>("sceneBuilder:geometryStagingBudget", kDefaultGeometryStagingBudget);
+        if (stagingBudget == 0) return {};
+
+        // Geometry that does not fit the scene's buffers is left to the scene, which reports the error.
+        const size_t ibSize = mSceneData.meshIndexData.size() * sizeof(uint32_t);
+        const size_t vbSize = mSceneData.meshStaticData.size() * sizeof(PackedStaticVertexData);
+        if (ibSize > std::numeric_limits<uint32_t>::max() || vbSize > std::numeric_limits<uint32_t>::max()) return {};
+
+        // Create the buffers with the same layout as Scene::createMeshVao().
+        if (ibSize > 0)
+        {
+            ResourceBindFlags ibBindFlags = ResourceBindFlags::Index | ResourceBindFlags::ShaderResource;
+            mSceneData.pMeshIndexBuffer = mpDevice->createBuffer(ibSize, ibBindFlags, MemoryType::DeviceLocal, nullptr);
+        }
+        if (vbSize > 0)
+        {
+            ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::Vertex;
+            mSceneData.pMeshStaticDataBuffer = mpDevice->createStructuredBuffer(sizeof(PackedStaticVertexData), (uint32_t)mSceneData.meshStaticData.size(), vbBindFlags, MemoryType::DeviceLocal, nullptr, false);
+        }
+
+        // The copies are recorded on a worker thread. The remaining scene setup only reads the
+        // geometry and does not use the render context, so the two can run concurrently.
+        // The caller must join the returned future before anything else records on the render context.
+        return std::async(std::launch::async, [this, stagingBudget]()
+        {
+            GeometryUploader uploader(mpDevice, stagingBudget);
+            if (mSceneData.pMeshIndexBuffer) uploader.upload(mSceneData.pMeshIndexBuffer.get(), mSceneData.meshIndexData);
+            if (mSceneData.pMeshStaticDataBuffer) uploader.upload(mSceneData.pMeshStaticDataBuffer.get(), mSceneData.meshStaticData);
+            uploader.finish();
+        });
+    }
+
     void SceneBuilder::removeDuplicateSDFGrids()
     {
         // Removes duplicate SDF grids.
@@ -2758,6 +3101,89 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::createMeshlets()
+    {
+        if (!is_set(mFlags, Flags::GenerateMeshlets)) return;
+
+        FALCOR_ASSERT(mSceneData.meshDesc.size() == mMeshes.size());
+        FALCOR_ASSERT(mSceneData.meshlets.empty());
+
+        MeshletBuilder::Options options;
+        options.maxVertices = mSettings.getOption<uint32_t>("sceneBuilder:meshletMaxVertices", kDefaultMeshletMaxVertices);
+        options.maxTriangles = mSettings.getOption<uint32_t>("sceneBuilder:meshletMaxTriangles", kDefaultMeshletMaxTriangles);
+
+        // Build the meshlets of all meshes in parallel.
+        // The bounds of dynamic meshes are computed from their vertices at load time.
+        std::vector<MeshletBuilder::Meshlets> meshMeshlets(mMeshes.size());
+        NumericRange<size_t> range(0, mMeshes.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t meshID)
+        {
+            const auto& mesh = mMeshes[meshID];
+            if (mesh.topology != Vao::Topology::TriangleList) return;
+
+            const PackedStaticVertexData* pStaticData = mSceneData.meshStaticData.data() + mesh.staticVertexOffset;
+            std::vector<float3> positions(mesh.staticVertexCount);
+            for (uint32_t i = 0; i < mesh.staticVertexCount; ++i) positions[i] = pStaticData[i].position;
+
+            std::vector<uint32_t> indices(mesh.getTriangleCount() * 3);
+            if (mesh.indexCount > 0)
+            {
+                const uint32_t* pIndices = mSceneData.meshIndexData.data() + mesh.indexOffset;
+                for (uint32_t i = 0; i < mesh.indexCount; ++i)
+                {
+                    indices[i] = mesh.use16BitIndices ? reinterpret_cast<const uint16_t*>(pIndices)[i] : pIndices[i];
+                }
+            }
+            else
+            {
+                for (uint32_t i = 0; i < indices.size(); ++i) indices[i] = i;
+            }
+
+            meshMeshlets[meshID] = MeshletBuilder::build(indices, positions, options);
+        });
+
+        // Concatenate the meshlets into the global lists.
+        size_t meshletCount = 0;
+        size_t meshletVertexCount = 0;
+        size_t meshletTriangleCount = 0;
+
+        for (uint32_t meshID = 0; meshID < mMeshes.size(); meshID++)
+        {
+            const auto& m = meshMeshlets[meshID];
+            mSceneData.meshDesc[meshID].meshletOffset = (uint32_t)meshletCount;
+            mSceneData.meshDesc[meshID].meshletCount = (uint32_t)m.meshlets.size();
+            meshletCount += m.meshlets.size();
+            meshletVertexCount += m.vertices.size();
+            meshletTriangleCount += m.triangles.size();
+        }
+
+        if (meshletVertexCount > std::numeric_limits<uint32_t>::max() || meshletTriangleCount > std::numeric_limits<uint32_t>::max())
+        {
+            FALCOR_THROW("Trying to build a scene that exceeds supported meshlet data size.");
+        }
+
+        mSceneData.meshlets.reserve(meshletCount);
+        mSceneData.meshletVertices.reserve(meshletVertexCount);
+        mSceneData.meshletTriangles.reserve(meshletTriangleCount);
+
+        for (auto& m : meshMeshlets)
+        {
+            const uint32_t vertexOffset = (uint32_t)mSceneData.meshletVertices.size();
+            const uint32_t triangleOffset = (uint32_t)mSceneData.meshletTriangles.size();
+            for (auto meshlet : m.meshlets)
+            {
+                meshlet.vertexOffset += vertexOffset;
+                meshlet.triangleOffset += triangleOffset;
+                mSceneData.meshlets.push_back(meshlet);
+            }
+            mSceneData.meshletVertices.insert(mSceneData.meshletVertices.end(), m.vertices.begin(), m.vertices.end());
+            mSceneData.meshletTriangles.insert(mSceneData.meshletTriangles.end(), m.triangles.begin(), m.triangles.end());
+            m = {};
+        }
+
+        logInfo("Generated {} meshlets (max {} vertices, {} triangles).", meshletCount, options.maxVertices, options.maxTriangles);
+    }
+
     void SceneBuilder::createMeshInstanceData(uint32_t& tlasInstanceIndex)
     {
         // Setup all mesh instances.
@@ -2994,8 +3420,11 @@ namespace Falcor
         flags.value("DontUseDisplacement", SceneBuilder::Flags::DontUseDisplacement);
         flags.value("UseCompressedHitInfo", SceneBuilder::Flags::UseCompressedHitInfo);
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
+        flags.value("OptimizeMeshes", SceneBuilder::Flags::OptimizeMeshes);
+        flags.value("GenerateMeshlets", SceneBuilder::Flags::GenerateMeshlets);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
+        flags.value("UseAssetCache", SceneBuilder::Flags::UseAssetCache);
         ScriptBindings::addEnumBinaryOperators(flags);
 
         pybind11::class_<SceneBuilder> sceneBuilder(m, "SceneBuilder");
@@ -3025,6 +3454,7 @@ namespace Falcor
         sceneBuilder.def("addLight", &SceneBuilder::addLight, "light"_a);
         sceneBuilder.def("getLight", &SceneBuilder::getLight, "name"_a);
         sceneBuilder.def("loadLightProfile", &SceneBuilder::loadLightProfile, "filename"_a, "normalize"_a = true);
+        sceneBuilder.def("addDependency", &SceneBuilder::addDependency, "path"_a);
         sceneBuilder.def("addCamera", &SceneBuilder::addCamera, "camera"_a);
         sceneBuilder.def("addAnimation", &SceneBuilder::addAnimation, "animation"_a);
         sceneBuilder.def("createAnimation", &SceneBuilder::createAnimation, "animatable"_a, "name"_a, "duration"_a);
@@ -28,9 +28,12 @@
 #pragma once
 #include "Scene.h"
 #include "SceneCache.h"
+#include "AssetCache.h"
 #include "SceneIDs.h"
 #include "Transform.h"
 #include "TriangleMesh.h"
+#include "BLASPartitioner.h"
+#include "MeshletBuilder.h"
 #include "VertexAttrib.slangh"
 #include "SceneTypes.slang"
 #include "Material/MaterialTextureLoader.h"
@@ -46,7 +49,9 @@
 #include <pybind11/pytypes.h>
 
 #include <filesystem>
+#include <future>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 #include <random>
@@ -78,9 +83,12 @@ namespace Falcor
             DontUseDisplacement             = 0x4000,   ///< Don't use displacement mapping.
             UseCompressedHitInfo            = 0x8000,   ///< Use compressed hit info (on scenes with triangle meshes only).
             TessellateCurvesIntoPolyTubes   = 0x10000,  ///< Tessellate curves into poly-tubes (the default is linear swept spheres).
+            OptimizeMeshes                  = 0x20000,  ///< Reorder triangles for vertex cache efficiency, overdraw and spatial locality, and vertices for fetch locality. An ACMR/ATVR report is logged per mesh.
+            GenerateMeshlets                = 0x80000,  ///< Partition meshes into meshlets with bounding spheres and normal cones for cluster culling.
 
             UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
-            RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
+            RebuildCache                    = 0x20000000, ///< Rebuild scene cache. Also rebuilds the entries of the asset cache.
+            UseAssetCache                   = 0x40000000, ///< Enable the per-asset cache. Processed meshes are cached on disk keyed by their content, so re-importing a scene only re-processes the meshes that changed.
 
             Default = None
         };
@@ -368,6 +376,20 @@ namespace Falcor
         /// Pop the state of the asset resolver from the stack.
         void popAssetResolver();
 
+        /** Register a file the scene is imported from.
+            The scene file, material textures and light profiles are registered automatically. Importers should register
+            other files they read, such as included files or referenced layers. The files are recorded in the scene cache,
+            which is rebuilt when any of them change.
+            \param[in] path Resolved file path.
+        */
+        void addDependency(const std::filesystem::path& path);
+
+        /** Get the per-asset cache.
+            Importers can use it to cache their own expensive processing steps.
+            \return The asset cache, or nullptr if Flags::UseAssetCache is not set.
+        */
+        AssetCache* getAssetCache() const { return mpAssetCache.get(); }
+
         /** Get the scene. Make sure to add all the objects before calling this function
             \return nullptr if something went wrong, otherwise a new Scene object
         */
@@ -786,11 +808,14 @@ namespace Falcor
         ref<Scene> mpScene;
         SceneCache::Key mSceneCacheKey;
         bool mWriteSceneCache = false;  ///< True if scene cache should be written after import.
+        std::set<std::filesystem::path> mDependencies; ///< Files the scene is imported from.
+        std::unique_ptr<AssetCache> mpAssetCache;       ///< Per-asset cache, or nullptr if disabled.
 
         SceneGraph mSceneGraph;
 
         MeshList mMeshes;
         MeshGroupList mMeshGroups; ///< Groups of meshes. Each group represents all the geometries in a BLAS for ray tracing.
+        size_t mMaxTrianglesPerBLAS = 0; ///< Mesh groups with more triangles are split into multiple groups.
 
         CurveList mCurves;
 
@@ -819,6 +844,7 @@ namespace Falcor
         MeshGroupList splitMeshGroupSimple(MeshGroup& meshGroup) const;
         MeshGroupList splitMeshGroupMedian(MeshGroup& meshGroup) const;
         MeshGroupList splitMeshGroupMidpointMeshes(MeshGroup& meshGroup);
+        MeshGroupList splitMeshGroupSAH(MeshGroup& meshGroup, const BLASPartitioner::Options& options) const;
 
         // Post processing
         void prepareDisplacementMaps();
@@ -839,10 +865,14 @@ namespace Falcor
         void removeDuplicateMaterials();
         void collectVolumeGrids();
         void quantizeTexCoords();
+        void compressAnimations();
+        std::future<void> uploadMeshGeometry();
+        std::vector<SceneCache::Dependency> collectDependencies() const;
         void removeDuplicateSDFGrids();
 
         // Scene setup
         void createMeshData();
+        void createMeshlets();
         void createMeshInstanceData(uint32_t& tlasInstanceIndex);
         void createCurveData();
         void createCurveInstanceData(uint32_t& tlasInstanceIndex);
@@ -31,6 +31,7 @@
 #include "Material/ClothMaterial.h"
 #include "Material/GaussMaterial.h"
 #include "Material/MaterialTextureLoader.h"
+#include "Core/Platform/MemoryMappedFile.h"
 #include "Utils/Logger.h"
 
 #include <lz4_stream/lz4_stream.h>
@@ -44,7 +45,7 @@ namespace Falcor
         /** Specfies the current cache file version.
             This needs to be incremented every time the file format changes!
         */
-        const uint32_t kVersion = 25;
+        const uint32_t kVersion = 33;
 
         /** Scene cache directory (subdirectory in the application data directory).
         */
@@ -205,10 +206,26 @@ namespace Falcor
         // Verify header.
         Header header;
         fs.read(reinterpret_cast<char*>(&header), sizeof(header));
-        return !fs.eof() && header.isValid();
+        if (fs.eof() || !header.isValid()) return false;
+
+        // Verify that the files the scene was imported from are unchanged.
+        InputStream stream(fs);
+        auto dependencies = readDependencies(stream);
+        if (!fs.good()) return false;
+
+        for (const auto& dependency : dependencies)
+        {
+            if (!isDependencyValid(dependency))
+            {
+                logInfo("Scene cache '{}' is out of date, '{}' has changed.", cachePath, dependency.path);
+                return false;
+            }
+        }
+
+        return true;
     }
 
-    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key)
+    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key, const std::vector<Dependency>& dependencies)
     {
         auto cachePath = getCachePath(key);
 
@@ -227,6 +244,10 @@ namespace Falcor
         header.version = kVersion;
         fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
 
+        // Write dependencies (uncompressed), so they can be validated without decompressing the cache.
+        OutputStream headerStream(fs);
+        writeDependencies(headerStream, dependencies);
+
         // Write cache (compressed).
         lz4_stream::basic_ostream<kBlockSize> zs(fs);
         OutputStream stream(zs);
@@ -249,6 +270,10 @@ namespace Falcor
         fs.read(reinterpret_cast<char*>(&header), sizeof(header));
         if (!header.isValid()) FALCOR_THROW("Invalid header in scene cache file '{}'.", cachePath);
 
+        // Skip dependencies (uncompressed).
+        InputStream headerStream(fs);
+        readDependencies(headerStream);
+
         // Read cache (compressed).
         lz4_stream::basic_istream<kBlockSize, kBlockSize> zs(fs);
         InputStream stream(zs);
@@ -257,11 +282,81 @@ namespace Falcor
         return sceneData;
     }
 
+    std::optional<SceneCache::Dependency> SceneCache::createDependency(const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        Dependency dependency;
+        dependency.path = std::filesystem::absolute(path, ec);
+        dependency.size = std::filesystem::file_size(path, ec);
+        if (ec) return {};
+        dependency.modifiedTime = std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+        if (ec) return {};
+        auto contentHash = computeFileHash(path);
+        if (!contentHash) return {};
+        dependency.contentHash = *contentHash;
+        return dependency;
+    }
+
+    bool SceneCache::isDependencyValid(const Dependency& dependency)
+    {
+        std::error_code ec;
+        uint64_t size = std::filesystem::file_size(dependency.path, ec);
+        if (ec || size != dependency.size) return false;
+        int64_t modifiedTime = std::filesystem::last_write_time(dependency.path, ec).time_since_epoch().count();
+        if (ec) return false;
+        if (modifiedTime == dependency.modifiedTime) return true;
+
+        auto contentHash = computeFileHash(dependency.path);
+        return contentHash && *contentHash == dependency.contentHash;
+    }
+
+    std::optional<SceneCache::Key> SceneCache::computeFileHash(const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        uint64_t size = std::filesystem::file_size(path, ec);
+        if (ec) return {};
+
+        SHA1 sha1;
+        sha1.update(size);
+        if (size == 0) return sha1.finalize();
+
+        MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+        if (!file.isOpen()) return {};
+
+        sha1.update(file.getData(), file.getSize());
+        return sha1.finalize();
+    }
+
     std::filesystem::path SceneCache::getCachePath(const Key& key)
     {
         return getAppDataDirectory() / kDirectory / SHA1::toString(key);
     }
 
+    void SceneCache::writeDependencies(OutputStream& stream, const std::vector<Dependency>& dependencies)
+    {
+        stream.write((uint64_t)dependencies.size());
+        for (const auto& dependency : dependencies)
+        {
+            stream.write(dependency.path);
+            stream.write(dependency.size);
+            stream.write(dependency.modifiedTime);
+            stream.write(dependency.contentHash);
+        }
+    }
+
+    std::vector<SceneCache::Dependency> SceneCache::readDependencies(InputStream& stream)
+    {
+        std::vector<Dependency> dependencies(stream.read<uint64_t>());
+        for (auto& dependency : dependencies)
+        {
+            stream.read(dependency.path);
+            stream.read(dependency.size);
+            stream.read(dependency.modifiedTime);
+            stream.read(dependency.contentHash);
+        }
+        return dependencies;
+    }
+
     // SceneData
 
     void SceneCache::writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData)
@@ -348,6 +443,9 @@ namespace Falcor
         stream.write(sceneData.has16BitIndices);
         stream.write(sceneData.has32BitIndices);
         stream.write(sceneData.meshDrawCount);
+        stream.write(sceneData.meshlets);
+        stream.write(sceneData.meshletVertices);
+        stream.write(sceneData.meshletTriangles);
         stream.write(sceneData.meshIndexData);
         stream.write(sceneData.meshStaticData);
         stream.write(sceneData.meshSkinningData);
@@ -369,6 +467,9 @@ namespace Falcor
             stream.write((uint32_t)cachedCurve.vertexData.size());
             for (const auto& data : cachedCurve.vertexData) stream.write(data);
         }
+        stream.write(sceneData.vertexCacheStreaming.enabled);
+        stream.write(sceneData.vertexCacheStreaming.windowSize);
+        stream.write(sceneData.vertexCacheStreaming.positionTolerance);
 
         writeMarker(stream, "CustomPrimitives");
         stream.write(sceneData.customPrimitiveDesc);
@@ -469,6 +570,9 @@ namespace Falcor
         stream.read(sceneData.has16BitIndices);
         stream.read(sceneData.has32BitIndices);
         stream.read(sceneData.meshDrawCount);
+        stream.read(sceneData.meshlets);
+        stream.read(sceneData.meshletVertices);
+        stream.read(sceneData.meshletTriangles);
         stream.read(sceneData.meshIndexData);
         stream.read(sceneData.meshStaticData);
         stream.read(sceneData.meshSkinningData);
@@ -490,6 +594,9 @@ namespace Falcor
             cachedCurve.vertexData.resize(stream.read<uint32_t>());
             for (auto& data : cachedCurve.vertexData) stream.read(data);
         }
+        stream.read(sceneData.vertexCacheStreaming.enabled);
+        stream.read(sceneData.vertexCacheStreaming.windowSize);
+        stream.read(sceneData.vertexCacheStreaming.positionTolerance);
 
         readMarker(stream, "CustomPrimitives");
         stream.read(sceneData.customPrimitiveDesc);
@@ -923,6 +1030,21 @@ namespace Falcor
         stream.write(pAnimation->mInterpolationMode);
         stream.write(pAnimation->mEnableWarping);
         stream.write(pAnimation->mKeyframes);
+        stream.write(pAnimation->mIsCompressed);
+        if (pAnimation->mIsCompressed)
+        {
+            const auto& compressed = pAnimation->mCompressed;
+            stream.write(compressed.times);
+            stream.write(compressed.rotations);
+            stream.write(compressed.rotationValues);
+            for (const auto& track : { &compressed.translations, &compressed.scalings })
+            {
+                stream.write(track->minValue);
+                stream.write(track->step);
+                stream.write(track->quantized);
+                stream.write(track->values);
+            }
+        }
     }
 
     ref<Animation> SceneCache::readAnimation(InputStream& stream)
@@ -936,6 +1058,22 @@ namespace Falcor
         stream.read(pAnimation->mInterpolationMode);
         stream.read(pAnimation->mEnableWarping);
         stream.read(pAnimation->mKeyframes);
+        stream.read(pAnimation->mIsCompressed);
+        if (pAnimation->mIsCompressed)
+        {
+            auto& compressed = pAnimation->mCompressed;
+            stream.read(compressed.times);
+            stream.read(compressed.rotations);
+            stream.read(compressed.rotationValues);
+            for (auto& track : { &compressed.translations, &compressed.scalings })
+            {
+                stream.read(track->minValue);
+                stream.read(track->step);
+                stream.read(track->quantized);
+                stream.read(track->values);
+            }
+        }
+        pAnimation->updateKeyframeTimes();
         return pAnimation;
     }
 
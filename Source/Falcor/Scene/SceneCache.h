@@ -42,6 +42,7 @@
 #include "Utils/CryptoUtils.h"
 
 #include <filesystem>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -50,13 +51,30 @@ namespace Falcor
     /** Helper class for reading and writing scene cache files.
         The scene cache is used to heavily reduce load times of more complex assets.
         The cache stores a binary representation of `Scene::SceneData` which contains everything to re-create a `Scene`.
+        Each cache also records the files the scene was imported from, and is only considered valid while they are unchanged.
     */
     class FALCOR_API SceneCache
     {
     public:
         using Key = SHA1::MD;
 
+        /** Describes the state of a file a cached scene depends on.
+        */
+        struct Dependency
+        {
+            std::filesystem::path path;     ///< Absolute file path.
+            uint64_t size = 0;              ///< File size in bytes.
+            int64_t modifiedTime = 0;       ///< Last modification time in file clock ticks.
+            Key contentHash = {};           ///< Hash of the file content, see computeFileHash().
+
+            bool operator==(const Dependency& other) const
+            {
+                return path == other.path && size == other.size && modifiedTime == other.modifiedTime && contentHash == other.contentHash;
+            }
+        };
+
         /** Check if there is a valid scene cache for a given cache key.
+            The cache is invalid if any of the files it depends on has changed.
             \param[in] key Cache key.
             \return Returns true if a valid cache exists.
         */
@@ -65,8 +83,9 @@ namespace Falcor
         /** Write a scene cache.
             \param[in] sceneData Scene data.
             \param[in] key Cache key.
+            \param[in] dependencies Files the scene was imported from.
         */
-        static void writeCache(const Scene::SceneData& sceneData, const Key& key);
+        static void writeCache(const Scene::SceneData& sceneData, const Key& key, const std::vector<Dependency>& dependencies = {});
 
         /** Read a scene cache.
             \param[in] pDevice GPU device.
@@ -75,12 +94,35 @@ namespace Falcor
         */
         static Scene::SceneData readCache(ref<Device> pDevice, const Key& key);
 
+        /** Record the current state of a file.
+            \param[in] path File path.
+            \return Returns the dependency, or an empty optional if the file does not exist.
+        */
+        static std::optional<Dependency> createDependency(const std::filesystem::path& path);
+
+        /** Check if a file still matches its recorded state.
+            Files with unchanged size and modification time are assumed to be unchanged without reading them.
+            If only the modification time differs, the content hash decides, so touched or copied files do not invalidate the cache.
+            \param[in] dependency Recorded state of the file.
+            \return Returns true if the file exists and its content is unchanged.
+        */
+        static bool isDependencyValid(const Dependency& dependency);
+
+        /** Compute the SHA-1 hash of a file's size and content.
+            \param[in] path File path.
+            \return Returns the hash, or an empty optional if the file cannot be read.
+        */
+        static std::optional<Key> computeFileHash(const std::filesystem::path& path);
+
     private:
         class OutputStream;
         class InputStream;
 
         static std::filesystem::path getCachePath(const Key& key);
 
+        static void writeDependencies(OutputStream& stream, const std::vector<Dependency>& dependencies);
+        static std::vector<Dependency> readDependencies(InputStream& stream);
+
         static void writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData);
         static Scene::SceneData readSceneData(InputStream& stream, ref<Device> pDevice);
 
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "TriangleMesh.h"
+#include "AssimpIOSystem.h"
 #include "GlobalState.h"
 #include "Core/Error.h"
 #include "Core/Platform/OS.h"
@@ -193,7 +194,11 @@ namespace Falcor
         return create(vertices, indices);
     }
 
-    ref<TriangleMesh> TriangleMesh::createFromFile(const std::filesystem::path& path, ImportFlags importFlags)
+    ref<TriangleMesh> TriangleMesh::createFromFile(
+        const std::filesystem::path& path,
+        ImportFlags importFlags,
+        const std::function<void(const std::filesystem::path&)>& fileCallback
+    )
     {
         if (!std::filesystem::exists(path))
         {
@@ -202,6 +207,7 @@ namespace Falcor
         }
 
         Assimp::Importer importer;
+        importer.SetIOHandler(new AssimpIOSystem(fileCallback)); // Importer takes ownership.
 
         unsigned int flags =
             aiProcess_FlipUVs |
@@ -214,6 +220,7 @@ namespace Falcor
 
         if (hasExtension(path, "gz"))
         {
+            if (fileCallback) fileCallback(path);
             auto decompressed = decompressFile(path);
             scene = importer.ReadFileFromMemory(decompressed.data(), decompressed.size(), flags);
         }
@@ -350,14 +357,23 @@ namespace Falcor
         triangleMesh.def_static("createDisk", &TriangleMesh::createDisk, "radius"_a = 1.f, "segments"_a = 32);
         triangleMesh.def_static("createCube", &TriangleMesh::createCube, "size"_a = float3(1.f));
         triangleMesh.def_static("createSphere", &TriangleMesh::createSphere, "radius"_a = 1.f, "segmentsU"_a = 32, "segmentsV"_a = 32);
+        // Files read from a scene script are registered as dependencies of the scene.
+        auto addDependency = [](const std::filesystem::path& path)
+        {
+            if (SceneBuilder* pSceneBuilder = getActivePythonSceneBuilder())
+                pSceneBuilder->addDependency(path);
+        };
         triangleMesh.def_static("createFromFile",
-            [](const std::filesystem::path& path, bool smoothNormals)
-            { return TriangleMesh::createFromFile(getActiveAssetResolver().resolvePath(path), smoothNormals); },
+            [addDependency](const std::filesystem::path& path, bool smoothNormals)
+            {
+                auto importFlags = smoothNormals ? TriangleMesh::ImportFlags::GenSmoothNormals : TriangleMesh::ImportFlags::None;
+                return TriangleMesh::createFromFile(getActiveAssetResolver().resolvePath(path), importFlags, addDependency);
+            },
             "path"_a, "smoothNormals"_a = false
         ); // PYTHONDEPRECATED
         triangleMesh.def_static("createFromFile",
-            [](const std::filesystem::path& path, TriangleMesh::ImportFlags importFlags)
-            { return TriangleMesh::createFromFile(getActiveAssetResolver().resolvePath(path), importFlags); },
+            [addDependency](const std::filesystem::path& path, TriangleMesh::ImportFlags importFlags)
+            { return TriangleMesh::createFromFile(getActiveAssetResolver().resolvePath(path), importFlags, addDependency); },
             "path"_a, "importFlags"_a
         ); // PYTHONDEPRECATED
     }
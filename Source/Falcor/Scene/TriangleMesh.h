@@ -32,6 +32,7 @@
 #include "Utils/Math/Vector.h"
 #include "Utils/Math/Matrix.h"
 #include <filesystem>
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -114,9 +115,15 @@ namespace Falcor
             All geometry found in the asset is pre-transformed and merged into the same triangle mesh.
             \param[in] path File path to load mesh from (absolute or relative to working directory).
             \param[in] flags Flags controlling ASSIMP mesh import options.
+            \param[in] fileCallback Optional callback invoked for every file that is read, including side files such as
+                material libraries. Used to register the files as scene dependencies.
             \return Returns the triangle mesh or nullptr if the mesh failed to load.
         */
-        static ref<TriangleMesh> createFromFile(const std::filesystem::path& path, ImportFlags flags);
+        static ref<TriangleMesh> createFromFile(
+            const std::filesystem::path& path,
+            ImportFlags flags,
+            const std::function<void(const std::filesystem::path&)>& fileCallback = {}
+        );
 
         /** Creates a triangle mesh from a file.
             This is using ASSIMP to support a wide variety of asset formats.
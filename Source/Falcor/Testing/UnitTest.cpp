@@ -43,9 +43,12 @@
 #include <fmt/color.h>
 #include <pugixml.hpp>
 #include <BS_thread_pool_light.hpp>
+#include <nlohmann/json.hpp>
 
 #include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <fstream>
 #include <regex>
 #include <cstdint>
 
@@ -60,6 +63,7 @@ struct TestDesc
     std::string name;
     unittest::Options options;
     CPUTestFunc cpuFunc;
+    CPUBenchmarkFunc benchmarkFunc;
     GPUTestFunc gpuFunc;
 };
 
@@ -76,8 +80,12 @@ struct TestResult
     std::vector<std::string> messages;
     std::string extraMessage;
     uint64_t elapsedMS = 0;
+    std::optional<BenchmarkResult> benchmark;
 };
 
+/// Median time per iteration in nanoseconds of benchmarks from a previous run, keyed by "suite:name".
+using BenchmarkBaseline = std::map<std::string, double>;
+
 static std::vector<TestDesc>& getTestRegistry()
 {
     static std::vector<TestDesc> registry;
@@ -133,6 +141,16 @@ void registerCPUTest(std::filesystem::path path, std::string name, unittest::Opt
     getTestRegistry().push_back(desc);
 }
 
+void registerCPUBenchmark(std::filesystem::path path, std::string name, unittest::Options options, CPUBenchmarkFunc func)
+{
+    TestDesc desc;
+    desc.path = std::move(path);
+    desc.name = std::move(name);
+    desc.options = std::move(options);
+    desc.benchmarkFunc = std::move(func);
+    getTestRegistry().push_back(desc);
+}
+
 void registerGPUTest(std::filesystem::path path, std::string name, unittest::Options options, GPUTestFunc func)
 {
     TestDesc desc;
@@ -211,7 +229,116 @@ inline void writeXmlReport(const std::filesystem::path& path, const std::vector<
     doc.save_file(path.native().c_str());
 }
 
-inline TestResult runTest(const Test& test, DevicePool& devicePool)
+inline std::string formatBenchmarkTime(double ns)
+{
+    if (ns < 1e3)
+        return fmt::format("{:.1f} ns", ns);
+    if (ns < 1e6)
+        return fmt::format("{:.2f} us", ns * 1e-3);
+    if (ns < 1e9)
+        return fmt::format("{:.2f} ms", ns * 1e-6);
+    return fmt::format("{:.2f} s", ns * 1e-9);
+}
+
+inline std::string formatBenchmarkResult(const BenchmarkResult& result)
+{
+    std::string str = fmt::format(
+        "median {}, p95 {}, MAD {}, {} samples x {} iterations",
+        formatBenchmarkTime(result.medianNs),
+        formatBenchmarkTime(result.p95Ns),
+        formatBenchmarkTime(result.madNs),
+        result.sampleCount,
+        result.iterationsPerSample
+    );
+    if (result.bytesPerSecond > 0.0)
+        str += fmt::format(", {}/s", formatByteSize((size_t)result.bytesPerSecond));
+    if (result.itemsPerSecond > 0.0)
+        str += fmt::format(", {:.4g} items/s", result.itemsPerSecond);
+    return str;
+}
+
+inline std::string getBenchmarkKey(const Test& test)
+{
+    return test.suiteName + ":" + test.name;
+}
+
+/**
+ * Remove benchmarks from a list of tests unless they are enabled.
+ * Benchmarks are slow and timing sensitive, so they are not part of regular test runs.
+ */
+inline void removeBenchmarks(std::vector<Test>& tests, const BenchmarkOptions& options)
+{
+    if (options.enabled)
+        return;
+    tests.erase(std::remove_if(tests.begin(), tests.end(), [](const Test& test) { return test.benchmarkFunc != nullptr; }), tests.end());
+}
+
+/**
+ * Read benchmark results from a JSON report written by writeBenchmarkReport().
+ * @param[in] path File path, or an empty path.
+ * @return Median time per benchmark, empty if no path is given.
+ */
+inline BenchmarkBaseline readBenchmarkBaseline(const std::filesystem::path& path)
+{
+    BenchmarkBaseline baseline;
+    if (path.empty())
+        return baseline;
+
+    std::ifstream ifs(path);
+    if (!ifs.good())
+        FALCOR_THROW("Failed to open benchmark baseline '{}'.", path);
+
+    try
+    {
+        nlohmann::json doc = nlohmann::json::parse(ifs);
+        for (const auto& entry : doc.at("benchmarks"))
+            baseline[entry.at("suite").get<std::string>() + ":" + entry.at("name").get<std::string>()] = entry.at("medianNs").get<double>();
+    }
+    catch (const nlohmann::json::exception& e)
+    {
+        FALCOR_THROW("Failed to parse benchmark baseline '{}': {}", path, e.what());
+    }
+
+    return baseline;
+}
+
+/**
+ * Write the benchmark results in JSON format.
+ * @param[in] path File path.
+ * @param[in] report List of tests/results. Results without benchmark statistics are ignored.
+ */
+inline void writeBenchmarkReport(const std::filesystem::path& path, const std::vector<std::pair<Test, TestResult>>& report)
+{
+    nlohmann::json benchmarks = nlohmann::json::array();
+    for (const auto& [test, result] : report)
+    {
+        if (!result.benchmark)
+            continue;
+        const BenchmarkResult& b = *result.benchmark;
+        benchmarks.push_back({
+            {"suite", test.suiteName},
+            {"name", test.name},
+            {"passed", result.status == TestResult::Status::Passed},
+            {"iterationsPerSample", b.iterationsPerSample},
+            {"sampleCount", b.sampleCount},
+            {"medianNs", b.medianNs},
+            {"p95Ns", b.p95Ns},
+            {"madNs", b.madNs},
+            {"minNs", b.minNs},
+            {"bytesPerSecond", b.bytesPerSecond},
+            {"itemsPerSecond", b.itemsPerSecond},
+        });
+    }
+
+    nlohmann::json doc = {{"version", getLongVersionString()}, {"benchmarks", benchmarks}};
+
+    std::ofstream ofs(path);
+    if (!ofs.good())
+        FALCOR_THROW("Failed to write benchmark report '{}'.", path);
+    ofs << doc.dump(4) << std::endl;
+}
+
+inline TestResult runTest(const Test& test, DevicePool& devicePool, const BenchmarkOptions& benchmarkOptions, const BenchmarkBaseline& baseline)
 {
     if (!test.skipMessage.empty())
         return {TestResult::Status::Skipped, {test.skipMessage}};
@@ -223,6 +350,7 @@ inline TestResult runTest(const Test& test, DevicePool& devicePool)
         pDevice = devicePool.acquireDevice(test.deviceType);
 
     CPUUnitTestContext cpuCtx;
+    CPUBenchmarkContext benchmarkCtx(benchmarkOptions);
     GPUUnitTestContext gpuCtx(pDevice);
 
     auto startTime = std::chrono::steady_clock::now();
@@ -231,6 +359,8 @@ inline TestResult runTest(const Test& test, DevicePool& devicePool)
     {
         if (test.cpuFunc)
             test.cpuFunc(cpuCtx);
+        else if (test.benchmarkFunc)
+            test.benchmarkFunc(benchmarkCtx);
         else
             test.gpuFunc(gpuCtx);
     }
@@ -260,7 +390,35 @@ inline TestResult runTest(const Test& test, DevicePool& devicePool)
         result.extraMessage = e.what();
     }
 
-    result.messages = test.cpuFunc ? cpuCtx.getFailureMessages() : gpuCtx.getFailureMessages();
+    if (test.cpuFunc)
+        result.messages = cpuCtx.getFailureMessages();
+    else if (test.benchmarkFunc)
+        result.messages = benchmarkCtx.getFailureMessages();
+    else
+        result.messages = gpuCtx.getFailureMessages();
+
+    // Check the benchmark against the baseline.
+    if (test.benchmarkFunc && result.status == TestResult::Status::Passed)
+    {
+        result.benchmark = benchmarkCtx.getResult();
+        auto it = baseline.find(getBenchmarkKey(test));
+        if (!result.benchmark)
+        {
+            result.status = TestResult::Status::Failed;
+            result.extraMessage = "Benchmark did not call ctx.run().";
+        }
+        else if (it != baseline.end() && result.benchmark->medianNs > it->second * (1.0 + benchmarkOptions.regressionThreshold))
+        {
+            result.status = TestResult::Status::Failed;
+            result.extraMessage = fmt::format(
+                "Benchmark regression: median {} is {:.1f}% slower than the baseline {} (threshold {:.1f}%).",
+                formatBenchmarkTime(result.benchmark->medianNs),
+                (result.benchmark->medianNs / it->second - 1.0) * 100.0,
+                formatBenchmarkTime(it->second),
+                benchmarkOptions.regressionThreshold * 100.0
+            );
+        }
+    }
 
     if (!result.messages.empty())
         result.status = TestResult::Status::Failed;
@@ -297,10 +455,14 @@ inline int32_t runTestsParallel(const RunOptions& options)
     auto startTime = std::chrono::steady_clock::now();
 
     DevicePool devicePool(options.deviceDesc);
+    BenchmarkBaseline baseline = readBenchmarkBaseline(options.benchmark.baselinePath);
 
     // Gather tests.
     std::vector<Test> tests = enumerateTests();
     tests = filterTests(tests, options.testSuiteFilter, options.testCaseFilter, options.tagFilter, options.deviceDesc.type);
+    // Benchmarks only run serially, see runTests().
+    FALCOR_ASSERT(!options.benchmark.enabled);
+    removeBenchmarks(tests, options.benchmark);
 
     std::vector<TestResult> results(tests.size());
 
@@ -311,7 +473,7 @@ inline int32_t runTestsParallel(const RunOptions& options)
     for (size_t testIndex = 0; testIndex < tests.size(); ++testIndex)
     {
         threadPool.push_task(
-            [&abort, &tests, &results, &devicePool, testIndex]()
+            [&abort, &tests, &results, &devicePool, &options, &baseline, testIndex]()
             {
                 if (abort)
                     return;
@@ -322,7 +484,7 @@ inline int32_t runTestsParallel(const RunOptions& options)
 
                 reportLine("[ RUN      ] {}:{}{}", test.suiteName, test.name, repeats);
 
-                result = runTest(test, devicePool);
+                result = runTest(test, devicePool, options.benchmark, baseline);
 
                 std::string statusTag;
                 switch (result.status)
@@ -337,6 +499,8 @@ inline int32_t runTestsParallel(const RunOptions& options)
                     statusTag = "[  SKIPPED ]";
                     break;
                 }
+                if (result.benchmark)
+                    reportLine("[ BENCH    ] {}:{}{} {}", test.suiteName, test.name, repeats, formatBenchmarkResult(*result.benchmark));
                 if (!result.extraMessage.empty())
                     reportLine("{}", result.extraMessage);
                 reportLine("{} {}:{}{} ({} ms)", statusTag, test.suiteName, test.name, repeats, result.elapsedMS);
@@ -389,10 +553,12 @@ inline int32_t runTestsSerial(const RunOptions& options)
     auto startTime = std::chrono::steady_clock::now();
 
     DevicePool devicePool(options.deviceDesc);
+    BenchmarkBaseline baseline = readBenchmarkBaseline(options.benchmark.baselinePath);
 
     // Gather tests.
     std::vector<Test> tests = enumerateTests();
     tests = filterTests(tests, options.testSuiteFilter, options.testCaseFilter, options.tagFilter, options.deviceDesc.type);
+    removeBenchmarks(tests, options.benchmark);
 
     // Split tests into suites.
     std::map<std::string, std::vector<Test>> suites;
@@ -430,7 +596,7 @@ inline int32_t runTestsSerial(const RunOptions& options)
                 if (options.repeat > 1)
                     repeats = fmt::format("[{}/{}]", repeatIndex + 1, options.repeat);
                 reportLine("[ RUN      ] {}:{}{}", suiteName, test.name, repeats);
-                TestResult result = runTest(test, devicePool);
+                TestResult result = runTest(test, devicePool, options.benchmark, baseline);
                 report.emplace_back(test, result);
 
                 std::string statusTag;
@@ -446,6 +612,8 @@ inline int32_t runTestsSerial(const RunOptions& options)
                     statusTag = "[  SKIPPED ]";
                     break;
                 }
+                if (result.benchmark)
+                    reportLine("[ BENCH    ] {}:{}{} {}", suiteName, test.name, repeats, formatBenchmarkResult(*result.benchmark));
                 if (!result.extraMessage.empty())
                     reportLine("{}", result.extraMessage);
                 reportLine("{} {}:{}{} ({} ms)", statusTag, suiteName, test.name, repeats, result.elapsedMS);
@@ -473,6 +641,8 @@ inline int32_t runTestsSerial(const RunOptions& options)
 
     if (!options.xmlReportPath.empty())
         writeXmlReport(options.xmlReportPath, report);
+    if (!options.benchmark.jsonReportPath.empty())
+        writeBenchmarkReport(options.benchmark.jsonReportPath, report);
 
     reportLine(
         "[==========] {} test{} from {} test suite{} ran. ({} ms total)",
@@ -507,7 +677,15 @@ int32_t runTests(const RunOptions& options)
     Threading::start();
     Scripting::start();
 
-    int32_t failureCount = options.parallel > 1 ? runTestsParallel(options) : runTestsSerial(options);
+    // Benchmarks are timing sensitive and must not compete with other tests for the CPU.
+    bool parallel = options.parallel > 1;
+    if (parallel && options.benchmark.enabled)
+    {
+        reportLine("Benchmarks are enabled, running tests serially.");
+        parallel = false;
+    }
+
+    int32_t failureCount = parallel ? runTestsParallel(options) : runTestsSerial(options);
 
     Scripting::shutdown();
     Threading::shutdown();
@@ -532,7 +710,9 @@ std::vector<Test> enumerateTests()
         test.cpuFunc = desc.cpuFunc;
         test.gpuFunc = desc.gpuFunc;
 
-        if (test.cpuFunc)
+        test.benchmarkFunc = desc.benchmarkFunc;
+
+        if (test.cpuFunc || test.benchmarkFunc)
         {
             tests.push_back(test);
         }
@@ -645,6 +825,93 @@ void UnitTestContext::reportFailure(const std::string& message)
 
 ///////////////////////////////////////////////////////////////////////////
 
+BenchmarkResult computeBenchmarkStatistics(std::vector<double> sampleTimesNs, uint64_t bytesPerIteration, uint64_t itemsPerIteration)
+{
+    BenchmarkResult result;
+    result.sampleCount = (uint32_t)sampleTimesNs.size();
+    if (sampleTimesNs.empty())
+        return result;
+
+    // Percentiles are linearly interpolated between the closest ranks.
+    auto percentile = [](const std::vector<double>& sorted, double p)
+    {
+        double pos = p * (sorted.size() - 1);
+        size_t i = (size_t)pos;
+        if (i + 1 >= sorted.size())
+            return sorted.back();
+        return sorted[i] + (sorted[i + 1] - sorted[i]) * (pos - i);
+    };
+
+    std::sort(sampleTimesNs.begin(), sampleTimesNs.end());
+    result.minNs = sampleTimesNs.front();
+    result.medianNs = percentile(sampleTimesNs, 0.5);
+    result.p95Ns = percentile(sampleTimesNs, 0.95);
+
+    std::vector<double> deviations(sampleTimesNs.size());
+    for (size_t i = 0; i < sampleTimesNs.size(); ++i)
+        deviations[i] = std::abs(sampleTimesNs[i] - result.medianNs);
+    std::sort(deviations.begin(), deviations.end());
+    result.madNs = percentile(deviations, 0.5);
+
+    if (result.medianNs > 0.0)
+    {
+        result.bytesPerSecond = bytesPerIteration * 1e9 / result.medianNs;
+        result.itemsPerSecond = itemsPerIteration * 1e9 / result.medianNs;
+    }
+
+    return result;
+}
+
+void CPUBenchmarkContext::run(const std::function<void()>& func)
+{
+    FALCOR_CHECK(!mResult, "CPUBenchmarkContext::run() can only be called once per benchmark.");
+
+    using Clock = std::chrono::steady_clock;
+    const uint64_t kMaxIterationsPerSample = 1ull << 32;
+
+    // Returns the time in seconds to run the given number of iterations.
+    auto measure = [&func](uint64_t iterations)
+    {
+        auto startTime = Clock::now();
+        for (uint64_t i = 0; i < iterations; ++i)
+            func();
+        return std::chrono::duration<double>(Clock::now() - startTime).count();
+    };
+
+    // Warm up caches, allocators and lazily initialized state.
+    double warmupTime = 0.0;
+    double iterationTime = 0.0;
+    do
+    {
+        iterationTime = measure(1);
+        warmupTime += iterationTime;
+    } while (warmupTime < mOptions.warmupTime);
+
+    // Calibrate the number of iterations so that a sample takes at least the minimum sample time.
+    // Very short functions are timed in batches to stay well above the timer resolution.
+    uint64_t iterations = 1;
+    if (iterationTime < mOptions.minSampleTime)
+    {
+        iterations = (uint64_t)std::ceil(mOptions.minSampleTime / std::max(iterationTime, 1e-9));
+        iterations = std::clamp<uint64_t>(iterations, 1, kMaxIterationsPerSample);
+        double sampleTime = measure(iterations);
+        while (sampleTime < mOptions.minSampleTime && iterations < kMaxIterationsPerSample)
+        {
+            iterations = std::min(iterations * 2, kMaxIterationsPerSample);
+            sampleTime = measure(iterations);
+        }
+    }
+
+    std::vector<double> sampleTimesNs(std::max(1u, mOptions.sampleCount));
+    for (auto& sampleTimeNs : sampleTimesNs)
+        sampleTimeNs = measure(iterations) * 1e9 / iterations;
+
+    mResult = computeBenchmarkStatistics(std::move(sampleTimesNs), mBytesPerIteration, mItemsPerIteration);
+    mResult->iterationsPerSample = iterations;
+}
+
+///////////////////////////////////////////////////////////////////////////
+
 void GPUUnitTestContext::createProgram(
     const std::filesystem::path& path,
     const std::string& entry,
@@ -783,6 +1050,49 @@ GPU_TEST(TestGPUTest)
     EXPECT_GE(s[6], 11);
 }
 
+CPU_TEST(TestBenchmarkStatistics)
+{
+    // Shuffled samples 1 to 18 and 20, plus an outlier.
+    std::vector<double> samples = {7, 3, 12, 1, 18, 9, 15, 2, 20, 5, 11, 8, 1000, 4, 16, 6, 13, 10, 17, 14};
+    unittest::BenchmarkResult result = unittest::computeBenchmarkStatistics(samples, 100, 10);
+    EXPECT_EQ(result.sampleCount, 20u);
+    EXPECT_EQ(result.minNs, 1.0);
+    EXPECT_EQ(result.medianNs, 10.5);
+    EXPECT_EQ(result.madNs, 5.0);
+    EXPECT_GE(result.p95Ns, 20.0);
+    EXPECT_LE(result.p95Ns, 1000.0);
+    EXPECT_EQ(result.bytesPerSecond, 100 * 1e9 / 10.5);
+    EXPECT_EQ(result.itemsPerSecond, 10 * 1e9 / 10.5);
+
+    unittest::BenchmarkResult single = unittest::computeBenchmarkStatistics({42.0});
+    EXPECT_EQ(single.medianNs, 42.0);
+    EXPECT_EQ(single.p95Ns, 42.0);
+    EXPECT_EQ(single.madNs, 0.0);
+    EXPECT_EQ(single.bytesPerSecond, 0.0);
+}
+
+CPU_BENCHMARK(TestCPUBenchmark)
+{
+    std::vector<uint32_t> values(1024);
+    for (uint32_t i = 0; i < values.size(); ++i)
+        values[i] = i;
+
+    uint64_t sum = 0;
+    ctx.setItemsPerIteration(values.size());
+    ctx.run(
+        [&]()
+        {
+            for (uint32_t v : values)
+                sum += v;
+        }
+    );
+
+    ASSERT(ctx.getResult().has_value());
+    EXPECT_GT(ctx.getResult()->iterationsPerSample, 0u);
+    EXPECT_GT(ctx.getResult()->medianNs, 0.0);
+    EXPECT_GT(sum, 0u);
+}
+
 CPU_TEST(TestSkip1, "skipped")
 {
     EXPECT(false);
@@ -40,6 +40,7 @@
 #include <filesystem>
 #include <functional>
 #include <map>
+#include <optional>
 #include <set>
 #include <sstream>
 #include <string>
@@ -84,6 +85,24 @@ public:
     SkippingTestException(const std::string& what) : std::runtime_error(what.c_str()) {}
 };
 
+struct BenchmarkOptions
+{
+    /// Run benchmarks. Benchmarks are skipped by default and always run serially.
+    bool enabled = false;
+    /// Minimum time in seconds spent running a benchmark before it is measured.
+    double warmupTime = 0.1;
+    /// Minimum duration of a sample in seconds. The number of iterations per sample is calibrated to reach it.
+    double minSampleTime = 0.05;
+    /// Number of samples to record.
+    uint32_t sampleCount = 10;
+    /// If set, benchmark results are written to this file in JSON format.
+    std::filesystem::path jsonReportPath;
+    /// If set, benchmark results are compared against a JSON report written by a previous run.
+    std::filesystem::path baselinePath;
+    /// A benchmark fails if its median time exceeds the baseline median by more than this fraction.
+    double regressionThreshold = 0.1;
+};
+
 struct RunOptions
 {
     Device::Desc deviceDesc;
@@ -93,14 +112,39 @@ struct RunOptions
     std::filesystem::path xmlReportPath;
     uint32_t parallel = 1;
     uint32_t repeat = 1;
+    BenchmarkOptions benchmark;
 };
 
+/// Benchmark statistics. Times are per iteration in nanoseconds.
+struct BenchmarkResult
+{
+    uint64_t iterationsPerSample = 0;
+    uint32_t sampleCount = 0;
+    double medianNs = 0.0;
+    double p95Ns = 0.0;
+    double madNs = 0.0; ///< Median absolute deviation from the median.
+    double minNs = 0.0;
+    double bytesPerSecond = 0.0; ///< Throughput at the median time, or zero if the bytes per iteration are not set.
+    double itemsPerSecond = 0.0; ///< Throughput at the median time, or zero if the items per iteration are not set.
+};
+
+/**
+ * Compute benchmark statistics.
+ * @param[in] sampleTimesNs Time per iteration of each sample in nanoseconds.
+ * @param[in] bytesPerIteration Bytes processed per iteration, or zero.
+ * @param[in] itemsPerIteration Items processed per iteration, or zero.
+ * @return Statistics, with iterationsPerSample left at zero.
+ */
+FALCOR_API BenchmarkResult computeBenchmarkStatistics(std::vector<double> sampleTimesNs, uint64_t bytesPerIteration = 0, uint64_t itemsPerIteration = 0);
+
 FALCOR_API int32_t runTests(const RunOptions& options);
 
 class CPUUnitTestContext;
+class CPUBenchmarkContext;
 class GPUUnitTestContext;
 
 using CPUTestFunc = std::function<void(CPUUnitTestContext& ctx)>;
+using CPUBenchmarkFunc = std::function<void(CPUBenchmarkContext& ctx)>;
 using GPUTestFunc = std::function<void(GPUUnitTestContext& ctx)>;
 
 struct Test
@@ -112,6 +156,7 @@ struct Test
     Device::Type deviceType;
 
     CPUTestFunc cpuFunc;
+    CPUBenchmarkFunc benchmarkFunc;
     GPUTestFunc gpuFunc;
 };
 
@@ -153,6 +198,41 @@ private:
 class FALCOR_API CPUUnitTestContext : public UnitTestContext
 {};
 
+class FALCOR_API CPUBenchmarkContext : public CPUUnitTestContext
+{
+public:
+    CPUBenchmarkContext(const BenchmarkOptions& options) : mOptions(options) {}
+
+    /**
+     * Set the number of bytes processed by one iteration, used for reporting throughput.
+     */
+    void setBytesPerIteration(uint64_t bytes) { mBytesPerIteration = bytes; }
+
+    /**
+     * Set the number of items processed by one iteration, used for reporting throughput.
+     */
+    void setItemsPerIteration(uint64_t items) { mItemsPerIteration = items; }
+
+    /**
+     * Measure a function. The function is first run repeatedly to warm up,
+     * then the number of iterations per sample is calibrated, and finally
+     * the samples are recorded. Only the function itself is timed, so setup
+     * and validation belong outside of it. Can only be called once per benchmark.
+     */
+    void run(const std::function<void()>& func);
+
+    /**
+     * Returns the result, or an empty optional if run() was not called.
+     */
+    const std::optional<BenchmarkResult>& getResult() const { return mResult; }
+
+private:
+    BenchmarkOptions mOptions;
+    uint64_t mBytesPerIteration = 0;
+    uint64_t mItemsPerIteration = 0;
+    std::optional<BenchmarkResult> mResult;
+};
+
 class FALCOR_API GPUUnitTestContext : public UnitTestContext
 {
 public:
@@ -350,6 +430,7 @@ void applyArgs(Options& options, Args&&... args)
 }
 
 FALCOR_API void registerCPUTest(std::filesystem::path path, std::string name, unittest::Options options, CPUTestFunc func);
+FALCOR_API void registerCPUBenchmark(std::filesystem::path path, std::string name, unittest::Options options, CPUBenchmarkFunc func);
 FALCOR_API void registerGPUTest(std::filesystem::path path, std::string name, unittest::Options options, GPUTestFunc func);
 
 /**
@@ -532,6 +613,7 @@ inline std::optional<std::string> createBinaryMessage(std::string_view lhsStr, s
 
 using UnitTestContext = unittest::UnitTestContext;
 using CPUUnitTestContext = unittest::CPUUnitTestContext;
+using CPUBenchmarkContext = unittest::CPUBenchmarkContext;
 using GPUUnitTestContext = unittest::GPUUnitTestContext;
 
 /**
@@ -568,6 +650,41 @@ using GPUUnitTestContext = unittest::GPUUnitTestContext;
     } RegisterCPUTest##name;                                                    \
     static void CPUUnitTest##name(CPUUnitTestContext& ctx) /* over to the user for the braces */
 
+/**
+ * Macro to define a CPU benchmark. Takes the same optional arguments as CPU_TEST.
+ * The benchmark body sets up its data and calls ctx.run() with the code to measure.
+ * The EXPECT and ASSERT macros can be used to validate the results.
+ *
+ * CPU_BENCHMARK(Benchmark1)
+ * {
+ *     std::vector<float> data(1 << 20, 1.f);
+ *     float sum = 0.f;
+ *     ctx.setBytesPerIteration(data.size() * sizeof(float));
+ *     ctx.run([&]() { sum = std::accumulate(data.begin(), data.end(), 0.f); });
+ *     EXPECT_EQ(sum, float(data.size()));
+ * }
+ *
+ * Results are reported with the median, 95th percentile and median absolute
+ * deviation of the time per iteration.
+ *
+ * Note: All CPU benchmarks are implicitly tagged with "cpu" and "benchmark".
+ */
+#define CPU_BENCHMARK(name, ...)                                                      \
+    static void CPUBenchmark##name(CPUBenchmarkContext& ctx);                         \
+    struct CPUBenchmarkRegisterer##name                                               \
+    {                                                                                 \
+        CPUBenchmarkRegisterer##name()                                                \
+        {                                                                             \
+            std::filesystem::path path = __FILE__;                                    \
+            unittest::Options options;                                                \
+            applyArgs(options, ##__VA_ARGS__);                                        \
+            options.tags.insert("cpu");                                               \
+            options.tags.insert("benchmark");                                         \
+            unittest::registerCPUBenchmark(path, #name, options, CPUBenchmark##name); \
+        }                                                                             \
+    } RegisterCPUBenchmark##name;                                                     \
+    static void CPUBenchmark##name(CPUBenchmarkContext& ctx) /* over to the user for the braces */
+
 /**
  * Macro to define a GPU unit test. The optional arguments include:
  *
@@ -611,9 +728,9 @@ using GPUUnitTestContext = unittest::GPUUnitTestContext;
 
 // clang-format off
 
-/// Used as an argument of CPU_TEST/GPU_TEST to tag a test with a set of strings.
+/// Used as an argument of CPU_TEST/CPU_BENCHMARK/GPU_TEST to tag a test with a set of strings.
 #define TAGS(...) ::Falcor::unittest::Tags{__VA_ARGS__}
-/// Used as an argument of CPU_TEST/GPU_TEST to mark a test to be skipped.
+/// Used as an argument of CPU_TEST/CPU_BENCHMARK/GPU_TEST to mark a test to be skipped.
 #define SKIP(msg) ::Falcor::unittest::Skip{msg}
 /// Used as an argument of GPU_TEST to mark a test to only run for certain devices.
 #define DEVICE_TYPES(...) ::Falcor::unittest::DeviceTypes{__VA_ARGS__}
@@ -31,6 +31,18 @@
 
 namespace Falcor
 {
+namespace
+{
+size_t getSizeClass(size_t byteSize)
+{
+    FALCOR_ASSERT(byteSize > 0);
+    size_t sizeClass = 0;
+    while (byteSize >>= 1)
+        sizeClass++;
+    return sizeClass;
+}
+} // namespace
+
 BufferAllocator::BufferAllocator(size_t alignment, size_t elementSize, size_t cacheLineSize, ResourceBindFlags bindFlags)
     : mAlignment(alignment), mElementSize(elementSize), mCacheLineSize(cacheLineSize), mBindFlags(bindFlags)
 {
@@ -52,10 +64,50 @@ BufferAllocator::BufferAllocator(size_t alignment, size_t elementSize, size_t ca
 
 size_t BufferAllocator::allocate(size_t byteSize)
 {
+    size_t byteOffset = 0;
+    if (byteSize > 0 && allocFromFreeList(byteSize, byteOffset))
+    {
+        // Reused memory is cleared to match the behavior for new allocations.
+        std::memset(mBuffer.data() + byteOffset, 0, byteSize);
+        markAsDirty(byteOffset, byteSize);
+        return byteOffset;
+    }
+
     computeAndAllocatePadding(byteSize);
     return allocInternal(byteSize);
 }
 
+void BufferAllocator::deallocate(size_t byteOffset, size_t byteSize)
+{
+    FALCOR_CHECK(byteSize > 0, "Size must be larger than zero.");
+    FALCOR_CHECK(byteOffset + byteSize <= mBuffer.size(), "Memory region is out of range.");
+
+    // Check that the region does not overlap a free block.
+    auto it = mFreeBlocks.upper_bound(byteOffset);
+    FALCOR_CHECK(it == mFreeBlocks.end() || it->first >= byteOffset + byteSize, "Memory region is already freed.");
+    FALCOR_CHECK(it == mFreeBlocks.begin() || std::prev(it)->second <= byteOffset, "Memory region is already freed.");
+
+    insertFreeBlock(byteOffset, byteOffset + byteSize);
+
+    // Shrink the buffer if the free memory is at the end.
+    auto last = std::prev(mFreeBlocks.end());
+    if (last->second == mBuffer.size())
+    {
+        size_t size = last->first;
+        eraseFreeBlock(last);
+        mBuffer.resize(size);
+
+        // Drop the dirty ranges of the removed memory.
+        for (auto dirty = mDirtyRanges.lower_bound(size); dirty != mDirtyRanges.end();)
+            dirty = mDirtyRanges.erase(dirty);
+        if (!mDirtyRanges.empty())
+        {
+            auto& end = std::prev(mDirtyRanges.end())->second;
+            end = std::min(end, size);
+        }
+    }
+}
+
 void BufferAllocator::setBlob(const void* pData, size_t byteOffset, size_t byteSize)
 {
     FALCOR_CHECK(pData != nullptr, "Invalid pointer.");
@@ -73,7 +125,31 @@ void BufferAllocator::modified(size_t byteOffset, size_t byteSize)
 void BufferAllocator::clear()
 {
     mBuffer.clear();
-    mDirty = {};
+    mDirtyRanges.clear();
+    mFreeBlocks.clear();
+    for (auto& sizeClass : mFreeSizeClasses)
+        sizeClass.clear();
+    mFreeSize = 0;
+}
+
+void BufferAllocator::setUploadOverhead(size_t byteSize)
+{
+    mUploadOverhead = byteSize;
+
+    // Coalesce the existing dirty ranges with the new policy.
+    auto dirtyRanges = std::move(mDirtyRanges);
+    mDirtyRanges.clear();
+    for (const auto& [start, end] : dirtyRanges)
+        markAsDirty(Range(start, end));
+}
+
+std::vector<BufferAllocator::Range> BufferAllocator::getDirtyRanges() const
+{
+    std::vector<Range> ranges;
+    ranges.reserve(mDirtyRanges.size());
+    for (const auto& [start, end] : mDirtyRanges)
+        ranges.emplace_back(start, end);
+    return ranges;
 }
 
 ref<Buffer> BufferAllocator::getGPUBuffer(ref<Device> pDevice)
@@ -104,30 +180,27 @@ ref<Buffer> BufferAllocator::getGPUBuffer(ref<Device> pDevice)
             mpGpuBuffer = pDevice->createBuffer(bufSize, mBindFlags, MemoryType::DeviceLocal, nullptr);
         }
 
-        mDirty = Range(0, mBuffer.size()); // Mark entire buffer as dirty so the data gets uploaded.
+        // Mark entire buffer as dirty so the data gets uploaded.
+        mDirtyRanges.clear();
+        mDirtyRanges[0] = mBuffer.size();
     }
 
-    // If any range is dirty, upload the data from the CPU to the GPU.
-    if (mDirty.start < mDirty.end)
+    // Upload the dirty ranges from the CPU to the GPU.
+    FALCOR_ASSERT(mBuffer.size() <= mpGpuBuffer->getSize());
+    for (const auto& [start, end] : mDirtyRanges)
     {
-        size_t byteSize = mDirty.end - mDirty.start;
-        size_t byteOffset = mDirty.start;
-        FALCOR_ASSERT(byteOffset + byteSize <= mBuffer.size());
-        FALCOR_ASSERT(mBuffer.size() <= mpGpuBuffer->getSize());
-        mpGpuBuffer->setBlob(mBuffer.data() + byteOffset, byteOffset, byteSize);
-
-        mDirty = {mBuffer.size(), 0}; // Reset dirty range to inverted range. Any min/max operation on it will work.
+        FALCOR_ASSERT(start < end && end <= mBuffer.size());
+        mpGpuBuffer->setBlob(mBuffer.data() + start, start, end - start);
     }
+    mDirtyRanges.clear();
 
     return mpGpuBuffer;
 }
 
 // Private
 
-void BufferAllocator::computeAndAllocatePadding(size_t byteSize)
+size_t BufferAllocator::computeAlignedOffset(size_t currentOffset, size_t byteSize) const
 {
-    size_t currentOffset = mBuffer.size();
-
     if (mAlignment > 0 && currentOffset % mAlignment > 0)
     {
         // We're not at the minimum alignment; get aligned.
@@ -145,6 +218,12 @@ void BufferAllocator::computeAndAllocatePadding(size_t byteSize)
         }
     }
 
+    return currentOffset;
+}
+
+void BufferAllocator::computeAndAllocatePadding(size_t byteSize)
+{
+    size_t currentOffset = computeAlignedOffset(mBuffer.size(), byteSize);
     size_t pad = currentOffset - mBuffer.size();
     if (pad > 0)
     {
@@ -157,13 +236,93 @@ size_t BufferAllocator::allocInternal(size_t byteSize)
 {
     size_t byteOffset = mBuffer.size();
     mBuffer.insert(mBuffer.end(), byteSize, {});
+
+    // After the buffer has shrunk, new memory may lie within the existing GPU buffer, which still holds the freed data.
+    // Mark it as dirty so the cleared memory gets uploaded. Memory beyond the GPU buffer is uploaded when it is recreated.
+    if (byteSize > 0 && mpGpuBuffer && byteOffset < mpGpuBuffer->getSize())
+        markAsDirty(byteOffset, byteSize);
+
     return byteOffset;
 }
 
+bool BufferAllocator::allocFromFreeList(size_t byteSize, size_t& byteOffset)
+{
+    // Search the size class of the allocation for the smallest block that fits, including alignment padding.
+    // All blocks in the larger size classes are large enough, but padding may still rule out some of them.
+    for (size_t sizeClass = getSizeClass(byteSize); sizeClass < kSizeClassCount; sizeClass++)
+    {
+        const auto& blocks = mFreeSizeClasses[sizeClass];
+        for (auto it = blocks.lower_bound({byteSize, 0}); it != blocks.end(); ++it)
+        {
+            const size_t start = it->second;
+            const size_t end = start + it->first;
+            const size_t offset = computeAlignedOffset(start, byteSize);
+            if (offset + byteSize > end)
+                continue;
+
+            // Return the padding and the remainder of the block to the free list.
+            eraseFreeBlock(mFreeBlocks.find(start));
+            if (start < offset)
+                insertFreeBlock(start, offset);
+            if (offset + byteSize < end)
+                insertFreeBlock(offset + byteSize, end);
+
+            byteOffset = offset;
+            return true;
+        }
+    }
+    return false;
+}
+
+void BufferAllocator::insertFreeBlock(size_t start, size_t end)
+{
+    FALCOR_ASSERT(start < end);
+
+    // Merge with adjacent free blocks.
+    auto next = mFreeBlocks.lower_bound(start);
+    if (next != mFreeBlocks.begin() && std::prev(next)->second == start)
+    {
+        auto prev = std::prev(next);
+        start = prev->first;
+        eraseFreeBlock(prev);
+    }
+    if (next != mFreeBlocks.end() && next->first == end)
+    {
+        end = next->second;
+        eraseFreeBlock(next);
+    }
+
+    mFreeBlocks[start] = end;
+    mFreeSizeClasses[getSizeClass(end - start)].insert({end - start, start});
+    mFreeSize += end - start;
+}
+
+void BufferAllocator::eraseFreeBlock(std::map<size_t, size_t>::iterator it)
+{
+    FALCOR_ASSERT(it != mFreeBlocks.end());
+    const size_t size = it->second - it->first;
+    mFreeSizeClasses[getSizeClass(size)].erase({size, it->first});
+    mFreeSize -= size;
+    mFreeBlocks.erase(it);
+}
+
 void BufferAllocator::markAsDirty(const Range& range)
 {
     FALCOR_ASSERT(range.start < range.end);
-    mDirty.start = std::min(mDirty.start, range.start);
-    mDirty.end = std::max(mDirty.end, range.end);
+
+    // Merge with all dirty ranges that are closer than the upload overhead.
+    // Uploading the gap between them is cheaper than issuing a separate upload.
+    size_t start = range.start;
+    size_t end = range.end;
+    auto it = mDirtyRanges.lower_bound(start);
+    if (it != mDirtyRanges.begin() && std::prev(it)->second + mUploadOverhead >= start)
+        --it;
+    while (it != mDirtyRanges.end() && it->first <= end + mUploadOverhead)
+    {
+        start = std::min(start, it->first);
+        end = std::max(end, it->second);
+        it = mDirtyRanges.erase(it);
+    }
+    mDirtyRanges[start] = end;
 }
 } // namespace Falcor
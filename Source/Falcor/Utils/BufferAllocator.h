@@ -30,6 +30,9 @@
 #include "Core/Macros.h"
 #include "Core/API/Buffer.h"
 
+#include <array>
+#include <map>
+#include <set>
 #include <vector>
 
 namespace Falcor
@@ -49,10 +52,33 @@ namespace Falcor
  * It is assumed that the base pointer of the GPU buffer starts at a
  * cache line. The implementation doesn't provide any alignment
  * guarantees for the CPU side buffer (where it doesn't matter anyway).
+ *
+ * Allocations can be freed again. Freed memory is kept in free lists
+ * bucketed by power-of-two size classes and reused by later allocations,
+ * subject to the same alignment requirements.
+ *
+ * Modifications are tracked as a set of dirty ranges, which are uploaded
+ * separately to the GPU buffer. Ranges that are close to each other are
+ * coalesced when uploading the gap between them is cheaper than the
+ * overhead of an additional upload.
  */
 class FALCOR_API BufferAllocator
 {
 public:
+    /// Default upload overhead in bytes, see setUploadOverhead().
+    static constexpr size_t kDefaultUploadOverhead = 4096;
+
+    /// Byte range [start, end) of the buffer.
+    struct Range
+    {
+        size_t start = 0;
+        size_t end = 0;
+        Range(){};
+        Range(size_t s, size_t e) : start(s), end(e) {}
+        size_t size() const { return end - start; }
+        bool operator==(const Range& other) const { return start == other.start && end == other.end; }
+    };
+
     /**
      * Create a buffer allocator.
      * @param[in] alignment Minimum alignment in bytes for any allocation.
@@ -68,7 +94,8 @@ public:
     );
 
     /**
-     * Allocates a memory region.
+     * Allocates a memory region. The memory is zero-initialized.
+     * Previously freed memory is reused if possible, otherwise the buffer is grown.
      * @param[in] byteSize Amount of memory in bytes to allocate.
      * @return Offset in bytes to the allocated memory.
      */
@@ -94,8 +121,7 @@ public:
     size_t pushBack(const T& obj)
     {
         const size_t byteSize = sizeof(T);
-        computeAndAllocatePadding(byteSize);
-        size_t byteOffset = allocInternal(byteSize);
+        size_t byteOffset = allocate(byteSize);
         T* ptr = reinterpret_cast<T*>(mBuffer.data() + byteOffset);
         *ptr = obj;
         markAsDirty(byteOffset, byteSize);
@@ -111,14 +137,32 @@ public:
     size_t emplaceBack(Args&&... args)
     {
         const size_t byteSize = sizeof(T);
-        computeAndAllocatePadding(byteSize);
-        size_t byteOffset = allocInternal(byteSize);
+        size_t byteOffset = allocate(byteSize);
         void* ptr = mBuffer.data() + byteOffset;
         new (ptr) T(std::forward<Args>(args)...);
         markAsDirty(byteOffset, byteSize);
         return byteOffset;
     }
 
+    /**
+     * Frees a memory region so that it can be reused by later allocations.
+     * If the region is at the end of the buffer, the buffer is shrunk instead.
+     * @param[in] byteOffset Offset in bytes to the allocated memory, as returned by the allocation.
+     * @param[in] byteSize Size in bytes of the allocation.
+     */
+    void deallocate(size_t byteOffset, size_t byteSize);
+
+    /**
+     * Frees memory holding an array of the given type.
+     * @param[in] byteOffset Offset in bytes to the allocated memory.
+     * @param[in] count Number of array elements.
+     */
+    template<typename T>
+    void deallocate(size_t byteOffset, size_t count = 1)
+    {
+        deallocate(byteOffset, count * sizeof(T));
+    }
+
     /**
      * Set data into a memory region.
      * @param[in] pData Pointer to the source data.
@@ -186,6 +230,32 @@ public:
      */
     size_t getSize() const { return mBuffer.size(); }
 
+    /**
+     * Get the amount of freed memory that is available for reuse.
+     * @return Size in bytes.
+     */
+    size_t getFreeSize() const { return mFreeSize; }
+
+    /**
+     * Set the upload overhead used for coalescing dirty ranges.
+     * The overhead is the fixed cost of an upload expressed as the number of bytes that could be transferred in the same time.
+     * Dirty ranges separated by fewer bytes are merged into a single upload.
+     * @param[in] byteSize Upload overhead in bytes. A value of zero only merges touching or overlapping ranges.
+     */
+    void setUploadOverhead(size_t byteSize);
+
+    /**
+     * Get the upload overhead used for coalescing dirty ranges.
+     * @return Upload overhead in bytes.
+     */
+    size_t getUploadOverhead() const { return mUploadOverhead; }
+
+    /**
+     * Get the ranges of the buffer that will be uploaded on the next call to getGPUBuffer().
+     * @return Sorted list of disjoint ranges.
+     */
+    std::vector<Range> getDirtyRanges() const;
+
     /**
      * Clear buffer. This removes all allocations.
      */
@@ -198,16 +268,14 @@ public:
     ref<Buffer> getGPUBuffer(ref<Device> pDevice);
 
 private:
+    static constexpr size_t kSizeClassCount = 64;
+
+    size_t computeAlignedOffset(size_t currentOffset, size_t byteSize) const;
     void computeAndAllocatePadding(size_t byteSize);
     size_t allocInternal(size_t byteSize);
-
-    struct Range
-    {
-        size_t start = 0;
-        size_t end = 0;
-        Range(){};
-        Range(size_t s, size_t e) : start(s), end(e) {}
-    };
+    bool allocFromFreeList(size_t byteSize, size_t& byteOffset);
+    void insertFreeBlock(size_t start, size_t end);
+    void eraseFreeBlock(std::map<size_t, size_t>::iterator it);
 
     void markAsDirty(const Range& range);
     void markAsDirty(size_t byteOffset, size_t byteSize) { markAsDirty(Range(byteOffset, byteOffset + byteSize)); }
@@ -224,9 +292,19 @@ private:
     /// Bind flags for the GPU buffer.
     const ResourceBindFlags mBindFlags;
 
-    /// Range of buffer that is dirty and needs to be updatd on the GPU. We track a single dirty range for now to minimize the number of
-    /// uploads, but this could be changed.
-    Range mDirty;
+    /// Fixed cost of an upload in bytes. Dirty ranges closer than this are coalesced.
+    size_t mUploadOverhead = kDefaultUploadOverhead;
+
+    /// Disjoint ranges of the buffer that are dirty and need to be updated on the GPU, mapping start to end offset.
+    std::map<size_t, size_t> mDirtyRanges;
+
+    /// Disjoint and non-adjacent free blocks, mapping start to end offset.
+    std::map<size_t, size_t> mFreeBlocks;
+
+    /// Free blocks as (size, start) pairs, bucketed by the size class floor(log2(size)).
+    std::array<std::set<std::pair<size_t, size_t>>, kSizeClassCount> mFreeSizeClasses;
+
+    size_t mFreeSize = 0; ///< Total size of the free blocks in bytes.
 
     std::vector<uint8_t> mBuffer; ///< CPU buffer holding a copy of the data.
     ref<Buffer> mpGpuBuffer;      ///< GPU buffer holding the data.
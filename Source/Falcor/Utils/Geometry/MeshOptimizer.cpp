@@ -0,0 +1,327 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshOptimizer.h"
+#include "Utils/Math/AABB.h"
+#include <algorithm>
+#include <numeric>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kInvalidIndex = 0xffffffff;
+
+/// Expand 10 bits to 30 bits by inserting two zeros after each bit.
+uint32_t expandBits(uint32_t v)
+{
+    v = (v * 0x00010001u) & 0xFF0000FFu;
+    v = (v * 0x00000101u) & 0x0F00F00Fu;
+    v = (v * 0x00000011u) & 0xC30C30C3u;
+    v = (v * 0x00000005u) & 0x49249249u;
+    return v;
+}
+
+uint32_t morton3D(float3 p)
+{
+    uint3 q = uint3(clamp(p * 1024.f, float3(0.f), float3(1023.f)));
+    return (expandBits(q.x) << 2) | (expandBits(q.y) << 1) | expandBits(q.z);
+}
+
+/// Triangle adjacency of each vertex in compressed row format.
+struct VertexAdjacency
+{
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> triangles;
+
+    VertexAdjacency(fstd::span<const uint32_t> indices, uint32_t vertexCount) : offsets(vertexCount + 1, 0), triangles(indices.size())
+    {
+        for (uint32_t v : indices)
+            offsets[v + 1]++;
+        std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+        std::vector<uint32_t> cursor(offsets.begin(), offsets.end() - 1);
+        for (size_t i = 0; i < indices.size(); i++)
+            triangles[cursor[indices[i]]++] = (uint32_t)(i / 3);
+    }
+
+    uint32_t getCount(uint32_t v) const { return offsets[v + 1] - offsets[v]; }
+};
+
+/**
+ * Reorder clusters of triangles so that clusters facing away from the mesh center are drawn first.
+ * This is the view-independent overdraw metric from Sander et al. 2007.
+ */
+void sortClusters(
+    fstd::span<uint32_t> indices,
+    fstd::span<const float3> positions,
+    const std::vector<uint32_t>& clusterOffsets
+)
+{
+    const size_t triangleCount = indices.size() / 3;
+    const size_t clusterCount = clusterOffsets.size() - 1;
+    if (clusterCount <= 1)
+        return;
+
+    // Area-weighted mesh centroid.
+    float3 meshCentroid(0.f);
+    float meshArea = 0.f;
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        const float3& p0 = positions[indices[t * 3 + 0]];
+        const float3& p1 = positions[indices[t * 3 + 1]];
+        const float3& p2 = positions[indices[t * 3 + 2]];
+        float area = length(cross(p1 - p0, p2 - p0));
+        meshCentroid += (p0 + p1 + p2) * (area / 3.f);
+        meshArea += area;
+    }
+    meshCentroid = meshArea > 0.f ? meshCentroid / meshArea : float3(0.f);
+
+    // Sort key is the projection of the cluster centroid onto the cluster normal, relative to the mesh centroid.
+    std::vector<float> sortKey(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++)
+    {
+        float3 centroid(0.f);
+        float3 normal(0.f);
+        float area = 0.f;
+        for (uint32_t t = clusterOffsets[c]; t < clusterOffsets[c + 1]; t++)
+        {
+            const float3& p0 = positions[indices[t * 3 + 0]];
+            const float3& p1 = positions[indices[t * 3 + 1]];
+            const float3& p2 = positions[indices[t * 3 + 2]];
+            float3 n = cross(p1 - p0, p2 - p0);
+            float a = length(n);
+            centroid += (p0 + p1 + p2) * (a / 3.f);
+            normal += n;
+            area += a;
+        }
+        centroid = area > 0.f ? centroid / area : float3(0.f);
+        float normalLength = length(normal);
+        sortKey[c] = normalLength > 0.f ? dot(centroid - meshCentroid, normal / normalLength) : 0.f;
+    }
+
+    std::vector<uint32_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return sortKey[a] > sortKey[b]; });
+
+    std::vector<uint32_t> sorted;
+    sorted.reserve(indices.size());
+    for (uint32_t c : order)
+        sorted.insert(sorted.end(), indices.begin() + clusterOffsets[c] * 3, indices.begin() + clusterOffsets[c + 1] * 3);
+    std::copy(sorted.begin(), sorted.end(), indices.begin());
+}
+} // namespace
+
+VertexCacheStats analyzeVertexCache(fstd::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+    FALCOR_CHECK(indices.size() % 3 == 0, "Index count must be a multiple of 3.");
+    FALCOR_CHECK(cacheSize > 0, "Cache size must be larger than zero.");
+
+    VertexCacheStats stats;
+    stats.triangleCount = (uint32_t)(indices.size() / 3);
+    stats.vertexCount = vertexCount;
+
+    // FIFO cache. A vertex is still cached if fewer than 'cacheSize' vertices were inserted after it.
+    std::vector<uint32_t> insertTime(vertexCount, kInvalidIndex);
+    uint32_t time = 0;
+    for (uint32_t v : indices)
+    {
+        FALCOR_CHECK(v < vertexCount, "Vertex index {} is out of range.", v);
+        if (insertTime[v] == kInvalidIndex || time - insertTime[v] > cacheSize)
+        {
+            insertTime[v] = time++;
+            stats.transformedVertexCount++;
+        }
+    }
+
+    stats.acmr = stats.triangleCount > 0 ? (float)stats.transformedVertexCount / stats.triangleCount : 0.f;
+    stats.atvr = vertexCount > 0 ? (float)stats.transformedVertexCount / vertexCount : 0.f;
+    return stats;
+}
+
+void sortTrianglesSpatially(fstd::span<uint32_t> indices, fstd::span<const float3> positions)
+{
+    FALCOR_CHECK(indices.size() % 3 == 0, "Index count must be a multiple of 3.");
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount <= 1)
+        return;
+
+    std::vector<float3> centroids(triangleCount);
+    AABB bounds;
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        centroids[t] = (positions[indices[t * 3 + 0]] + positions[indices[t * 3 + 1]] + positions[indices[t * 3 + 2]]) / 3.f;
+        bounds.include(centroids[t]);
+    }
+
+    const float3 extent = bounds.extent();
+    const float3 scale = float3(
+        extent.x > 0.f ? 1.f / extent.x : 0.f, extent.y > 0.f ? 1.f / extent.y : 0.f, extent.z > 0.f ? 1.f / extent.z : 0.f
+    );
+
+    std::vector<std::pair<uint32_t, uint32_t>> keys(triangleCount);
+    for (size_t t = 0; t < triangleCount; t++)
+        keys[t] = {morton3D((centroids[t] - bounds.minPoint) * scale), (uint32_t)t};
+    std::sort(keys.begin(), keys.end());
+
+    std::vector<uint32_t> sorted(indices.size());
+    for (size_t t = 0; t < triangleCount; t++)
+    {
+        uint32_t src = keys[t].second;
+        for (uint32_t i = 0; i < 3; i++)
+            sorted[t * 3 + i] = indices[src * 3 + i];
+    }
+    std::copy(sorted.begin(), sorted.end(), indices.begin());
+}
+
+void optimizeVertexCache(fstd::span<uint32_t> indices, fstd::span<const float3> positions, uint32_t cacheSize)
+{
+    FALCOR_CHECK(indices.size() % 3 == 0, "Index count must be a multiple of 3.");
+    FALCOR_CHECK(cacheSize > 0, "Cache size must be larger than zero.");
+    const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+    if (triangleCount <= 1)
+        return;
+
+    uint32_t vertexCount = *std::max_element(indices.begin(), indices.end()) + 1;
+    FALCOR_CHECK(positions.empty() || positions.size() >= vertexCount, "Not enough vertex positions.");
+
+    VertexAdjacency adjacency(indices, vertexCount);
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+        liveTriangles[v] = adjacency.getCount(v);
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEndStack;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+
+    // Clusters are delimited by dead-ends, where the next fanning vertex is not adjacent to the previous one.
+    std::vector<uint32_t> clusterOffsets = {0};
+
+    uint32_t time = cacheSize + 1;
+    uint32_t cursor = 0;
+
+    auto skipDeadEnd = [&]() -> uint32_t
+    {
+        while (!deadEndStack.empty())
+        {
+            uint32_t v = deadEndStack.back();
+            deadEndStack.pop_back();
+            if (liveTriangles[v] > 0)
+                return v;
+        }
+        while (cursor < vertexCount)
+        {
+            if (liveTriangles[cursor] > 0)
+                return cursor;
+            cursor++;
+        }
+        return kInvalidIndex;
+    };
+
+    uint32_t fanningVertex = 0;
+    while (fanningVertex != kInvalidIndex)
+    {
+        // Emit all live triangles adjacent to the fanning vertex.
+        candidates.clear();
+        for (uint32_t i = adjacency.offsets[fanningVertex]; i < adjacency.offsets[fanningVertex + 1]; i++)
+        {
+            uint32_t t = adjacency.triangles[i];
+            if (emitted[t])
+                continue;
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                uint32_t v = indices[t * 3 + j];
+                output.push_back(v);
+                deadEndStack.push_back(v);
+                candidates.push_back(v);
+                liveTriangles[v]--;
+                if (time - cacheTime[v] > cacheSize)
+                    cacheTime[v] = time++;
+            }
+            emitted[t] = true;
+        }
+
+        // Select the candidate that is still in the cache after its remaining triangles are emitted, preferring the oldest.
+        uint32_t next = kInvalidIndex;
+        int bestPriority = -1;
+        for (uint32_t v : candidates)
+        {
+            if (liveTriangles[v] == 0)
+                continue;
+            int priority = 0;
+            if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize)
+                priority = (int)(time - cacheTime[v]);
+            if (priority > bestPriority)
+            {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+
+        if (next == kInvalidIndex)
+        {
+            next = skipDeadEnd();
+            if (output.size() / 3 > clusterOffsets.back())
+                clusterOffsets.push_back((uint32_t)(output.size() / 3));
+        }
+        fanningVertex = next;
+    }
+
+    FALCOR_ASSERT(output.size() == indices.size());
+    if (clusterOffsets.back() != triangleCount)
+        clusterOffsets.push_back(triangleCount);
+
+    std::copy(output.begin(), output.end(), indices.begin());
+
+    if (!positions.empty())
+        sortClusters(indices, positions, clusterOffsets);
+}
+
+std::vector<uint32_t> optimizeVertexFetch(fstd::span<uint32_t> indices, uint32_t vertexCount)
+{
+    std::vector<uint32_t> remap(vertexCount, kInvalidIndex);
+    uint32_t nextVertex = 0;
+    for (uint32_t& v : indices)
+    {
+        FALCOR_CHECK(v < vertexCount, "Vertex index {} is out of range.", v);
+        if (remap[v] == kInvalidIndex)
+            remap[v] = nextVertex++;
+        v = remap[v];
+    }
+
+    // Place unreferenced vertices last.
+    for (uint32_t& r : remap)
+        if (r == kInvalidIndex)
+            r = nextVertex++;
+
+    FALCOR_ASSERT(nextVertex == vertexCount);
+    return remap;
+}
+} // namespace Falcor
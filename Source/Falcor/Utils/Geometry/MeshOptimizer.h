@@ -0,0 +1,100 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Error.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Statistics from simulating a FIFO post-transform vertex cache on a triangle list.
+ */
+struct VertexCacheStats
+{
+    uint32_t triangleCount = 0;
+    uint32_t vertexCount = 0;
+    uint32_t transformedVertexCount = 0; ///< Number of cache misses, i.e. vertex shader invocations.
+    float acmr = 0.f;                    ///< Average cache miss ratio (transformed vertices per triangle). Ideal is ~0.5.
+    float atvr = 0.f;                    ///< Average transform to vertex ratio (transformed vertices per vertex). Ideal is 1.
+};
+
+/**
+ * Simulate a FIFO post-transform vertex cache.
+ * @param[in] indices Triangle list indices.
+ * @param[in] vertexCount Number of vertices referenced by the indices.
+ * @param[in] cacheSize Number of entries in the simulated cache.
+ * @return Cache statistics.
+ */
+FALCOR_API VertexCacheStats analyzeVertexCache(fstd::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = 32);
+
+/**
+ * Reorder triangles along a Morton curve through the triangle centroids.
+ * This improves spatial locality of the triangle order, e.g. for BLAS builds and as a starting point for cache optimization.
+ * @param[in,out] indices Triangle list indices.
+ * @param[in] positions Vertex positions.
+ */
+FALCOR_API void sortTrianglesSpatially(fstd::span<uint32_t> indices, fstd::span<const float3> positions);
+
+/**
+ * Reorder triangles for post-transform vertex cache efficiency and reduced overdraw.
+ * Implements the "Tipsify" algorithm from Sander et al. 2007, "Fast Triangle Reordering for Vertex Locality and Reduced
+ * Overdraw". Triangles are emitted in clusters, which are then sorted so that outward facing clusters are drawn first.
+ * @param[in,out] indices Triangle list indices.
+ * @param[in] positions Vertex positions used for overdraw optimization. If empty, clusters are not reordered.
+ * @param[in] cacheSize Target vertex cache size.
+ */
+FALCOR_API void optimizeVertexCache(fstd::span<uint32_t> indices, fstd::span<const float3> positions, uint32_t cacheSize = 16);
+
+/**
+ * Compute a vertex order for fetch locality, where vertices are numbered in order of first use by the triangles.
+ * Unreferenced vertices are placed last. The indices are updated to the new vertex order.
+ * @param[in,out] indices Triangle list indices.
+ * @param[in] vertexCount Number of vertices.
+ * @return Remapping table holding the new index of each original vertex.
+ */
+FALCOR_API std::vector<uint32_t> optimizeVertexFetch(fstd::span<uint32_t> indices, uint32_t vertexCount);
+
+/**
+ * Reorder vertex data according to a remapping table returned by optimizeVertexFetch().
+ * @param[in,out] vertices Vertex data.
+ * @param[in] remap Remapping table holding the new index of each original vertex.
+ */
+template<typename T>
+void remapVertices(std::vector<T>& vertices, const std::vector<uint32_t>& remap)
+{
+    FALCOR_ASSERT(vertices.size() == remap.size());
+    std::vector<T> remapped(vertices.size());
+    for (size_t i = 0; i < vertices.size(); i++)
+        remapped[remap[i]] = std::move(vertices[i]);
+    vertices = std::move(remapped);
+}
+} // namespace Falcor
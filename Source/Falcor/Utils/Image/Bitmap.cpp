@@ -28,7 +28,7 @@
 #include "Bitmap.h"
 #include "Core/Macros.h"
 #include "Core/API/Texture.h"
-#include "Core/Platform/MemoryMappedFile.h"
+#include "Core/Platform/IOService.h"
 #include "Utils/Math/ScalarMath.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
@@ -226,16 +226,16 @@ Bitmap::UniqueConstPtr Bitmap::createFromFile(const std::filesystem::path& path,
     }
 
     // Read file using memory mapped access which is much faster than regular file IO.
-    MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
-    if (!file.isOpen())
+    auto pFile = IOService::get().map(path, MemoryMappedFile::AccessHint::SequentialScan);
+    if (!pFile)
     {
         genWarning("Can't open image file {}", path);
         return nullptr;
     }
-    FIMEMORY* memory = FreeImage_OpenMemory((BYTE*)file.getData(), file.getSize());
+    FIMEMORY* memory = FreeImage_OpenMemory((BYTE*)pFile->getData(), pFile->getSize());
     FIBITMAP* pDib = FreeImage_LoadFromMemory(fifFormat, memory);
     FreeImage_CloseMemory(memory);
-    file.close();
+    pFile.reset();
 
     if (pDib == nullptr)
     {
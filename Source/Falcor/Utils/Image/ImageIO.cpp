@@ -30,7 +30,7 @@
 #include "Core/API/Device.h"
 #include "Core/API/CopyContext.h"
 #include "Core/API/NativeFormats.h"
-#include "Core/Platform/MemoryMappedFile.h"
+#include "Core/Platform/IOService.h"
 #include "Utils/Math/ScalarMath.h"
 #include "Utils/Logger.h"
 
@@ -522,13 +522,13 @@ void readDDSHeader(ImportData& data, const void* pHeaderData, size_t& headerSize
 // Loads the information and data for the specified image. This function does not handle creation of the texture for the image.
 void loadDDS(const std::filesystem::path& path, bool loadAsSrgb, ImportData& data)
 {
-    MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
-    if (!file.isOpen())
+    auto pFile = IOService::get().map(path, MemoryMappedFile::AccessHint::SequentialScan);
+    if (!pFile)
     {
         FALCOR_THROW("Failed to open file.");
     }
 
-    if (file.getSize() < (sizeof(uint32_t) + sizeof(DDS_HEADER)))
+    if (pFile->getSize() < (sizeof(uint32_t) + sizeof(DDS_HEADER)))
     {
         FALCOR_THROW("Failed to read DDS header (file too small).");
     }
@@ -539,18 +539,18 @@ void loadDDS(const std::filesystem::path& path, bool loadAsSrgb, ImportData& dat
     size_t headerSize = maxHeaderSize;
 
     // The actual header size may be smaller than the max size; be sure not to read past the end of the file.
-    std::memcpy(header, file.getData(), std::min<size_t>(file.getSize(), headerSize));
+    std::memcpy(header, pFile->getData(), std::min<size_t>(pFile->getSize(), headerSize));
     readDDSHeader(data, header, headerSize, loadAsSrgb);
 
-    if (file.getSize() <= headerSize)
+    if (pFile->getSize() <= headerSize)
     {
         FALCOR_THROW("No image data after DDS header.");
     }
 
     // Read image data.
-    size_t imageSize = file.getSize() - headerSize;
+    size_t imageSize = pFile->getSize() - headerSize;
     data.imageData.resize(imageSize);
-    std::memcpy(data.imageData.data(), reinterpret_cast<const uint8_t*>(file.getData()) + headerSize, imageSize);
+    std::memcpy(data.imageData.data(), reinterpret_cast<const uint8_t*>(pFile->getData()) + headerSize, imageSize);
 }
 } // namespace
 
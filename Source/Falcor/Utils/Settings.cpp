@@ -63,8 +63,85 @@ std::vector<std::string> toStrings(const nlohmann::json& value)
     return result;
 }
 
+bool isRegexLiteral(const std::string_view str)
+{
+    return str.find_first_of("^$\\.*+?()[]{}|") == std::string_view::npos;
+}
+
+// Collect the attributes that can be reached through ':' separated names, see SettingsProperties::get().
+void flattenAttributes(const nlohmann::json& json, const std::string& prefix, std::map<std::string, const nlohmann::json*>& attributes)
+{
+    for (auto& it : json.items())
+    {
+        // Keys containing ':' can never be looked up, as the name is always split at the first ':'.
+        if (it.key().empty() || it.key().find(':') != std::string::npos)
+            continue;
+        std::string name = prefix.empty() ? it.key() : prefix + ":" + it.key();
+        if (it.value().is_object())
+            flattenAttributes(it.value(), name, attributes);
+        attributes[name] = &it.value();
+    }
+}
+
 } // namespace
 
+std::shared_ptr<const Settings::FilteredAttributeIndex> Settings::buildFilteredAttributeIndex(const nlohmann::json& attributes)
+{
+    if (!attributes.is_object())
+        return nullptr;
+
+    std::map<std::string, const nlohmann::json*> flattened;
+    flattenAttributes(attributes, "", flattened);
+
+    auto index = std::make_shared<FilteredAttributeIndex>();
+    for (const auto& [name, value] : flattened)
+    {
+        FilteredAttribute attribute;
+        attribute.value = *value;
+
+        auto filterIt = flattened.find(name + ".filter");
+        if (filterIt != flattened.end())
+        {
+            // The filter can be either a string, or an array of 1 or 2 values
+            // (first being the expression, second optionally a boolean for negating the expression).
+            const nlohmann::json& filter = *filterIt->second;
+            std::string expression;
+            if (filter.is_string())
+            {
+                expression = filter.get<std::string>();
+            }
+            else
+            {
+                FALCOR_CHECK(filter.is_array(), "Expecting an array");
+                expression = filter[0].get<std::string>();
+                if (filter.size() > 1)
+                    attribute.negateFilter = filter[1].get<bool>();
+            }
+
+            if (isRegexLiteral(expression))
+            {
+                attribute.filterType = FilteredAttribute::FilterType::Exact;
+                attribute.pattern = std::move(expression);
+            }
+            else if (expression.size() >= 2 && expression.compare(expression.size() - 2, 2, ".*") == 0 &&
+                     isRegexLiteral(std::string_view(expression).substr(0, expression.size() - 2)))
+            {
+                attribute.filterType = FilteredAttribute::FilterType::Prefix;
+                attribute.pattern = expression.substr(0, expression.size() - 2);
+            }
+            else
+            {
+                attribute.filterType = FilteredAttribute::FilterType::Regex;
+                attribute.regex = std::regex(expression);
+                attribute.pattern = std::move(expression);
+            }
+        }
+
+        index->emplace(name, std::move(attribute));
+    }
+    return index;
+}
+
 Settings& Settings::getGlobalSettings()
 {
     static Settings globalSettings = []()
@@ -109,12 +186,16 @@ bool Settings::addOptionsJSON(const std::filesystem::path& path)
 
 void Settings::addFilteredAttributes(const pybind11::dict& attributes)
 {
-    merge(getActive().mFilteredAttributes, pyjson::to_json(attributes));
+    SettingsData& data = getActive();
+    merge(data.mFilteredAttributes, pyjson::to_json(attributes));
+    data.mFilteredAttributeIndex = buildFilteredAttributeIndex(data.mFilteredAttributes);
 }
 
 void Settings::clearFilteredAttributes()
 {
-    getActive().mFilteredAttributes.clear();
+    SettingsData& data = getActive();
+    data.mFilteredAttributes.clear();
+    data.mFilteredAttributeIndex.reset();
 }
 
 void Settings::updateSearchPaths(const nlohmann::json& update)
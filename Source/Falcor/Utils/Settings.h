@@ -35,6 +35,7 @@
 #include <optional>
 #include <mutex>
 #include <map>
+#include <memory>
 #include <filesystem>
 #include <vector>
 
@@ -348,42 +349,27 @@ public:
         // The underlying library requires attribute names to be null terminated
         FALCOR_ASSERT(!attributeName.empty() && attributeName.data()[attributeName.size()] == 0);
 
-        SettingsProperties props(&getActive().mFilteredAttributes);
-
-        std::string str = props.toString();
+        // The filtered attributes are compiled into an index whenever they change, so this is just a lookup.
+        const FilteredAttributeIndex* index = getActive().mFilteredAttributeIndex.get();
+        if (!index)
+            return std::optional<T>();
 
         // Don't have it at all (or have it with a wrong type)
-        if (!props.has<T>(attributeName))
+        auto it = index->find(attributeName);
+        if (it == index->end() || !SettingsProperties::isType<T>(it->second.value))
             return std::optional<T>();
 
-        std::string attributeNameFilter = std::string(attributeName) + ".filter";
-
-        // If we don't have the filter at all, we can return the value right away
-        if (!props.has(attributeNameFilter))
-            return props.get<T>(attributeName);
+        if (!it->second.appliesTo(shapeName))
+            return std::optional<T>();
 
-        // filter can be either std::string, or a pybind11::list of 1 or 2 values
-        // (first being std::string, second optionally boolean).
-        // Unfortunately, pybind makes us do a ton of unnecessary lookups here:
-        std::string expression;
-        bool negateRegex = false;
-        if (props.has<std::string>(attributeNameFilter))
+        try
         {
-            expression = props.get(attributeNameFilter, expression);
+            return SettingsProperties::JsonCaster<T>::cast(it->second.value);
         }
-        else
+        catch (const nlohmann::json::type_error& e)
         {
-            nlohmann::json array = *props.get<nlohmann::json>(attributeNameFilter);
-            FALCOR_CHECK(array.is_array(), "Expecting an array");
-            expression = array[0].get<std::string>();
-            if (array.size() > 1)
-                negateRegex = array[1].get<bool>();
+            throw SettingsProperties::TypeError(e.what());
         }
-
-        if (matches(shapeName, expression) == negateRegex)
-            return std::optional<T>();
-
-        return props.get<T>(attributeName);
     }
 
     template<typename T>
@@ -436,6 +422,10 @@ public:
     // Clears all the attributes to default
     void clearFilteredAttributes();
 
+    // Returns the options and filtered attributes serialized to a string.
+    // Equal settings produce equal strings, which makes the result suitable for hashing.
+    std::string toString() const { return getActive().mOptions.dump() + getActive().mFilteredAttributes.dump(); }
+
     /**
      * Returns search paths from the given category.
      *
@@ -467,10 +457,58 @@ public:
     }
 
 private:
+    /**
+     * Filtered attribute, with its filter expression compiled for matching against shape names.
+     * Filters that are a plain name or a plain prefix followed by ".*" are matched without std::regex.
+     */
+    struct FilteredAttribute
+    {
+        enum class FilterType
+        {
+            None,   ///< No filter, the attribute applies to all shapes.
+            Exact,  ///< Shape name must be equal to the pattern.
+            Prefix, ///< Shape name must start with the pattern (followed by anything but line terminators).
+            Regex,  ///< Shape name must match the regex.
+        };
+
+        nlohmann::json value;
+        FilterType filterType{FilterType::None};
+        std::string pattern;
+        std::regex regex;
+        bool negateFilter{false};
+
+        bool appliesTo(const std::string_view shapeName) const
+        {
+            bool match = true;
+            switch (filterType)
+            {
+            case FilterType::None:
+                return true;
+            case FilterType::Exact:
+                match = shapeName == pattern;
+                break;
+            case FilterType::Prefix:
+                // '.' in ECMAScript regular expressions does not match line terminators.
+                match = shapeName.size() >= pattern.size() && shapeName.compare(0, pattern.size(), pattern) == 0 &&
+                        shapeName.find_first_of("\n\r", pattern.size()) == std::string_view::npos;
+                break;
+            case FilterType::Regex:
+                match = std::regex_match(shapeName.begin(), shapeName.end(), regex);
+                break;
+            }
+            return match != negateFilter;
+        }
+    };
+
+    /// Filtered attributes by full (':' separated) attribute name.
+    using FilteredAttributeIndex = std::map<std::string, FilteredAttribute, std::less<>>;
+
     struct SettingsData
     {
         nlohmann::json mOptions;
         nlohmann::json mFilteredAttributes;
+        /// Compiled mFilteredAttributes. Immutable, so it can be shared between settings stack levels.
+        std::shared_ptr<const FilteredAttributeIndex> mFilteredAttributeIndex;
     };
 
     SettingsData& getActive() { return mData.back(); }
@@ -479,12 +517,7 @@ private:
     bool addOptionsJSON(const std::filesystem::path& path);
     bool addOptionsTOML(const std::filesystem::path& path);
 
-    static bool matches(const std::string_view shapeName, const std::string_view expression)
-    {
-        std::regex attrRegex(expression.data(), expression.size());
-        std::smatch match;
-        return std::regex_match(shapeName.data(), attrRegex);
-    }
+    static std::shared_ptr<const FilteredAttributeIndex> buildFilteredAttributeIndex(const nlohmann::json& attributes);
 
     static void deep_merge(nlohmann::json& lhs, const nlohmann::json& rhs)
     {
@@ -79,6 +79,17 @@ public:
         mIndices.push_back(iter->second);
         return insertedNew;
     }
+    /**
+     * @brief Reserve storage for the given number of appended data items.
+     * @param[in] count Expected number of items to be appended.
+     */
+    void reserve(size_t count)
+    {
+        mIndexMap.reserve(count);
+        mValues.reserve(count);
+        mIndices.reserve(count);
+    }
+
     /**
      * @brief Get the set of unique data items.
      */
@@ -40,6 +40,13 @@
 #include <opensubdiv/bfr/surface.h>
 #include <opensubdiv/bfr/tessellation.h>
 
+#include <fstd/span.h>
+#include <tbb/enumerable_thread_specific.h>
+#include <tbb/parallel_for.h>
+
+#include <limits>
+#include <memory>
+
 using namespace pxr;
 using namespace OpenSubdiv;
 
@@ -80,12 +87,24 @@ class MeshIndexer
 public:
     MeshIndexer(const TfToken& uvInterp) : mUVInterp(uvInterp) {}
 
+    // Reserve storage for the given number of (pre-deduplication) vertices and triangles.
+    void reserve(size_t vertexCount, size_t triangleCount)
+    {
+        mPositionSet.reserve(vertexCount);
+        mNormals.reserve(vertexCount);
+        mIndices.reserve(triangleCount * 3);
+        if (mUVInterp == UsdGeomTokens->vertex || mUVInterp == UsdGeomTokens->varying)
+            mUVs.reserve(vertexCount);
+        else if (mUVInterp == UsdGeomTokens->faceVarying)
+            mUVs.reserve(triangleCount * 3);
+    }
+
     // Add a face's worth of facets to the mesh. Assumes that the facets are triangles.
     void addFacets(
-        const std::vector<int>& indices,
-        const std::vector<float>& positions,
-        const std::vector<float>& normals,
-        const std::vector<float>& uvs
+        fstd::span<const int> indices,
+        fstd::span<const float> positions,
+        fstd::span<const float> normals,
+        fstd::span<const float> uvs
     )
     {
         FALCOR_ASSERT((indices.size() % 3) == 0);
@@ -96,7 +115,7 @@ public:
         const size_t positionCount = positions.size() / 3;
 
         // Table to map from given vertex index to mesh vertex index
-        std::vector<int> indexMap;
+        mIndexMap.clear();
 
         for (int i = 0, j = 0; i < positionCount; ++i, j += 3)
         {
@@ -112,12 +131,12 @@ public:
                     mUVs.push_back(GfVec2f(uvs[2 * i + 0], uvs[2 * i + 1]));
                 }
             }
-            indexMap.push_back(idx);
+            mIndexMap.push_back(idx);
         }
 
         for (const auto& idx : indices)
         {
-            mIndices.push_back(indexMap[idx]);
+            mIndices.push_back(mIndexMap[idx]);
 
             // If uv attributes are face varying, append to the current index.
             if (mUVInterp == UsdGeomTokens->faceVarying)
@@ -142,12 +161,100 @@ public:
 private:
     TfToken mUVInterp;
     IndexedVector<GfVec3f, int32_t, GfVec3fHash> mPositionSet;
+    std::vector<int> mIndexMap;
     VtIntArray mIndices;
     VtVec3fArray mPositions;
     VtVec3fArray mNormals;
     VtVec2fArray mUVs;
 };
 
+typedef Bfr::RefinerSurfaceFactory<> SurfaceFactory;
+typedef Bfr::Surface<float> Surface;
+typedef Bfr::SurfaceFactoryMeshAdapter::FVarID FVarID;
+
+/**
+ * Per-thread surface evaluation state.
+ * Surface factories cache the topology of the faces they have visited and are not safe to share between threads,
+ * so each worker thread owns a factory along with the surfaces and scratch buffers used to evaluate a face.
+ */
+struct FaceEvaluator
+{
+    FaceEvaluator(const Far::TopologyRefiner& refiner) : surfaceFactory(refiner, SurfaceFactory::Options()) {}
+
+    SurfaceFactory surfaceFactory;
+    Surface vertexSurface;
+    Surface varyingSurface;
+    Surface fvarSurface;
+    std::vector<float> facePatchPoints;
+    std::vector<float> coords;
+};
+
+/**
+ * Output layout of a tessellated mesh, prior to vertex deduplication.
+ * The tessellation pattern of a face only depends on the subdivision scheme, the face size and the tessellation rate,
+ * so the number of coordinates and facets generated for each face is known before any surface is evaluated.
+ * Face f writes its coordinates to [coordOffsets[f], coordOffsets[f + 1]) and its facets to [facetOffsets[f], facetOffsets[f + 1]).
+ */
+struct TessellationLayout
+{
+    std::vector<size_t> coordOffsets;
+    std::vector<size_t> facetOffsets;
+
+    size_t getCoordCount() const { return coordOffsets.back(); }
+    size_t getFacetCount() const { return facetOffsets.back(); }
+};
+
+TessellationLayout computeTessellationLayout(
+    Sdc::SchemeType scheme,
+    const VtIntArray& faceCounts,
+    uint32_t tessellationRate,
+    const Bfr::Tessellation::Options& tessOptions
+)
+{
+    // Per-face-size coordinate and facet counts; faces of a given size all share the same tessellation pattern.
+    std::vector<std::pair<uint32_t, uint32_t>> countsPerFaceSize;
+    std::vector<bool> countsValid;
+
+    const size_t faceCount = faceCounts.size();
+    TessellationLayout layout;
+    layout.coordOffsets.resize(faceCount + 1);
+    layout.facetOffsets.resize(faceCount + 1);
+
+    size_t coordOffset = 0;
+    size_t facetOffset = 0;
+    for (size_t f = 0; f < faceCount; ++f)
+    {
+        layout.coordOffsets[f] = coordOffset;
+        layout.facetOffsets[f] = facetOffset;
+
+        const int faceSize = faceCounts[f];
+        if (faceSize <= 0)
+            continue;
+        if ((size_t)faceSize >= countsPerFaceSize.size())
+        {
+            countsPerFaceSize.resize(faceSize + 1);
+            countsValid.resize(faceSize + 1);
+        }
+        if (!countsValid[faceSize])
+        {
+            Bfr::Parameterization parameterization(scheme, faceSize);
+            if (parameterization.IsValid())
+            {
+                Bfr::Tessellation tessPattern(parameterization, tessellationRate, tessOptions);
+                countsPerFaceSize[faceSize] = {(uint32_t)tessPattern.GetNumCoords(), (uint32_t)tessPattern.GetNumFacets()};
+            }
+            countsValid[faceSize] = true;
+        }
+        coordOffset += countsPerFaceSize[faceSize].first;
+        facetOffset += countsPerFaceSize[faceSize].second;
+    }
+    layout.coordOffsets[faceCount] = coordOffset;
+    layout.facetOffsets[faceCount] = facetOffset;
+
+    FALCOR_CHECK(facetOffset * 3 <= std::numeric_limits<int>::max(), "Tessellated mesh exceeds the maximum number of indices.");
+    return layout;
+}
+
 Sdc::Options::FVarLinearInterpolation getFaceVaryingLinearInterpolation(const UsdGeomMesh& geomMesh)
 {
     TfToken interp = getAttribute(geomMesh.GetFaceVaryingLinearInterpolationAttr(), UsdGeomTokens->cornersPlus1);
@@ -343,10 +450,6 @@ UsdMeshData tessellate(
         return triangulate(geomMesh, baseMesh, coarseFaceIndices);
     }
 
-    typedef Bfr::RefinerSurfaceFactory<> SurfaceFactory;
-    typedef Bfr::Surface<float> Surface;
-    typedef Bfr::SurfaceFactoryMeshAdapter::FVarID FVarID;
-
     OpenSubdiv::Sdc::SchemeType scheme = Sdc::SCHEME_CATMARK;
     TfToken usdScheme = baseMesh.topology.scheme;
 
@@ -429,21 +532,6 @@ UsdMeshData tessellate(
 
     std::unique_ptr<Far::TopologyRefiner> refiner(Far::TopologyRefinerFactory<Far::TopologyDescriptor>::Create(desc, refinerOptions));
 
-    SurfaceFactory::Options surfaceOptions;
-    SurfaceFactory surfaceFactory(*refiner, surfaceOptions);
-
-    Surface vertexSurface;
-    Surface varyingSurface;
-    Surface fvarSurface;
-
-    std::vector<float> facePatchPoints;
-    std::vector<float> outCoords;
-    std::vector<float> outPos;
-    std::vector<float> outDu, outDv;
-    std::vector<float> outNormals;
-    std::vector<float> outUV;
-    std::vector<int> outFacets;
-
     Bfr::Tessellation::Options tessOptions;
     // Facet size 3 => triangulate
     tessOptions.SetFacetSize(3);
@@ -454,106 +542,154 @@ UsdMeshData tessellate(
     // the subdivision process, as per the USD spec. As such, any authored normals are ignored.
     // Further, we do not need to handle e.g., face-varying or uniform normals here.
 
-    MeshIndexer meshIndexer(uvInterp);
+    const uint32_t faceCount = refiner->GetLevel(0).GetNumFaces();
 
-    const uint32_t faceCount = surfaceFactory.GetNumFaces();
+    // Precompute where each face's tessellation lands in the output, so that faces can be evaluated in parallel
+    // and written in place without growing the output arrays.
+    const TessellationLayout layout = computeTessellationLayout(scheme, baseMesh.topology.faceCounts, tessellationRate, tessOptions);
 
-    coarseFaceIndices.clear();
+    const bool evaluateUVs =
+        uvInterp == UsdGeomTokens->faceVarying || uvInterp == UsdGeomTokens->vertex || uvInterp == UsdGeomTokens->varying;
+    const bool createVaryingSurf = uvInterp == UsdGeomTokens->varying;
 
-    bool createVaryingSurf = false;
-
-    Surface* uvSurface = nullptr;
-    if (uvInterp == UsdGeomTokens->faceVarying)
-        uvSurface = &fvarSurface;
-    else if (uvInterp == UsdGeomTokens->vertex)
-        uvSurface = &vertexSurface;
-    else if (uvInterp == UsdGeomTokens->varying)
-    {
-        uvSurface = &varyingSurface;
-        createVaryingSurf = true;
-    }
+    std::vector<float> outPos(layout.getCoordCount() * 3);
+    std::vector<float> outNormals(layout.getCoordCount() * 3);
+    std::vector<float> outUV(evaluateUVs ? layout.getCoordCount() * 2 : 0);
+    std::vector<int> outFacets(layout.getFacetCount() * 3);
+    std::vector<uint8_t> faceValid(faceCount, 0);
 
     // Face-varying UVs always have ID of 0. It's safe to set this, and to create the face-varying surface,
     // even if UVs aren't provided.
-    FVarID fvarID = 0;
+    const FVarID fvarID = 0;
 
-    for (uint32_t f = 0; f < faceCount; ++f)
-    {
-        surfaceFactory.InitSurfaces(
-            f, &vertexSurface, &fvarSurface, &fvarID, desc.numFVarChannels, createVaryingSurf ? &varyingSurface : nullptr
-        );
-        if (!vertexSurface.IsValid())
-            continue;
-        // Fall back to using vertex surface if the uv surface is invalid for whatever reason.
-        if (uvSurface && !uvSurface->IsValid())
-            uvSurface = &vertexSurface;
-
-        Bfr::Tessellation tessPattern(vertexSurface.GetParameterization(), tessellationRate, tessOptions);
-
-        const int outCoordCount = tessPattern.GetNumCoords();
+    tbb::enumerable_thread_specific<std::unique_ptr<FaceEvaluator>> evaluators;
 
-        outCoords.resize(outCoordCount * 2);
-        tessPattern.GetCoords(outCoords.data());
-
-        outNormals.resize(outCoordCount * 3);
-        outPos.resize(outCoordCount * 3);
-        outDu.resize(outCoordCount * 3);
-        outDv.resize(outCoordCount * 3);
-
-        if (uvSurface)
+    tbb::parallel_for<uint32_t>(
+        0,
+        faceCount,
+        [&](uint32_t f)
         {
-            const int pointSize = 2;
-            facePatchPoints.resize(uvSurface->GetNumPatchPoints() * pointSize);
-            outUV.resize(outCoordCount * pointSize);
-            uvSurface->PreparePatchPoints(uvData, pointSize, facePatchPoints.data(), pointSize);
-            for (int i = 0, j = 0; i < outCoordCount; ++i, j += pointSize)
+            std::unique_ptr<FaceEvaluator>& evaluator = evaluators.local();
+            if (!evaluator)
+                evaluator = std::make_unique<FaceEvaluator>(*refiner);
+
+            Surface& vertexSurface = evaluator->vertexSurface;
+            evaluator->surfaceFactory.InitSurfaces(
+                f,
+                &vertexSurface,
+                &evaluator->fvarSurface,
+                &fvarID,
+                desc.numFVarChannels,
+                createVaryingSurf ? &evaluator->varyingSurface : nullptr
+            );
+            if (!vertexSurface.IsValid())
+                return;
+
+            Surface* uvSurface = nullptr;
+            if (uvInterp == UsdGeomTokens->faceVarying)
+                uvSurface = &evaluator->fvarSurface;
+            else if (uvInterp == UsdGeomTokens->vertex)
+                uvSurface = &vertexSurface;
+            else if (uvInterp == UsdGeomTokens->varying)
+                uvSurface = &evaluator->varyingSurface;
+            // Fall back to using vertex surface if the uv surface is invalid for whatever reason.
+            if (uvSurface && !uvSurface->IsValid())
+                uvSurface = &vertexSurface;
+
+            Bfr::Tessellation tessPattern(vertexSurface.GetParameterization(), tessellationRate, tessOptions);
+
+            const size_t coordOffset = layout.coordOffsets[f];
+            const size_t facetOffset = layout.facetOffsets[f];
+            const int outCoordCount = tessPattern.GetNumCoords();
+            const int facetCount = tessPattern.GetNumFacets();
+            FALCOR_ASSERT(coordOffset + outCoordCount == layout.coordOffsets[f + 1]);
+            FALCOR_ASSERT(facetOffset + facetCount == layout.facetOffsets[f + 1]);
+
+            std::vector<float>& outCoords = evaluator->coords;
+            std::vector<float>& facePatchPoints = evaluator->facePatchPoints;
+            outCoords.resize(outCoordCount * 2);
+            tessPattern.GetCoords(outCoords.data());
+
+            if (uvSurface)
             {
-                uvSurface->Evaluate(&outCoords[i * 2], facePatchPoints.data(), pointSize, &outUV[j]);
+                const int pointSize = 2;
+                float* faceUV = &outUV[coordOffset * pointSize];
+                facePatchPoints.resize(uvSurface->GetNumPatchPoints() * pointSize);
+                uvSurface->PreparePatchPoints(uvData, pointSize, facePatchPoints.data(), pointSize);
+                for (int i = 0, j = 0; i < outCoordCount; ++i, j += pointSize)
+                {
+                    uvSurface->Evaluate(&outCoords[i * 2], facePatchPoints.data(), pointSize, &faceUV[j]);
+                }
             }
-        }
-        else if (uvInterp == UsdGeomTokens->uniform)
-        {
-            outUV.resize(2);
-            outUV[0] = baseMesh.uvs[f][0];
-            outUV[1] = baseMesh.uvs[f][1];
-        }
-
-        const int pointSize = 3;
-        facePatchPoints.resize(vertexSurface.GetNumPatchPoints() * pointSize);
-        vertexSurface.PreparePatchPoints((float*)baseMesh.points.data(), pointSize, facePatchPoints.data(), pointSize);
-        {
-            float3 du;
-            float3 dv;
 
-            // Compute positions and normals
-            for (int i = 0, j = 0; i < outCoordCount; ++i, j += pointSize)
+            const int pointSize = 3;
+            float* facePos = &outPos[coordOffset * pointSize];
+            float* faceNormals = &outNormals[coordOffset * pointSize];
+            facePatchPoints.resize(vertexSurface.GetNumPatchPoints() * pointSize);
+            vertexSurface.PreparePatchPoints((float*)baseMesh.points.data(), pointSize, facePatchPoints.data(), pointSize);
             {
-                vertexSurface.Evaluate(
-                    &outCoords[i * 2],
-                    facePatchPoints.data(),
-                    pointSize,
-                    &outPos[j],
-                    reinterpret_cast<float*>(&du),
-                    reinterpret_cast<float*>(&dv)
-                );
-                // Use the partials to construct a normal vector.
-                float3 normal = normalize(cross(du, dv));
-                if (leftHanded)
-                    normal = -normal;
-                outNormals[j + 0] = normal.x;
-                outNormals[j + 1] = normal.y;
-                outNormals[j + 2] = normal.z;
+                float3 du;
+                float3 dv;
+
+                // Compute positions and normals
+                for (int i = 0, j = 0; i < outCoordCount; ++i, j += pointSize)
+                {
+                    vertexSurface.Evaluate(
+                        &outCoords[i * 2],
+                        facePatchPoints.data(),
+                        pointSize,
+                        &facePos[j],
+                        reinterpret_cast<float*>(&du),
+                        reinterpret_cast<float*>(&dv)
+                    );
+                    // Use the partials to construct a normal vector.
+                    float3 normal = normalize(cross(du, dv));
+                    if (leftHanded)
+                        normal = -normal;
+                    faceNormals[j + 0] = normal.x;
+                    faceNormals[j + 1] = normal.y;
+                    faceNormals[j + 2] = normal.z;
+                }
             }
+
+            tessPattern.GetFacets(&outFacets[facetOffset * 3]);
+            faceValid[f] = 1;
         }
+    );
 
-        const int facetCount = tessPattern.GetNumFacets();
-        outFacets.resize(facetCount * 3);
-        tessPattern.GetFacets(outFacets.data());
+    // Share vertices between faces. This is done sequentially and in face order, so that the output is
+    // identical regardless of how the faces were distributed over threads.
+    MeshIndexer meshIndexer(uvInterp);
+    meshIndexer.reserve(layout.getCoordCount(), layout.getFacetCount());
 
-        meshIndexer.addFacets(outFacets, outPos, outNormals, outUV);
+    coarseFaceIndices.clear();
+    coarseFaceIndices.reserve(layout.getFacetCount());
+
+    for (uint32_t f = 0; f < faceCount; ++f)
+    {
+        if (!faceValid[f])
+            continue;
+
+        const size_t coordOffset = layout.coordOffsets[f];
+        const size_t coordCount = layout.coordOffsets[f + 1] - coordOffset;
+        const size_t facetOffset = layout.facetOffsets[f];
+        const size_t facetCount = layout.facetOffsets[f + 1] - facetOffset;
+
+        fstd::span<const float> faceUV;
+        if (evaluateUVs)
+            faceUV = fstd::span<const float>(&outUV[coordOffset * 2], coordCount * 2);
+        else if (uvInterp == UsdGeomTokens->uniform)
+            faceUV = fstd::span<const float>(baseMesh.uvs[f].data(), 2);
+
+        meshIndexer.addFacets(
+            fstd::span<const int>(&outFacets[facetOffset * 3], facetCount * 3),
+            fstd::span<const float>(&outPos[coordOffset * 3], coordCount * 3),
+            fstd::span<const float>(&outNormals[coordOffset * 3], coordCount * 3),
+            faceUV
+        );
 
         // Append the index of each facet's originating coarse face, f.
-        for (int i = 0; i < facetCount; ++i)
+        for (size_t i = 0; i < facetCount; ++i)
             coarseFaceIndices.push_back(f);
     }
 
@@ -56,6 +56,13 @@ int runMain(int argc, char** argv)
     args::ValueFlag<std::string> tagFilterFlag(parser, "tags", "Filter test cases by tags.", {'t', "tags"});
     args::ValueFlag<std::string> xmlReportFlag(parser, "path", "XML report output file.", {'x', "xml-report"});
     args::ValueFlag<uint32_t> repeatFlag(parser, "N", "Number of times to repeat the test.", {'r', "repeat"});
+    args::Flag benchmarkFlag(parser, "", "Run benchmarks. Benchmarks are skipped by default and always run serially.", {'b', "benchmark"});
+    args::ValueFlag<std::string> benchmarkReportFlag(parser, "path", "Benchmark JSON report output file.", {"benchmark-report"});
+    args::ValueFlag<std::string> benchmarkBaselineFlag(parser, "path", "Benchmark JSON report to compare the results against.", {"benchmark-baseline"});
+    args::ValueFlag<double> benchmarkThresholdFlag(
+        parser, "fraction", "Relative slowdown of the median time that is reported as a regression (default: 0.1).", {"benchmark-threshold"}
+    );
+    args::ValueFlag<uint32_t> benchmarkSamplesFlag(parser, "N", "Number of samples to record per benchmark (default: 10).", {"benchmark-samples"});
     args::Flag enableDebugLayerFlag(parser, "", "Enable debug layer (enabled by default in Debug build).", {"enable-debug-layer"});
     args::Flag enableAftermathFlag(parser, "", "Enable Aftermath GPU crash dump.", {"enable-aftermath"});
 
@@ -129,6 +136,17 @@ int runMain(int argc, char** argv)
         options.parallel = args::get(parallelFlag);
     if (repeatFlag)
         options.repeat = args::get(repeatFlag);
+    // Writing or comparing benchmark reports implies running the benchmarks.
+    if (benchmarkFlag || benchmarkReportFlag || benchmarkBaselineFlag)
+        options.benchmark.enabled = true;
+    if (benchmarkReportFlag)
+        options.benchmark.jsonReportPath = args::get(benchmarkReportFlag);
+    if (benchmarkBaselineFlag)
+        options.benchmark.baselinePath = args::get(benchmarkBaselineFlag);
+    if (benchmarkThresholdFlag)
+        options.benchmark.regressionThreshold = args::get(benchmarkThresholdFlag);
+    if (benchmarkSamplesFlag)
+        options.benchmark.sampleCount = args::get(benchmarkSamplesFlag);
 
     if (listTestSuites || listTestCases || listTags)
     {
@@ -0,0 +1,208 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/API/GpuMemoryPlacement.h"
+
+namespace Falcor
+{
+CPU_TEST(GpuMemoryPlacementLinear)
+{
+    GpuMemoryPlacement placement(1024, 1 << 20);
+
+    // Allocations are placed linearly in the active page.
+    auto a = placement.allocate(100, 1);
+    EXPECT(a.newPage);
+    EXPECT_EQ(a.pageSize, 1024);
+    EXPECT_EQ(a.offset, 0);
+
+    auto b = placement.allocate(100, 256);
+    EXPECT(!b.newPage);
+    EXPECT_EQ(b.pageID, a.pageID);
+    EXPECT_EQ(b.offset, 256);
+
+    // An allocation that doesn't fit retires the active page.
+    auto c = placement.allocate(700, 1);
+    EXPECT(c.newPage);
+    EXPECT_NE(c.pageID, a.pageID);
+    EXPECT_EQ(c.offset, 0);
+    EXPECT_EQ(placement.getPageCount(), 2);
+
+    // Releases take effect once the GPU has passed the fence value.
+    placement.release(a.pageID, 5);
+    placement.release(b.pageID, 5);
+    EXPECT(placement.executeDeferredReleases(5).empty());
+    EXPECT_EQ(placement.getPooledSize(), 0);
+    EXPECT(placement.executeDeferredReleases(6).empty());
+    EXPECT_EQ(placement.getPooledSize(), 1024);
+
+    // The retired page is reused when the active page is full.
+    auto d = placement.allocate(900, 1);
+    EXPECT(!d.newPage);
+    EXPECT_EQ(d.pageID, a.pageID);
+    EXPECT_EQ(d.offset, 0);
+    EXPECT_EQ(placement.getPooledSize(), 0);
+    EXPECT_EQ(placement.getPageCount(), 2);
+}
+
+CPU_TEST(GpuMemoryPlacementActivePage)
+{
+    GpuMemoryPlacement placement(1024, 1 << 20);
+
+    auto a = placement.allocate(600, 1);
+    placement.release(a.pageID, 0);
+    placement.executeDeferredReleases(1);
+
+    // The active page is reused from the start once all its allocations are released.
+    auto b = placement.allocate(600, 1);
+    EXPECT(!b.newPage);
+    EXPECT_EQ(b.pageID, a.pageID);
+    EXPECT_EQ(b.offset, 0);
+    EXPECT_EQ(placement.getPageCount(), 1);
+}
+
+CPU_TEST(GpuMemoryPlacementLargePages)
+{
+    GpuMemoryPlacement placement(1024, 1 << 20);
+
+    EXPECT_EQ(placement.getPageSize(1), 1024);
+    EXPECT_EQ(placement.getPageSize(1024), 1024);
+    EXPECT_EQ(placement.getPageSize(1025), 1280);
+    EXPECT_EQ(placement.getPageSize(3000), 3072);
+    EXPECT_EQ(placement.getPageSize(4096), 4096);
+    EXPECT_EQ(placement.getPageSize(4097), 5120);
+
+    // Large allocations get a page of their own, rounded up to the size class.
+    auto a = placement.allocate(3000, 1);
+    EXPECT(a.newPage);
+    EXPECT_EQ(a.pageSize, 3072);
+    EXPECT_EQ(a.offset, 0);
+
+    auto b = placement.allocate(100, 1);
+    EXPECT(b.newPage);
+    EXPECT_NE(b.pageID, a.pageID);
+
+    // Released large pages are reused for allocations of the same size class.
+    placement.release(a.pageID, 0);
+    placement.executeDeferredReleases(1);
+    EXPECT_EQ(placement.getPooledSize(), 3072);
+
+    auto c = placement.allocate(2900, 1);
+    EXPECT(!c.newPage);
+    EXPECT_EQ(c.pageID, a.pageID);
+    EXPECT_EQ(c.pageSize, 3072);
+
+    auto d = placement.allocate(5000, 1);
+    EXPECT(d.newPage);
+    EXPECT_EQ(d.pageSize, 5120);
+    EXPECT_EQ(placement.getPageCount(), 3);
+}
+
+CPU_TEST(GpuMemoryPlacementUnpooledPages)
+{
+    GpuMemoryPlacement placement(1024, 8192);
+
+    // Size classes above the pool budget fall back to the exact allocation size.
+    EXPECT_EQ(placement.getPageSize(8192), 8192);
+    EXPECT_EQ(placement.getPageSize(8193), 8193);
+    EXPECT_EQ(placement.getPageSize(10000), 10000);
+
+    auto a = placement.allocate(2000, 1);
+    auto b = placement.allocate(10000, 1);
+    EXPECT(b.newPage);
+    EXPECT_EQ(b.pageSize, 10000);
+
+    // Releasing a page larger than the pool budget destroys it without evicting pooled pages.
+    placement.release(a.pageID, 1);
+    placement.executeDeferredReleases(2);
+    EXPECT_EQ(placement.getPooledSize(), 2048);
+
+    placement.release(b.pageID, 2);
+    auto evicted = placement.executeDeferredReleases(3);
+    EXPECT_EQ(evicted.size(), 1);
+    EXPECT_EQ(evicted[0], b.pageID);
+    EXPECT_EQ(placement.getPooledSize(), 2048);
+    EXPECT_EQ(placement.getPageCount(), 1);
+
+    auto c = placement.allocate(10000, 1);
+    EXPECT(c.newPage);
+    EXPECT_NE(c.pageID, b.pageID);
+}
+
+CPU_TEST(GpuMemoryPlacementEviction)
+{
+    GpuMemoryPlacement placement(1024, 4096);
+
+    auto a = placement.allocate(2000, 1);
+    auto b = placement.allocate(2000, 1);
+    auto c = placement.allocate(2000, 1);
+    EXPECT_EQ(placement.getPageCount(), 3);
+
+    // Pooling all three pages exceeds the budget, so the least recently released page is evicted.
+    placement.release(c.pageID, 3);
+    placement.release(a.pageID, 1);
+    placement.release(b.pageID, 2);
+    auto evicted = placement.executeDeferredReleases(10);
+    EXPECT_EQ(evicted.size(), 1);
+    EXPECT_EQ(evicted[0], a.pageID);
+    EXPECT_EQ(placement.getPooledSize(), 4096);
+    EXPECT_EQ(placement.getPageCount(), 2);
+
+    // The most recently released page is reused first.
+    auto d = placement.allocate(2000, 1);
+    EXPECT_EQ(d.pageID, c.pageID);
+}
+
+GPU_TEST(GpuMemoryHeapSubAllocator)
+{
+    ref<GpuMemoryHeap> pHeap = ctx.getDevice()->getUploadHeap();
+    GpuMemoryHeap::SubAllocator allocator(pHeap, 4096);
+
+    // Allocations are placed linearly in a chunk.
+    auto a = allocator.allocate(100, 16);
+    auto b = allocator.allocate(100, 256);
+    EXPECT_EQ(a.pageID, b.pageID);
+    EXPECT_EQ(b.offset % 256, 0);
+    EXPECT_GE(b.offset, a.offset + 100);
+    EXPECT_EQ(b.pData - a.pData, (ptrdiff_t)(b.offset - a.offset));
+    std::memset(a.pData, 1, 100);
+    std::memset(b.pData, 2, 100);
+
+    // Allocations larger than the chunk are made from the heap directly.
+    auto c = allocator.allocate(8192, 16);
+    EXPECT_EQ(c.size, 8192);
+    std::memset(c.pData, 3, 8192);
+
+    // Allocations larger than the page size get a dedicated page.
+    auto d = allocator.allocate(pHeap->getPageSize() + 1, 16);
+    EXPECT_NE(d.pageID, a.pageID);
+    EXPECT_EQ(d.offset, 0);
+
+    allocator.reset();
+    ctx.getDevice()->endFrame();
+}
+} // namespace Falcor
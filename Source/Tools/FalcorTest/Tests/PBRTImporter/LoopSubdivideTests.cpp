@@ -0,0 +1,261 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "PBRTImporter/LoopSubdivide.h"
+#include <cstring>
+
+namespace Falcor
+{
+namespace
+{
+// Open pyramid (boundary edges around the base) and a closed tetrahedron (interior vertices of valence 3).
+const float3 kPositions[] = {
+    {0.f, 0.f, 0.f}, {1.f, 0.f, 0.f}, {1.f, 1.f, 0.f}, {0.f, 1.f, 0.f}, {0.5f, 0.5f, 1.f},
+    {3.f, 0.f, 0.f}, {4.f, 0.f, 0.f}, {3.5f, 1.f, 0.f}, {3.5f, 0.5f, 1.f},
+};
+const uint32_t kIndices[] = {
+    0, 1, 4, 1, 2, 4, 2, 3, 4, 3, 0, 4,
+    5, 7, 6, 5, 6, 8, 6, 7, 8, 7, 5, 8,
+};
+
+// Reference output of two subdivision levels, generated with the original pointer-based implementation.
+const float3 kExpectedPositions[] = {
+    {0x1.59999ap-3, 0x1.59999ap-3, 0x0p+0},
+    {0x1.a9999ap-1, 0x1.59999ap-3, 0x0p+0},
+    {0x1.a9999ap-1, 0x1.a9999ap-1, 0x0p+0},
+    {0x1.59999ap-3, 0x1.a9999ap-1, 0x0p+0},
+    {0x1p-1, 0x1p-1, 0x1p-1},
+    {0x1.b33334p+1, 0x1.333334p-2, 0x1.99999ap-3},
+    {0x1.ccccccp+1, 0x1.333332p-2, 0x1.99999ap-3},
+    {0x1.cp+1, 0x1.fffffep-2, 0x1.99999ap-3},
+    {0x1.cp+1, 0x1.99999ap-2, 0x1.99999ap-2},
+    {0x1p-1, 0x1.666666p-5, 0x0p+0},
+    {0x1.555556p-1, 0x1.555554p-2, 0x1.355556p-2},
+    {0x1.555554p-2, 0x1.555556p-2, 0x1.355556p-2},
+    {0x1.e9999ap-1, 0x1p-1, 0x0p+0},
+    {0x1.555556p-1, 0x1.555556p-1, 0x1.355556p-2},
+    {0x1p-1, 0x1.e9999ap-1, 0x0p+0},
+    {0x1.555556p-2, 0x1.555556p-1, 0x1.355556p-2},
+    {0x1.666666p-5, 0x1p-1, 0x0p+0},
+    {0x1.b6aaaap+1, 0x1.a55556p-2, 0x1.6aaaaap-3},
+    {0x1.c95556p+1, 0x1.a55554p-2, 0x1.6aaaaap-3},
+    {0x1.c00002p+1, 0x1.1p-2, 0x1.6aaaaap-3},
+    {0x1.c95556p+1, 0x1.5aaaaap-2, 0x1.4aaaaap-2},
+    {0x1.b6aaaap+1, 0x1.5aaaacp-2, 0x1.4aaaacp-2},
+    {0x1.cp+1, 0x1.fp-2, 0x1.4aaaaap-2},
+    {0x1.466666p-2, 0x1.333334p-4, 0x0p+0},
+    {0x1.a1fffep-2, 0x1.6eaaacp-3, 0x1.6cp-3},
+    {0x1.dd5556p-3, 0x1.dd5558p-3, 0x1.06aaacp-3},
+    {0x1.5ccccep-1, 0x1.333334p-4, 0x0p+0},
+    {0x1.88aaacp-1, 0x1.dd5556p-3, 0x1.06aaacp-3},
+    {0x1.2efffep-1, 0x1.6eaaaap-3, 0x1.6cp-3},
+    {0x1.fffffep-2, 0x1.36aaaap-2, 0x1.5eaaaap-2},
+    {0x1.22p-1, 0x1.bbfffep-2, 0x1.c6p-2},
+    {0x1.bbfffep-2, 0x1.bbfffcp-2, 0x1.c6p-2},
+    {0x1.d9999ap-1, 0x1.466666p-2, 0x0p+0},
+    {0x1.a45556p-1, 0x1.a1fffep-2, 0x1.6cp-3},
+    {0x1.d9999ap-1, 0x1.5ccccep-1, 0x0p+0},
+    {0x1.88aaacp-1, 0x1.88aaacp-1, 0x1.06aaacp-3},
+    {0x1.a45556p-1, 0x1.2efffep-1, 0x1.6cp-3},
+    {0x1.64aaacp-1, 0x1.fffffep-2, 0x1.5eaaaap-2},
+    {0x1.21fffep-1, 0x1.22p-1, 0x1.c6p-2},
+    {0x1.5ccccep-1, 0x1.d9999ap-1, 0x0p+0},
+    {0x1.2fp-1, 0x1.a45556p-1, 0x1.6cp-3},
+    {0x1.466666p-2, 0x1.d9999ap-1, 0x0p+0},
+    {0x1.dd5556p-3, 0x1.88aaacp-1, 0x1.06aaacp-3},
+    {0x1.a2p-2, 0x1.a45556p-1, 0x1.6cp-3},
+    {0x1.fffffep-2, 0x1.64aaacp-1, 0x1.5eaaaap-2},
+    {0x1.bbfffep-2, 0x1.21fffep-1, 0x1.c6p-2},
+    {0x1.333334p-4, 0x1.5ccccep-1, 0x0p+0},
+    {0x1.6eaaacp-3, 0x1.2fp-1, 0x1.6cp-3},
+    {0x1.333334p-4, 0x1.466666p-2, 0x0p+0},
+    {0x1.6eaaaap-3, 0x1.a2p-2, 0x1.6cp-3},
+    {0x1.36aaaap-2, 0x1.fffffep-2, 0x1.5eaaaap-2},
+    {0x1.b35554p+1, 0x1.548p-2, 0x1.80aaacp-3},
+    {0x1.ba9556p+1, 0x1.515556p-2, 0x1.2aaaaap-3},
+    {0x1.b69558p+1, 0x1.207ffep-2, 0x1.80aaaap-3},
+    {0x1.bccp+1, 0x1.eb2aaap-2, 0x1.80aaaap-3},
+    {0x1.c34002p+1, 0x1.eb2aaap-2, 0x1.80aaacp-3},
+    {0x1.cp+1, 0x1.a7fffep-2, 0x1.2aaaaap-3},
+    {0x1.c56aacp+1, 0x1.515554p-2, 0x1.2aaaaap-3},
+    {0x1.ccaaaap+1, 0x1.548p-2, 0x1.80aaaap-3},
+    {0x1.c96aacp+1, 0x1.208002p-2, 0x1.80aaacp-3},
+    {0x1.ba9556p+1, 0x1.18aaaap-2, 0x1.06aaacp-2},
+    {0x1.b35554p+1, 0x1.3a8p-2, 0x1.e8aaaap-3},
+    {0x1.ccaaaap+1, 0x1.3a8p-2, 0x1.e8aaaap-3},
+    {0x1.c56aacp+1, 0x1.18aaaap-2, 0x1.06aaaap-2},
+    {0x1.cp+1, 0x1.440002p-2, 0x1.5d5556p-2},
+    {0x1.c34002p+1, 0x1.85d556p-2, 0x1.8bp-2},
+    {0x1.bccp+1, 0x1.85d554p-2, 0x1.8bp-2},
+    {0x1.cc8p+1, 0x1.8ap-2, 0x1.06aaacp-2},
+    {0x1.cp+1, 0x1.029556p-1, 0x1.e8aaaap-3},
+    {0x1.c71556p+1, 0x1.e0aaaap-2, 0x1.06aaaap-2},
+    {0x1.c71556p+1, 0x1.b55556p-2, 0x1.5d5556p-2},
+    {0x1.cp+1, 0x1.b9d556p-2, 0x1.8bp-2},
+    {0x1.b8eaaap+1, 0x1.e0aaaap-2, 0x1.06aaacp-2},
+    {0x1.b37ffep+1, 0x1.8ap-2, 0x1.06aaaap-2},
+    {0x1.b8eaaap+1, 0x1.b55556p-2, 0x1.5d5556p-2},
+};
+const float3 kExpectedNormals[] = {
+    {0x1.00199ap-5, 0x1.00199ap-5, -0x1.00e14ap-5},
+    {-0x1.00199ap-5, 0x1.00199ap-5, -0x1.00e144p-5},
+    {-0x1.00199ap-5, -0x1.00199ap-5, -0x1.00e13ep-5},
+    {0x1.00199ap-5, -0x1.00199ap-5, -0x1.00e144p-5},
+    {-0x1.820708p-31, -0x1.efbf18p-28, -0x1.20fffcp-5},
+    {0x1.24b78p-9, 0x1.24b80cp-10, 0x1.24b82p-11},
+    {-0x1.24b76ep-9, 0x1.24b75ap-10, 0x1.24b734p-11},
+    {-0x1.28p-29, -0x1.24b768p-9, 0x1.24b788p-10},
+    {-0x1.a00008p-30, 0x0p+0, -0x1.24b746p-9},
+    {0x0p+0, 0x1.07e668p-2, -0x1.6358c2p-3},
+    {-0x1.6a588ap-3, 0x1.6a589p-3, -0x1.d2157ap-3},
+    {0x1.6a5888p-3, 0x1.6a588ap-3, -0x1.d21574p-3},
+    {-0x1.07e668p-2, -0x0p+0, -0x1.6358bap-3},
+    {-0x1.6a589p-3, -0x1.6a58a4p-3, -0x1.d21584p-3},
+    {0x0p+0, -0x1.07e668p-2, -0x1.6358bap-3},
+    {0x1.6a58a4p-3, -0x1.6a5898p-3, -0x1.d21592p-3},
+    {0x1.07e668p-2, 0x0p+0, -0x1.6358c2p-3},
+    {0x1.6bf89cp-5, -0x1.6bf99cp-6, 0x1.10fb4p-5},
+    {-0x1.6bf898p-5, -0x1.6bf8d4p-6, 0x1.10f9eep-5},
+    {0x1.2p-27, 0x1.6bf83ep-5, 0x1.6bf858p-6},
+    {-0x1.6bf8ap-5, 0x1.6bf762p-6, -0x1.10f9c2p-5},
+    {0x1.6bf894p-5, 0x1.6bfa18p-6, -0x1.10faa4p-5},
+    {0x1.28p-25, -0x1.6bf92p-5, -0x1.6bf8fap-6},
+    {0x1.395556p-4, 0x1.9f2aacp-3, -0x1.3329d4p-3},
+    {0x1.417eeep-4, 0x1.2f915ap-2, -0x1.eb8daap-3},
+    {0x1.92757p-3, 0x1.927578p-3, -0x1.b663f8p-3},
+    {-0x1.395556p-4, 0x1.9f2aacp-3, -0x1.3329d2p-3},
+    {-0x1.927574p-3, 0x1.927568p-3, -0x1.b663fcp-3},
+    {-0x1.417ee8p-4, 0x1.2f9168p-2, -0x1.eb8dbep-3},
+    {0x1p-26, 0x1.cf24bap-3, -0x1.bbd88p-3},
+    {-0x1.5d32a4p-4, 0x1.5d3294p-4, -0x1.35a31ap-3},
+    {0x1.5d328cp-4, 0x1.5d3298p-4, -0x1.35a314p-3},
+    {-0x1.9f2aacp-3, 0x1.395556p-4, -0x1.3329ccp-3},
+    {-0x1.2f915ap-2, 0x1.417eaap-4, -0x1.eb8dap-3},
+    {-0x1.9f2aacp-3, -0x1.395556p-4, -0x1.3329dp-3},
+    {-0x1.927568p-3, -0x1.927586p-3, -0x1.b663f6p-3},
+    {-0x1.2f9168p-2, -0x1.417ecep-4, -0x1.eb8dd6p-3},
+    {-0x1.cf24bap-3, 0x1.cp-25, -0x1.bbd878p-3},
+    {-0x1.5d3294p-4, -0x1.5d32cp-4, -0x1.35a32p-3},
+    {-0x1.395556p-4, -0x1.9f2aacp-3, -0x1.3329ccp-3},
+    {-0x1.417eaap-4, -0x1.2f917p-2, -0x1.eb8dc4p-3},
+    {0x1.395556p-4, -0x1.9f2aacp-3, -0x1.3329ccp-3},
+    {0x1.927586p-3, -0x1.927578p-3, -0x1.b66406p-3},
+    {0x1.417ecep-4, -0x1.2f9162p-2, -0x1.eb8dc6p-3},
+    {-0x1.cp-25, -0x1.cf24a4p-3, -0x1.bbd864p-3},
+    {0x1.5d32cp-4, -0x1.5d32ap-4, -0x1.35a32ap-3},
+    {0x1.9f2aacp-3, -0x1.395556p-4, -0x1.3329d4p-3},
+    {0x1.2f917p-2, -0x1.417ee8p-4, -0x1.eb8dcep-3},
+    {0x1.9f2aacp-3, 0x1.395556p-4, -0x1.3329dp-3},
+    {0x1.2f9162p-2, 0x1.417ee8p-4, -0x1.eb8dacp-3},
+    {0x1.cf24a4p-3, -0x1p-26, -0x1.bbd87p-3},
+    {0x1.b6f1e8p-6, -0x1.da4bbp-9, 0x1.f23dbap-7},
+    {0x1.fcef3ep-7, 0x1.fcf12ap-8, 0x1.a75f24p-5},
+    {0x1.405f4ep-7, 0x1.66d9dp-6, 0x1.66da74p-7},
+    {0x1.16c26p-6, -0x1.2b9148p-6, 0x1.212a7ap-6},
+    {-0x1.16c244p-6, -0x1.2b9104p-6, 0x1.212934p-6},
+    {-0x1p-30, -0x1.fceee4p-7, 0x1.c72de4p-5},
+    {-0x1.fcef5cp-7, 0x1.fcefc6p-8, 0x1.a75fd4p-5},
+    {-0x1.b6f1dcp-6, -0x1.da4eacp-9, 0x1.f239ccp-7},
+    {-0x1.405f08p-7, 0x1.66d982p-6, 0x1.66d904p-7},
+    {0x1.fcef5cp-7, 0x1.c72dcep-5, -0x1.47f21ep-6},
+    {0x1.b6f1dap-6, 0x1.b6f444p-7, -0x1.520b3p-7},
+    {-0x1.b6f1ecp-6, 0x1.b6ef7ap-7, -0x1.520986p-7},
+    {-0x1.fcef24p-7, 0x1.c72e7p-5, -0x1.47f2e4p-6},
+    {-0x1.4p-27, 0x1.8790d8p-5, -0x1.430462p-5},
+    {-0x1.16c25cp-6, 0x1.16c11p-7, -0x1.7140a2p-6},
+    {0x1.16c23cp-6, 0x1.16c372p-7, -0x1.714172p-6},
+    {-0x1.03660cp-4, -0x1.0855dcp-6, -0x1.08541cp-7},
+    {0x1.a8p-26, -0x1.b6f2d6p-6, -0x1.da4b82p-9},
+    {-0x1.879056p-5, -0x1.4303a8p-5, -0x1.1235ecp-8},
+    {-0x1.879066p-5, -0x1.878fa4p-6, -0x1.c23e58p-6},
+    {0x1.98p-26, -0x1.16c316p-6, -0x1.2b9178p-6},
+    {0x1.879078p-5, -0x1.4304d4p-5, -0x1.1232d6p-8},
+    {0x1.036608p-4, -0x1.085474p-6, -0x1.085274p-7},
+    {0x1.87905p-5, -0x1.878fccp-6, -0x1.c240bcp-6},
+};
+const uint32_t kExpectedIndices[] = {
+    0, 23, 25, 23, 9, 24, 25, 24, 11, 23, 24, 25,
+    9, 26, 28, 26, 1, 27, 28, 27, 10, 26, 27, 28,
+    11, 29, 31, 29, 10, 30, 31, 30, 4, 29, 30, 31,
+    9, 28, 24, 28, 10, 29, 24, 29, 11, 28, 29, 24,
+    1, 32, 27, 32, 12, 33, 27, 33, 10, 32, 33, 27,
+    12, 34, 36, 34, 2, 35, 36, 35, 13, 34, 35, 36,
+    10, 37, 30, 37, 13, 38, 30, 38, 4, 37, 38, 30,
+    12, 36, 33, 36, 13, 37, 33, 37, 10, 36, 37, 33,
+    2, 39, 35, 39, 14, 40, 35, 40, 13, 39, 40, 35,
+    14, 41, 43, 41, 3, 42, 43, 42, 15, 41, 42, 43,
+    13, 44, 38, 44, 15, 45, 38, 45, 4, 44, 45, 38,
+    14, 43, 40, 43, 15, 44, 40, 44, 13, 43, 44, 40,
+    3, 46, 42, 46, 16, 47, 42, 47, 15, 46, 47, 42,
+    16, 48, 49, 48, 0, 25, 49, 25, 11, 48, 25, 49,
+    15, 50, 45, 50, 11, 31, 45, 31, 4, 50, 31, 45,
+    16, 49, 47, 49, 11, 50, 47, 50, 15, 49, 50, 47,
+    5, 51, 53, 51, 17, 52, 53, 52, 19, 51, 52, 53,
+    17, 54, 56, 54, 7, 55, 56, 55, 18, 54, 55, 56,
+    19, 57, 59, 57, 18, 58, 59, 58, 6, 57, 58, 59,
+    17, 56, 52, 56, 18, 57, 52, 57, 19, 56, 57, 52,
+    5, 53, 61, 53, 19, 60, 61, 60, 21, 53, 60, 61,
+    19, 59, 63, 59, 6, 62, 63, 62, 20, 59, 62, 63,
+    21, 64, 66, 64, 20, 65, 66, 65, 8, 64, 65, 66,
+    19, 63, 60, 63, 20, 64, 60, 64, 21, 63, 64, 60,
+    6, 58, 62, 58, 18, 67, 62, 67, 20, 58, 67, 62,
+    18, 55, 69, 55, 7, 68, 69, 68, 22, 55, 68, 69,
+    20, 70, 65, 70, 22, 71, 65, 71, 8, 70, 71, 65,
+    18, 69, 67, 69, 22, 70, 67, 70, 20, 69, 70, 67,
+    7, 54, 68, 54, 17, 72, 68, 72, 22, 54, 72, 68,
+    17, 51, 73, 51, 5, 61, 73, 61, 21, 51, 61, 73,
+    22, 74, 71, 74, 21, 66, 71, 66, 8, 74, 66, 71,
+    17, 73, 72, 73, 21, 74, 72, 74, 22, 73, 74, 72,
+};
+} // namespace
+
+CPU_TEST(LoopSubdivide_Reference)
+{
+    auto result = pbrt::loopSubdivide(2, kPositions, kIndices);
+
+    ASSERT_EQ(result.positions.size(), std::size(kExpectedPositions));
+    ASSERT_EQ(result.normals.size(), std::size(kExpectedNormals));
+    ASSERT_EQ(result.indices.size(), std::size(kExpectedIndices));
+
+    // The output must be bit-identical to the reference.
+    EXPECT(std::memcmp(result.positions.data(), kExpectedPositions, sizeof(kExpectedPositions)) == 0);
+    EXPECT(std::memcmp(result.normals.data(), kExpectedNormals, sizeof(kExpectedNormals)) == 0);
+    EXPECT(std::memcmp(result.indices.data(), kExpectedIndices, sizeof(kExpectedIndices)) == 0);
+}
+
+CPU_TEST(LoopSubdivide_Levels)
+{
+    // Each level splits every triangle into four.
+    for (uint32_t levels = 0; levels <= 3; levels++)
+    {
+        auto result = pbrt::loopSubdivide(levels, kPositions, kIndices);
+        EXPECT_EQ(result.indices.size(), std::size(kIndices) << (2 * levels)) << "levels = " << levels;
+        EXPECT_EQ(result.positions.size(), result.normals.size()) << "levels = " << levels;
+    }
+}
+} // namespace Falcor
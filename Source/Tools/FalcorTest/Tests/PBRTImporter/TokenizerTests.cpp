@@ -0,0 +1,191 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "PBRTImporter/Parser.h"
+
+namespace Falcor
+{
+namespace
+{
+using namespace pbrt;
+
+void expectToken(CPUUnitTestContext& ctx, Tokenizer& tokenizer, std::string_view text, uint32_t line, uint32_t column)
+{
+    auto token = tokenizer.next();
+    ASSERT(token.has_value());
+    EXPECT_EQ(token->token, text);
+    EXPECT_EQ(token->loc.line, line) << "token = " << text;
+    EXPECT_EQ(token->loc.column, column) << "token = " << text;
+}
+} // namespace
+
+CPU_TEST(PBRTTokenizer_Locations)
+{
+    // Whitespace runs and comments longer than the 16 bytes that are scanned at a time.
+    std::string str = "Shape \"trianglemesh\"\n"
+                      "    # A comment that is longer than sixteen characters\n"
+                      "\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t\t  \"point3 P\" [ # comment\r\n"
+                      "\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n"
+                      "                                        1 2 3 ]# end";
+    auto tokenizer = Tokenizer::createFromString(str);
+
+    expectToken(ctx, *tokenizer, "Shape", 1, 0);
+    expectToken(ctx, *tokenizer, "\"trianglemesh\"", 1, 6);
+    expectToken(ctx, *tokenizer, "# A comment that is longer than sixteen characters", 2, 4);
+    expectToken(ctx, *tokenizer, "\"point3 P\"", 3, 20);
+    expectToken(ctx, *tokenizer, "[", 3, 31);
+    expectToken(ctx, *tokenizer, "# comment", 3, 33);
+    expectToken(ctx, *tokenizer, "1", 22, 40);
+    expectToken(ctx, *tokenizer, "2", 22, 42);
+    expectToken(ctx, *tokenizer, "3", 22, 44);
+    expectToken(ctx, *tokenizer, "]", 22, 46);
+    expectToken(ctx, *tokenizer, "# end", 22, 47);
+    EXPECT(!tokenizer->next().has_value());
+}
+
+CPU_TEST(PBRTTokenizer_FloatArray)
+{
+    // Numbers separated by newlines and comments spanning several 16-byte blocks.
+    std::string str = "[ 1 2.5 -3e2 +4 .5\n"
+                      "  # A comment that is longer than sixteen characters\n"
+                      "                        6\t7 ] Shape";
+    auto tokenizer = Tokenizer::createFromString(str);
+    expectToken(ctx, *tokenizer, "[", 1, 0);
+
+    std::vector<Float> values;
+    EXPECT(tokenizer->parseFloatArray(values));
+    EXPECT(values == std::vector<Float>({1.f, 2.5f, -300.f, 4.f, 0.5f, 6.f, 7.f}));
+    expectToken(ctx, *tokenizer, "Shape", 3, 30);
+    EXPECT(!tokenizer->next().has_value());
+}
+
+CPU_TEST(PBRTTokenizer_FloatArrayFallback)
+{
+    // Malformed numbers are left to the regular tokenizer.
+    {
+        auto tokenizer = Tokenizer::createFromString("[ 1 2\n 3x 4 ]");
+        expectToken(ctx, *tokenizer, "[", 1, 0);
+        std::vector<Float> values;
+        EXPECT(!tokenizer->parseFloatArray(values));
+        EXPECT(values == std::vector<Float>({1.f, 2.f}));
+        expectToken(ctx, *tokenizer, "3x", 2, 1);
+        expectToken(ctx, *tokenizer, "4", 2, 4);
+    }
+    {
+        auto tokenizer = Tokenizer::createFromString("[ 1,2 ]");
+        expectToken(ctx, *tokenizer, "[", 1, 0);
+        std::vector<Float> values;
+        EXPECT(!tokenizer->parseFloatArray(values));
+        EXPECT(values.empty());
+        expectToken(ctx, *tokenizer, "1,2", 1, 2);
+    }
+    {
+        auto tokenizer = Tokenizer::createFromString("[ -- ]");
+        expectToken(ctx, *tokenizer, "[", 1, 0);
+        std::vector<Float> values;
+        EXPECT(!tokenizer->parseFloatArray(values));
+        expectToken(ctx, *tokenizer, "--", 1, 2);
+    }
+
+    // Arrays mixing numbers and strings stop in front of the first string.
+    {
+        auto tokenizer = Tokenizer::createFromString("[ 1 \"two\" ]");
+        expectToken(ctx, *tokenizer, "[", 1, 0);
+        std::vector<Float> values;
+        EXPECT(!tokenizer->parseFloatArray(values));
+        EXPECT(values == std::vector<Float>({1.f}));
+        expectToken(ctx, *tokenizer, "\"two\"", 1, 4);
+        expectToken(ctx, *tokenizer, "]", 1, 10);
+    }
+
+    // A missing closing bracket consumes the input without reporting the end of the array.
+    {
+        auto tokenizer = Tokenizer::createFromString("[ 1 2 ");
+        expectToken(ctx, *tokenizer, "[", 1, 0);
+        std::vector<Float> values;
+        EXPECT(!tokenizer->parseFloatArray(values));
+        EXPECT(values == std::vector<Float>({1.f, 2.f}));
+        EXPECT(!tokenizer->next().has_value());
+    }
+}
+
+CPU_TEST(PBRTTokenizer_IntArray)
+{
+    {
+        auto tokenizer = Tokenizer::createFromString("[ 0 -2 +3 # comment\n 2147483647 -2147483648 ]");
+        expectToken(ctx, *tokenizer, "[", 1, 0);
+        std::vector<int> values;
+        EXPECT(tokenizer->parseIntArray(values));
+        EXPECT(values == std::vector<int>({0, -2, 3, 2147483647, -2147483647 - 1}));
+        EXPECT(!tokenizer->next().has_value());
+    }
+
+    // Non-integer and out of range values are left to the regular tokenizer.
+    {
+        auto tokenizer = Tokenizer::createFromString("[ 1 2.5 ]");
+        expectToken(ctx, *tokenizer, "[", 1, 0);
+        std::vector<int> values;
+        EXPECT(!tokenizer->parseIntArray(values));
+        EXPECT(values == std::vector<int>({1}));
+        expectToken(ctx, *tokenizer, "2.5", 1, 4);
+    }
+    {
+        auto tokenizer = Tokenizer::createFromString("[ 1\n 4000000000 ]");
+        expectToken(ctx, *tokenizer, "[", 1, 0);
+        std::vector<int> values;
+        EXPECT(!tokenizer->parseIntArray(values));
+        EXPECT(values == std::vector<int>({1}));
+        expectToken(ctx, *tokenizer, "4000000000", 2, 1);
+    }
+}
+
+CPU_TEST(PBRTTokenizer_FindIncludes)
+{
+    std::string str = "Include \"a.pbrt\"\n"
+                      "NotInclude \"b.pbrt\" Includes \"c.pbrt\" Include 1\n"
+                      "# Include\t\"d.pbrt\"\n"
+                      "Include \"e.pbrt\"";
+    auto tokenizer = Tokenizer::createFromString(str);
+
+    // Only the includes within the search distance are reported.
+    std::vector<std::string> filenames;
+    tokenizer->findIncludes(80, filenames);
+    EXPECT(filenames == std::vector<std::string>({"a.pbrt", "d.pbrt"}));
+
+    // No new search until parsing gets close to the end of the searched input.
+    filenames.clear();
+    tokenizer->findIncludes(80, filenames);
+    EXPECT(filenames.empty());
+
+    while (auto token = tokenizer->next())
+        if (token->token == "1")
+            break;
+    tokenizer->findIncludes(80, filenames);
+    EXPECT(filenames == std::vector<std::string>({"e.pbrt"}));
+}
+} // namespace Falcor
@@ -0,0 +1,209 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/IOService.h"
+
+#include <vector>
+#include <fstream>
+#include <random>
+#include <cstring>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+std::string writeRandomFile(const std::filesystem::path& path, size_t size)
+{
+    std::string data(size, 0);
+    std::mt19937 rng;
+    for (size_t i = 0; i < size; ++i)
+        data[i] = char(rng() & 0xff);
+
+    std::ofstream ofs(path, std::ios::binary);
+    ofs.write(data.data(), data.size());
+    ofs.close();
+    return data;
+}
+
+bool waitForReadCount(const IOService& service, uint64_t readCount)
+{
+    auto end = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (service.getStats().readCount < readCount)
+    {
+        if (std::chrono::steady_clock::now() > end)
+            return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+} // namespace
+
+CPU_TEST(IOService_Read)
+{
+    const std::filesystem::path tempPath = std::filesystem::absolute("test_io_service_read.bin");
+    std::string data = writeRandomFile(tempPath, 64 * 1024);
+
+    IOService service(2);
+    EXPECT(service.read(tempPath) == data);
+    EXPECT(service.read(tempPath, 1000, 5000) == data.substr(1000, 5000));
+    EXPECT(service.read(tempPath, 0, 0).empty());
+
+    // Reading past the end of the file fails.
+    EXPECT_THROW(service.read(tempPath, data.size() - 10, 20));
+    EXPECT_THROW(service.read("__file_that_does_not_exist__"));
+
+    IOService::Stats stats = service.getStats();
+    EXPECT_EQ(stats.bytesRead, data.size() + 5000);
+    EXPECT_EQ(stats.readCount, 3);
+    EXPECT_GE(stats.busyTime, 0.0);
+
+    service.resetStats();
+    EXPECT_EQ(service.getStats().bytesRead, 0);
+    EXPECT_EQ(service.getStats().readCount, 0);
+
+    std::filesystem::remove(tempPath);
+}
+
+CPU_TEST(IOService_ReadAsync)
+{
+    const size_t kFileCount = 16;
+    std::vector<std::filesystem::path> paths;
+    std::vector<std::string> data;
+    for (size_t i = 0; i < kFileCount; ++i)
+    {
+        paths.push_back(std::filesystem::absolute(fmt::format("test_io_service_async_{}.bin", i)));
+        data.push_back(writeRandomFile(paths.back(), 1000 + i * 100));
+    }
+
+    IOService service(4);
+    std::vector<std::future<std::string>> futures;
+    for (const auto& path : paths)
+        futures.push_back(service.readAsync(path));
+    auto rangeFuture = service.readAsync(paths[0], 10, 100);
+    auto missingFuture = service.readAsync("__file_that_does_not_exist__");
+
+    for (size_t i = 0; i < kFileCount; ++i)
+        EXPECT(futures[i].get() == data[i]);
+    EXPECT(rangeFuture.get() == data[0].substr(10, 100));
+    EXPECT_THROW(missingFuture.get());
+
+    for (const auto& path : paths)
+        std::filesystem::remove(path);
+}
+
+CPU_TEST(IOService_ReadAhead)
+{
+    const std::filesystem::path tempPath = std::filesystem::absolute("test_io_service_read_ahead.bin");
+    std::string data = writeRandomFile(tempPath, 4096);
+
+    IOService service(2);
+    {
+        auto readAhead = service.readAhead({tempPath, tempPath, "__file_that_does_not_exist__"});
+
+        // The read-ahead data is handed to the next read, relative paths map to the same file.
+        EXPECT(service.read(std::filesystem::relative(tempPath)) == data);
+        EXPECT_EQ(service.getStats().readCount, 1);
+
+        // Subsequent reads go to the file again.
+        EXPECT(service.read(tempPath) == data);
+        EXPECT_EQ(service.getStats().readCount, 2);
+    }
+
+    // Data of a file modified after the read-ahead is not used.
+    {
+        auto readAhead = service.readAhead({tempPath});
+        ASSERT(waitForReadCount(service, 3));
+        std::string modified = writeRandomFile(tempPath, 2048);
+        EXPECT(service.read(tempPath) == modified);
+        EXPECT_EQ(service.getStats().readCount, 4);
+    }
+
+    // Releasing the hints drops the data, the next read goes to the file.
+    {
+        auto readAhead = service.readAhead({tempPath});
+        readAhead.release();
+        service.read(tempPath);
+        EXPECT(waitForReadCount(service, 6));
+    }
+
+    std::filesystem::remove(tempPath);
+}
+
+CPU_TEST(IOService_ReadAheadWindow)
+{
+    const size_t kFileCount = IOService::kMaxReadAheadCount + 16;
+    std::vector<std::filesystem::path> paths;
+    std::vector<std::string> data;
+    for (size_t i = 0; i < kFileCount; ++i)
+    {
+        paths.push_back(std::filesystem::absolute(fmt::format("test_io_service_window_{}.bin", i)));
+        data.push_back(writeRandomFile(paths.back(), 100 + i));
+    }
+
+    IOService service(4);
+    auto readAhead = service.readAhead(paths);
+
+    // Only the first files are read ahead, the remaining ones are started as files are consumed.
+    ASSERT(waitForReadCount(service, IOService::kMaxReadAheadCount));
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_EQ(service.getStats().readCount, IOService::kMaxReadAheadCount);
+
+    std::vector<std::future<std::string>> futures;
+    for (size_t i = 0; i < kFileCount; ++i)
+        futures.push_back(service.readAsync(paths[i]));
+    for (size_t i = 0; i < kFileCount; ++i)
+        EXPECT(futures[i].get() == data[i]);
+    EXPECT_EQ(service.getStats().readCount, kFileCount);
+
+    for (const auto& path : paths)
+        std::filesystem::remove(path);
+}
+
+CPU_TEST(IOService_Map)
+{
+    const std::filesystem::path tempPath = std::filesystem::absolute("test_io_service_map.bin");
+    std::string data = writeRandomFile(tempPath, 32 * 1024);
+
+    IOService service(1);
+    {
+        auto pFile = service.map(tempPath);
+        ASSERT(pFile != nullptr);
+        EXPECT_EQ(pFile->getSize(), data.size());
+        EXPECT(std::memcmp(pFile->getData(), data.data(), data.size()) == 0);
+    }
+
+    EXPECT(service.map("__file_that_does_not_exist__") == nullptr);
+
+    // Empty files cannot be mapped.
+    writeRandomFile(tempPath, 0);
+    EXPECT(service.map(tempPath) == nullptr);
+
+    std::filesystem::remove(tempPath);
+}
+} // namespace Falcor
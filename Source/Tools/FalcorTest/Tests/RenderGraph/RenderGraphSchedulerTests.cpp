@@ -0,0 +1,143 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/RenderGraphScheduler.h"
+
+namespace Falcor
+{
+namespace
+{
+using State = Resource::State;
+using Queue = RenderGraphScheduler::Queue;
+
+/**
+ * Graph with a G-buffer pass feeding two independent compute passes (AO and shadows), whose results are combined by a lighting pass.
+ * Resources: 0 = color, 1 = depth, 2 = AO, 3 = shadows, 4 = lighting, 5 = output.
+ */
+RenderGraphScheduler::Input createDeferredInput()
+{
+    RenderGraphScheduler::Input input;
+    input.passes = {
+        {"GBuffer", 2.f, false, {{0, State::RenderTarget, true}, {1, State::DepthStencil, true}}},
+        {"AO", 1.f, true, {{1, State::ShaderResource, false}, {2, State::UnorderedAccess, true}}},
+        {"Shadows", 3.f, true, {{1, State::ShaderResource, false}, {3, State::UnorderedAccess, true}}},
+        {"Lighting",
+         2.f,
+         false,
+         {{0, State::ShaderResource, false},
+          {2, State::ShaderResource, false},
+          {3, State::ShaderResource, false},
+          {4, State::UnorderedAccess, true}}},
+        {"ToneMap", 1.f, false, {{4, State::ShaderResource, false}, {5, State::RenderTarget, true}}},
+    };
+    return input;
+}
+
+bool hasBarrier(const std::vector<RenderGraphScheduler::Barrier>& barriers, uint32_t resource, State before, State after)
+{
+    for (const auto& b : barriers)
+        if (b.resource == resource && b.before == before && b.after == after)
+            return true;
+    return false;
+}
+} // namespace
+
+CPU_TEST(RenderGraphScheduler_Levels)
+{
+    auto plan = RenderGraphScheduler::build(createDeferredInput());
+
+    EXPECT_EQ(plan.getLevelCount(), 4u);
+    ASSERT_EQ(plan.passes.size(), 5u);
+    EXPECT(plan.levels[0] == std::vector<uint32_t>({0}));
+    EXPECT(plan.levels[1] == std::vector<uint32_t>({1, 2}));
+    EXPECT(plan.levels[2] == std::vector<uint32_t>({3}));
+    EXPECT(plan.levels[3] == std::vector<uint32_t>({4}));
+
+    // The schedule is ordered by level.
+    for (size_t i = 1; i < plan.passes.size(); i++)
+        EXPECT_LE(plan.passes[i - 1].level, plan.passes[i].level);
+
+    // The critical path goes through the more expensive shadow pass.
+    EXPECT(plan.criticalPath == std::vector<uint32_t>({0, 2, 3, 4}));
+    EXPECT_EQ(plan.criticalPathCost, 8.f);
+    EXPECT_EQ(plan.findPass(1)->slack, 2.f);
+    EXPECT_EQ(plan.findPass(2)->slack, 0.f);
+}
+
+CPU_TEST(RenderGraphScheduler_AsyncCompute)
+{
+    auto plan = RenderGraphScheduler::build(createDeferredInput());
+
+    // Only the AO pass is compute-capable and off the critical path.
+    for (const auto& p : plan.passes)
+        EXPECT(p.queue == (p.pass == 1 ? Queue::Compute : Queue::Graphics)) << "pass " << p.pass;
+
+    // The depth buffer is released on the graphics queue after the G-buffer pass, so both readers can use it.
+    const auto* pGBuffer = plan.findPass(0);
+    EXPECT(hasBarrier(pGBuffer->releaseBarriers, 1, State::DepthStencil, State::ShaderResource));
+
+    const auto* pAO = plan.findPass(1);
+    EXPECT(pAO->queueWaits == std::vector<uint32_t>({0}));
+    EXPECT(hasBarrier(pAO->barriers, 2, State::Undefined, State::UnorderedAccess));
+
+    // The shadow pass overlaps with AO and doesn't wait on the compute queue.
+    const auto* pShadows = plan.findPass(2);
+    EXPECT(pShadows->queueWaits.empty());
+    EXPECT(pShadows->barriers.size() == 1);
+
+    // Lighting consumes the AO result produced on the compute queue.
+    const auto* pLighting = plan.findPass(3);
+    EXPECT(pLighting->queueWaits == std::vector<uint32_t>({1}));
+    EXPECT(hasBarrier(pAO->releaseBarriers, 2, State::UnorderedAccess, State::ShaderResource));
+    EXPECT(hasBarrier(pLighting->barriers, 0, State::RenderTarget, State::ShaderResource));
+    EXPECT(hasBarrier(pLighting->barriers, 3, State::UnorderedAccess, State::ShaderResource));
+}
+
+CPU_TEST(RenderGraphScheduler_Hazards)
+{
+    // Two passes writing the same UAV, followed by a reader, and an explicit execution dependency without resources.
+    RenderGraphScheduler::Input input;
+    input.passes = {
+        {"A", 1.f, false, {{0, State::UnorderedAccess, true}}},
+        {"B", 1.f, false, {{0, State::UnorderedAccess, true}}},
+        {"C", 1.f, false, {{0, State::ShaderResource, false}}},
+        {"D", 1.f, false, {}},
+    };
+    input.dependencies = {{2, 3}};
+
+    auto plan = RenderGraphScheduler::build(input);
+    EXPECT_EQ(plan.getLevelCount(), 4u);
+    EXPECT(hasBarrier(plan.findPass(1)->barriers, 0, State::UnorderedAccess, State::UnorderedAccess));
+    EXPECT(hasBarrier(plan.findPass(2)->barriers, 0, State::UnorderedAccess, State::ShaderResource));
+    EXPECT_EQ(plan.findPass(3)->level, 3u);
+
+    // Dependencies must follow the pass order.
+    input.dependencies = {{3, 0}};
+    EXPECT_THROW(RenderGraphScheduler::build(input));
+}
+} // namespace Falcor
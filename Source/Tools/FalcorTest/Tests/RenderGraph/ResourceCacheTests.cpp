@@ -0,0 +1,85 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/ResourceCache.h"
+#include "RenderGraph/RenderPassReflection.h"
+
+namespace Falcor
+{
+GPU_TEST(ResourceCache_FieldTable)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    RenderPassReflection reflectionA;
+    reflectionA.addOutput("out", "Output").texture2D(16, 16);
+
+    RenderPassReflection reflectionB;
+    reflectionB.addInput("in", "Input");
+    reflectionB.addInput("external", "External input").flags(RenderPassReflection::Field::Flags::Optional);
+
+    ResourceCache cache;
+    cache.registerField("A.out", *reflectionA.getField("out"), 0);
+    cache.registerField("B.in", *reflectionB.getField("in"), 1, "A.out");
+    cache.allocateResources(pDevice, {uint2(16, 16), ResourceFormat::RGBA8Unorm});
+
+    ResourceCache::FieldTable fieldsA = cache.createFieldTable("A", reflectionA);
+    ResourceCache::FieldTable fieldsB = cache.createFieldTable("B", reflectionB);
+
+    // Field indices follow the reflection order.
+    EXPECT_EQ(fieldsA.getFieldCount(), 1u);
+    EXPECT_EQ(fieldsB.getFieldCount(), 2u);
+    EXPECT_EQ(fieldsA.findField("out"), 0u);
+    EXPECT_EQ(fieldsB.findField("in"), 0u);
+    EXPECT_EQ(fieldsB.findField("external"), 1u);
+    EXPECT_EQ(fieldsB.findField("out"), ResourceCache::kInvalidIndex);
+
+    // Aliased fields resolve to the same resource as the string lookup.
+    ref<Resource> pOut = cache.getResource(fieldsA.getHandle(0));
+    EXPECT(pOut != nullptr);
+    EXPECT(cache.getResource(fieldsB.getHandle(0)) == pOut);
+    EXPECT(cache.getResource("B.in") == pOut);
+
+    // External resources bound after the table was created are visible through the handles.
+    const ResourceCache::ResourceHandle& externalHandle = fieldsB.getHandle(1);
+    EXPECT(cache.getResource(externalHandle) == nullptr);
+
+    ref<Texture> pExternal = pDevice->createTexture2D(4, 4, ResourceFormat::RGBA8Unorm, 1, 1);
+    cache.registerExternalResource("B.external", pExternal);
+    EXPECT(cache.getResource(externalHandle) == ref<Resource>(pExternal));
+    EXPECT(cache.getResource("B.external") == ref<Resource>(pExternal));
+
+    cache.registerExternalResource("B.external", nullptr);
+    EXPECT(cache.getResource(externalHandle) == nullptr);
+    EXPECT(cache.getResource("B.external") == nullptr);
+
+    // External resources take precedence over resources owned by the cache.
+    cache.registerExternalResource("B.in", pExternal);
+    EXPECT(cache.getResource(fieldsB.getHandle(0)) == ref<Resource>(pExternal));
+    EXPECT(cache.getResource(fieldsA.getHandle(0)) == pOut);
+}
+} // namespace Falcor
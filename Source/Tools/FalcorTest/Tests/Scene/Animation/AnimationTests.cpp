@@ -0,0 +1,262 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Animation/Animation.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+/// Create an animation translating along x by one unit per second, with irregularly spaced keyframes starting at time zero.
+ref<Animation> createLinearAnimation(uint32_t keyframeCount, std::vector<double>& times)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<double> dist(0.1, 1.0);
+    times.resize(keyframeCount);
+    for (uint32_t i = 0; i < keyframeCount; i++)
+        times[i] = i == 0 ? 0.0 : times[i - 1] + dist(rng);
+
+    ref<Animation> pAnimation = Animation::create("test", NodeID(0), times.back());
+    for (double time : times)
+    {
+        Animation::Keyframe keyframe;
+        keyframe.time = time;
+        keyframe.translation = float3((float)time, 0.f, 0.f);
+        pAnimation->addKeyframe(keyframe);
+    }
+    return pAnimation;
+}
+} // namespace
+
+CPU_TEST(Animation_Keyframes)
+{
+    ref<Animation> pAnimation = Animation::create("test", NodeID(0), 10.0);
+
+    // Add keyframes out of order and replace an existing one.
+    for (double time : {5.0, 1.0, 3.0, 10.0, 0.0, 3.0})
+    {
+        Animation::Keyframe keyframe;
+        keyframe.time = time;
+        keyframe.translation = float3((float)time);
+        pAnimation->addKeyframe(keyframe);
+    }
+
+    EXPECT_EQ(pAnimation->getKeyframeCount(), 5);
+    EXPECT(pAnimation->doesKeyframeExists(3.0));
+    EXPECT(!pAnimation->doesKeyframeExists(2.0));
+    EXPECT_EQ(pAnimation->getKeyframe(5.0).translation.x, 5.f);
+    EXPECT_THROW(pAnimation->getKeyframe(2.0));
+}
+
+CPU_TEST(Animation_Scrubbing)
+{
+    std::vector<double> times;
+    ref<Animation> pAnimation = createLinearAnimation(1000, times);
+
+    // Evaluate at random times, both forward and backward, and at the keyframes themselves.
+    std::mt19937 rng(2);
+    std::uniform_real_distribution<double> dist(0.0, times.back());
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        double time = (i % 4 == 0) ? times[rng() % times.size()] : dist(rng);
+        float4x4 transform = pAnimation->animate(time);
+        EXPECT_LE(std::abs(transform[0][3] - (float)time), 1e-3f) << "time = " << time;
+    }
+
+    // Times outside the keyframe range are clamped with the default constant behavior.
+    EXPECT_EQ(pAnimation->animate(-1.0)[0][3], 0.f);
+    EXPECT_EQ(pAnimation->animate(times.back() + 1.0)[0][3], (float)times.back());
+}
+
+CPU_TEST(Animation_TRS)
+{
+    ref<Animation> pAnimation = Animation::create("test", NodeID(0), 1.0);
+    Animation::Keyframe keyframe;
+    keyframe.translation = float3(1.f, 2.f, 3.f);
+    keyframe.scaling = float3(2.f, 0.5f, 4.f);
+    keyframe.rotation = math::quatFromAngleAxis(0.7f, normalize(float3(1.f, 2.f, -1.f)));
+    pAnimation->addKeyframe(keyframe);
+
+    float4x4 T = math::matrixFromTranslation(keyframe.translation);
+    float4x4 R = math::matrixFromQuat(keyframe.rotation);
+    float4x4 S = math::matrixFromScaling(keyframe.scaling);
+    float4x4 expected = mul(mul(T, R), S);
+
+    float4x4 transform = pAnimation->animate(0.0);
+    for (int r = 0; r < 4; r++)
+        for (int c = 0; c < 4; c++)
+            EXPECT_LE(std::abs(transform[r][c] - expected[r][c]), 1e-5f) << "r=" << r << " c=" << c;
+}
+
+CPU_TEST(Animation_CompressLinear)
+{
+    std::vector<double> times;
+    ref<Animation> pAnimation = createLinearAnimation(1000, times);
+    const uint64_t uncompressedSize = pAnimation->getMemoryUsageInBytes();
+
+    pAnimation->compress();
+    EXPECT(pAnimation->isCompressed());
+    EXPECT_LE(pAnimation->getKeyframeCount(), 10);
+    EXPECT_LE(pAnimation->getMemoryUsageInBytes() * 10, uncompressedSize);
+
+    // The first and last keyframes are always kept.
+    EXPECT(pAnimation->doesKeyframeExists(times.front()));
+    EXPECT(pAnimation->doesKeyframeExists(times.back()));
+
+    std::mt19937 rng(4);
+    std::uniform_real_distribution<double> dist(0.0, times.back());
+    for (uint32_t i = 0; i < 10000; i++)
+    {
+        double time = (i % 4 == 0) ? times[rng() % times.size()] : dist(rng);
+        float4x4 transform = pAnimation->animate(time);
+        EXPECT_LE(std::abs(transform[0][3] - (float)time), 1e-3f) << "time = " << time;
+    }
+}
+
+CPU_TEST(Animation_CompressHermite)
+{
+    // Accelerating rotation with varying scale, sampled densely.
+    const uint32_t keyframeCount = 500;
+    ref<Animation> pAnimation = Animation::create("test", NodeID(0), 2.0);
+    pAnimation->setInterpolationMode(Animation::InterpolationMode::Hermite);
+    pAnimation->setEnableWarping(true);
+    for (uint32_t i = 0; i < keyframeCount; i++)
+    {
+        Animation::Keyframe keyframe;
+        keyframe.time = 2.0 * i / (keyframeCount - 1);
+        float t = (float)keyframe.time;
+        keyframe.translation = float3(t, std::sin(t), 0.f);
+        keyframe.scaling = float3(1.f + 0.5f * t);
+        keyframe.rotation = math::quatFromAngleAxis(t * t, normalize(float3(1.f, 2.f, -1.f)));
+        pAnimation->addKeyframe(keyframe);
+    }
+
+    std::vector<double> sampleTimes;
+    std::vector<float4x4> expected;
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        sampleTimes.push_back(2.0 * i / 999);
+        expected.push_back(pAnimation->animate(sampleTimes.back()));
+    }
+
+    const uint64_t uncompressedSize = pAnimation->getMemoryUsageInBytes();
+    pAnimation->compress();
+    EXPECT(pAnimation->isCompressed());
+
+    // Hermite interpolation ignores the keyframe spacing, so fewer keyframes can be removed than with linear interpolation.
+    // Most of the savings come from quantization.
+    EXPECT_LT(pAnimation->getKeyframeCount(), keyframeCount);
+    EXPECT_LE(pAnimation->getMemoryUsageInBytes() * 2, uncompressedSize);
+
+    for (size_t i = 0; i < sampleTimes.size(); i++)
+    {
+        float4x4 transform = pAnimation->animate(sampleTimes[i]);
+        for (int r = 0; r < 3; r++)
+            for (int c = 0; c < 4; c++)
+                EXPECT_LE(std::abs(transform[r][c] - expected[i][r][c]), 5e-3f) << "time = " << sampleTimes[i] << " r=" << r << " c=" << c;
+    }
+}
+
+CPU_TEST(Animation_CompressRotationTolerance)
+{
+    // Rotation over several turns, so that the quaternions change sign, with a tolerance below the rotation quantization error.
+    for (auto mode : {Animation::InterpolationMode::Linear, Animation::InterpolationMode::Hermite})
+    {
+        const uint32_t keyframeCount = 400;
+        ref<Animation> pAnimation = Animation::create("test", NodeID(0), 4.0);
+        pAnimation->setInterpolationMode(mode);
+        std::vector<Animation::Keyframe> keyframes;
+        for (uint32_t i = 0; i < keyframeCount; i++)
+        {
+            Animation::Keyframe keyframe;
+            keyframe.time = 4.0 * i / (keyframeCount - 1);
+            float t = (float)keyframe.time;
+            keyframe.rotation = math::quatFromAngleAxis(3.f * t * t, normalize(float3(0.3f, 1.f, 0.2f)));
+            keyframes.push_back(keyframe);
+            pAnimation->addKeyframe(keyframe);
+        }
+
+        Animation::CompressionOptions options;
+        options.rotationTolerance = 1e-5f;
+        pAnimation->compress(options);
+        EXPECT(pAnimation->isCompressed());
+
+        for (const auto& keyframe : keyframes)
+        {
+            float4x4 transform = pAnimation->animate(keyframe.time);
+            float4x4 expected = math::matrixFromQuat(keyframe.rotation);
+            for (int r = 0; r < 3; r++)
+                for (int c = 0; c < 3; c++)
+                    EXPECT_LE(std::abs(transform[r][c] - expected[r][c]), 2e-5f) << "time = " << keyframe.time << " r=" << r << " c=" << c;
+        }
+    }
+}
+
+CPU_TEST(Animation_CompressAddKeyframe)
+{
+    std::vector<double> times;
+    ref<Animation> pAnimation = createLinearAnimation(100, times);
+    pAnimation->compress();
+    EXPECT(pAnimation->isCompressed());
+
+    // Adding a keyframe decompresses the animation and keeps the remaining keyframes.
+    const size_t compressedCount = pAnimation->getKeyframeCount();
+    Animation::Keyframe keyframe;
+    keyframe.time = 0.5 * (times[0] + times[1]);
+    keyframe.translation = float3(100.f);
+    pAnimation->addKeyframe(keyframe);
+
+    EXPECT(!pAnimation->isCompressed());
+    EXPECT_EQ(pAnimation->getKeyframeCount(), compressedCount + 1);
+    EXPECT_EQ(pAnimation->getKeyframe(keyframe.time).translation.x, 100.f);
+    EXPECT_LE(std::abs(pAnimation->animate(times.back())[0][3] - (float)times.back()), 1e-3f);
+}
+
+CPU_BENCHMARK(Animation_ScrubbingBenchmark)
+{
+    std::vector<double> times;
+    ref<Animation> pAnimation = createLinearAnimation(100000, times);
+
+    // Jump around in a long clip, as when scrubbing the timeline.
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<double> dist(0.0, times.back());
+    std::vector<double> sampleTimes(1024);
+    for (auto& time : sampleTimes) time = dist(rng);
+
+    float sum = 0.f;
+    ctx.setItemsPerIteration(sampleTimes.size());
+    ctx.run(
+        [&]()
+        {
+            for (double time : sampleTimes) sum += pAnimation->animate(time)[0][3];
+        }
+    );
+    EXPECT_GT(sum, 0.f);
+}
+} // namespace Falcor
@@ -0,0 +1,169 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Animation/VertexCacheStream.h"
+#include "Core/Platform/OS.h"
+#include <fstream>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+struct TestVertex
+{
+    float2 texCrd;
+    float3 position;
+    uint32_t id;
+};
+
+/// Create keyframes of a randomly perturbed grid moving along a smooth path.
+std::vector<std::vector<TestVertex>> createFrames(uint32_t frameCount, uint32_t vertexCount)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+
+    std::vector<std::vector<TestVertex>> frames(frameCount, std::vector<TestVertex>(vertexCount));
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        float3 p(dist(rng), dist(rng), dist(rng));
+        float2 uv(dist(rng), dist(rng));
+        for (uint32_t f = 0; f < frameCount; f++)
+        {
+            float3 offset(std::sin(0.1f * f + p.x), 0.01f * f * f, dist(rng) * 1e-3f);
+            frames[f][v] = { uv, 10.f * p + offset, v * 7 + f };
+        }
+    }
+    return frames;
+}
+
+VertexCacheFile::Desc createDesc(uint32_t vertexCount, float tolerance)
+{
+    VertexCacheFile::Desc desc;
+    desc.vertexCount = vertexCount;
+    desc.vertexStride = sizeof(TestVertex);
+    desc.positionOffset = offsetof(TestVertex, position);
+    desc.positionTolerance = tolerance;
+    return desc;
+}
+} // namespace
+
+CPU_TEST(VertexCacheFile_RoundTrip)
+{
+    const uint32_t frameCount = 2 * VertexCacheFile::kIntraFrameInterval + 5;
+    const uint32_t vertexCount = 1000;
+    const float tolerance = 1e-4f;
+    auto frames = createFrames(frameCount, vertexCount);
+
+    std::filesystem::path path = getTempFilePath();
+    VertexCacheFile::write(path, createDesc(vertexCount, tolerance), frameCount, [&](uint32_t f) { return frames[f].data(); });
+
+    {
+        VertexCacheFile file(path);
+        EXPECT_EQ(file.getFrameCount(), frameCount);
+        EXPECT_EQ(file.getVertexCount(), vertexCount);
+        EXPECT_EQ(file.getFrameSize(), vertexCount * sizeof(TestVertex));
+        EXPECT_LT(file.getFileSize(), frameCount * file.getFrameSize());
+
+        // Decode in reverse order to exercise random access to intra and delta frames.
+        std::vector<TestVertex> decoded(vertexCount);
+        for (uint32_t f = frameCount; f-- > 0;)
+        {
+            file.readFrame(f, decoded.data());
+            for (uint32_t v = 0; v < vertexCount; v++)
+            {
+                const TestVertex& expected = frames[f][v];
+                EXPECT_LE(length(decoded[v].position - expected.position), tolerance) << "frame = " << f << " vertex = " << v;
+                EXPECT(all(decoded[v].texCrd == expected.texCrd)) << "frame = " << f << " vertex = " << v;
+                EXPECT_EQ(decoded[v].id, expected.id) << "frame = " << f << " vertex = " << v;
+            }
+        }
+    }
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(VertexCacheFile_Invalid)
+{
+    std::filesystem::path path = getTempFilePath();
+    EXPECT_THROW(VertexCacheFile file(path));
+
+    {
+        std::ofstream stream(path, std::ios::binary);
+        stream << "not a vertex cache file, just some text of sufficient length";
+    }
+    EXPECT_THROW(VertexCacheFile file(path));
+
+    std::filesystem::remove(path);
+}
+
+CPU_TEST(VertexCacheWindow_Update)
+{
+    VertexCacheWindow window(3);
+    EXPECT_EQ(window.getSlotCount(), 3);
+    EXPECT_EQ(window.findSlot(0), VertexCacheWindow::kInvalidSlot);
+
+    // All keyframes need to be loaded initially.
+    auto loads = window.update({ 0, 1, 2 });
+    EXPECT_EQ(loads.size(), 3);
+    for (const auto& load : loads)
+    {
+        EXPECT_EQ(window.findSlot(load.frame), load.slot);
+        EXPECT(!window.isLoaded(load.frame));
+        EXPECT(window.markLoaded(load));
+        EXPECT(window.isLoaded(load.frame));
+    }
+
+    // Advancing by one keyframe reuses the slot of the keyframe that dropped out.
+    uint32_t slot0 = window.findSlot(0);
+    uint32_t slot1 = window.findSlot(1);
+    loads = window.update({ 1, 2, 3 });
+    EXPECT_EQ(loads.size(), 1);
+    EXPECT_EQ(loads[0].frame, 3);
+    EXPECT_EQ(loads[0].slot, slot0);
+    EXPECT_EQ(window.findSlot(0), VertexCacheWindow::kInvalidSlot);
+    EXPECT_EQ(window.findSlot(1), slot1);
+    EXPECT(window.isLoaded(1));
+    EXPECT(!window.isLoaded(3));
+    auto pending = loads[0];
+
+    // Keyframes beyond the slot count are ignored.
+    loads = window.update({ 1, 2, 3, 4 });
+    EXPECT_EQ(loads.size(), 0);
+    EXPECT_EQ(window.findSlot(4), VertexCacheWindow::kInvalidSlot);
+
+    // A load into a slot that has been reassigned before it completed is stale.
+    loads = window.update({ 1, 2, 5 });
+    EXPECT_EQ(loads.size(), 1);
+    EXPECT_EQ(loads[0].slot, slot0);
+    EXPECT(!window.markLoaded(pending));
+    EXPECT(!window.isLoaded(5));
+    EXPECT(window.markLoaded(loads[0]));
+    EXPECT(window.isLoaded(5));
+}
+} // namespace Falcor
@@ -0,0 +1,107 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/AssetCache.h"
+#include "Core/Platform/OS.h"
+#include <fstream>
+
+namespace Falcor
+{
+CPU_TEST(AssetCache_ReadWrite)
+{
+    std::filesystem::path directory = getTempFilePath();
+    AssetCache cache(directory);
+
+    AssetCache::Key keyA = SHA1::compute("a", 1);
+    AssetCache::Key keyB = SHA1::compute("b", 1);
+
+    std::vector<uint8_t> data;
+    EXPECT(!cache.read(keyA, data));
+
+    std::vector<uint8_t> entryA = {1, 2, 3, 4, 5};
+    cache.write(keyA, entryA);
+    EXPECT(cache.read(keyA, data));
+    EXPECT(data == entryA);
+    EXPECT(!cache.read(keyB, data));
+
+    // Overwrite with an empty entry.
+    cache.write(keyA, {});
+    EXPECT(cache.read(keyA, data));
+    EXPECT(data.empty());
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.hitCount, 2);
+    EXPECT_EQ(stats.missCount, 2);
+    EXPECT_EQ(stats.writeCount, 2);
+    EXPECT_EQ(stats.bytesRead, 5);
+    EXPECT_EQ(stats.bytesWritten, 5);
+
+    // Truncated entries are rejected.
+    cache.write(keyB, entryA);
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(directory))
+    {
+        if (entry.is_regular_file() && entry.path().filename().string().rfind(SHA1::toString(keyB), 0) == 0)
+            std::filesystem::resize_file(entry.path(), std::filesystem::file_size(entry.path()) - 1);
+    }
+    EXPECT(!cache.read(keyB, data));
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_TEST(AssetCache_Serialization)
+{
+    AssetCache::Writer writer;
+    writer.write(uint32_t(42));
+    writer.write(std::vector<float>{1.f, 2.f, 3.f});
+    writer.write(std::string("mesh"));
+
+    std::vector<uint8_t> data = writer.getData();
+    {
+        AssetCache::Reader reader(data);
+        uint32_t value = 0;
+        std::vector<float> vec;
+        std::string str;
+        EXPECT(reader.read(value) && reader.read(vec) && reader.read(str));
+        EXPECT(reader.isAtEnd());
+        EXPECT_EQ(value, 42);
+        EXPECT(vec == std::vector<float>({1.f, 2.f, 3.f}));
+        EXPECT_EQ(str, "mesh");
+    }
+
+    // Reads past the end fail instead of reading out of bounds.
+    data.resize(data.size() - 2);
+    {
+        AssetCache::Reader reader(data);
+        uint32_t value = 0;
+        std::vector<float> vec;
+        std::string str;
+        EXPECT(reader.read(value) && reader.read(vec));
+        EXPECT(!reader.read(str));
+    }
+}
+} // namespace Falcor
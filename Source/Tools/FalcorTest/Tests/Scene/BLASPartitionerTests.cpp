@@ -0,0 +1,166 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/BLASPartitioner.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const uint64_t kTrianglesPerItem = 1000;
+
+/// Create a grid of non-overlapping unit boxes in the xz-plane.
+std::vector<BLASPartitioner::Item> createGrid(uint32_t size)
+{
+    std::vector<BLASPartitioner::Item> items;
+    for (uint32_t z = 0; z < size; z++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            float3 p(2.f * x, 0.f, 2.f * z);
+            items.push_back({AABB(p, p + float3(1.f)), kTrianglesPerItem});
+        }
+    }
+    return items;
+}
+
+BLASPartitioner::Options createOptions(uint64_t maxItemsPerGroup)
+{
+    BLASPartitioner::Options options;
+    options.maxGroupMemory = maxItemsPerGroup * kTrianglesPerItem * options.bytesPerTriangle;
+    return options;
+}
+
+void checkPartition(CPUUnitTestContext& ctx, const std::vector<BLASPartitioner::Item>& items, const BLASPartitioner::Partition& partition)
+{
+    std::vector<uint32_t> count(items.size(), 0);
+    for (const auto& group : partition)
+    {
+        EXPECT(!group.empty());
+        for (uint32_t i : group)
+        {
+            ASSERT_LT(i, items.size());
+            count[i]++;
+        }
+    }
+    for (size_t i = 0; i < items.size(); i++)
+        EXPECT_EQ(count[i], 1u) << "item " << i;
+}
+} // namespace
+
+CPU_TEST(BLASPartitioner_Budget)
+{
+    auto items = createGrid(8);
+    auto options = createOptions(16);
+
+    auto partition = BLASPartitioner::partition(items, options);
+    checkPartition(ctx, items, partition);
+
+    auto metrics = BLASPartitioner::evaluate(items, partition, options);
+    EXPECT_EQ(metrics.groupCount, 4u);
+    EXPECT_LE(metrics.maxGroupMemory, options.maxGroupMemory);
+
+    // A grid of disjoint boxes split into quadrants has no overlap.
+    EXPECT_EQ(metrics.overlappingPairs, 0u);
+    EXPECT_EQ(metrics.overlapArea, 0.f);
+
+    // Everything fits in a single group with a large enough budget.
+    EXPECT_EQ(BLASPartitioner::partition(items, createOptions(64)).size(), 1u);
+}
+
+CPU_TEST(BLASPartitioner_Overlap)
+{
+    // Partition a shuffled grid in input order as a baseline.
+    auto items = createGrid(16);
+    std::mt19937 rng(0);
+    std::shuffle(items.begin(), items.end(), rng);
+    auto options = createOptions(32);
+
+    BLASPartitioner::Partition baseline(items.size() / 32);
+    for (uint32_t i = 0; i < items.size(); i++)
+        baseline[i / 32].push_back(i);
+
+    auto partition = BLASPartitioner::partition(items, options);
+    checkPartition(ctx, items, partition);
+
+    auto metrics = BLASPartitioner::evaluate(items, partition, options);
+    auto baselineMetrics = BLASPartitioner::evaluate(items, baseline, options);
+
+    EXPECT_EQ(metrics.groupCount, baselineMetrics.groupCount);
+    EXPECT_LE(metrics.maxGroupMemory, options.maxGroupMemory);
+    EXPECT_LT(metrics.sahCost, baselineMetrics.sahCost);
+    EXPECT_LT(metrics.overlapArea, baselineMetrics.overlapArea);
+    EXPECT_LT(metrics.overlappingPairs, baselineMetrics.overlappingPairs);
+}
+
+CPU_TEST(BLASPartitioner_Degenerate)
+{
+    auto options = createOptions(4);
+
+    // Items with coincident centroids are split by triangle count.
+    std::vector<BLASPartitioner::Item> items(10, {AABB(float3(0.f), float3(1.f)), kTrianglesPerItem});
+    auto partition = BLASPartitioner::partition(items, options);
+    checkPartition(ctx, items, partition);
+    for (const auto& group : partition)
+        EXPECT_LE(group.size(), 4u);
+
+    auto metrics = BLASPartitioner::evaluate(items, partition, options);
+    EXPECT_EQ(metrics.overlappingPairs, metrics.groupCount * (metrics.groupCount - 1) / 2);
+
+    // A single item exceeding the budget forms its own group.
+    std::vector<BLASPartitioner::Item> large = {{AABB(float3(0.f), float3(1.f)), 100 * kTrianglesPerItem}};
+    EXPECT_EQ(BLASPartitioner::partition(large, options).size(), 1u);
+
+    EXPECT(BLASPartitioner::partition({}, options).empty());
+}
+
+CPU_TEST(BLASPartitioner_Metrics)
+{
+    BLASPartitioner::Options options;
+    std::vector<BLASPartitioner::Item> items = {
+        {AABB(float3(0.f), float3(1.f)), 10},
+        {AABB(float3(0.f), float3(1.f)), 20},
+        {AABB(float3(3.f, 0.f, 0.f), float3(4.f, 1.f, 1.f)), 30},
+    };
+
+    // Scene bounds are 4x1x1 with area 18. Each unit box has area 6.
+    auto metrics = BLASPartitioner::evaluate(items, {{0}, {1}, {2}}, options);
+    EXPECT_EQ(metrics.groupCount, 3u);
+    EXPECT_EQ(metrics.maxGroupMemory, 30 * options.bytesPerTriangle);
+    EXPECT_EQ(metrics.overlappingPairs, 1u);
+    EXPECT_EQ(metrics.overlapArea, 6.f / 18.f);
+    EXPECT_LE(std::abs(metrics.sahCost - 6.f * 60.f / 18.f), 1e-5f);
+
+    metrics = BLASPartitioner::evaluate(items, {{0, 1}, {2}}, options);
+    EXPECT_EQ(metrics.overlappingPairs, 0u);
+    EXPECT_EQ(metrics.overlapArea, 0.f);
+}
+} // namespace Falcor
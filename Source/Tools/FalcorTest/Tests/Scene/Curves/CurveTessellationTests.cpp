@@ -0,0 +1,297 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Curves/CurveTessellation.h"
+
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+struct Groom
+{
+    std::vector<uint32_t> vertexCountsPerStrand;
+    std::vector<float3> controlPoints;
+    std::vector<float> widths;
+    std::vector<float2> UVs;
+};
+
+/// Create a synthetic groom of random strands. Some control points are duplicated to exercise duplicate removal.
+Groom createGroom(uint32_t strandCount, uint32_t minVertexCount, uint32_t maxVertexCount, uint32_t seed)
+{
+    Groom groom;
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+
+    for (uint32_t i = 0; i < strandCount; ++i)
+    {
+        uint32_t vertexCount = minVertexCount + rng() % (maxVertexCount - minVertexCount + 1);
+        groom.vertexCountsPerStrand.push_back(vertexCount);
+
+        float3 p = float3(u(rng), 0.f, u(rng)) * 10.f;
+        float2 uv = float2(u(rng), u(rng));
+        for (uint32_t j = 0; j < vertexCount; ++j)
+        {
+            if (j == 0 || j == vertexCount - 1 || rng() % 8 != 0)
+                p += float3(0.1f * (u(rng) - 0.5f), 0.2f, 0.1f * (u(rng) - 0.5f));
+            groom.controlPoints.push_back(p);
+            groom.widths.push_back(0.01f + 0.01f * u(rng));
+            groom.UVs.push_back(uv);
+        }
+    }
+
+    return groom;
+}
+
+template<typename T>
+void appendRange(std::vector<T>& dst, const fast_vector<T>& src)
+{
+    dst.insert(dst.end(), src.begin(), src.end());
+}
+
+template<typename T>
+bool equalRange(const std::vector<T>& a, const fast_vector<T>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin(), [](const T& x, const T& y) { return all(x == y); });
+}
+
+template<>
+bool equalRange(const std::vector<float>& a, const fast_vector<float>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template<>
+bool equalRange(const std::vector<uint32_t>& a, const fast_vector<uint32_t>& b)
+{
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+const uint32_t kSubdivPerSegment = 4;
+const uint32_t kPointCountPerCrossSection = 4;
+} // namespace
+
+CPU_TEST(CurveTessellation_SweptSphere)
+{
+    Groom groom = createGroom(1000, 2, 16, 1234);
+    const float4x4 xform = math::matrixFromScaling(float3(2.f));
+
+    for (uint32_t keepOneEveryXStrands : {1, 3})
+    {
+        for (uint32_t keepOneEveryXVerticesPerStrand : {1, 2})
+        {
+            auto result = CurveTessellation::convertToLinearSweptSphere(
+                (uint32_t)groom.vertexCountsPerStrand.size(),
+                groom.vertexCountsPerStrand.data(),
+                groom.controlPoints.data(),
+                groom.widths.data(),
+                groom.UVs.data(),
+                1,
+                kSubdivPerSegment,
+                keepOneEveryXStrands,
+                keepOneEveryXVerticesPerStrand,
+                1.f,
+                xform
+            );
+
+            // Tessellate each strand on its own and check that the results are laid out back to back.
+            std::vector<uint32_t> indices;
+            std::vector<float3> points;
+            std::vector<float> radius;
+            std::vector<float2> texCrds;
+            uint32_t pointOffset = 0;
+            for (size_t i = 0; i < groom.vertexCountsPerStrand.size(); ++i)
+            {
+                if (i % keepOneEveryXStrands == 0)
+                {
+                    auto strand = CurveTessellation::convertToLinearSweptSphere(
+                        1,
+                        &groom.vertexCountsPerStrand[i],
+                        &groom.controlPoints[pointOffset],
+                        &groom.widths[pointOffset],
+                        &groom.UVs[pointOffset],
+                        1,
+                        kSubdivPerSegment,
+                        1,
+                        keepOneEveryXVerticesPerStrand,
+                        1.f,
+                        xform
+                    );
+                    EXPECT_EQ(strand.indices.size() + 1, strand.points.size());
+                    for (uint32_t index : strand.indices)
+                        indices.push_back((uint32_t)points.size() + index);
+                    appendRange(points, strand.points);
+                    appendRange(radius, strand.radius);
+                    appendRange(texCrds, strand.texCrds);
+                }
+                pointOffset += groom.vertexCountsPerStrand[i];
+            }
+
+            EXPECT_EQ(result.degree, 1);
+            EXPECT(equalRange(indices, result.indices));
+            EXPECT(equalRange(points, result.points));
+            EXPECT(equalRange(radius, result.radius));
+            EXPECT(equalRange(texCrds, result.texCrds));
+        }
+    }
+}
+
+CPU_TEST(CurveTessellation_Polytube)
+{
+    Groom groom = createGroom(1000, 2, 16, 5678);
+
+    for (uint32_t keepOneEveryXStrands : {1, 3})
+    {
+        for (uint32_t keepOneEveryXVerticesPerStrand : {1, 2})
+        {
+            auto result = CurveTessellation::convertToPolytube(
+                (uint32_t)groom.vertexCountsPerStrand.size(),
+                groom.vertexCountsPerStrand.data(),
+                groom.controlPoints.data(),
+                groom.widths.data(),
+                groom.UVs.data(),
+                kSubdivPerSegment,
+                keepOneEveryXStrands,
+                keepOneEveryXVerticesPerStrand,
+                1.f,
+                kPointCountPerCrossSection
+            );
+
+            // Tessellate each strand on its own and check that the results are laid out back to back.
+            std::vector<float3> vertices;
+            std::vector<float3> normals;
+            std::vector<float4> tangents;
+            std::vector<float2> texCrds;
+            std::vector<float> radii;
+            std::vector<uint32_t> faceVertexCounts;
+            std::vector<uint32_t> faceVertexIndices;
+            uint32_t pointOffset = 0;
+            for (size_t i = 0; i < groom.vertexCountsPerStrand.size(); ++i)
+            {
+                if (i % keepOneEveryXStrands == 0)
+                {
+                    auto strand = CurveTessellation::convertToPolytube(
+                        1,
+                        &groom.vertexCountsPerStrand[i],
+                        &groom.controlPoints[pointOffset],
+                        &groom.widths[pointOffset],
+                        &groom.UVs[pointOffset],
+                        kSubdivPerSegment,
+                        1,
+                        keepOneEveryXVerticesPerStrand,
+                        1.f,
+                        kPointCountPerCrossSection
+                    );
+                    for (uint32_t index : strand.faceVertexIndices)
+                        faceVertexIndices.push_back((uint32_t)vertices.size() + index);
+                    appendRange(vertices, strand.vertices);
+                    appendRange(normals, strand.normals);
+                    appendRange(tangents, strand.tangents);
+                    appendRange(texCrds, strand.texCrds);
+                    appendRange(radii, strand.radii);
+                    appendRange(faceVertexCounts, strand.faceVertexCounts);
+                }
+                pointOffset += groom.vertexCountsPerStrand[i];
+            }
+
+            EXPECT(equalRange(vertices, result.vertices));
+            EXPECT(equalRange(normals, result.normals));
+            EXPECT(equalRange(tangents, result.tangents));
+            EXPECT(equalRange(texCrds, result.texCrds));
+            EXPECT(equalRange(radii, result.radii));
+            EXPECT(equalRange(faceVertexCounts, result.faceVertexCounts));
+            EXPECT(equalRange(faceVertexIndices, result.faceVertexIndices));
+        }
+    }
+}
+
+CPU_BENCHMARK(CurveTessellation_LinearSweptSphereBenchmark)
+{
+    // Synthetic groom with 1M strands of 4 to 6 control points each.
+    const uint32_t strandCount = 1000000;
+    const uint32_t subdivPerSegment = 2;
+    Groom groom = createGroom(strandCount, 4, 6, 42);
+
+    CurveTessellation::SweptSphereResult sweptSpheres;
+    ctx.setItemsPerIteration(strandCount);
+    ctx.run(
+        [&]()
+        {
+            sweptSpheres = CurveTessellation::convertToLinearSweptSphere(
+                strandCount,
+                groom.vertexCountsPerStrand.data(),
+                groom.controlPoints.data(),
+                groom.widths.data(),
+                groom.UVs.data(),
+                1,
+                subdivPerSegment,
+                1,
+                1,
+                1.f,
+                float4x4::identity()
+            );
+        }
+    );
+
+    EXPECT_EQ(sweptSpheres.indices.size() + strandCount, sweptSpheres.points.size());
+}
+
+CPU_BENCHMARK(CurveTessellation_PolytubeBenchmark)
+{
+    // Synthetic groom with 1M strands of 4 to 6 control points each.
+    // Polytubes are only generated for every 4th strand to keep memory usage reasonable.
+    const uint32_t strandCount = 1000000;
+    const uint32_t subdivPerSegment = 2;
+    const uint32_t polytubeKeepOneEveryXStrands = 4;
+    Groom groom = createGroom(strandCount, 4, 6, 42);
+
+    CurveTessellation::MeshResult polytubes;
+    ctx.setItemsPerIteration(strandCount / polytubeKeepOneEveryXStrands);
+    ctx.run(
+        [&]()
+        {
+            polytubes = CurveTessellation::convertToPolytube(
+                strandCount,
+                groom.vertexCountsPerStrand.data(),
+                groom.controlPoints.data(),
+                groom.widths.data(),
+                groom.UVs.data(),
+                subdivPerSegment,
+                polytubeKeepOneEveryXStrands,
+                1,
+                1.f,
+                kPointCountPerCrossSection
+            );
+        }
+    );
+
+    EXPECT_EQ(polytubes.faceVertexIndices.size(), 3 * polytubes.faceVertexCounts.size());
+}
+} // namespace Falcor
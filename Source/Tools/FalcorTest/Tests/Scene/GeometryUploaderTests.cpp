@@ -0,0 +1,69 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/GeometryUploader.h"
+#include <random>
+
+namespace Falcor
+{
+    GPU_TEST(GeometryUploader_Upload)
+    {
+        ref<Device> pDevice = ctx.getDevice();
+
+        // Use a tiny staging budget so the ring wraps around many times.
+        const size_t kStagingBudget = 4096;
+        const uint32_t kElementCount = 100000;
+
+        std::vector<uint32_t> data(kElementCount);
+        std::mt19937 rng;
+        for (auto& v : data) v = rng();
+
+        ref<Buffer> pBuffer = pDevice->createBuffer(kElementCount * sizeof(uint32_t), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal);
+
+        GeometryUploader uploader(pDevice, kStagingBudget, 4);
+        EXPECT_EQ(uploader.getStagingBufferSize(), kStagingBudget / 4);
+
+        // Upload the first part with a single call and the rest in odd-sized pieces.
+        const uint32_t kSplit = 1000;
+        uploader.upload(pBuffer.get(), 0, data.data(), kSplit * sizeof(uint32_t));
+        for (uint32_t offset = kSplit; offset < kElementCount; offset += 777)
+        {
+            uint32_t count = std::min(777u, kElementCount - offset);
+            uploader.upload(pBuffer.get(), offset * sizeof(uint32_t), data.data() + offset, count * sizeof(uint32_t));
+        }
+        uploader.finish();
+        EXPECT_EQ(uploader.getUploadedBytes(), kElementCount * sizeof(uint32_t));
+
+        std::vector<uint32_t> result = pBuffer->getElements<uint32_t>();
+        ASSERT_EQ(result.size(), data.size());
+        for (uint32_t i = 0; i < kElementCount; i++)
+        {
+            EXPECT_EQ(result[i], data[i]) << "i = " << i;
+        }
+    }
+}
@@ -27,11 +27,135 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Core/AssetResolver.h"
+#include "Core/Platform/OS.h"
+#include "Scene/AssetCache.h"
 #include "Scene/Material/MERLFile.h"
 #include "Scene/Material/MERLMaterialData.slang"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
+#include <fstream>
 
 namespace Falcor
 {
+namespace
+{
+const size_t kSampleCount = 90 * 90 * 360 / 2;
+
+/// Write a MERL file with constant RGB values.
+void writeMERLFile(const std::filesystem::path& path, float3 value)
+{
+    const int dims[3] = {90, 90, 180};
+    std::vector<double> data(3 * kSampleCount);
+    std::fill(data.begin(), data.begin() + kSampleCount, value.x);
+    std::fill(data.begin() + kSampleCount, data.begin() + 2 * kSampleCount, value.y);
+    std::fill(data.begin() + 2 * kSampleCount, data.end(), value.z);
+
+    std::ofstream ofs(path, std::ios::binary);
+    ofs.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+    ofs.write(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(double));
+}
+
+template<typename T>
+bool isEqual(const std::vector<T>& a, const std::vector<T>& b)
+{
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const T& x, const T& y) { return all(x == y); });
+}
+
+/// Load a set of MERL files in parallel.
+bool loadMERLFiles(const std::vector<std::filesystem::path>& paths, AssetCache* pCache)
+{
+    std::vector<MERLFile> files(paths.size());
+    std::vector<uint8_t> loaded(paths.size());
+    auto range = NumericRange<size_t>(0, paths.size());
+    std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) { loaded[i] = files[i].loadBRDF(paths[i], pCache); });
+    return std::all_of(loaded.begin(), loaded.end(), [](uint8_t v) { return v != 0; });
+}
+} // namespace
+
+CPU_TEST(MERLFile_Cache)
+{
+    std::filesystem::path directory = getTempFilePath();
+    std::filesystem::create_directories(directory);
+    const std::filesystem::path path = directory / "constant.binary";
+    writeMERLFile(path, float3(750.f, 600.f, 300.f));
+
+    AssetCache cache(directory / "cache");
+
+    MERLFile uncached;
+    ASSERT(uncached.loadBRDF(path, &cache));
+    EXPECT_EQ(cache.getStats().missCount, 1);
+    EXPECT_EQ(cache.getStats().writeCount, 1);
+
+    MERLFile cached;
+    ASSERT(cached.loadBRDF(path, &cache));
+    EXPECT_EQ(cache.getStats().hitCount, 1);
+
+    EXPECT_EQ(cached.getDesc().name, "constant");
+    EXPECT(cached.getDesc().path == path);
+    ASSERT_EQ(cached.getData().size(), kSampleCount);
+    EXPECT(isEqual(cached.getData(), uncached.getData()));
+    EXPECT_EQ(cached.getData()[0].x, 0.5f);
+
+    // Changing the file contents changes the cache key.
+    writeMERLFile(path, float3(1500.f));
+    ASSERT(cached.loadBRDF(path, &cache));
+    EXPECT_EQ(cache.getStats().missCount, 2);
+    EXPECT_EQ(cached.getData()[0].x, 1.f);
+
+    // Truncated files fail to load and are not cached.
+    std::filesystem::resize_file(path, 1000);
+    EXPECT(!cached.loadBRDF(path, &cache));
+    EXPECT_EQ(cache.getStats().writeCount, 2);
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_BENCHMARK(MERLFile_LoadBenchmark)
+{
+    std::filesystem::path directory = getTempFilePath();
+    std::filesystem::create_directories(directory);
+    std::vector<std::filesystem::path> paths;
+    for (size_t i = 0; i < 8; i++)
+    {
+        paths.push_back(directory / fmt::format("brdf{}.binary", i));
+        writeMERLFile(paths.back(), float3(100.f * (i + 1)));
+    }
+
+    bool result = false;
+    ctx.setItemsPerIteration(paths.size());
+    ctx.setBytesPerIteration(paths.size() * std::filesystem::file_size(paths[0]));
+    ctx.run([&]() { result = loadMERLFiles(paths, nullptr); });
+    EXPECT(result);
+
+    std::filesystem::remove_all(directory);
+}
+
+CPU_BENCHMARK(MERLFile_CachedLoadBenchmark)
+{
+    std::filesystem::path directory = getTempFilePath();
+    std::filesystem::create_directories(directory);
+    std::vector<std::filesystem::path> paths;
+    for (size_t i = 0; i < 8; i++)
+    {
+        paths.push_back(directory / fmt::format("brdf{}.binary", i));
+        writeMERLFile(paths.back(), float3(100.f * (i + 1)));
+    }
+
+    // Populate the cache before measuring.
+    AssetCache cache(directory / "cache");
+    ASSERT(loadMERLFiles(paths, &cache));
+
+    bool result = false;
+    ctx.setItemsPerIteration(paths.size());
+    ctx.setBytesPerIteration(paths.size() * std::filesystem::file_size(paths[0]));
+    ctx.run([&]() { result = loadMERLFiles(paths, &cache); });
+    EXPECT(result);
+    EXPECT_EQ(cache.getStats().writeCount, paths.size());
+
+    std::filesystem::remove_all(directory);
+}
+
 GPU_TEST(MERLFile)
 {
     // TODO: This is not ideal, we should only access files in the runtime directory.
@@ -57,4 +181,28 @@ GPU_TEST(MERLFile)
         EXPECT_EQ(v.z, expected.z);
     }
 }
+
+GPU_TEST(MERLFile_CachedAlbedoLUT)
+{
+    const std::filesystem::path path = getProjectDirectory() / "media/test_scenes/materials/data/gray-lambert.binary";
+    std::filesystem::path directory = getTempFilePath();
+    AssetCache cache(directory);
+
+    // The first load adds the albedo lookup table to the cache entry.
+    std::vector<float4> lut;
+    {
+        MERLFile merlFile;
+        ASSERT(merlFile.loadBRDF(path, &cache));
+        lut = merlFile.prepareAlbedoLUT(ctx.getDevice());
+    }
+    EXPECT_EQ(cache.getStats().writeCount, 2);
+
+    MERLFile merlFile;
+    ASSERT(merlFile.loadBRDF(path, &cache));
+    EXPECT_EQ(cache.getStats().hitCount, 1);
+    EXPECT(isEqual(merlFile.prepareAlbedoLUT(ctx.getDevice()), lut));
+    EXPECT_EQ(cache.getStats().writeCount, 2);
+
+    std::filesystem::remove_all(directory);
+}
 } // namespace Falcor
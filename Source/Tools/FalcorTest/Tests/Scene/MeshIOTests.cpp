@@ -0,0 +1,109 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+
+namespace Falcor
+{
+namespace
+{
+std::map<std::string, ref<Buffer>> createMeshBuffers(ref<Device> pDevice, uint32_t vertexCount, uint32_t triangleCount)
+{
+    return {
+        {"positions", pDevice->createStructuredBuffer(sizeof(float3), vertexCount)},
+        {"texcrds", pDevice->createStructuredBuffer(sizeof(float3), vertexCount)},
+        {"triangleIndices", pDevice->createStructuredBuffer(sizeof(uint3), triangleCount)},
+    };
+}
+} // namespace
+
+GPU_TEST(MeshIO_GetMeshBatch)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    SceneBuilder builder(pDevice, Settings());
+    auto pMaterial = StandardMaterial::create(pDevice, "Material");
+    std::vector<ref<TriangleMesh>> meshes = {
+        TriangleMesh::createQuad(),
+        TriangleMesh::createCube(),
+        TriangleMesh::createSphere(0.5f, 16, 8),
+    };
+    for (size_t i = 0; i < meshes.size(); i++)
+    {
+        float4x4 transform = math::matrixFromTranslation(float3(2.f * i, 0.f, 0.f));
+        NodeID nodeID = builder.addNode({fmt::format("Node{}", i), transform, float4x4::identity()});
+        builder.addMeshInstance(nodeID, builder.addTriangleMesh(meshes[i], pMaterial));
+    }
+    ref<Scene> pScene = builder.getScene();
+    ASSERT_GE(pScene->getMeshCount(), 2);
+
+    // Batch the meshes in reverse order to check that the packing follows the given order.
+    std::vector<MeshID> meshIDs;
+    uint32_t vertexCount = 0;
+    uint32_t triangleCount = 0;
+    for (uint32_t i = pScene->getMeshCount(); i-- > 0;)
+    {
+        meshIDs.push_back(MeshID(i));
+        vertexCount += pScene->getMesh(MeshID(i)).vertexCount;
+        triangleCount += pScene->getMesh(MeshID(i)).getTriangleCount();
+    }
+
+    auto batchBuffers = createMeshBuffers(pDevice, vertexCount, triangleCount);
+    pScene->getMeshBatchVerticesAndIndices(meshIDs, batchBuffers);
+    const auto batchPositions = batchBuffers["positions"]->getElements<float3>();
+    const auto batchTexCrds = batchBuffers["texcrds"]->getElements<float3>();
+    const auto batchIndices = batchBuffers["triangleIndices"]->getElements<uint3>();
+
+    // Compare against the data of the meshes read one by one.
+    uint32_t vertexOffset = 0;
+    uint32_t triangleOffset = 0;
+    for (MeshID meshID : meshIDs)
+    {
+        const auto& mesh = pScene->getMesh(meshID);
+        auto buffers = createMeshBuffers(pDevice, mesh.vertexCount, mesh.getTriangleCount());
+        pScene->getMeshVerticesAndIndices(meshID, buffers);
+        const auto positions = buffers["positions"]->getElements<float3>();
+        const auto texCrds = buffers["texcrds"]->getElements<float3>();
+        const auto indices = buffers["triangleIndices"]->getElements<uint3>();
+
+        for (uint32_t i = 0; i < mesh.vertexCount; i++)
+        {
+            EXPECT(all(batchPositions[vertexOffset + i] == positions[i])) << "mesh " << meshID.get() << " vertex " << i;
+            EXPECT(all(batchTexCrds[vertexOffset + i] == texCrds[i])) << "mesh " << meshID.get() << " vertex " << i;
+        }
+        for (uint32_t i = 0; i < mesh.getTriangleCount(); i++)
+        {
+            EXPECT(all(batchIndices[triangleOffset + i] == indices[i])) << "mesh " << meshID.get() << " triangle " << i;
+        }
+
+        vertexOffset += mesh.vertexCount;
+        triangleOffset += mesh.getTriangleCount();
+    }
+}
+} // namespace Falcor
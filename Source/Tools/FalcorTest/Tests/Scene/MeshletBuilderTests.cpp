@@ -0,0 +1,221 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/MeshletBuilder.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace Falcor
+{
+namespace
+{
+struct TestMesh
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+};
+
+/// Create a grid in the xz-plane with normals pointing in +y.
+TestMesh createGrid(uint32_t size)
+{
+    TestMesh mesh;
+    const uint32_t n = size + 1;
+    for (uint32_t z = 0; z < n; z++)
+        for (uint32_t x = 0; x < n; x++)
+            mesh.positions.push_back(float3(float(x), 0.f, float(z)));
+    for (uint32_t z = 0; z < size; z++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            uint32_t i = z * n + x;
+            mesh.indices.insert(mesh.indices.end(), {i, i + n, i + 1, i + 1, i + n, i + n + 1});
+        }
+    }
+    return mesh;
+}
+
+/// Create a unit sphere with outward facing normals.
+TestMesh createSphere(uint32_t segments)
+{
+    TestMesh mesh;
+    for (uint32_t j = 0; j <= segments; j++)
+    {
+        for (uint32_t i = 0; i <= segments; i++)
+        {
+            float phi = float(i) / segments * 2.f * (float)M_PI;
+            float theta = float(j) / segments * (float)M_PI;
+            mesh.positions.push_back(float3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+        }
+    }
+    for (uint32_t j = 0; j < segments; j++)
+    {
+        for (uint32_t i = 0; i < segments; i++)
+        {
+            uint32_t k = j * (segments + 1) + i;
+            mesh.indices.insert(mesh.indices.end(), {k, k + 1, k + segments + 1, k + 1, k + segments + 2, k + segments + 1});
+        }
+    }
+    return mesh;
+}
+
+float3 getNormal(const TestMesh& mesh, uint32_t i0, uint32_t i1, uint32_t i2)
+{
+    return cross(mesh.positions[i1] - mesh.positions[i0], mesh.positions[i2] - mesh.positions[i0]);
+}
+
+/// Check that the meshlets cover every triangle exactly once, respect the limits and have valid bounds.
+void validateMeshlets(CPUUnitTestContext& ctx, const TestMesh& mesh, const MeshletBuilder::Meshlets& result, const MeshletBuilder::Options& options)
+{
+    std::vector<std::array<uint32_t, 3>> expected;
+    for (size_t t = 0; t < mesh.indices.size(); t += 3)
+        expected.push_back({mesh.indices[t], mesh.indices[t + 1], mesh.indices[t + 2]});
+
+    std::vector<std::array<uint32_t, 3>> actual;
+    for (const auto& m : result.meshlets)
+    {
+        EXPECT_GE(m.vertexCount, 3);
+        EXPECT_LE(m.vertexCount, options.maxVertices);
+        EXPECT_GE(m.triangleCount, 1);
+        EXPECT_LE(m.triangleCount, options.maxTriangles);
+        ASSERT_LE(m.vertexOffset + m.vertexCount, result.vertices.size());
+        ASSERT_LE(m.triangleOffset + m.triangleCount, result.triangles.size());
+
+        for (uint32_t i = 0; i < m.vertexCount; i++)
+        {
+            const float3& p = mesh.positions[result.vertices[m.vertexOffset + i]];
+            EXPECT_LE(length(p - m.center), m.radius * 1.0001f + 1e-6f);
+        }
+
+        const float minConeDot = std::sqrt(std::max(0.f, 1.f - m.coneCutoff * m.coneCutoff));
+        for (uint32_t t = 0; t < m.triangleCount; t++)
+        {
+            uint3 local = MeshletBuilder::unpackTriangle(result.triangles[m.triangleOffset + t]);
+            ASSERT_LT(local.x, m.vertexCount);
+            ASSERT_LT(local.y, m.vertexCount);
+            ASSERT_LT(local.z, m.vertexCount);
+            std::array<uint32_t, 3> tri = {
+                result.vertices[m.vertexOffset + local.x],
+                result.vertices[m.vertexOffset + local.y],
+                result.vertices[m.vertexOffset + local.z],
+            };
+            actual.push_back(tri);
+
+            float3 n = getNormal(mesh, tri[0], tri[1], tri[2]);
+            if (m.coneCutoff < 1.f && length(n) > 0.f)
+                EXPECT_GE(dot(normalize(n), m.coneAxis), minConeDot - 1e-4f);
+        }
+    }
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    EXPECT(actual == expected);
+}
+} // namespace
+
+CPU_TEST(MeshletBuilder_Grid)
+{
+    TestMesh mesh = createGrid(100);
+    MeshletBuilder::Options options;
+    auto result = MeshletBuilder::build(mesh.indices, mesh.positions, options);
+    validateMeshlets(ctx, mesh, result, options);
+
+    // A connected grid should give well filled meshlets.
+    const size_t triangleCount = mesh.indices.size() / 3;
+    const size_t minMeshletCount = (triangleCount + options.maxTriangles - 1) / options.maxTriangles;
+    EXPECT_LE(result.meshlets.size(), minMeshletCount * 2);
+
+    // The grid is flat, so the normal cones are tight and the meshlets face +y.
+    for (const auto& m : result.meshlets)
+    {
+        EXPECT_GE(m.coneAxis.y, 0.9999f);
+        EXPECT_LE(m.coneCutoff, 1e-3f);
+        EXPECT(m.isBackFacing(m.center - float3(0.f, 100.f, 0.f)));
+        EXPECT(!m.isBackFacing(m.center + float3(0.f, 100.f, 0.f)));
+    }
+}
+
+CPU_TEST(MeshletBuilder_Limits)
+{
+    TestMesh mesh = createSphere(48);
+    for (auto limits : {uint2(3, 1), uint2(32, 16), uint2(64, 124), uint2(128, 256), uint2(256, 256)})
+    {
+        MeshletBuilder::Options options;
+        options.maxVertices = limits.x;
+        options.maxTriangles = limits.y;
+        auto result = MeshletBuilder::build(mesh.indices, mesh.positions, options);
+        validateMeshlets(ctx, mesh, result, options);
+    }
+
+    // Non-indexed triangle soup.
+    TestMesh soup;
+    for (uint32_t i : mesh.indices)
+    {
+        soup.indices.push_back((uint32_t)soup.positions.size());
+        soup.positions.push_back(mesh.positions[i]);
+    }
+    MeshletBuilder::Options options;
+    auto result = MeshletBuilder::build(soup.indices, soup.positions, options);
+    validateMeshlets(ctx, soup, result, options);
+    EXPECT_EQ(result.meshlets.size(), (soup.indices.size() / 3 + 20) / 21); // 64 vertices fit 21 separate triangles.
+
+    options.maxVertices = MeshletBuilder::kMaxVertexCount + 1;
+    EXPECT_THROW(MeshletBuilder::build(mesh.indices, mesh.positions, options));
+    options.maxVertices = 64;
+    options.maxTriangles = 0;
+    EXPECT_THROW(MeshletBuilder::build(mesh.indices, mesh.positions, options));
+}
+
+CPU_TEST(MeshletBuilder_ConeCulling)
+{
+    TestMesh mesh = createSphere(64);
+    auto result = MeshletBuilder::build(mesh.indices, mesh.positions, {});
+
+    // Culling must be conservative: all triangles of a culled meshlet are back-facing.
+    // From far away, roughly half of the sphere is back-facing, and a good part of those meshlets should be culled.
+    const float3 viewPos(0.f, 0.f, 20.f);
+    uint32_t culledCount = 0;
+    for (const auto& m : result.meshlets)
+    {
+        if (!m.isBackFacing(viewPos))
+            continue;
+        culledCount++;
+        for (uint32_t t = 0; t < m.triangleCount; t++)
+        {
+            uint3 local = MeshletBuilder::unpackTriangle(result.triangles[m.triangleOffset + t]);
+            uint32_t i0 = result.vertices[m.vertexOffset + local.x];
+            uint32_t i1 = result.vertices[m.vertexOffset + local.y];
+            uint32_t i2 = result.vertices[m.vertexOffset + local.z];
+            float3 n = getNormal(mesh, i0, i1, i2);
+            EXPECT_GE(dot(mesh.positions[i0] - viewPos, n), 0.f);
+        }
+    }
+    EXPECT_GT(culledCount, result.meshlets.size() / 4);
+    EXPECT_LT(culledCount, result.meshlets.size() / 2);
+}
+} // namespace Falcor
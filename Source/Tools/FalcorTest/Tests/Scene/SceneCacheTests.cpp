@@ -0,0 +1,103 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneCache.h"
+#include "Core/Platform/OS.h"
+#include <chrono>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+void writeFile(const std::filesystem::path& path, const std::string& content)
+{
+    std::ofstream fs(path, std::ios::binary | std::ios::trunc);
+    fs.write(content.data(), content.size());
+}
+} // namespace
+
+CPU_TEST(SceneCache_FileHash)
+{
+    std::filesystem::path path = getTempFilePath();
+
+    writeFile(path, "");
+    auto emptyHash = SceneCache::computeFileHash(path);
+    EXPECT(emptyHash.has_value());
+
+    // Files differing in a single byte have different hashes.
+    writeFile(path, "0123456789abcdefXYZ");
+    auto hashA = SceneCache::computeFileHash(path);
+    writeFile(path, "0123456789abcdefXYW");
+    auto hashB = SceneCache::computeFileHash(path);
+    writeFile(path, "0123456789abcdefXYZ");
+    auto hashC = SceneCache::computeFileHash(path);
+    EXPECT(hashA.has_value() && hashB.has_value() && hashC.has_value());
+    EXPECT(*hashA != *hashB);
+    EXPECT(*hashA == *hashC);
+    EXPECT(*hashA != *emptyHash);
+
+    // The hash is SHA-1 over the file size and content.
+    const std::string content = "0123456789abcdefXYZ";
+    SHA1 sha1;
+    sha1.update(uint64_t(content.size()));
+    sha1.update(content.data(), content.size());
+    EXPECT(*hashA == sha1.finalize());
+
+    std::filesystem::remove(path);
+    EXPECT(!SceneCache::computeFileHash(path).has_value());
+}
+
+CPU_TEST(SceneCache_Dependency)
+{
+    std::filesystem::path path = getTempFilePath();
+    writeFile(path, "scene file content");
+
+    auto dependency = SceneCache::createDependency(path);
+    EXPECT(dependency.has_value());
+    EXPECT_EQ(dependency->size, uint64_t(18));
+    EXPECT(SceneCache::isDependencyValid(*dependency));
+
+    // Touching the file without changing its content keeps the dependency valid.
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::hours(1));
+    EXPECT(SceneCache::isDependencyValid(*dependency));
+
+    // Changing the content with the same size invalidates the dependency.
+    writeFile(path, "scene file CONTENT");
+    EXPECT(!SceneCache::isDependencyValid(*dependency));
+
+    // Changing the size invalidates the dependency.
+    writeFile(path, "scene file content, edited");
+    EXPECT(!SceneCache::isDependencyValid(*dependency));
+
+    // Missing files are invalid.
+    std::filesystem::remove(path);
+    EXPECT(!SceneCache::isDependencyValid(*dependency));
+    EXPECT(!SceneCache::createDependency(path).has_value());
+}
+} // namespace Falcor
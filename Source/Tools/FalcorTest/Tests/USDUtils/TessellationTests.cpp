@@ -0,0 +1,162 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "USDUtils/Tessellator/Tessellation.h"
+
+BEGIN_DISABLE_USD_WARNINGS
+#include <pxr/usd/usd/stage.h>
+END_DISABLE_USD_WARNINGS
+
+#include <cmath>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Create a quad-dominant torus control cage with per-vertex UVs. A few quads are merged into pentagons to produce
+/// extraordinary vertices, as found on typical character meshes.
+UsdMeshData createTorus(uint32_t ringCount, uint32_t sideCount)
+{
+    const float kPi = 3.14159265358979f;
+    UsdMeshData mesh;
+    mesh.topology.scheme = UsdGeomTokens->catmullClark;
+    mesh.topology.orient = UsdGeomTokens->rightHanded;
+    mesh.uvInterp = UsdGeomTokens->vertex;
+
+    for (uint32_t i = 0; i < ringCount; ++i)
+    {
+        for (uint32_t j = 0; j < sideCount; ++j)
+        {
+            float u = 2.f * kPi * i / ringCount;
+            float v = 2.f * kPi * j / sideCount;
+            float r = 1.f + 0.3f * std::cos(v);
+            mesh.points.push_back(GfVec3f(r * std::cos(u), r * std::sin(u), 0.3f * std::sin(v)));
+            mesh.uvs.push_back(GfVec2f(float(i) / ringCount, float(j) / sideCount));
+        }
+    }
+
+    auto index = [&](uint32_t i, uint32_t j) { return int((i % ringCount) * sideCount + (j % sideCount)); };
+    for (uint32_t i = 0; i < ringCount; ++i)
+    {
+        for (uint32_t j = 0; j < sideCount; ++j)
+        {
+            if (i % 8 == 0 && j % 8 == 0)
+            {
+                // Split quads (i, j) and (i, j + 1) into a pentagon and a triangle.
+                mesh.topology.faceCounts.push_back(5);
+                for (int idx : {index(i, j), index(i + 1, j), index(i + 1, j + 1), index(i, j + 2), index(i, j + 1)})
+                    mesh.topology.faceIndices.push_back(idx);
+                mesh.topology.faceCounts.push_back(3);
+                for (int idx : {index(i + 1, j + 1), index(i + 1, j + 2), index(i, j + 2)})
+                    mesh.topology.faceIndices.push_back(idx);
+                ++j;
+                continue;
+            }
+            mesh.topology.faceCounts.push_back(4);
+            for (int idx : {index(i, j), index(i + 1, j), index(i + 1, j + 1), index(i, j + 1)})
+                mesh.topology.faceIndices.push_back(idx);
+        }
+    }
+
+    return mesh;
+}
+
+UsdGeomMesh createGeomMesh(const UsdStageRefPtr& stage)
+{
+    return UsdGeomMesh::Define(stage, SdfPath("/Mesh"));
+}
+} // namespace
+
+CPU_TEST(USDTessellation_CatmullClark)
+{
+    UsdStageRefPtr stage = UsdStage::CreateInMemory();
+    UsdGeomMesh geomMesh = createGeomMesh(stage);
+    UsdMeshData baseMesh = createTorus(32, 16);
+
+    const uint32_t refinementLevel = 2;
+    VtIntArray coarseFaceIndices;
+    UsdMeshData result = tessellate(geomMesh, baseMesh, refinementLevel, coarseFaceIndices);
+
+    ASSERT_GT(result.points.size(), 0u);
+    EXPECT_EQ(result.topology.faceIndices.size(), 3 * coarseFaceIndices.size());
+    EXPECT_EQ(result.topology.faceCounts.size(), coarseFaceIndices.size());
+    EXPECT_EQ(result.normals.size(), result.points.size());
+    EXPECT_EQ(result.uvs.size(), result.points.size());
+    EXPECT(result.uvInterp == UsdGeomTokens->vertex);
+
+    // Every coarse face is tessellated, and facets are emitted in coarse face order.
+    const uint32_t rate = refinementLevel + 1;
+    std::vector<uint32_t> facetCounts(baseMesh.topology.getNumFaces(), 0);
+    for (size_t i = 0; i < coarseFaceIndices.size(); ++i)
+    {
+        if (i > 0)
+            EXPECT_LE(coarseFaceIndices[i - 1], coarseFaceIndices[i]);
+        facetCounts[coarseFaceIndices[i]]++;
+    }
+    for (uint32_t f = 0; f < facetCounts.size(); ++f)
+    {
+        if (baseMesh.topology.faceCounts[f] == 4)
+            EXPECT_EQ(facetCounts[f], 2 * rate * rate) << "face " << f;
+        else
+            EXPECT_GT(facetCounts[f], 0) << "face " << f;
+    }
+
+    for (int idx : result.topology.faceIndices)
+    {
+        EXPECT_GE(idx, 0);
+        EXPECT_LT(idx, int(result.points.size()));
+    }
+
+    // The result must not depend on how faces were scheduled over threads.
+    VtIntArray coarseFaceIndices2;
+    UsdMeshData result2 = tessellate(geomMesh, baseMesh, refinementLevel, coarseFaceIndices2);
+    EXPECT(result2.topology.faceIndices == result.topology.faceIndices);
+    EXPECT(result2.points == result.points);
+    EXPECT(result2.normals == result.normals);
+    EXPECT(result2.uvs == result.uvs);
+    EXPECT(coarseFaceIndices2 == coarseFaceIndices);
+}
+
+CPU_BENCHMARK(USDTessellation_Benchmark)
+{
+    // Control cage of roughly 50k faces, comparable to a production character mesh, refined two levels.
+    UsdStageRefPtr stage = UsdStage::CreateInMemory();
+    UsdGeomMesh geomMesh = createGeomMesh(stage);
+    UsdMeshData baseMesh = createTorus(256, 192);
+
+    const uint32_t refinementLevel = 2;
+    VtIntArray coarseFaceIndices;
+    UsdMeshData result;
+
+    ctx.setItemsPerIteration(baseMesh.topology.getNumFaces());
+    ctx.run([&]() { result = tessellate(geomMesh, baseMesh, refinementLevel, coarseFaceIndices); });
+
+    EXPECT_EQ(result.topology.faceIndices.size(), 3 * coarseFaceIndices.size());
+}
+} // namespace Falcor
@@ -313,4 +313,166 @@ GPU_TEST(BufferAllocatorStructAlign)
     }
 }
 
+CPU_TEST(BufferAllocatorDirtyRanges)
+{
+    using Range = BufferAllocator::Range;
+
+    BufferAllocator buf(0, 0, 0);
+    buf.allocate(65536);
+    EXPECT_EQ(buf.getUploadOverhead(), BufferAllocator::kDefaultUploadOverhead);
+    EXPECT(buf.getDirtyRanges().empty());
+
+    // Edits at opposite ends of the buffer are tracked separately.
+    buf.set<uint32_t>(0, 1);
+    buf.set<uint32_t>(60000, 2);
+    EXPECT(buf.getDirtyRanges() == std::vector<Range>({{0, 4}, {60000, 60004}}));
+
+    // Edits closer than the upload overhead are coalesced.
+    buf.set<uint32_t>(100, 3);
+    buf.set<uint32_t>(59000, 4);
+    EXPECT(buf.getDirtyRanges() == std::vector<Range>({{0, 104}, {59000, 60004}}));
+
+    // Without upload overhead, only touching ranges are coalesced.
+    buf.setUploadOverhead(0);
+    buf.modified(104, 4);
+    buf.modified(200, 4);
+    EXPECT(buf.getDirtyRanges() == std::vector<Range>({{0, 108}, {200, 204}, {59000, 60004}}));
+
+    // Raising the upload overhead coalesces the existing ranges.
+    buf.setUploadOverhead(65536);
+    EXPECT(buf.getDirtyRanges() == std::vector<Range>({{0, 60004}}));
+
+    buf.clear();
+    EXPECT(buf.getDirtyRanges().empty());
+}
+
+CPU_TEST(BufferAllocatorFreeList)
+{
+    // Raw buffer with alignment and cacheline alignment.
+    BufferAllocator buf(16, 0, 128);
+
+    size_t a = buf.allocate(20);
+    size_t b = buf.allocate(100);
+    size_t c = buf.allocate(4);
+    EXPECT_EQ(a, 0);
+    EXPECT_EQ(b, 128);
+    EXPECT_EQ(c, 240);
+    EXPECT_EQ(buf.getSize(), 244);
+
+    buf.set<uint32_t>(b, 0xdeadbeef);
+    buf.deallocate(b, 100);
+    EXPECT_EQ(buf.getFreeSize(), 100);
+    EXPECT_THROW(buf.deallocate(b, 4));
+    EXPECT_THROW(buf.deallocate(buf.getSize(), 4));
+
+    // Reuse the freed block. The memory is cleared and needs to be uploaded.
+    buf.setUploadOverhead(0);
+    size_t d = buf.allocate(40);
+    EXPECT_EQ(d, 128);
+    EXPECT_EQ(*(const uint32_t*)(buf.getStartPointer() + d), 0);
+    EXPECT(buf.getDirtyRanges().back() == BufferAllocator::Range(128, 168));
+    EXPECT_EQ(buf.getFreeSize(), 60);
+
+    // The remainder of the block is too small after alignment, so the buffer is grown.
+    size_t e = buf.allocate(60);
+    EXPECT_EQ(e, 256);
+    EXPECT_EQ(buf.getSize(), 316);
+
+    // The remainder of the block fits an aligned allocation.
+    size_t f = buf.allocate(48);
+    EXPECT_EQ(f, 176);
+    EXPECT_EQ(buf.getFreeSize(), 12);
+
+    // Freeing the last allocation shrinks the buffer.
+    buf.deallocate(e, 60);
+    EXPECT_EQ(buf.getSize(), 256);
+    EXPECT_EQ(buf.getFreeSize(), 12);
+
+    // Freeing adjacent allocations merges the free blocks.
+    buf.deallocate(d, 40);
+    buf.deallocate(f, 48);
+    EXPECT_EQ(buf.getFreeSize(), 100);
+    EXPECT_EQ(buf.allocate(100), 128);
+    EXPECT_EQ(buf.getFreeSize(), 0);
+
+    buf.clear();
+    EXPECT_EQ(buf.getSize(), 0);
+    EXPECT_EQ(buf.getFreeSize(), 0);
+}
+
+CPU_TEST(BufferAllocatorFreeListCacheLine)
+{
+    BufferAllocator buf(16, 0, 128);
+
+    buf.allocate(96);
+    size_t a = buf.allocate(200);
+    buf.allocate(4);
+    EXPECT_EQ(a, 96);
+    buf.deallocate(a, 200);
+
+    // An allocation that fits in a cache line is not placed across a cache line boundary in the freed block.
+    size_t b = buf.allocate(64);
+    EXPECT_EQ(b, 128);
+    EXPECT_EQ(buf.getFreeSize(), 136);
+
+    // The padding in front of it is reused by smaller allocations.
+    size_t c = buf.allocate(32);
+    EXPECT_EQ(c, 96);
+    EXPECT_EQ(buf.getFreeSize(), 104);
+}
+
+GPU_TEST(BufferAllocatorDirtyUpload)
+{
+    BufferAllocator buf(0, 0, 0);
+    buf.allocate<uint32_t>(16384);
+    buf.getGPUBuffer(ctx.getDevice());
+    EXPECT(buf.getDirtyRanges().empty());
+
+    buf.set<uint32_t>(0, 11);
+    buf.set<uint32_t>(65532, 22);
+    EXPECT_EQ(buf.getDirtyRanges().size(), 2);
+
+    ref<Buffer> pBuffer = buf.getGPUBuffer(ctx.getDevice());
+    EXPECT(buf.getDirtyRanges().empty());
+
+    std::vector<uint32_t> data = pBuffer->getElements<uint32_t>(0, 16384);
+    EXPECT_EQ(data[0], 11);
+    EXPECT_EQ(data[16383], 22);
+    for (size_t i = 1; i < 16383; i++)
+    {
+        EXPECT_EQ(data[i], 0) << "i=" << i;
+    }
+}
+
+GPU_TEST(BufferAllocatorShrinkAndGrow)
+{
+    BufferAllocator buf(0, 0, 0);
+    size_t offsetA = buf.allocate<uint32_t>(1024);
+    size_t offsetB = buf.allocate<uint32_t>(1024);
+    std::vector<uint32_t> values(1024, 0xdeadbeef);
+    buf.setBlob(values.data(), offsetB, values.size() * sizeof(uint32_t));
+    ref<Buffer> pBuffer = buf.getGPUBuffer(ctx.getDevice());
+
+    // Freeing the tail shrinks the CPU buffer, but the GPU buffer keeps its size and contents.
+    buf.deallocate(offsetB, 1024 * sizeof(uint32_t));
+    EXPECT_EQ(buf.getSize(), 4096);
+
+    // Memory allocated again within the GPU buffer must be uploaded cleared, and written data must be uploaded.
+    size_t offsetC = buf.allocate<uint32_t>(1024);
+    EXPECT_EQ(offsetC, offsetB);
+    buf.set<uint32_t>(offsetC, 33);
+    EXPECT(!buf.getDirtyRanges().empty());
+
+    ref<Buffer> pNewBuffer = buf.getGPUBuffer(ctx.getDevice());
+    EXPECT(pNewBuffer == pBuffer);
+    EXPECT(buf.getDirtyRanges().empty());
+
+    std::vector<uint32_t> data = pNewBuffer->getElements<uint32_t>(offsetA / sizeof(uint32_t), 2048);
+    EXPECT_EQ(data[1024], 33);
+    for (size_t i = 1025; i < 2048; i++)
+    {
+        EXPECT_EQ(data[i], 0) << "i=" << i;
+    }
+}
+
 } // namespace Falcor
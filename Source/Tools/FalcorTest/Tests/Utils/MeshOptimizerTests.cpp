@@ -0,0 +1,189 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Geometry/MeshOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+struct TestMesh
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+};
+
+/// Create a regular grid mesh with shuffled triangle and vertex order.
+TestMesh createScrambledGrid(uint32_t size, uint32_t seed)
+{
+    TestMesh mesh;
+    const uint32_t n = size + 1;
+    for (uint32_t y = 0; y < n; y++)
+        for (uint32_t x = 0; x < n; x++)
+            mesh.positions.push_back(float3(float(x), float(y), 0.f));
+
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            uint32_t i = y * n + x;
+            triangles.push_back({i, i + 1, i + n});
+            triangles.push_back({i + 1, i + n + 1, i + n});
+        }
+    }
+
+    std::mt19937 rng(seed);
+    std::shuffle(triangles.begin(), triangles.end(), rng);
+
+    std::vector<uint32_t> remap(mesh.positions.size());
+    for (uint32_t i = 0; i < remap.size(); i++)
+        remap[i] = i;
+    std::shuffle(remap.begin(), remap.end(), rng);
+    remapVertices(mesh.positions, remap);
+
+    for (const auto& t : triangles)
+        for (uint32_t i : t)
+            mesh.indices.push_back(remap[i]);
+
+    return mesh;
+}
+
+/// Return the set of triangles as sorted position triples, independent of triangle and vertex order and winding rotation.
+std::vector<std::array<float, 9>> getTriangleSet(const TestMesh& mesh)
+{
+    std::vector<std::array<float, 9>> result;
+    for (size_t t = 0; t < mesh.indices.size(); t += 3)
+    {
+        // Rotate so the smallest vertex index comes first to keep the winding.
+        uint32_t rot = 0;
+        for (uint32_t k = 1; k < 3; k++)
+        {
+            const float3& a = mesh.positions[mesh.indices[t + k]];
+            const float3& b = mesh.positions[mesh.indices[t + rot]];
+            if (a.x < b.x || (a.x == b.x && a.y < b.y))
+                rot = k;
+        }
+        std::array<float, 9> tri;
+        for (uint32_t k = 0; k < 3; k++)
+        {
+            const float3& p = mesh.positions[mesh.indices[t + (rot + k) % 3]];
+            tri[k * 3 + 0] = p.x;
+            tri[k * 3 + 1] = p.y;
+            tri[k * 3 + 2] = p.z;
+        }
+        result.push_back(tri);
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+} // namespace
+
+CPU_TEST(MeshOptimizer_AnalyzeVertexCache)
+{
+    // Two triangles sharing an edge: 4 unique vertices, all misses.
+    std::vector<uint32_t> indices = {0, 1, 2, 2, 1, 3};
+    VertexCacheStats stats = analyzeVertexCache(indices, 4);
+    EXPECT_EQ(stats.triangleCount, 2);
+    EXPECT_EQ(stats.vertexCount, 4);
+    EXPECT_EQ(stats.transformedVertexCount, 4);
+    EXPECT_EQ(stats.acmr, 2.f);
+    EXPECT_EQ(stats.atvr, 1.f);
+
+    // With a cache of 3 entries, vertex 0 is evicted before it is used again.
+    indices = {0, 1, 2, 1, 2, 3, 0, 2, 3};
+    stats = analyzeVertexCache(indices, 4, 3);
+    EXPECT_EQ(stats.transformedVertexCount, 5);
+    stats = analyzeVertexCache(indices, 4, 4);
+    EXPECT_EQ(stats.transformedVertexCount, 4);
+}
+
+CPU_TEST(MeshOptimizer_VertexCache)
+{
+    TestMesh mesh = createScrambledGrid(64, 1);
+    const auto reference = getTriangleSet(mesh);
+    const uint32_t vertexCount = (uint32_t)mesh.positions.size();
+
+    VertexCacheStats before = analyzeVertexCache(mesh.indices, vertexCount);
+
+    sortTrianglesSpatially(mesh.indices, mesh.positions);
+    VertexCacheStats sorted = analyzeVertexCache(mesh.indices, vertexCount);
+    EXPECT_LT(sorted.acmr, before.acmr);
+    EXPECT(getTriangleSet(mesh) == reference);
+
+    optimizeVertexCache(mesh.indices, mesh.positions);
+    VertexCacheStats optimized = analyzeVertexCache(mesh.indices, vertexCount);
+    EXPECT_LT(optimized.acmr, sorted.acmr);
+    // A regular grid has 2 triangles per vertex, so the ideal ACMR is 0.5.
+    EXPECT_LT(optimized.acmr, 0.8f);
+    EXPECT_LT(optimized.atvr, 1.6f);
+    EXPECT(getTriangleSet(mesh) == reference);
+}
+
+CPU_TEST(MeshOptimizer_VertexFetch)
+{
+    TestMesh mesh = createScrambledGrid(32, 2);
+    const auto reference = getTriangleSet(mesh);
+    const uint32_t vertexCount = (uint32_t)mesh.positions.size();
+
+    optimizeVertexCache(mesh.indices, mesh.positions);
+    std::vector<uint32_t> indices = mesh.indices;
+    auto remap = optimizeVertexFetch(mesh.indices, vertexCount);
+    remapVertices(mesh.positions, remap);
+
+    ASSERT_EQ(remap.size(), vertexCount);
+    for (size_t i = 0; i < indices.size(); i++)
+        EXPECT_EQ(mesh.indices[i], remap[indices[i]]);
+
+    // Vertices are numbered in order of first use.
+    uint32_t next = 0;
+    for (uint32_t i : mesh.indices)
+    {
+        EXPECT_LE(i, next);
+        if (i == next)
+            next++;
+    }
+    EXPECT_EQ(next, vertexCount);
+    EXPECT(getTriangleSet(mesh) == reference);
+
+    // Unreferenced vertices are placed last.
+    std::vector<uint32_t> partial = {3, 1, 2};
+    remap = optimizeVertexFetch(partial, 5);
+    EXPECT(partial == std::vector<uint32_t>({0, 1, 2}));
+    EXPECT_EQ(remap[3], 0);
+    EXPECT_EQ(remap[1], 1);
+    EXPECT_EQ(remap[2], 2);
+    EXPECT_GE(remap[0], 3);
+    EXPECT_GE(remap[4], 3);
+}
+} // namespace Falcor
@@ -33,6 +33,8 @@
 #include <pybind11/stl.h>
 #include <pybind11/pytypes.h>
 
+#include <regex>
+
 #if FALCOR_WINDOWS
 #define C_DRIVE "c:"
 #else
@@ -321,6 +323,90 @@ CPU_TEST(Settings_AttributeAssign)
     EXPECT_EQ(shapes[3].multiplyEmission, 3);
 }
 
+CPU_TEST(Settings_AttributeFilterPatterns)
+{
+    // Filters covering the exact, prefix and general regex matching paths.
+    const std::vector<std::string> expressions = {
+        "/World/Tiger", "/World/Tiger.*", ".*", "", "lights/.*", "/W(or)+ld/.*", "[a-z]+", "/World/Tiger_.*/back",
+    };
+    const std::vector<std::string> shapeNames = {
+        "/World/Tiger", "/World/Tiger/Body", "/World/Tiger_Fur/back", "/World/Ground", "lights/dome",
+        "lights/", "abc", "", "/World/Tiger\n",
+    };
+
+    for (size_t i = 0; i < expressions.size(); ++i)
+    {
+        for (bool negate : {false, true})
+        {
+            pybind11::dict pyDict;
+            pyDict["importer"] = pybind11::dict();
+            pyDict["importer"]["value"] = 1;
+            pyDict["importer"]["value.filter"] = makeList(expressions[i], negate);
+
+            Settings settings;
+            settings.addFilteredAttributes(pyDict);
+
+            std::regex regex(expressions[i]);
+            for (const std::string& shapeName : shapeNames)
+            {
+                bool expected = std::regex_match(shapeName, regex) != negate;
+                EXPECT_EQ(settings.getAttribute(shapeName, "importer:value", 0), expected ? 1 : 0)
+                    << "expression '" << expressions[i] << "' shape '" << shapeName << "' negate " << negate;
+            }
+        }
+    }
+}
+
+CPU_BENCHMARK(Settings_AttributeBenchmark)
+{
+    pybind11::dict pyDict;
+    pyDict["usdImporter"] = pybind11::dict();
+    pyDict["usdImporter"]["enableMotion"] = false;
+    pyDict["usdImporter"]["enableMotion.filter"] = makeList("/World/Tiger/.*", true);
+    pyDict["usdImporter"]["refinementLevel"] = 2;
+    pyDict["usdImporter"]["refinementLevel.filter"] = "/World/Tiger/Body";
+    pyDict["usdImporter"]["curves"] = pybind11::dict();
+    pyDict["usdImporter"]["curves"]["tessellationMode"] = 1;
+    pyDict["usdImporter"]["curves"]["tessellationMode.filter"] = ".*_Fur[0-9]+";
+
+    Settings settings;
+    settings.addFilteredAttributes(pyDict);
+
+    const uint32_t kShapeCount = 1024;
+    std::vector<std::string> shapeNames(kShapeCount);
+    for (uint32_t i = 0; i < kShapeCount; ++i)
+        shapeNames[i] = fmt::format("/World/{}/Mesh_Fur{}", (i % 4 == 0) ? "Tiger" : "Props", i);
+
+    // Each iteration cycles through the shapes and attributes.
+    const uint32_t kQueryCount = 1000000;
+    uint32_t count = 0;
+
+    ctx.setItemsPerIteration(kQueryCount);
+    ctx.run(
+        [&]()
+        {
+            for (uint32_t i = 0; i < kQueryCount; ++i)
+            {
+                const std::string& shapeName = shapeNames[i % kShapeCount];
+                switch (i % 3)
+                {
+                case 0:
+                    count += settings.getAttribute(shapeName, "usdImporter:enableMotion", true) ? 1 : 0;
+                    break;
+                case 1:
+                    count += settings.getAttribute(shapeName, "usdImporter:refinementLevel", 0);
+                    break;
+                case 2:
+                    count += settings.getAttribute(shapeName, "usdImporter:curves:tessellationMode", 0);
+                    break;
+                }
+            }
+        }
+    );
+
+    EXPECT_GT(count, 0u);
+}
+
 CPU_TEST(Settings_UpdatePathsColon)
 {
     Settings settings;
@@ -34,6 +34,7 @@
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/FalcorMath.h"
+#include "Scene/AssimpIOSystem.h"
 #include "Scene/Importer.h"
 #include "Scene/SceneBuilder.h"
 #include "Scene/Material/Material.h"
@@ -1123,6 +1124,9 @@ void importInternal(const void* buffer, size_t byteSize, const std::filesystem::
         removeFlags |= aiComponent_TANGENTS_AND_BITANGENTS;
 
     Assimp::Importer importer;
+    // Register all files read by Assimp, including side files such as .mtl and .bin, as scene dependencies.
+    // The importer takes ownership of the file system.
+    importer.SetIOHandler(new AssimpIOSystem([&builder](const std::filesystem::path& filePath) { builder.addDependency(filePath); }));
     importer.SetPropertyInteger(AI_CONFIG_PP_RVC_FLAGS, removeFlags);
 
     const aiScene* pScene = nullptr;
@@ -33,129 +33,257 @@
 
 #include "LoopSubdivide.h"
 #include "Core/Error.h"
+#include "Utils/NumericRange.h"
 
 #include <algorithm>
-#include <map>
+#include <atomic>
+#include <exception>
+#include <execution>
+#include <limits>
 #include <memory>
-#include <memory_resource>
-#include <set>
+#include <mutex>
+#include <numeric>
+#include <unordered_map>
 
 #include <cmath>
 
 namespace Falcor::pbrt
 {
 
-struct SDFace;
-struct SDVertex;
+namespace
+{
+constexpr uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+constexpr uint64_t kEmptyEdgeKey = std::numeric_limits<uint64_t>::max();
 
-#define NEXT(i) (((i) + 1) % 3)
-#define PREV(i) (((i) + 2) % 3)
+inline uint32_t next(uint32_t i)
+{
+    return (i + 1) % 3;
+}
 
-struct SDVertex
+inline uint32_t prev(uint32_t i)
 {
-    SDVertex(const float3& p = float3(0.f)) : p(p) {}
+    return (i + 2) % 3;
+}
 
-    int valence();
-    void oneRing(float3* p);
+/// Key identifying an undirected edge by its two vertex indices.
+inline uint64_t edgeKey(uint32_t v0, uint32_t v1)
+{
+    return (uint64_t(std::min(v0, v1)) << 32) | uint64_t(std::max(v0, v1));
+}
 
-    float3 p;
-    SDFace* startFace = nullptr;
-    SDVertex* child = nullptr;
-    bool regular = false;
-    bool boundary = false;
-};
+/// 64-bit finalizer from MurmurHash3.
+inline uint64_t hashEdgeKey(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ull;
+    key ^= key >> 33;
+    return key;
+}
 
-struct SDFace
+/**
+ * Run func(i) for all i in [0, count) in parallel.
+ * The first exception thrown by any invocation is rethrown on the calling thread.
+ */
+template<typename Func>
+void parallelFor(uint32_t count, Func func)
 {
-    SDFace()
-    {
-        for (uint32_t i = 0; i < 3; ++i)
-        {
-            v[i] = nullptr;
-            f[i] = nullptr;
-        }
-        for (uint32_t i = 0; i < 4; ++i)
+    std::exception_ptr exception;
+    std::mutex mutex;
+    NumericRange<uint32_t> range(0, count);
+    std::for_each(
+        std::execution::par,
+        range.begin(),
+        range.end(),
+        [&](uint32_t i)
         {
-            children[i] = nullptr;
+            try
+            {
+                func(i);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!exception)
+                    exception = std::current_exception();
+            }
         }
+    );
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+/**
+ * Flat, index-based version of pbrt's subdivision mesh.
+ * Faces are stored as half-edges, where half-edge h = 3 * face + k starts at vertex k of the face.
+ * For each half-edge we store its start vertex and the face on the other side of the edge
+ * (this corresponds to SDFace::v[k] and SDFace::f[k] in pbrt).
+ * The children of face f on the next subdivision level are faces 4 * f + k, and the child of
+ * vertex v is vertex v (i.e. even vertices keep their index and odd vertices are appended).
+ */
+struct SDMesh
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> startFaces;
+    std::vector<uint8_t> boundary;
+    std::vector<uint8_t> regular;
+
+    std::vector<uint32_t> faceVertices;
+    std::vector<uint32_t> faceNeighbors;
+
+    uint32_t getVertexCount() const { return (uint32_t)positions.size(); }
+    uint32_t getFaceCount() const { return (uint32_t)(faceVertices.size() / 3); }
+
+    void resizeVertices(size_t count)
+    {
+        positions.resize(count);
+        startFaces.resize(count);
+        boundary.resize(count);
+        regular.resize(count);
+    }
+
+    void resizeFaces(size_t count)
+    {
+        faceVertices.resize(3 * count);
+        faceNeighbors.resize(3 * count);
     }
 
-    uint32_t vnum(SDVertex* vert) const
+    uint32_t vnum(uint32_t face, uint32_t vert) const
     {
-        for (int i = 0; i < 3; ++i)
+        for (uint32_t i = 0; i < 3; ++i)
         {
-            if (v[i] == vert)
+            if (faceVertices[3 * face + i] == vert)
                 return i;
         }
-        FALCOR_THROW("Basic logic error in SDFace::vnum().");
+        FALCOR_THROW("Basic logic error in SDMesh::vnum().");
     }
 
-    SDFace* nextFace(SDVertex* vert) const { return f[vnum(vert)]; }
-    SDFace* prevFace(SDVertex* vert) const { return f[PREV(vnum(vert))]; }
-    SDVertex* nextVert(SDVertex* vert) const { return v[NEXT(vnum(vert))]; }
-    SDVertex* prevVert(SDVertex* vert) const { return v[PREV(vnum(vert))]; }
-    SDVertex* otherVert(SDVertex* v0, SDVertex* v1)
+    uint32_t nextFace(uint32_t face, uint32_t vert) const { return faceNeighbors[3 * face + vnum(face, vert)]; }
+    uint32_t prevFace(uint32_t face, uint32_t vert) const { return faceNeighbors[3 * face + prev(vnum(face, vert))]; }
+    uint32_t nextVert(uint32_t face, uint32_t vert) const { return faceVertices[3 * face + next(vnum(face, vert))]; }
+    uint32_t prevVert(uint32_t face, uint32_t vert) const { return faceVertices[3 * face + prev(vnum(face, vert))]; }
+
+    uint32_t otherVert(uint32_t face, uint32_t v0, uint32_t v1) const
     {
         for (uint32_t i = 0; i < 3; ++i)
         {
-            if (v[i] != v0 && v[i] != v1)
-                return v[i];
+            uint32_t v = faceVertices[3 * face + i];
+            if (v != v0 && v != v1)
+                return v;
         }
-        FALCOR_THROW("Basic logic error in SDFace::otherVert()");
+        FALCOR_THROW("Basic logic error in SDMesh::otherVert()");
     }
 
-    SDVertex* v[3];
-    SDFace* f[3];
-    SDFace* children[4];
-};
+    int valence(uint32_t vert) const
+    {
+        uint32_t startFace = startFaces[vert];
+        uint32_t f = startFace;
+        if (!boundary[vert])
+        {
+            // Compute valence of interior vertex.
+            int nf = 1;
+            while ((f = nextFace(f, vert)) != startFace)
+                ++nf;
+            return nf;
+        }
+        else
+        {
+            // Compute valence of boundary vertex
+            int nf = 1;
+            while ((f = nextFace(f, vert)) != kInvalidIndex)
+                ++nf;
+            f = startFace;
+            while ((f = prevFace(f, vert)) != kInvalidIndex)
+                ++nf;
+            return nf + 1;
+        }
+    }
 
-struct SDEdge
-{
-    SDEdge(SDVertex* v0 = nullptr, SDVertex* v1 = nullptr)
+    /// Call func(p) for all positions p in the one-ring of a vertex, in the same order as pbrt's SDVertex::oneRing().
+    template<typename Func>
+    void forEachOneRing(uint32_t vert, Func func) const
     {
-        v[0] = std::min(v0, v1);
-        v[1] = std::max(v0, v1);
-        f[0] = f[1] = nullptr;
-        f0edgeNum = -1;
+        uint32_t startFace = startFaces[vert];
+        if (!boundary[vert])
+        {
+            // Get one-ring vertices for interior vertex.
+            uint32_t face = startFace;
+            do
+            {
+                func(positions[nextVert(face, vert)]);
+                face = nextFace(face, vert);
+            } while (face != startFace);
+        }
+        else
+        {
+            // Get one-ring vertices for boundary vertex.
+            uint32_t face = startFace;
+            uint32_t f2;
+            while ((f2 = nextFace(face, vert)) != kInvalidIndex)
+            {
+                face = f2;
+            }
+            func(positions[nextVert(face, vert)]);
+            do
+            {
+                func(positions[prevVert(face, vert)]);
+                face = prevFace(face, vert);
+            } while (face != kInvalidIndex);
+        }
     }
+};
 
-    bool operator<(const SDEdge& e2) const
+/// Small buffer holding the one-ring of a vertex. Only falls back to heap allocation for high valence vertices.
+class OneRing
+{
+public:
+    const float3* gather(const SDMesh& mesh, uint32_t vert, uint32_t valence)
     {
-        if (v[0] == e2.v[0])
-            return v[1] < e2.v[1];
-        return v[0] < e2.v[0];
+        float3* ring = mLocal;
+        if (valence > kLocalSize)
+        {
+            mHeap.resize(valence);
+            ring = mHeap.data();
+        }
+        uint32_t count = 0;
+        mesh.forEachOneRing(vert, [&](const float3& p) { ring[count++] = p; });
+        FALCOR_ASSERT(count == valence);
+        return ring;
     }
 
-    SDVertex* v[2];
-    SDFace* f[2];
-    int f0edgeNum;
+private:
+    static constexpr uint32_t kLocalSize = 16;
+    float3 mLocal[kLocalSize];
+    std::vector<float3> mHeap;
 };
 
-static float3 weightOneRing(SDVertex* vert, float beta);
-static float3 weightBoundary(SDVertex* vert, float beta);
+float3 weightOneRing(const SDMesh& mesh, uint32_t vert, float beta)
+{
+    uint32_t valence = mesh.valence(vert);
+    float3 p = (1 - valence * beta) * mesh.positions[vert];
+    mesh.forEachOneRing(vert, [&](const float3& q) { p += beta * q; });
+    return p;
+}
 
-inline int SDVertex::valence()
+float3 weightBoundary(const SDMesh& mesh, uint32_t vert, float beta)
 {
-    SDFace* f = startFace;
-    if (!boundary)
-    {
-        // Compute valence of interior vertex.
-        int nf = 1;
-        while ((f = f->nextFace(this)) != startFace)
-            ++nf;
-        return nf;
-    }
-    else
-    {
-        // Compute valence of boundary vertex
-        int nf = 1;
-        while ((f = f->nextFace(this)) != nullptr)
-            ++nf;
-        f = startFace;
-        while ((f = f->prevFace(this)) != nullptr)
-            ++nf;
-        return nf + 1;
-    }
+    float3 first;
+    float3 last;
+    uint32_t count = 0;
+    mesh.forEachOneRing(
+        vert,
+        [&](const float3& q)
+        {
+            if (count++ == 0)
+                first = q;
+            last = q;
+        }
+    );
+    float3 p = (1 - 2 * beta) * mesh.positions[vert];
+    p += beta * first;
+    p += beta * last;
+    return p;
 }
 
 inline float beta(uint32_t valence)
@@ -171,372 +299,368 @@ inline float loopGamma(uint32_t valence)
     return 1.f / (valence + 3.f / (8.f * beta(valence)));
 }
 
-LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+/// Odd (edge) vertices created on the next subdivision level.
+struct OddVertices
 {
-    std::vector<SDVertex*> vertices;
-    std::vector<SDFace*> faces;
-
-    // Allocate vertices and faces.
-    std::unique_ptr<SDVertex[]> vertexBuffer = std::make_unique<SDVertex[]>(positions.size());
-    for (size_t i = 0; i < positions.size(); ++i)
-    {
-        vertexBuffer[i] = SDVertex(positions[i]);
-        vertices.push_back(&vertexBuffer[i]);
-    }
-    size_t faceCount = indices.size() / 3;
-    std::unique_ptr<SDFace[]> fs = std::make_unique<SDFace[]>(faceCount);
-    for (size_t i = 0; i < faceCount; ++i)
-    {
-        faces.push_back(&fs[i]);
-    }
+    std::vector<uint32_t> vertices; ///< Odd vertex index for each half-edge.
+    std::vector<uint8_t> creators;  ///< True for the half-edge that initializes the odd vertex.
+    uint32_t count = 0;             ///< Number of odd vertices.
+};
 
-    // Set face to vertex pointers.
-    {
-        const uint32_t* vp = indices.data();
-        for (size_t i = 0; i < faceCount; ++i, vp += 3)
+/**
+ * Find the odd vertex of every half-edge for the next subdivision level.
+ * Half-edges connecting the same pair of vertices share a single odd vertex. Odd vertices are
+ * numbered in order of the first half-edge referencing them, starting at the current vertex count.
+ * This matches the order in which pbrt creates odd vertices when iterating over faces and edges.
+ */
+OddVertices computeOddVertices(const SDMesh& mesh)
+{
+    const uint32_t halfEdgeCount = (uint32_t)mesh.faceVertices.size();
+
+    // Build a concurrent open-addressing hash table keyed by edge. For every edge we keep track of
+    // the lowest half-edge index referencing it, which is the half-edge that creates the odd vertex.
+    size_t capacity = 1;
+    while (capacity < 2 * (size_t)halfEdgeCount)
+        capacity <<= 1;
+    const size_t mask = capacity - 1;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> keys(new std::atomic<uint64_t>[capacity]);
+    std::unique_ptr<std::atomic<uint32_t>[]> firstHalfEdges(new std::atomic<uint32_t>[capacity]);
+    NumericRange<size_t> slotRange(0, capacity);
+    std::for_each(
+        std::execution::par_unseq,
+        slotRange.begin(),
+        slotRange.end(),
+        [&](size_t slot)
         {
-            SDFace* f = faces[i];
-            for (uint32_t j = 0; j < 3; ++j)
-            {
-                SDVertex* v = vertices[vp[j]];
-                f->v[j] = v;
-                v->startFace = f;
-            }
+            keys[slot].store(kEmptyEdgeKey, std::memory_order_relaxed);
+            firstHalfEdges[slot].store(kInvalidIndex, std::memory_order_relaxed);
         }
-    }
+    );
 
-    // Set neighbor pointers in faces.
-    std::set<SDEdge> edges;
-    for (size_t i = 0; i < faceCount; ++i)
-    {
-        SDFace* f = faces[i];
-        for (uint32_t edgeNum = 0; edgeNum < 3; ++edgeNum)
+    std::vector<uint32_t> slots(halfEdgeCount);
+    parallelFor(
+        halfEdgeCount,
+        [&](uint32_t h)
         {
-            // Update neighbor pointer for edgeNum.
-            int v0 = edgeNum, v1 = NEXT(edgeNum);
-            SDEdge e(f->v[v0], f->v[v1]);
-            if (edges.find(e) == edges.end())
-            {
-                // Handle new edge.
-                e.f[0] = f;
-                e.f0edgeNum = edgeNum;
-                edges.insert(e);
-            }
-            else
+            uint64_t key = edgeKey(mesh.faceVertices[h], mesh.faceVertices[h - h % 3 + next(h % 3)]);
+            size_t slot = hashEdgeKey(key) & mask;
+            while (true)
             {
-                // Handle previously seen edge.
-                e = *edges.find(e);
-                e.f[0]->f[e.f0edgeNum] = f;
-                f->f[edgeNum] = e.f[0];
-                edges.erase(e);
+                uint64_t expected = kEmptyEdgeKey;
+                if (keys[slot].compare_exchange_strong(expected, key) || expected == key)
+                    break;
+                slot = (slot + 1) & mask;
             }
+            uint32_t first = firstHalfEdges[slot].load();
+            while (h < first && !firstHalfEdges[slot].compare_exchange_weak(first, h))
+                ;
+            slots[h] = (uint32_t)slot;
         }
-    }
-
-    // Finish vertex initialization.
-    for (size_t i = 0; i < positions.size(); ++i)
-    {
-        SDVertex* v = vertices[i];
-        SDFace* f = v->startFace;
-        do
+    );
+
+    // Number the odd vertices in order of their creating half-edges.
+    OddVertices result;
+    result.creators.resize(halfEdgeCount);
+    parallelFor(
+        halfEdgeCount, [&](uint32_t h) { result.creators[h] = firstHalfEdges[slots[h]].load(std::memory_order_relaxed) == h ? 1 : 0; }
+    );
+    std::vector<uint32_t> ordinals(halfEdgeCount);
+    std::exclusive_scan(std::execution::par, result.creators.begin(), result.creators.end(), ordinals.begin(), 0u);
+    if (halfEdgeCount > 0)
+        result.count = ordinals.back() + result.creators.back();
+
+    const uint32_t vertexCount = mesh.getVertexCount();
+    result.vertices = std::move(slots);
+    parallelFor(
+        halfEdgeCount,
+        [&](uint32_t h)
         {
-            f = f->nextFace(v);
-        } while ((f != nullptr) && f != v->startFace);
-        v->boundary = (f == nullptr);
-        if (!v->boundary && v->valence() == 6)
-            v->regular = true;
-        else if (v->boundary && v->valence() == 4)
-            v->regular = true;
-        else
-            v->regular = false;
-    }
+            uint32_t first = firstHalfEdges[result.vertices[h]].load(std::memory_order_relaxed);
+            result.vertices[h] = vertexCount + ordinals[first];
+        }
+    );
 
-    // Refine LoopSubdiv into triangles.
-    std::vector<SDFace*> f = faces;
-    std::vector<SDVertex*> v = vertices;
+    return result;
+}
 
-    std::pmr::monotonic_buffer_resource buffer;
-    std::pmr::polymorphic_allocator<SDVertex> vertexAllocator(&buffer);
-    std::pmr::polymorphic_allocator<SDFace> faceAllocator(&buffer);
+/// Create the mesh for the next level of subdivision.
+SDMesh subdivide(const SDMesh& mesh)
+{
+    const uint32_t vertexCount = mesh.getVertexCount();
+    const uint32_t faceCount = mesh.getFaceCount();
 
-    for (size_t i = 0; i < levels; ++i)
-    {
-        // Update f and v for next level of subdivision.
-        std::vector<SDFace*> newFaces;
-        std::vector<SDVertex*> newVertices;
+    OddVertices oddVertices = computeOddVertices(mesh);
 
-        // Allocate next level of children in mesh tree.
-        for (SDVertex* vertex : v)
-        {
-            vertex->child = vertexAllocator.allocate(1);
-            vertex->child->regular = vertex->regular;
-            vertex->child->boundary = vertex->boundary;
-            newVertices.push_back(vertex->child);
-        }
-        for (SDFace* face : f)
-        {
-            for (uint32_t k = 0; k < 4; ++k)
-            {
-                face->children[k] = faceAllocator.allocate(1);
-                newFaces.push_back(face->children[k]);
-            }
-        }
+    FALCOR_CHECK((size_t)vertexCount + oddVertices.count < kInvalidIndex, "Too many vertices in subdivided mesh.");
+    FALCOR_CHECK(12 * (size_t)faceCount < kInvalidIndex, "Too many faces in subdivided mesh.");
 
-        // Update vertex positions and create new edge vertices.
+    SDMesh child;
+    child.resizeVertices((size_t)vertexCount + oddVertices.count);
+    child.resizeFaces(4 * (size_t)faceCount);
 
-        // Update vertex positions for even vertices.
-        for (SDVertex* vertex : v)
+    // Update vertex positions for even vertices.
+    parallelFor(
+        vertexCount,
+        [&](uint32_t vertex)
         {
-            if (!vertex->boundary)
+            child.regular[vertex] = mesh.regular[vertex];
+            child.boundary[vertex] = mesh.boundary[vertex];
+            if (!mesh.boundary[vertex])
             {
                 // Apply one-ring rule for even vertex.
-                if (vertex->regular)
-                    vertex->child->p = weightOneRing(vertex, 1.f / 16.f);
+                if (mesh.regular[vertex])
+                    child.positions[vertex] = weightOneRing(mesh, vertex, 1.f / 16.f);
                 else
-                    vertex->child->p = weightOneRing(vertex, beta(vertex->valence()));
+                    child.positions[vertex] = weightOneRing(mesh, vertex, beta(mesh.valence(vertex)));
             }
             else
             {
                 // Apply boundary rule for even vertex.
-                vertex->child->p = weightBoundary(vertex, 1.f / 8.f);
+                child.positions[vertex] = weightBoundary(mesh, vertex, 1.f / 8.f);
             }
+
+            // Update even vertex face pointers.
+            uint32_t startFace = mesh.startFaces[vertex];
+            child.startFaces[vertex] = 4 * startFace + mesh.vnum(startFace, vertex);
         }
+    );
 
-        // Compute new odd edge vertices.
-        std::map<SDEdge, SDVertex*> edgeVerts;
-        for (SDFace* face : f)
+    // Compute new odd edge vertices.
+    parallelFor(
+        3 * faceCount,
+        [&](uint32_t h)
         {
-            for (uint32_t k = 0; k < 3; ++k)
+            if (!oddVertices.creators[h])
+                return;
+
+            uint32_t face = h / 3;
+            uint32_t k = h % 3;
+            uint32_t v0 = std::min(mesh.faceVertices[h], mesh.faceVertices[3 * face + next(k)]);
+            uint32_t v1 = std::max(mesh.faceVertices[h], mesh.faceVertices[3 * face + next(k)]);
+            uint32_t neighbor = mesh.faceNeighbors[h];
+
+            // Create and initialize new odd vertex
+            uint32_t vert = oddVertices.vertices[h];
+            child.regular[vert] = true;
+            child.boundary[vert] = neighbor == kInvalidIndex;
+            child.startFaces[vert] = 4 * face + 3;
+
+            // Apply edge rules to compute new vertex position
+            float3& p = child.positions[vert];
+            if (child.boundary[vert])
             {
-                // Compute odd vertex on kth edge.
-                SDEdge edge(face->v[k], face->v[NEXT(k)]);
-                SDVertex* vert = edgeVerts[edge];
-                if (vert == nullptr)
-                {
-                    // Create and initialize new odd vertex
-                    vert = vertexAllocator.allocate(1);
-                    newVertices.push_back(vert);
-                    vert->regular = true;
-                    vert->boundary = (face->f[k] == nullptr);
-                    vert->startFace = face->children[3];
-
-                    // Apply edge rules to compute new vertex position
-                    if (vert->boundary)
-                    {
-                        vert->p = 0.5f * edge.v[0]->p;
-                        vert->p += 0.5f * edge.v[1]->p;
-                    }
-                    else
-                    {
-                        vert->p = 3.f / 8.f * edge.v[0]->p;
-                        vert->p += 3.f / 8.f * edge.v[1]->p;
-                        vert->p += 1.f / 8.f * face->otherVert(edge.v[0], edge.v[1])->p;
-                        vert->p += 1.f / 8.f * face->f[k]->otherVert(edge.v[0], edge.v[1])->p;
-                    }
-                    edgeVerts[edge] = vert;
-                }
+                p = 0.5f * mesh.positions[v0];
+                p += 0.5f * mesh.positions[v1];
+            }
+            else
+            {
+                p = 3.f / 8.f * mesh.positions[v0];
+                p += 3.f / 8.f * mesh.positions[v1];
+                p += 1.f / 8.f * mesh.positions[mesh.otherVert(face, v0, v1)];
+                p += 1.f / 8.f * mesh.positions[mesh.otherVert(neighbor, v0, v1)];
             }
         }
+    );
 
-        // Update new mesh topology.
-
-        // Update even vertex face pointers.
-        for (SDVertex* vertex : v)
+    // Update new mesh topology.
+    parallelFor(
+        faceCount,
+        [&](uint32_t face)
         {
-            int vertNum = vertex->startFace->vnum(vertex);
-            vertex->child->startFace = vertex->startFace->children[vertNum];
-        }
+            const uint32_t* v = &mesh.faceVertices[3 * face];
+            const uint32_t* f = &mesh.faceNeighbors[3 * face];
+            uint32_t children[4] = {4 * face, 4 * face + 1, 4 * face + 2, 4 * face + 3};
 
-        // Update face neighbor pointers.
-        for (SDFace* face : f)
-        {
             for (uint32_t j = 0; j < 3; ++j)
             {
                 // Update children f pointers for siblings.
-                face->children[3]->f[j] = face->children[NEXT(j)];
-                face->children[j]->f[NEXT(j)] = face->children[3];
+                child.faceNeighbors[3 * children[3] + j] = children[next(j)];
+                child.faceNeighbors[3 * children[j] + next(j)] = children[3];
 
                 // Update children f pointers for neighbor children.
-                SDFace* f2 = face->f[j];
-                face->children[j]->f[j] = f2 != nullptr ? f2->children[f2->vnum(face->v[j])] : nullptr;
-                f2 = face->f[PREV(j)];
-                face->children[j]->f[PREV(j)] = f2 != nullptr ? f2->children[f2->vnum(face->v[j])] : nullptr;
+                uint32_t f2 = f[j];
+                child.faceNeighbors[3 * children[j] + j] = f2 != kInvalidIndex ? 4 * f2 + mesh.vnum(f2, v[j]) : kInvalidIndex;
+                f2 = f[prev(j)];
+                child.faceNeighbors[3 * children[j] + prev(j)] = f2 != kInvalidIndex ? 4 * f2 + mesh.vnum(f2, v[j]) : kInvalidIndex;
             }
-        }
 
-        // Update face vertex pointers.
-        for (SDFace* face : f)
-        {
             for (uint32_t j = 0; j < 3; ++j)
             {
                 // Update child vertex pointer to new even vertex
-                face->children[j]->v[j] = face->v[j]->child;
+                child.faceVertices[3 * children[j] + j] = v[j];
 
                 // Update child vertex pointer to new odd vertex
-                SDVertex* vert = edgeVerts[SDEdge(face->v[j], face->v[NEXT(j)])];
-                face->children[j]->v[NEXT(j)] = vert;
-                face->children[NEXT(j)]->v[j] = vert;
-                face->children[3]->v[j] = vert;
+                uint32_t vert = oddVertices.vertices[3 * face + j];
+                child.faceVertices[3 * children[j] + next(j)] = vert;
+                child.faceVertices[3 * children[next(j)] + j] = vert;
+                child.faceVertices[3 * children[3] + j] = vert;
             }
         }
+    );
 
-        // Prepare for next level of subdivision
-        f = newFaces;
-        v = newVertices;
-    }
+    return child;
+}
 
-    // Push vertices to limit surface.
-    std::vector<float3> pLimit(v.size());
-    for (size_t i = 0; i < v.size(); ++i)
-    {
-        if (v[i]->boundary)
-            pLimit[i] = weightBoundary(v[i], 1.f / 5.f);
-        else
-            pLimit[i] = weightOneRing(v[i], loopGamma(v[i]->valence()));
-    }
-    for (size_t i = 0; i < v.size(); ++i)
-    {
-        v[i]->p = pLimit[i];
-    }
+} // namespace
 
-    // Compute vertex tangents on limit surface.
-    std::vector<float3> Ns;
-    Ns.reserve(v.size());
-    std::vector<float3> pRing(16, float3());
-    for (SDVertex* vertex : v)
+LoopSubdivideResult loopSubdivide(uint32_t levels, fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+{
+    FALCOR_CHECK(positions.size() < kInvalidIndex, "Too many vertices.");
+    FALCOR_CHECK(indices.size() % 3 == 0 && indices.size() < kInvalidIndex, "Invalid index count.");
+
+    SDMesh mesh;
+    const uint32_t vertexCount = (uint32_t)positions.size();
+    const uint32_t faceCount = (uint32_t)(indices.size() / 3);
+
+    // Allocate vertices and faces.
+    mesh.resizeVertices(vertexCount);
+    mesh.resizeFaces(faceCount);
+    std::copy(positions.begin(), positions.end(), mesh.positions.begin());
+    std::fill(mesh.startFaces.begin(), mesh.startFaces.end(), kInvalidIndex);
+    std::fill(mesh.faceNeighbors.begin(), mesh.faceNeighbors.end(), kInvalidIndex);
+
+    // Set face to vertex pointers.
+    for (uint32_t i = 0; i < faceCount; ++i)
     {
-        float3 S(0.f);
-        float3 T(0.f);
-        uint32_t valence = vertex->valence();
-        if (valence > pRing.size())
-            pRing.resize(valence);
-        vertex->oneRing(&pRing[0]);
-        if (!vertex->boundary)
+        for (uint32_t j = 0; j < 3; ++j)
         {
-            // Compute tangents of interior face
-            for (uint32_t j = 0; j < valence; ++j)
-            {
-                S += std::cos(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
-                T += std::sin(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
-            }
+            uint32_t v = indices[3 * i + j];
+            FALCOR_CHECK(v < vertexCount, "Vertex index {} is out of range.", v);
+            mesh.faceVertices[3 * i + j] = v;
+            mesh.startFaces[v] = i;
         }
-        else
+    }
+
+    // Set neighbor pointers in faces.
+    // Note that this has to run sequentially to pair up edges shared by more than two faces the same way pbrt does.
+    {
+        std::unordered_map<uint64_t, uint32_t> edges;
+        edges.reserve(indices.size());
+        for (uint32_t i = 0; i < faceCount; ++i)
         {
-            // Compute tangents of boundary face
-            S = pRing[valence - 1] - pRing[0];
-            if (valence == 2)
+            for (uint32_t edgeNum = 0; edgeNum < 3; ++edgeNum)
             {
-                T = float3(pRing[0] + pRing[1] - 2.f * vertex->p);
-            }
-            else if (valence == 3)
-            {
-                T = pRing[1] - vertex->p;
-            }
-            else if (valence == 4) // regular
-            {
-                T = float3(-1.f * pRing[0] + 2.f * pRing[1] + 2.f * pRing[2] + -1.f * pRing[3] + -2.f * vertex->p);
-            }
-            else
-            {
-                float theta = float(M_PI) / float(valence - 1);
-                T = float3(std::sin(theta) * (pRing[0] + pRing[valence - 1]));
-                for (uint32_t k = 1; k < valence - 1; ++k)
+                // Update neighbor pointer for edgeNum.
+                uint64_t key = edgeKey(mesh.faceVertices[3 * i + edgeNum], mesh.faceVertices[3 * i + next(edgeNum)]);
+                auto it = edges.find(key);
+                if (it == edges.end())
+                {
+                    // Handle new edge.
+                    edges.emplace(key, 3 * i + edgeNum);
+                }
+                else
                 {
-                    float wt = (2 * std::cos(theta) - 2) * std::sin((k)*theta);
-                    T += float3(wt * pRing[k]);
+                    // Handle previously seen edge.
+                    uint32_t h = it->second;
+                    mesh.faceNeighbors[h] = i;
+                    mesh.faceNeighbors[3 * i + edgeNum] = h / 3;
+                    edges.erase(it);
                 }
-                T = -T;
             }
         }
-        Ns.push_back(cross(S, T));
     }
 
-    // Create triangle mesh from subdivision mesh
-    {
-        size_t ntris = f.size();
-        std::vector<uint32_t> verts(3 * ntris);
-        uint32_t* vp = verts.data();
-        uint32_t totVerts = (uint32_t)v.size();
-        std::map<SDVertex*, uint32_t> usedVerts;
-        for (uint32_t i = 0; i < totVerts; ++i)
-        {
-            usedVerts[v[i]] = i;
-        }
-        for (size_t i = 0; i < ntris; ++i)
+    // Finish vertex initialization.
+    parallelFor(
+        vertexCount,
+        [&](uint32_t v)
         {
-            for (uint32_t j = 0; j < 3; ++j)
+            uint32_t startFace = mesh.startFaces[v];
+            FALCOR_CHECK(startFace != kInvalidIndex, "Vertex {} is not referenced by any face.", v);
+            uint32_t f = startFace;
+            do
             {
-                *vp = usedVerts[f[i]->v[j]];
-                ++vp;
-            }
+                f = mesh.nextFace(f, v);
+            } while (f != kInvalidIndex && f != startFace);
+            mesh.boundary[v] = f == kInvalidIndex;
+            int valence = mesh.valence(v);
+            if (!mesh.boundary[v] && valence == 6)
+                mesh.regular[v] = true;
+            else if (mesh.boundary[v] && valence == 4)
+                mesh.regular[v] = true;
+            else
+                mesh.regular[v] = false;
         }
+    );
 
-        LoopSubdivideResult result;
-        result.positions = std::move(pLimit);
-        result.normals = std::move(Ns);
-        result.indices = std::move(verts);
-        return result;
-    }
-}
-
-static float3 weightOneRing(SDVertex* vert, float beta)
-{
-    // Put vert one-ring in pRing.
-    uint32_t valence = vert->valence();
-    FALCOR_ASSERT(valence < 16);
-    float3 pRing[16];
-
-    vert->oneRing(pRing);
-    float3 p = (1 - valence * beta) * vert->p;
-    for (uint32_t i = 0; i < valence; ++i)
-    {
-        p += beta * pRing[i];
-    }
-    return p;
-}
+    // Refine LoopSubdiv into triangles.
+    for (uint32_t i = 0; i < levels; ++i)
+        mesh = subdivide(mesh);
 
-void SDVertex::oneRing(float3* p_)
-{
-    if (!boundary)
-    {
-        // Get one-ring vertices for interior vertex.
-        SDFace* face = startFace;
-        do
-        {
-            *p_++ = face->nextVert(this)->p;
-            face = face->nextFace(this);
-        } while (face != startFace);
-    }
-    else
-    {
-        // Get one-ring vertices for boundary vertex.
-        SDFace* face = startFace;
-        SDFace* f2;
-        while ((f2 = face->nextFace(this)) != nullptr)
+    // Push vertices to limit surface.
+    std::vector<float3> pLimit(mesh.getVertexCount());
+    parallelFor(
+        mesh.getVertexCount(),
+        [&](uint32_t v)
         {
-            face = f2;
+            if (mesh.boundary[v])
+                pLimit[v] = weightBoundary(mesh, v, 1.f / 5.f);
+            else
+                pLimit[v] = weightOneRing(mesh, v, loopGamma(mesh.valence(v)));
         }
-        *p_++ = face->nextVert(this)->p;
-        do
+    );
+    mesh.positions = pLimit;
+
+    // Compute vertex tangents on limit surface.
+    std::vector<float3> Ns(mesh.getVertexCount());
+    parallelFor(
+        mesh.getVertexCount(),
+        [&](uint32_t v)
         {
-            *p_++ = face->prevVert(this)->p;
-            face = face->prevFace(this);
-        } while (face != nullptr);
-    }
-}
+            OneRing oneRing;
+            float3 S(0.f);
+            float3 T(0.f);
+            uint32_t valence = mesh.valence(v);
+            const float3* pRing = oneRing.gather(mesh, v, valence);
+            const float3& p = mesh.positions[v];
+            if (!mesh.boundary[v])
+            {
+                // Compute tangents of interior face
+                for (uint32_t j = 0; j < valence; ++j)
+                {
+                    S += std::cos(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
+                    T += std::sin(2.f * float(M_PI) * j / valence) * float3(pRing[j]);
+                }
+            }
+            else
+            {
+                // Compute tangents of boundary face
+                S = pRing[valence - 1] - pRing[0];
+                if (valence == 2)
+                {
+                    T = float3(pRing[0] + pRing[1] - 2.f * p);
+                }
+                else if (valence == 3)
+                {
+                    T = pRing[1] - p;
+                }
+                else if (valence == 4) // regular
+                {
+                    T = float3(-1.f * pRing[0] + 2.f * pRing[1] + 2.f * pRing[2] + -1.f * pRing[3] + -2.f * p);
+                }
+                else
+                {
+                    float theta = float(M_PI) / float(valence - 1);
+                    T = float3(std::sin(theta) * (pRing[0] + pRing[valence - 1]));
+                    for (uint32_t k = 1; k < valence - 1; ++k)
+                    {
+                        float wt = (2 * std::cos(theta) - 2) * std::sin((k)*theta);
+                        T += float3(wt * pRing[k]);
+                    }
+                    T = -T;
+                }
+            }
+            Ns[v] = cross(S, T);
+        }
+    );
 
-static float3 weightBoundary(SDVertex* vert, float beta)
-{
-    // Put vert one-ring in pRing.
-    uint32_t valence = vert->valence();
-    FALCOR_ASSERT(valence < 16);
-    float3 pRing[16];
-
-    vert->oneRing(pRing);
-    float3 p = (1 - 2 * beta) * vert->p;
-    p += beta * pRing[0];
-    p += beta * pRing[valence - 1];
-    return p;
+    // Create triangle mesh from subdivision mesh
+    LoopSubdivideResult result;
+    result.positions = std::move(pLimit);
+    result.normals = std::move(Ns);
+    result.indices = std::move(mesh.faceVertices);
+    return result;
 }
 
 } // namespace Falcor::pbrt
@@ -66,11 +66,13 @@
 #include "EnvMapConverter.h"
 #include "Core/Error.h"
 #include "Core/API/Device.h"
+#include "Core/Platform/IOService.h"
 #include "Utils/Settings.h"
 #include "Utils/Logger.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Math/FalcorMath.h"
 #include "Utils/Math/FNVHash.h"
+#include "Utils/NumericRange.h"
 #include "Scene/Importer.h"
 #include "Scene/Material/Material.h"
 #include "Scene/Material/StandardMaterial.h"
@@ -86,6 +88,9 @@
 
 #include <pybind11/pybind11.h>
 
+#include <algorithm>
+#include <execution>
+#include <set>
 #include <unordered_map>
 
 namespace Falcor
@@ -207,6 +212,12 @@ struct InstanceDefinition
     std::vector<std::pair<CurveID, float4x4>> curves; // List of curveID + transfrom
 };
 
+struct MeasuredBRDF
+{
+    RGLMaterial::BRDFData brdf;      ///< Preprocessed BRDF data.
+    uint32_t remainingUseCount = 0;  ///< Number of materials still to be created from the BRDF.
+};
+
 struct BuilderContext
 {
     BasicScene& scene;
@@ -220,6 +231,8 @@ struct BuilderContext
     std::map<std::string, Falcor::ref<Falcor::Material>> namedMaterials;
     std::vector<Falcor::ref<Falcor::Material>> materials;
 
+    std::map<std::filesystem::path, MeasuredBRDF> measuredBRDFs; ///< Preprocessed BRDFs of measured materials by path.
+
     Falcor::ref<Falcor::Material> pDefaultMaterial;
 
     std::unordered_map<CurveAggregate::Key, CurveAggregate, CurveAggregate::KeyHash> curveAggregates;
@@ -724,6 +737,7 @@ Light createLight(BuilderContext& ctx, const LightSceneEntity& entity)
         {
             auto path = ctx.resolver(filename);
             auto pOctTexture = Falcor::Texture::createFromFile(ctx.builder.getDevice(), path, false, false);
+            ctx.builder.addDependency(path);
             // TODO: Use equal-area octahedral parametrization when env map supports it.
             logWarning(
                 entity.loc,
@@ -822,6 +836,7 @@ FloatTexture createFloatTexture(BuilderContext& ctx, const TextureSceneEntity& e
         bool sRGB = encoding == "sRGB";
 
         floatTexture.texture = Falcor::Texture::createFromFile(ctx.builder.getDevice(), path, generateMips, sRGB);
+        ctx.builder.addDependency(path);
     }
     else if (type == "checkerboard")
     {
@@ -939,6 +954,7 @@ SpectrumTexture createSpectrumTexture(BuilderContext& ctx, const TextureSceneEnt
         bool sRGB = encoding == "sRGB";
 
         spectrumTexture.texture = Falcor::Texture::createFromFile(ctx.builder.getDevice(), path, generateMips, sRGB);
+        ctx.builder.addDependency(path);
     }
     else if (type == "checkerboard")
     {
@@ -1317,8 +1333,22 @@ Falcor::ref<Falcor::Material> createMaterial(BuilderContext& ctx, const Material
         auto path = ctx.resolver(params.getString("filename", ""));
         try
         {
-            auto pRGLMaterial = RGLMaterial::create(ctx.builder.getDevice(), entity.name, path);
-            pMaterial = pRGLMaterial;
+            auto it = ctx.measuredBRDFs.find(path);
+            if (it == ctx.measuredBRDFs.end())
+            {
+                pMaterial = RGLMaterial::create(ctx.builder.getDevice(), entity.name, path, ctx.builder.getAssetCache());
+            }
+            else if (--it->second.remainingUseCount > 0)
+            {
+                pMaterial = RGLMaterial::create(ctx.builder.getDevice(), entity.name, it->second.brdf, ctx.builder.getAssetCache());
+            }
+            else
+            {
+                // Release the preprocessed tables once the last material using them is created.
+                RGLMaterial::BRDFData brdf = std::move(it->second.brdf);
+                ctx.measuredBRDFs.erase(it);
+                pMaterial = RGLMaterial::create(ctx.builder.getDevice(), entity.name, brdf, ctx.builder.getAssetCache());
+            }
         }
         catch (const RuntimeError& e)
         {
@@ -1344,7 +1374,9 @@ Falcor::ref<Falcor::Material> createMaterial(BuilderContext& ctx, const Material
         auto normalmap = params.getString("normalmap", "");
         if (!normalmap.empty())
         {
-            auto pNormalMap = Texture::createFromFile(ctx.builder.getDevice(), ctx.resolver(normalmap), true, false);
+            auto normalMapPath = ctx.resolver(normalmap);
+            auto pNormalMap = Texture::createFromFile(ctx.builder.getDevice(), normalMapPath, true, false);
+            ctx.builder.addDependency(normalMapPath);
             pMaterial->setTexture(Material::TextureSlot::Normal, pNormalMap);
         }
     }
@@ -1593,7 +1625,9 @@ Shape createShape(BuilderContext& ctx, const ShapeSceneEntity& entity)
         auto filename = params.getString("filename", "");
         auto path = ctx.resolver(filename);
 
-        shape.pTriangleMesh = Falcor::TriangleMesh::createFromFile(path.string());
+        shape.pTriangleMesh = Falcor::TriangleMesh::createFromFile(
+            path, Falcor::TriangleMesh::ImportFlags::None, [&](const std::filesystem::path& filePath) { ctx.builder.addDependency(filePath); }
+        );
         if (shape.pTriangleMesh)
             shape.pTriangleMesh->setName(filename);
         shape.transform = entity.transform;
@@ -1791,8 +1825,70 @@ InstanceDefinition createInstanceDefinition(BuilderContext& ctx, const InstanceD
     return instanceDefinition;
 }
 
+/**
+ * Get the files referenced by the scene, in the order they are loaded by buildScene().
+ * This includes image textures, measured BRDFs, normal maps, environment maps and PLY meshes.
+ */
+std::vector<std::filesystem::path> getReferencedFiles(BuilderContext& ctx)
+{
+    std::vector<std::filesystem::path> paths;
+    auto addFile = [&](const ParameterDictionary& params, const std::string& name)
+    {
+        auto filename = params.getString(name, "");
+        if (!filename.empty())
+            paths.push_back(ctx.resolver(filename));
+    };
+
+    for (const auto& [name, entity] : ctx.scene.getFloatTextures())
+        if (entity.name == "imagemap")
+            addFile(entity.params, "filename");
+    for (const auto& [name, entity] : ctx.scene.getSpectrumTextures())
+        if (entity.name == "imagemap")
+            addFile(entity.params, "filename");
+
+    auto addMaterialFiles = [&](const MaterialSceneEntity& entity)
+    {
+        if (entity.type == "measured")
+            addFile(entity.params, "filename");
+        addFile(entity.params, "normalmap");
+    };
+    for (const auto& [name, entity] : ctx.scene.getNamedMaterials())
+        addMaterialFiles(entity);
+    for (const auto& entity : ctx.scene.getMaterials())
+        addMaterialFiles(entity);
+
+    for (const auto& entity : ctx.scene.getLights())
+        if (entity.name == "infinite")
+            addFile(entity.params, "filename");
+
+    auto addShapeFiles = [&](const ShapeSceneEntity& entity)
+    {
+        if (entity.name == "plymesh")
+            addFile(entity.params, "filename");
+    };
+    for (const auto& entity : ctx.scene.getShapes())
+        addShapeFiles(entity);
+
+    // Instance definitions are created on first use.
+    std::set<std::string> instanceDefinitions;
+    for (const auto& entity : ctx.scene.getInstances())
+    {
+        auto it = ctx.scene.getInstanceDefinitions().find(entity.name);
+        if (it != ctx.scene.getInstanceDefinitions().end() && instanceDefinitions.insert(entity.name).second)
+        {
+            for (const auto& shapeEntity : it->second.shapes)
+                addShapeFiles(shapeEntity);
+        }
+    }
+
+    return paths;
+}
+
 void buildScene(BuilderContext& ctx)
 {
+    // Start reading the referenced files in the background. Files are read a limited amount ahead of their use.
+    auto readAhead = IOService::get().readAhead(getReferencedFiles(ctx));
+
     // Load float textures.
     for (const auto& [name, entity] : ctx.scene.getFloatTextures())
         ctx.floatTextures.emplace(name, createFloatTexture(ctx, entity));
@@ -1804,6 +1900,42 @@ void buildScene(BuilderContext& ctx)
     for (const auto& entity : ctx.scene.getMedia())
         ctx.media.emplace(entity.name, createMedium(ctx, entity));
 
+    // Load and preprocess the BRDFs of measured materials in parallel.
+    {
+        std::map<std::filesystem::path, uint32_t> useCounts;
+        auto addMeasuredMaterial = [&](const MaterialSceneEntity& entity)
+        {
+            if (entity.type == "measured")
+                useCounts[ctx.resolver(entity.params.getString("filename", ""))]++;
+        };
+        for (const auto& [name, entity] : ctx.scene.getNamedMaterials())
+            addMeasuredMaterial(entity);
+        for (const auto& entity : ctx.scene.getMaterials())
+            addMeasuredMaterial(entity);
+
+        std::vector<std::filesystem::path> paths;
+        for (const auto& [path, useCount] : useCounts)
+            paths.push_back(path);
+
+        std::vector<RGLMaterial::BRDFData> brdfs(paths.size());
+        std::vector<uint8_t> loaded(paths.size());
+        auto range = NumericRange<size_t>(0, paths.size());
+        std::for_each(
+            std::execution::par,
+            range.begin(),
+            range.end(),
+            [&](size_t i) { loaded[i] = RGLMaterial::prepareBRDF(paths[i], ctx.builder.getAssetCache(), brdfs[i]); }
+        );
+
+        // Failed BRDFs are loaded again when creating the material, which reports the error.
+        for (size_t i = 0; i < paths.size(); i++)
+        {
+            ctx.builder.addDependency(paths[i]);
+            if (loaded[i])
+                ctx.measuredBRDFs.emplace(paths[i], MeasuredBRDF{ std::move(brdfs[i]), useCounts[paths[i]] });
+        }
+    }
+
     // Create named materials.
     for (const auto& [name, entity] : ctx.scene.getNamedMaterials())
         ctx.namedMaterials.emplace(name, createMaterial(ctx, entity));
@@ -1926,6 +2058,8 @@ void PBRTImporter::importScene(
         pbrt::BasicScene pbrtScene(path.parent_path());
         pbrt::BasicSceneBuilder pbrtBuilder(pbrtScene);
         pbrt::parseFile(pbrtBuilder, path);
+        for (const auto& includedPath : pbrtScene.getIncludedFiles())
+            builder.addDependency(includedPath);
         timeReport.measure("Parsing pbrt scene");
 
         pbrt::BuilderContext ctx{pbrtScene, builder};
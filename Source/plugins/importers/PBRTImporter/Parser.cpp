@@ -39,10 +39,21 @@
 
 #include <fast_float/fast_float.h>
 
+#include <algorithm>
 #include <atomic>
 #include <utility>
 #include <charconv>
 
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#define PBRT_TOKENIZER_USE_SSE2 1
+#include <emmintrin.h>
+#if FALCOR_MSVC
+#include <intrin.h>
+#endif
+#else
+#define PBRT_TOKENIZER_USE_SSE2 0
+#endif
+
 namespace Falcor::pbrt
 {
 
@@ -86,6 +97,95 @@ static char decodeEscaped(int ch, const FileLoc& loc)
     return 0;
 }
 
+namespace
+{
+inline bool isSpace(char ch)
+{
+    return ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r';
+}
+
+inline bool isDelimiter(char ch)
+{
+    return isSpace(ch) || ch == '"' || ch == '[' || ch == ']';
+}
+
+#if PBRT_TOKENIZER_USE_SSE2
+inline uint32_t findFirstSet(uint32_t mask)
+{
+#if FALCOR_MSVC
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return index;
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+inline __m128i matchSpace(__m128i c)
+{
+    __m128i m0 = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')), _mm_cmpeq_epi8(c, _mm_set1_epi8('\n')));
+    __m128i m1 = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('\t')), _mm_cmpeq_epi8(c, _mm_set1_epi8('\r')));
+    return _mm_or_si128(m0, m1);
+}
+#endif
+
+/**
+ * Character classes used for scanning the input.
+ * Each class provides a scalar test and a 16-wide SSE2 test returning a bit mask of the matching characters.
+ */
+struct NonSpaceChar
+{
+    static bool test(char ch) { return !isSpace(ch); }
+#if PBRT_TOKENIZER_USE_SSE2
+    static uint32_t test(__m128i c) { return ~uint32_t(_mm_movemask_epi8(matchSpace(c))) & 0xffff; }
+#endif
+};
+
+struct LineEndChar
+{
+    static bool test(char ch) { return ch == '\n' || ch == '\r'; }
+#if PBRT_TOKENIZER_USE_SSE2
+    static uint32_t test(__m128i c)
+    {
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('\n')), _mm_cmpeq_epi8(c, _mm_set1_epi8('\r')));
+        return uint32_t(_mm_movemask_epi8(m));
+    }
+#endif
+};
+
+struct DelimiterChar
+{
+    static bool test(char ch) { return isDelimiter(ch); }
+#if PBRT_TOKENIZER_USE_SSE2
+    static uint32_t test(__m128i c)
+    {
+        __m128i m0 = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('"')), _mm_cmpeq_epi8(c, _mm_set1_epi8('[')));
+        __m128i m1 = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(']')), matchSpace(c));
+        return uint32_t(_mm_movemask_epi8(_mm_or_si128(m0, m1)));
+    }
+#endif
+};
+
+/// Find the first character in [p, end) of the given character class. Returns end if there is none.
+template<typename CharClass>
+const char* findFirst(const char* p, const char* end)
+{
+#if PBRT_TOKENIZER_USE_SSE2
+    // Only full 16-byte blocks are loaded, so we never read past the end of the (possibly memory mapped) input.
+    while (end - p >= 16)
+    {
+        uint32_t mask = CharClass::test(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+        if (mask != 0)
+            return p + findFirstSet(mask);
+        p += 16;
+    }
+#endif
+    while (p < end && !CharClass::test(*p))
+        ++p;
+    return p;
+}
+} // namespace
+
 std::unique_ptr<Tokenizer> Tokenizer::createFromFile(const std::filesystem::path& path)
 {
     if (hasExtension(path, "gz"))
@@ -93,11 +193,14 @@ std::unique_ptr<Tokenizer> Tokenizer::createFromFile(const std::filesystem::path
         std::string str = decompressFile(path);
         return std::make_unique<Tokenizer>(std::move(str), path);
     }
-    else
-    {
-        std::string str = readFile(path);
-        return std::make_unique<Tokenizer>(std::move(str), path);
-    }
+
+    auto file = IOService::get().map(path, MemoryMappedFile::AccessHint::SequentialScan);
+    if (file)
+        return std::make_unique<Tokenizer>(std::move(file), path);
+
+    // Fall back to reading the file (empty files cannot be mapped).
+    std::string str = readFile(path);
+    return std::make_unique<Tokenizer>(std::move(str), path);
 }
 
 std::unique_ptr<Tokenizer> Tokenizer::createFromString(std::string str)
@@ -107,13 +210,25 @@ std::unique_ptr<Tokenizer> Tokenizer::createFromString(std::string str)
 
 Tokenizer::Tokenizer(std::string str, const std::filesystem::path& path) : mPath(path), mContents(std::move(str))
 {
-    auto pFilename = std::make_unique<std::string>(path.string());
+    init(mContents.data(), mContents.size());
+}
+
+Tokenizer::Tokenizer(std::shared_ptr<const MemoryMappedFile> file, const std::filesystem::path& path) : mPath(path), mMappedFile(std::move(file))
+{
+    FALCOR_ASSERT(mMappedFile && mMappedFile->isOpen());
+    init(static_cast<const char*>(mMappedFile->getData()), mMappedFile->getMappedSize());
+}
+
+void Tokenizer::init(const char* data, size_t size)
+{
+    auto pFilename = std::make_unique<std::string>(mPath.string());
     mLoc = FileLoc(*pFilename);
     getFilenames().push_back(std::move(pFilename));
 
-    mPos = mContents.data();
-    mEnd = mPos + mContents.size();
-    if (isUTF16(mContents.data(), mContents.size()))
+    mPos = data;
+    mEnd = data + size;
+    mIncludeSearchPos = data;
+    if (isUTF16(data, size))
         throwError("File is encoded with UTF-16, which is not currently supported.");
 }
 
@@ -126,100 +241,173 @@ bool Tokenizer::isUTF16(const void* ptr, size_t len) const
 
 std::optional<Token> Tokenizer::next()
 {
-    while (true)
-    {
-        const char* tokenStart = mPos;
-        FileLoc startLoc = mLoc;
+    advance(findFirst<NonSpaceChar>(mPos, mEnd));
+    if (mPos == mEnd)
+        return {};
 
-        int ch = getChar();
-        if (ch == EOF)
-        {
-            return {};
-        }
-        else if (ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r')
-        {
-            // Skip.
-        }
-        else if (ch == '"')
+    const char* tokenStart = mPos;
+    FileLoc startLoc = mLoc;
+
+    int ch = getChar();
+    if (ch == '"')
+    {
+        // Scan to closing quote.
+        bool haveEscaped = false;
+        while ((ch = getChar()) != '"')
         {
-            // Scan to closing quote.
-            bool haveEscaped = false;
-            while ((ch = getChar()) != '"')
+            if (ch == EOF)
             {
-                if (ch == EOF)
-                {
-                    throwError(startLoc, "Premature EOF.");
-                }
-                else if (ch == '\n')
-                {
-                    throwError(startLoc, "Unterminated string.");
-                }
-                else if (ch == '\\')
-                {
-                    haveEscaped = true;
-                    // Grab the next character.
-                    if ((ch = getChar()) == EOF)
-                    {
-                        throwError(startLoc, "Premature EOF.");
-                    }
-                }
+                throwError(startLoc, "Premature EOF.");
             }
-
-            if (!haveEscaped)
+            else if (ch == '\n')
             {
-                return Token({tokenStart, size_t(mPos - tokenStart)}, startLoc);
+                throwError(startLoc, "Unterminated string.");
             }
-            else
+            else if (ch == '\\')
             {
-                mEscaped.clear();
-                for (const char* p = tokenStart; p < mPos; ++p)
+                haveEscaped = true;
+                // Grab the next character.
+                if ((ch = getChar()) == EOF)
                 {
-                    if (*p != '\\')
-                    {
-                        mEscaped.push_back(*p);
-                    }
-                    else
-                    {
-                        ++p;
-                        FALCOR_ASSERT(p < mPos);
-                        mEscaped.push_back(decodeEscaped(*p, startLoc));
-                    }
+                    throwError(startLoc, "Premature EOF.");
                 }
-                return Token({mEscaped.data(), mEscaped.size()}, startLoc);
             }
         }
-        else if (ch == '[' || ch == ']')
+
+        if (!haveEscaped)
         {
-            return Token({tokenStart, size_t(1)}, startLoc);
+            return Token({tokenStart, size_t(mPos - tokenStart)}, startLoc);
         }
-        else if (ch == '#')
+        else
         {
-            // Comment: scan to EOL (or EOF).
-            while ((ch = getChar()) != EOF)
+            mEscaped.clear();
+            for (const char* p = tokenStart; p < mPos; ++p)
             {
-                if (ch == '\n' || ch == '\r')
+                if (*p != '\\')
                 {
-                    ungetChar();
-                    break;
+                    mEscaped.push_back(*p);
+                }
+                else
+                {
+                    ++p;
+                    FALCOR_ASSERT(p < mPos);
+                    mEscaped.push_back(decodeEscaped(*p, startLoc));
                 }
             }
+            return Token({mEscaped.data(), mEscaped.size()}, startLoc);
+        }
+    }
+    else if (ch == '[' || ch == ']')
+    {
+        return Token({tokenStart, size_t(1)}, startLoc);
+    }
+    else if (ch == '#')
+    {
+        // Comment: scan to EOL (or EOF).
+        advanceInLine(findFirst<LineEndChar>(mPos, mEnd));
+        return Token({tokenStart, size_t(mPos - tokenStart)}, startLoc);
+    }
+    else
+    {
+        // Regular statement or numeric token. Scan until we hit a space, opening quote, or bracket.
+        advanceInLine(findFirst<DelimiterChar>(mPos, mEnd));
+        return Token({tokenStart, size_t(mPos - tokenStart)}, startLoc);
+    }
+}
 
-            return Token({tokenStart, size_t(mPos - tokenStart)}, startLoc);
+void Tokenizer::findIncludes(size_t distance, std::vector<std::string>& filenames)
+{
+    if (mIncludeSearchPos == mEnd || (mIncludeSearchPos > mPos && size_t(mIncludeSearchPos - mPos) >= distance / 2))
+        return;
+
+    // Parsing may have passed the searched input, includes behind the current position are not reported.
+    const char* searchStart = std::max(mIncludeSearchPos, mPos);
+    const char* searchEnd = mPos + std::min(distance, size_t(mEnd - mPos));
+    const std::string_view kInclude = "Include";
+
+    // Search for the keyword starting in [searchStart, searchEnd).
+    const char* windowEnd = std::min(mEnd, searchEnd + kInclude.size() - 1);
+    std::string_view window(searchStart, size_t(windowEnd - searchStart));
+    for (size_t pos = window.find(kInclude); pos != std::string_view::npos; pos = window.find(kInclude, pos + kInclude.size()))
+    {
+        const char* p = searchStart + pos;
+        const char* q = p + kInclude.size();
+        if ((p > mPos && !isSpace(p[-1])) || q == mEnd || !isSpace(*q))
+            continue;
+
+        // The filename is the following quoted string.
+        q = findFirst<NonSpaceChar>(q, mEnd);
+        if (q == mEnd || *q != '"')
+            continue;
+        const char* filenameEnd = static_cast<const char*>(std::memchr(q + 1, '"', size_t(mEnd - q - 1)));
+        if (filenameEnd)
+            filenames.emplace_back(q + 1, filenameEnd);
+    }
+
+    mIncludeSearchPos = searchEnd;
+}
+
+bool Tokenizer::skipSpacesAndComments()
+{
+    while (true)
+    {
+        advance(findFirst<NonSpaceChar>(mPos, mEnd));
+        if (mPos == mEnd)
+            return false;
+        if (*mPos != '#')
+            return true;
+        advanceInLine(findFirst<LineEndChar>(mPos, mEnd));
+    }
+}
+
+bool Tokenizer::parseFloatArray(std::vector<Float>& values)
+{
+    while (skipSpacesAndComments())
+    {
+        if (*mPos == ']')
+        {
+            advanceInLine(mPos + 1);
+            return true;
         }
-        else
+
+        // Skip '+' character, fast_float::from_chars doesn't handle '+'.
+        const char* begin = *mPos == '+' ? mPos + 1 : mPos;
+        Float value;
+        auto result = fast_float::from_chars(begin, mEnd, value);
+        // Leave anything that is not a complete number to the regular tokenizer, which reports errors.
+        if (result.ec != std::errc() || (result.ptr != mEnd && !isDelimiter(*result.ptr)))
+            return false;
+
+        values.push_back(value);
+        advanceInLine(result.ptr);
+    }
+    return false;
+}
+
+bool Tokenizer::parseIntArray(std::vector<int>& values)
+{
+    while (skipSpacesAndComments())
+    {
+        if (*mPos == ']')
         {
-            // Regular statement or numeric token. Scan until we hit a space, opening quote, or bracket.
-            while ((ch = getChar()) != EOF)
-            {
-                if (ch == ' ' || ch == '\n' || ch == '\t' || ch == '\r' || ch == '"' || ch == '[' || ch == ']')
-                {
-                    ungetChar();
-                    break;
-                }
-            }
-            return Token({tokenStart, size_t(mPos - tokenStart)}, startLoc);
+            advanceInLine(mPos + 1);
+            return true;
         }
+
+        // Skip '+' character, std::from_chars doesn't handle '+'.
+        const char* begin = *mPos == '+' ? mPos + 1 : mPos;
+        int64_t value;
+        auto result = std::from_chars(begin, mEnd, value);
+        // Leave anything that is not a complete number to the regular tokenizer, which reports errors.
+        if (result.ec != std::errc() || (result.ptr != mEnd && !isDelimiter(*result.ptr)))
+            return false;
+        if (value < std::numeric_limits<int32_t>::lowest() || value > std::numeric_limits<int32_t>::max())
+            return false;
+
+        values.push_back((int32_t)value);
+        advanceInLine(result.ptr);
     }
+    return false;
 }
 
 static int32_t parseInt(const Token& t)
@@ -279,8 +467,8 @@ static std::string_view dequoteString(const Token& t)
 constexpr uint32_t TokenOptional = 0;
 constexpr uint32_t TokenRequired = 1;
 
-template<typename Next, typename Unget>
-static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken)
+template<typename Next, typename Unget, typename Current>
+static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken, Current currentTokenizer)
 {
     ParsedParameterVector parameterVector;
 
@@ -431,6 +619,28 @@ static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken)
         {
             while (true)
             {
+                // Parse runs of numbers directly from the tokenizer's input.
+                // The regular token path below picks up strings, booleans, errors and the end of included files.
+                if (valType == Unknown || valType == Float || valType == Int)
+                {
+                    if (Tokenizer* tokenizer = currentTokenizer())
+                    {
+                        bool done = false;
+                        if (valType == Int)
+                        {
+                            done = tokenizer->parseIntArray(param.ints);
+                        }
+                        else
+                        {
+                            done = tokenizer->parseFloatArray(param.floats);
+                            if (valType == Unknown && !param.floats.empty())
+                                valType = Float;
+                        }
+                        if (done)
+                            break;
+                    }
+                }
+
                 val = *nextToken(TokenRequired);
                 if (val.token == "]")
                     break;
@@ -442,7 +652,7 @@ static ParsedParameterVector parseParameters(Next nextToken, Unget ungetToken)
             addVal(val);
         }
 
-        parameterVector.push_back(param);
+        parameterVector.push_back(std::move(param));
     }
 
     return parameterVector;
@@ -456,6 +666,21 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
 
     auto searchPath = tokenizer->getPath().parent_path();
 
+    // Start reading included files ahead of parsing. The hints are dropped when parsing is finished.
+    const size_t kIncludeSearchDistance = 4 << 20;
+    std::vector<IOService::ReadAhead> includeReadAheads;
+    auto readAheadIncludes = [&](Tokenizer& includingTokenizer)
+    {
+        std::vector<std::string> filenames;
+        includingTokenizer.findIncludes(kIncludeSearchDistance, filenames);
+        if (filenames.empty())
+            return;
+        std::vector<std::filesystem::path> paths;
+        for (const auto& filename : filenames)
+            paths.push_back(searchPath / filename);
+        includeReadAheads.push_back(IOService::get().readAhead(paths));
+    };
+
     std::vector<std::unique_ptr<Tokenizer>> fileStack;
     fileStack.push_back(std::move(tokenizer));
 
@@ -478,6 +703,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
             return {};
         }
 
+        readAheadIncludes(*fileStack.back());
         std::optional<Token> tok = fileStack.back()->next();
 
         if (!tok)
@@ -505,6 +731,17 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
         ungetToken = t;
     };
 
+    /**
+     * Helper function returning the tokenizer of the current file, or nullptr if there
+     * is a pending unget token (which needs to be consumed through nextToken() first).
+     */
+    auto currentTokenizer = [&]() -> Tokenizer*
+    {
+        if (ungetToken.has_value() || fileStack.empty())
+            return nullptr;
+        return fileStack.back().get();
+    };
+
     /**
      * Helper function for pbrt API entrypoints that take a single string
      * parameter and a ParameterVector (e.g. onShape()).
@@ -514,7 +751,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
         Token t = *nextToken(TokenRequired);
         std::string_view dequoted = dequoteString(t);
         std::string n = toString(dequoted);
-        ParsedParameterVector parameterVector = parseParameters(nextToken, unget);
+        ParsedParameterVector parameterVector = parseParameters(nextToken, unget, currentTokenizer);
         (target.*apiFunc)(n, std::move(parameterVector), loc);
     };
 
@@ -635,6 +872,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                 auto path = searchPath / filename;
                 std::unique_ptr<Tokenizer> includeTokenizer = Tokenizer::createFromFile(path);
                 logInfo("PBRTImporter: Started parsing '{}'.", includeTokenizer->getPath().string());
+                target.onInclude(includeTokenizer->getPath(), tok->loc);
                 fileStack.push_back(std::move(includeTokenizer));
             }
             else if (tok->token == "Import")
@@ -850,7 +1088,7 @@ void parse(ParserTarget& target, std::unique_ptr<Tokenizer> tokenizer)
                 Token t = *nextToken(TokenRequired);
                 std::string_view dequoted = dequoteString(t);
                 std::string texName = toString(dequoted);
-                ParsedParameterVector params = parseParameters(nextToken, unget);
+                ParsedParameterVector params = parseParameters(nextToken, unget, currentTokenizer);
                 target.onTexture(name, type, texName, std::move(params), tok->loc);
             }
             else
@@ -35,6 +35,8 @@
 
 #include "Types.h"
 #include "Parameters.h"
+#include "Core/Platform/IOService.h"
+#include <cstring>
 #include <functional>
 #include <filesystem>
 #include <memory>
@@ -98,6 +100,7 @@ public:
     virtual void onObjectEnd(FileLoc loc) = 0;
     virtual void onObjectInstance(const std::string& name, FileLoc loc) = 0;
 
+    virtual void onInclude(const std::filesystem::path& path, FileLoc loc) = 0;
     virtual void onEndOfFiles() = 0;
 };
 
@@ -117,7 +120,13 @@ class Tokenizer
 {
 public:
     Tokenizer(std::string str, const std::filesystem::path& path);
+    Tokenizer(std::shared_ptr<const MemoryMappedFile> file, const std::filesystem::path& path);
 
+    /**
+     * Create a tokenizer for a file.
+     * Uncompressed files are memory mapped and tokenized in place, so tokens are available as soon as
+     * the first pages are read, and the file contents are never copied.
+     */
     static std::unique_ptr<Tokenizer> createFromFile(const std::filesystem::path& path);
     static std::unique_ptr<Tokenizer> createFromString(std::string str);
 
@@ -127,6 +136,31 @@ public:
      */
     std::optional<Token> next();
 
+    /**
+     * Parse a run of floating-point values directly from the input, skipping whitespace and comments.
+     * This is a fast path for the contents of numeric arrays, which bypasses the per-token processing of next().
+     * Parsing stops in front of the first token that is not a well-formed number, or after the closing ']'.
+     * @param[out] values Parsed values are appended to this vector.
+     * @return True if the closing ']' of the array was consumed.
+     */
+    bool parseFloatArray(std::vector<Float>& values);
+
+    /**
+     * Parse a run of integer values directly from the input. See parseFloatArray().
+     * @param[out] values Parsed values are appended to this vector.
+     * @return True if the closing ']' of the array was consumed.
+     */
+    bool parseIntArray(std::vector<int>& values);
+
+    /**
+     * Find the files included ahead of the current position, for issuing read-ahead hints.
+     * The input is searched in chunks: a new chunk is searched when parsing gets within half the distance of the
+     * end of the searched input. This is a plain text search, which also reports includes in comments.
+     * @param[in] distance Number of bytes to search ahead of the current position.
+     * @param[out] filenames Filenames of newly found includes are appended to this vector.
+     */
+    void findIncludes(size_t distance, std::vector<std::string>& filenames);
+
     const std::filesystem::path& getPath() const { return mPath; }
 
 private:
@@ -140,6 +174,8 @@ private:
         return filenames;
     }
 
+    void init(const char* data, size_t size);
+
     bool isUTF16(const void* ptr, size_t len) const;
 
     int getChar()
@@ -159,23 +195,38 @@ private:
         return ch;
     }
 
-    void ungetChar()
+    /// Advance to the given position, updating the file location.
+    void advance(const char* pos)
     {
-        --mPos;
-        if (*mPos == '\n')
+        // Find the newlines with memchr, which the C library vectorizes, instead of testing every skipped byte.
+        const char* lineStart = nullptr;
+        for (const char* p = mPos; (p = static_cast<const char*>(std::memchr(p, '\n', size_t(pos - p)))) != nullptr; ++p)
         {
-            // Don't worry about the column; we'll be going to the start of
-            // the next line again shortly...
-            --mLoc.line;
+            ++mLoc.line;
+            lineStart = p + 1;
         }
+        mLoc.column = lineStart ? uint32_t(pos - lineStart) : mLoc.column + uint32_t(pos - mPos);
+        mPos = pos;
     }
 
-    std::filesystem::path mPath; ///< File path we're reading from.
-    FileLoc mLoc;                ///< File location.
-    std::string mContents;       ///< File contents we're parsing.
+    /// Advance to the given position, which must be on the current line.
+    void advanceInLine(const char* pos)
+    {
+        mLoc.column += uint32_t(pos - mPos);
+        mPos = pos;
+    }
+
+    /// Skip whitespace and comments. Returns false at the end of the input.
+    bool skipSpacesAndComments();
+
+    std::filesystem::path mPath;                   ///< File path we're reading from.
+    FileLoc mLoc;                                  ///< File location.
+    std::string mContents;                               ///< File contents we're parsing (if not memory mapped).
+    std::shared_ptr<const MemoryMappedFile> mMappedFile; ///< Memory mapped file we're parsing (if any).
 
     const char* mPos; ///< Current position in the file.
     const char* mEnd; ///< End of the file (one past).
+    const char* mIncludeSearchPos; ///< End of the input searched by findIncludes().
 
     std::string mEscaped; ///< Temporary storage for escaped tokens.
 };
@@ -33,6 +33,7 @@
 #include "Scene/Material/HairMaterial.h"
 #include "Scene/Material/StandardMaterial.h"
 #include "Utils/Settings.h"
+#include "Utils/CryptoUtils.h"
 #include "USDUtils/USDHelpers.h"
 #include "USDUtils/USDUtils.h"
 #include "USDUtils/USDScene1Utils.h"
@@ -236,6 +237,107 @@ namespace Falcor
             return false;
         }
 
+        // Version of the tessellated mesh data stored in the asset cache.
+        // This needs to be incremented every time the tessellator changes its output!
+        const uint32_t kTessellatedMeshCacheVersion = 1;
+
+        template<typename T>
+        void hashArray(SHA1& sha1, const VtArray<T>& array)
+        {
+            sha1.update((uint64_t)array.size());
+            sha1.update(array.cdata(), array.size() * sizeof(T));
+        }
+
+        void hashToken(SHA1& sha1, const TfToken& token)
+        {
+            sha1.update(token.GetString());
+            sha1.update(uint8_t(0));
+        }
+
+        template<typename T>
+        void writeArray(AssetCache::Writer& writer, const VtArray<T>& array)
+        {
+            writer.write((uint64_t)array.size());
+            writer.write(array.cdata(), array.size() * sizeof(T));
+        }
+
+        template<typename T>
+        bool readArray(AssetCache::Reader& reader, VtArray<T>& array)
+        {
+            std::vector<T> data;
+            if (!reader.read(data)) return false;
+            array.assign(data.begin(), data.end());
+            return true;
+        }
+
+        bool readToken(AssetCache::Reader& reader, TfToken& token)
+        {
+            std::string str;
+            if (!reader.read(str)) return false;
+            token = TfToken(str);
+            return true;
+        }
+
+        // Tessellate a mesh, reusing the result from the asset cache if the builder has one.
+        // Only subdivided meshes are cached, plain triangulation is cheaper than a cache lookup.
+        UsdMeshData tessellateCached(const UsdGeomMesh& usdMesh, const UsdMeshData& baseMesh, uint32_t level, VtIntArray& coarseFaceIndices, ImporterContext& ctx)
+        {
+            AssetCache* pAssetCache = ctx.builder.getAssetCache();
+            if (!pAssetCache || level == 0) return tessellate(usdMesh, baseMesh, level, coarseFaceIndices);
+
+            // The key covers the base mesh and all attributes the tessellator reads from the prim.
+            SHA1 sha1;
+            sha1.update(kTessellatedMeshCacheVersion);
+            sha1.update(level);
+            hashToken(sha1, baseMesh.topology.scheme);
+            hashToken(sha1, baseMesh.topology.orient);
+            hashArray(sha1, baseMesh.topology.faceCounts);
+            hashArray(sha1, baseMesh.topology.faceIndices);
+            hashArray(sha1, baseMesh.topology.holeIndices);
+            hashArray(sha1, baseMesh.points);
+            hashArray(sha1, baseMesh.normals);
+            hashArray(sha1, baseMesh.uvs);
+            hashToken(sha1, baseMesh.normalInterp);
+            hashToken(sha1, baseMesh.uvInterp);
+            hashToken(sha1, getAttribute(usdMesh.GetFaceVaryingLinearInterpolationAttr(), UsdGeomTokens->cornersPlus1));
+            hashToken(sha1, getAttribute(usdMesh.GetInterpolateBoundaryAttr(), UsdGeomTokens->edgeAndCorner));
+            AssetCache::Key key = sha1.finalize();
+
+            std::vector<uint8_t> data;
+            if (!is_set(ctx.builder.getFlags(), SceneBuilder::Flags::RebuildCache) && pAssetCache->read(key, data))
+            {
+                UsdMeshData mesh;
+                AssetCache::Reader reader(data);
+                if (readToken(reader, mesh.topology.scheme) && readToken(reader, mesh.topology.orient) && readArray(reader, mesh.topology.faceCounts) &&
+                    readArray(reader, mesh.topology.faceIndices) && readArray(reader, mesh.topology.holeIndices) && readArray(reader, mesh.points) &&
+                    readArray(reader, mesh.normals) && readArray(reader, mesh.uvs) && readToken(reader, mesh.normalInterp) &&
+                    readToken(reader, mesh.uvInterp) && readArray(reader, coarseFaceIndices) && reader.isAtEnd())
+                {
+                    return mesh;
+                }
+                logWarning("Asset cache entry for tessellated mesh '{}' is invalid. Tessellating the mesh again.", usdMesh.GetPath().GetString());
+                coarseFaceIndices.clear();
+            }
+
+            UsdMeshData mesh = tessellate(usdMesh, baseMesh, level, coarseFaceIndices);
+            if (mesh.points.size() == 0) return mesh;
+
+            AssetCache::Writer writer;
+            writer.write(mesh.topology.scheme.GetString());
+            writer.write(mesh.topology.orient.GetString());
+            writeArray(writer, mesh.topology.faceCounts);
+            writeArray(writer, mesh.topology.faceIndices);
+            writeArray(writer, mesh.topology.holeIndices);
+            writeArray(writer, mesh.points);
+            writeArray(writer, mesh.normals);
+            writeArray(writer, mesh.uvs);
+            writer.write(mesh.normalInterp.GetString());
+            writer.write(mesh.uvInterp.GetString());
+            writeArray(writer, coarseFaceIndices);
+            pAssetCache->write(key, writer.getData());
+            return mesh;
+        }
+
         // Convert a UsdGeomMesh, and any GeomSubsets, into a MeshGeomData
         bool convertMeshGeomData(const UsdGeomMesh& usdMesh, const UsdTimeCode& timeCode, ImporterContext& ctx, MeshGeomData& geomOut)
         {
@@ -344,7 +446,7 @@ namespace Falcor
             }
 
             VtIntArray coarseFaceIndices;
-            UsdMeshData tessellatedMesh = tessellate(usdMesh, baseMesh, level, coarseFaceIndices);
+            UsdMeshData tessellatedMesh = tessellateCached(usdMesh, baseMesh, level, coarseFaceIndices, ctx);
             if (tessellatedMesh.points.size() == 0) return false;
 
             VtVec3iArray triangleIndices = tessellatedMesh.topology.getTriangleIndices();
@@ -337,6 +337,13 @@ namespace Falcor
         builder.pushAssetResolver();
         builder.getAssetResolver().addSearchPath(path.parent_path(), SearchPathPriority::First);
 
+        // Track all layers composed into the stage so the scene cache is invalidated when any of them change.
+        for (const auto& pLayer : pStage->GetUsedLayers())
+        {
+            const std::string& realPath = pLayer->GetRealPath();
+            if (!realPath.empty()) builder.addDependency(realPath);
+        }
+
         ImporterContext ctx(path, pStage, builder, materialToShortName, timeReport);
 
         // Falcor uses meter scene unit; scale if necessary. Note that Omniverse uses cm by default.
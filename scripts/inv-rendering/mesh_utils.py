@@ -194,3 +194,72 @@ class Mesh:
             assert torch.all(torch.isfinite(v_tangents))
 
         self.v_tangent = v_tangents
+
+
+class MeshBatch:
+    """
+    Vertex and index data of several meshes, packed back to back in mesh ID order.
+    Triangle indices refer to the packed vertices, so the batch can be processed like a single mesh.
+    Transfers to and from Falcor use a single dispatch and a single acceleration structure update per batch.
+    """
+
+    def __init__(self, mesh_ids):
+        self.mesh_ids = list(mesh_ids)
+        self.mesh = Mesh()
+        self.vertex_offsets = []
+        self.triangle_offsets = []
+
+    def load_from_falcor(self, testbed: falcor.Testbed):
+        scene = testbed.scene
+        device = testbed.device
+
+        self.vertex_offsets = [0]
+        self.triangle_offsets = [0]
+        for mesh_id in self.mesh_ids:
+            mesh = scene.get_mesh(mesh_id)
+            self.vertex_offsets.append(self.vertex_offsets[-1] + mesh.vertex_count)
+            self.triangle_offsets.append(self.triangle_offsets[-1] + mesh.triangle_count)
+        vertex_count = self.vertex_offsets[-1]
+        triangle_count = self.triangle_offsets[-1]
+
+        m = self.mesh
+        m.init_falcor(device, scene, vertex_count, triangle_count)
+        scene.get_mesh_batch_vertices_and_indices(self.mesh_ids, m.buffers)
+
+        # Copy from Falcor to PyTorch.
+        m.tri_idx = torch.zeros([triangle_count, 3], dtype=torch.int32)
+        m.buffers["triangleIndices"].copy_to_torch(m.tri_idx)
+
+        m.v_pos = torch.zeros([vertex_count, 3], dtype=torch.float32)
+        m.buffers["positions"].copy_to_torch(m.v_pos)
+
+        m.v_texcrd = torch.zeros([vertex_count, 3], dtype=torch.float32)
+        m.buffers["texcrds"].copy_to_torch(m.v_texcrd)
+
+        device.render_context.wait_for_cuda()
+
+        # Triangle indices are local to each mesh, make them index the packed vertices instead.
+        for i in range(len(self.mesh_ids)):
+            t0, t1 = self.get_triangle_range(i)
+            m.tri_idx[t0:t1] += self.vertex_offsets[i]
+
+    def get_vertex_range(self, i: int):
+        return self.vertex_offsets[i], self.vertex_offsets[i + 1]
+
+    def get_triangle_range(self, i: int):
+        return self.triangle_offsets[i], self.triangle_offsets[i + 1]
+
+    def update_to_falcor(self, testbed: falcor.Testbed):
+        scene = testbed.scene
+        device = testbed.device
+
+        # Copy from PyTorch to Falcor.
+        m = self.mesh
+        m.buffers["positions"].from_torch(m.v_pos.detach())
+        m.buffers["normals"].from_torch(m.v_norm.detach())
+        m.buffers["tangents"].from_torch(m.v_tangent.detach())
+        m.buffers["texcrds"].from_torch(m.v_texcrd.detach())
+        device.render_context.wait_for_cuda()
+
+        # Bind shader data.
+        scene.set_mesh_batch_vertices(self.mesh_ids, m.buffers)